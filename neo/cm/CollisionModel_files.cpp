@@ -43,6 +43,25 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+// binary cache of the .cm, holding the final tree so nothing has to be
+// filtered, merged or recalculated when it is loaded
+#define BCM_FILE_EXT		"bcm"
+#define BCM_FILEID			( ( ' ' << 24 ) | ( 'M' << 16 ) | ( 'C' << 8 ) | 'B' )
+#define BCM_FILEVERSION		1
+
+static idCVar cm_binaryCache( "cm_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "load collision models from the binary .bcm when it matches the map, and write it next to every .cm" );
+
+// polygons and brushes by file index while a .bcm is read
+typedef struct cm_binaryIndex_s {
+	cm_polygon_t **			polygons;
+	int						numPolygons;
+	cm_brush_t **			brushes;
+	int						numBrushes;
+	int						numNodes;			// totals, so the nodes and references each go in a single block
+	int						numPolygonRefs;
+	int						numBrushRefs;
+} cm_binaryIndex_t;
+
 /*
 ===============================================================================
 
@@ -257,6 +276,8 @@ void idCollisionModelManagerLocal::WriteCollisionModelsToFile( const char *filen
 	}
 
 	fileSystem->CloseFile( fp );
+
+	WriteBinaryCollisionModelsToFile( filename, firstModel, lastModel, mapFileCRC );
 }
 
 /*
@@ -304,6 +325,244 @@ bool idCollisionModelManagerLocal::WriteCollisionModelForMapEntity( const idMapE
 	return true;
 }
 
+/*
+================
+CM_CountNodeReferences
+================
+*/
+static void CM_CountNodeReferences( cm_node_t *node, int &numNodes, int &numPolygonRefs, int &numBrushRefs ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	numNodes++;
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		numPolygonRefs++;
+	}
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		numBrushRefs++;
+	}
+	if ( node->planeType != -1 ) {
+		CM_CountNodeReferences( node->children[0], numNodes, numPolygonRefs, numBrushRefs );
+		CM_CountNodeReferences( node->children[1], numNodes, numPolygonRefs, numBrushRefs );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::CollectBinaryData_r
+
+Lists every polygon and brush once, in tree order
+================
+*/
+void idCollisionModelManagerLocal::CollectBinaryData_r( cm_node_t *node, idList<cm_polygon_t *> &polygons, idList<cm_brush_t *> &brushes, idList<const idMaterial *> &materials ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		if ( pref->p->checkcount == checkCount ) {
+			continue;
+		}
+		pref->p->checkcount = checkCount;
+		polygons.Append( pref->p );
+		materials.AddUnique( pref->p->material );
+	}
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		if ( bref->b->checkcount == checkCount ) {
+			continue;
+		}
+		bref->b->checkcount = checkCount;
+		brushes.Append( bref->b );
+	}
+	if ( node->planeType != -1 ) {
+		CollectBinaryData_r( node->children[0], polygons, brushes, materials );
+		CollectBinaryData_r( node->children[1], polygons, brushes, materials );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryNodes
+
+Polygons and brushes are referenced by the index stored in their checkcount
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryNodes( idFile *fp, cm_node_t *node ) {
+	idList<int> refs;
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+	int i;
+
+	fp->WriteInt( node->planeType );
+	fp->WriteFloat( node->planeDist );
+
+	// the references are written back to front, so prepending
+	// them while loading restores the original order
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		refs.Append( pref->p->checkcount );
+	}
+	fp->WriteInt( refs.Num() );
+	for ( i = refs.Num() - 1; i >= 0; i-- ) {
+		fp->WriteInt( refs[i] );
+	}
+	refs.SetNum( 0, false );
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		refs.Append( bref->b->checkcount );
+	}
+	fp->WriteInt( refs.Num() );
+	for ( i = refs.Num() - 1; i >= 0; i-- ) {
+		fp->WriteInt( refs[i] );
+	}
+
+	if ( node->planeType != -1 ) {
+		WriteBinaryNodes( fp, node->children[0] );
+		WriteBinaryNodes( fp, node->children[1] );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, idCollisionModelLocal *model ) {
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idList<const idMaterial *> materials;
+	int i, j, polygonMemory, brushMemory, numNodes, numPolygonRefs, numBrushRefs;
+
+	checkCount++;
+	CollectBinaryData_r( model->node, polygons, brushes, materials );
+
+	fp->WriteString( model->name );
+	fp->WriteVec3( model->bounds[0] );
+	fp->WriteVec3( model->bounds[1] );
+	fp->WriteInt( model->contents );
+	fp->WriteBool( model->isConvex );
+	fp->WriteInt( model->numInternalEdges );
+	fp->WriteInt( model->numSharpEdges );
+	fp->WriteInt( model->numRemovedPolys );
+	fp->WriteInt( model->numMergedPolys );
+
+	// vertices
+	fp->WriteInt( model->numVertices );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->WriteVec3( model->vertices[i].p );
+	}
+	// edges with their final normals
+	fp->WriteInt( model->numEdges );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		fp->WriteInt( model->edges[i].vertexNum[0] );
+		fp->WriteInt( model->edges[i].vertexNum[1] );
+		fp->WriteUnsignedShort( model->edges[i].internal );
+		fp->WriteUnsignedShort( model->edges[i].numUsers );
+		fp->WriteVec3( model->edges[i].normal );
+	}
+	// materials used by the polygons
+	fp->WriteInt( materials.Num() );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		fp->WriteString( materials[i] ? materials[i]->GetName() : "" );
+	}
+	// polygons
+	polygonMemory = 0;
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		polygonMemory += sizeof( cm_polygon_t ) + ( polygons[i]->numEdges - 1 ) * sizeof( polygons[i]->edges[0] );
+	}
+	fp->WriteInt( polygons.Num() );
+	fp->WriteInt( polygonMemory );
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		cm_polygon_t *p = polygons[i];
+		fp->WriteInt( p->numEdges );
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->WriteInt( p->edges[j] );
+		}
+		fp->WriteVec3( p->plane.Normal() );
+		fp->WriteFloat( p->plane.Dist() );
+		fp->WriteVec3( p->bounds[0] );
+		fp->WriteVec3( p->bounds[1] );
+		fp->WriteInt( p->contents );
+		fp->WriteInt( materials.FindIndex( p->material ) );
+	}
+	// brushes
+	brushMemory = 0;
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		brushMemory += sizeof( cm_brush_t ) + ( brushes[i]->numPlanes - 1 ) * sizeof( brushes[i]->planes[0] );
+	}
+	fp->WriteInt( brushes.Num() );
+	fp->WriteInt( brushMemory );
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		cm_brush_t *b = brushes[i];
+		fp->WriteInt( b->numPlanes );
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->WriteVec3( b->planes[j].Normal() );
+			fp->WriteFloat( b->planes[j].Dist() );
+		}
+		fp->WriteVec3( b->bounds[0] );
+		fp->WriteVec3( b->bounds[1] );
+		fp->WriteInt( b->contents );
+		fp->WriteInt( b->primitiveNum );
+	}
+	// node tree
+	numNodes = numPolygonRefs = numBrushRefs = 0;
+	CM_CountNodeReferences( model->node, numNodes, numPolygonRefs, numBrushRefs );
+	fp->WriteInt( numNodes );
+	fp->WriteInt( numPolygonRefs );
+	fp->WriteInt( numBrushRefs );
+
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		polygons[i]->checkcount = i;
+	}
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		brushes[i]->checkcount = i;
+	}
+	WriteBinaryNodes( fp, model->node );
+
+	// the indexes must never match a future checkCount
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		polygons[i]->checkcount = 0;
+	}
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		brushes[i]->checkcount = 0;
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC ) {
+	int i;
+	idFile *fp;
+	idStr name;
+
+	if ( !cm_binaryCache.GetBool() ) {
+		return;
+	}
+
+	name = filename;
+	name.SetFileExtension( BCM_FILE_EXT );
+
+	common->Printf( "writing %s\n", name.c_str() );
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	// write file id, version and the map file crc
+	fp->WriteInt( BCM_FILEID );
+	fp->WriteInt( BCM_FILEVERSION );
+	fp->WriteUnsignedInt( mapFileCRC );
+
+	// write the collision models
+	fp->WriteInt( lastModel - firstModel );
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( fp, models[ i ] );
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
 
 /*
 ===============================================================================
@@ -469,6 +728,7 @@ void idCollisionModelManagerLocal::ParseBrushes( idLexer *src, idCollisionModelL
 		}
 		b->checkcount = 0;
 		b->primitiveNum = 0;
+		b->material = NULL;		// not stored in the .cm
 		// filter brush into tree
 		R_FilterBrushIntoTree( model, model->node, NULL, b );
 	}
@@ -561,6 +821,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idToken token;
 	idLexer *src;
 	unsigned int crc;
+	int firstModel;
+
+	// the binary cache is written with every .cm, and saves all the parsing
+	if ( LoadBinaryCollisionModelFile( name, mapFileCRC ) ) {
+		return true;
+	}
 
 	// load it
 	fileName = name;
@@ -598,6 +864,7 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	}
 
 	// parse the file
+	firstModel = numModels;
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
 			break;
@@ -616,5 +883,393 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	delete src;
 
+	// the .bcm was missing or stale
+	WriteBinaryCollisionModelsToFile( name, firstModel, numModels, crc );
+
+	return true;
+}
+
+/*
+================
+ReadBinaryCount
+
+A broken .bcm makes the readers return false, so the .cm is parsed instead.
+The count is checked against the bytes left in the file, each element takes
+at least minBytes of them.
+================
+*/
+static bool ReadBinaryCount( idFile *fp, int &count, int minBytes ) {
+	count = -1;
+	if ( fp->ReadInt( count ) != sizeof( count ) || count < 0
+		|| (long long)count * minBytes > fp->Length() - fp->Tell() ) {
+		common->Warning( "%s: bad count", fp->GetName() );
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+ReadBinaryString
+================
+*/
+static bool ReadBinaryString( idFile *fp, idStr &string ) {
+	int len;
+
+	if ( !ReadBinaryCount( fp, len, 1 ) ) {
+		return false;
+	}
+	string.Fill( ' ', len );
+	fp->Read( &string[0], len );
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryNodes
+
+Returns NULL if the file is broken, the nodes and references are freed with the model blocks
+================
+*/
+cm_node_t *idCollisionModelManagerLocal::ReadBinaryNodes( idFile *fp, idCollisionModelLocal *model, cm_node_t *parent, const cm_binaryIndex_s &index ) {
+	cm_node_t *node;
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+	int i, num, ref;
+
+	// a broken tree could recurse until the stack runs out
+	if ( model->numNodes >= index.numNodes ) {
+		common->Warning( "%s: too many nodes", fp->GetName() );
+		return NULL;
+	}
+
+	model->numNodes++;
+	node = AllocNode( model, index.numNodes );
+	node->brushes = NULL;
+	node->polygons = NULL;
+	node->parent = parent;
+	fp->ReadInt( node->planeType );
+	fp->ReadFloat( node->planeDist );
+
+	if ( !ReadBinaryCount( fp, num, 4 ) ) {
+		return NULL;
+	}
+	for ( i = 0; i < num; i++ ) {
+		ref = -1;
+		fp->ReadInt( ref );
+		if ( ref < 0 || ref >= index.numPolygons ) {
+			common->Warning( "%s: bad polygon reference", fp->GetName() );
+			return NULL;
+		}
+		pref = AllocPolygonReference( model, index.numPolygonRefs );
+		pref->p = index.polygons[ref];
+		pref->next = node->polygons;
+		node->polygons = pref;
+		model->numPolygonRefs++;
+	}
+	if ( !ReadBinaryCount( fp, num, 4 ) ) {
+		return NULL;
+	}
+	for ( i = 0; i < num; i++ ) {
+		ref = -1;
+		fp->ReadInt( ref );
+		if ( ref < 0 || ref >= index.numBrushes ) {
+			common->Warning( "%s: bad brush reference", fp->GetName() );
+			return NULL;
+		}
+		bref = AllocBrushReference( model, index.numBrushRefs );
+		bref->b = index.brushes[ref];
+		bref->next = node->brushes;
+		node->brushes = bref;
+		model->numBrushRefs++;
+	}
+
+	if ( node->planeType != -1 ) {
+		if ( node->planeType < 0 || node->planeType > 2 ) {
+			common->Warning( "%s: bad node plane", fp->GetName() );
+			return NULL;
+		}
+		node->children[0] = ReadBinaryNodes( fp, model, node, index );
+		if ( !node->children[0] ) {
+			return NULL;
+		}
+		node->children[1] = ReadBinaryNodes( fp, model, node, index );
+		if ( !node->children[1] ) {
+			return NULL;
+		}
+	}
+	return node;
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryCollisionModel
+
+Returns false if the file is broken, the model is left in models[] for the caller to free
+================
+*/
+bool idCollisionModelManagerLocal::ReadBinaryCollisionModel( idFile *fp ) {
+	idCollisionModelLocal *model;
+	cm_binaryIndex_t index;
+	idList<const idMaterial *> materials;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idStr name;
+	idVec3 normal;
+	float dist;
+	int i, j, num, memory;
+
+	if ( numModels >= MAX_SUBMODELS ) {
+		common->Error( "LoadModel: no free slots" );
+		return false;
+	}
+	model = AllocModel();
+	models[numModels ] = model;
+	numModels++;
+
+	if ( !ReadBinaryString( fp, model->name ) ) {
+		return false;
+	}
+	if ( model->name.Cmpn( PROC_CLIPMODEL_STRING_PRFX, strlen( PROC_CLIPMODEL_STRING_PRFX ) ) == 0 ) {
+		numInlinedProcClipModels++;
+	}
+
+	fp->ReadVec3( model->bounds[0] );
+	fp->ReadVec3( model->bounds[1] );
+	fp->ReadInt( model->contents );
+	fp->ReadBool( model->isConvex );
+	fp->ReadInt( model->numInternalEdges );
+	fp->ReadInt( model->numSharpEdges );
+	fp->ReadInt( model->numRemovedPolys );
+	fp->ReadInt( model->numMergedPolys );
+
+	// vertices
+	if ( !ReadBinaryCount( fp, model->numVertices, 12 ) ) {
+		return false;
+	}
+	model->maxVertices = model->numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->ReadVec3( model->vertices[i].p );
+		model->vertices[i].side = 0;
+		model->vertices[i].sideSet = 0;
+		model->vertices[i].checkcount = 0;
+	}
+
+	// edges
+	if ( !ReadBinaryCount( fp, model->numEdges, 24 ) ) {
+		return false;
+	}
+	model->maxEdges = model->numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		fp->ReadInt( model->edges[i].vertexNum[0] );
+		fp->ReadInt( model->edges[i].vertexNum[1] );
+		fp->ReadUnsignedShort( model->edges[i].internal );
+		fp->ReadUnsignedShort( model->edges[i].numUsers );
+		fp->ReadVec3( model->edges[i].normal );
+		model->edges[i].side = 0;
+		model->edges[i].sideSet = 0;
+		model->edges[i].checkcount = 0;
+		for ( j = 0; j < 2; j++ ) {
+			if ( model->edges[i].vertexNum[j] < 0 || model->edges[i].vertexNum[j] >= model->numVertices ) {
+				common->Warning( "%s: bad edge", fp->GetName() );
+				return false;
+			}
+		}
+	}
+
+	// materials
+	if ( !ReadBinaryCount( fp, num, 4 ) ) {
+		return false;
+	}
+	materials.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		if ( !ReadBinaryString( fp, name ) ) {
+			return false;
+		}
+		materials[i] = name.Length() ? declManager->FindMaterial( name ) : NULL;
+	}
+
+	// polygons, all in one block
+	if ( !ReadBinaryCount( fp, num, 4 ) || !ReadBinaryCount( fp, memory, 0 )
+		|| (long long)memory > (long long)num * (long long)sizeof( cm_polygon_t ) + fp->Length() - fp->Tell() ) {
+		return false;
+	}
+	model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + memory );
+	model->polygonBlock->bytesRemaining = memory;
+	model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+	polygons.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		int numEdges;
+		// everything has to fit in the block, FreeModel doesn't free polygons one by one
+		if ( !ReadBinaryCount( fp, numEdges, 4 ) || numEdges == 0
+			|| model->polygonBlock->bytesRemaining < (int)( sizeof( cm_polygon_t ) + ( numEdges - 1 ) * sizeof( int ) ) ) {
+			common->Warning( "%s: bad polygon", fp->GetName() );
+			return false;
+		}
+		cm_polygon_t *p = AllocPolygon( model, numEdges );
+		p->numEdges = numEdges;
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->ReadInt( p->edges[j] );
+			if ( abs( p->edges[j] ) >= model->numEdges ) {
+				common->Warning( "%s: bad polygon edge", fp->GetName() );
+				return false;
+			}
+		}
+		fp->ReadVec3( normal );
+		fp->ReadFloat( dist );
+		p->plane.SetNormal( normal );
+		p->plane.SetDist( dist );
+		fp->ReadVec3( p->bounds[0] );
+		fp->ReadVec3( p->bounds[1] );
+		fp->ReadInt( p->contents );
+		j = -1;
+		fp->ReadInt( j );
+		p->material = ( j >= 0 && j < materials.Num() ) ? materials[j] : NULL;
+		p->checkcount = 0;
+		polygons[i] = p;
+	}
+
+	// brushes, all in one block
+	if ( !ReadBinaryCount( fp, num, 4 ) || !ReadBinaryCount( fp, memory, 0 )
+		|| (long long)memory > (long long)num * (long long)sizeof( cm_brush_t ) + fp->Length() - fp->Tell() ) {
+		return false;
+	}
+	model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + memory );
+	model->brushBlock->bytesRemaining = memory;
+	model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+	brushes.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		int numPlanes;
+		if ( !ReadBinaryCount( fp, numPlanes, 16 ) || numPlanes == 0
+			|| model->brushBlock->bytesRemaining < (int)( sizeof( cm_brush_t ) + ( numPlanes - 1 ) * sizeof( idPlane ) ) ) {
+			common->Warning( "%s: bad brush", fp->GetName() );
+			return false;
+		}
+		cm_brush_t *b = AllocBrush( model, numPlanes );
+		b->numPlanes = numPlanes;
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->ReadVec3( normal );
+			fp->ReadFloat( dist );
+			b->planes[j].SetNormal( normal );
+			b->planes[j].SetDist( dist );
+		}
+		fp->ReadVec3( b->bounds[0] );
+		fp->ReadVec3( b->bounds[1] );
+		fp->ReadInt( b->contents );
+		fp->ReadInt( b->primitiveNum );
+		b->material = NULL;		// not stored in the .cm either
+		b->checkcount = 0;
+		brushes[i] = b;
+	}
+
+	// node tree with the references of the original build
+	index.polygons = polygons.Ptr();
+	index.numPolygons = polygons.Num();
+	index.brushes = brushes.Ptr();
+	index.numBrushes = brushes.Num();
+	if ( !ReadBinaryCount( fp, index.numNodes, 16 ) || !ReadBinaryCount( fp, index.numPolygonRefs, 4 )
+		|| !ReadBinaryCount( fp, index.numBrushRefs, 4 ) ) {
+		return false;
+	}
+	if ( !index.numNodes ) {
+		common->Warning( "%s: model %s has no nodes", fp->GetName(), model->name.c_str() );
+		return false;
+	}
+	// the tree is only hooked up when it is complete, FreeModel can't walk a partial one
+	cm_node_t *node = ReadBinaryNodes( fp, model, NULL, index );
+	if ( !node ) {
+		return false;
+	}
+	model->node = node;
+
+	// total memory used by this model
+	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
+						model->numEdges * sizeof(cm_edge_t) +
+						model->polygonMemory +
+						model->brushMemory +
+						model->numNodes * sizeof(cm_node_t) +
+						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
+						model->numBrushRefs * sizeof(cm_brushRef_t);
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+
+Returns false when the .bcm is missing, older than the .cm, built for another map or broken
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC ) {
+	idStr fileName, textName;
+	void *buffer;
+	ID_TIME_T timeStamp, textTimeStamp;
+	int i, length, ident, version, numBinaryModels;
+	unsigned int crc;
+
+	if ( !cm_binaryCache.GetBool() ) {
+		return false;
+	}
+
+	fileName = name;
+	fileName.SetFileExtension( BCM_FILE_EXT );
+	textName = name;
+	textName.SetFileExtension( CM_FILE_EXT );
+
+	length = fileSystem->ReadFile( fileName, &buffer, &timeStamp );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	fileSystem->ReadFile( textName, NULL, &textTimeStamp );
+	if ( textTimeStamp != FILE_NOT_FOUND_TIMESTAMP && textTimeStamp > timeStamp ) {
+		common->Printf( "%s is older than %s\n", fileName.c_str(), textName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	idFile_Memory fp( fileName, (const char *)buffer, length );
+
+	ident = version = 0;
+	fp.ReadInt( ident );
+	fp.ReadInt( version );
+	if ( ident != BCM_FILEID || version != BCM_FILEVERSION ) {
+		common->Printf( "%s has the wrong version\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	crc = 0;
+	fp.ReadUnsignedInt( crc );
+	if ( mapFileCRC && crc != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	int firstModel = numModels;
+	int firstInlinedProcClipModel = numInlinedProcClipModels;
+	bool valid = ReadBinaryCount( &fp, numBinaryModels, 4 );
+	for ( i = 0; valid && i < numBinaryModels; i++ ) {
+		valid = ReadBinaryCollisionModel( &fp );
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !valid ) {
+		// throw away what was read, the .cm is parsed from scratch
+		common->Printf( "%s is broken, parsing %s\n", fileName.c_str(), textName.c_str() );
+		for ( i = firstModel; i < numModels; i++ ) {
+			FreeModel( models[i] );
+			models[i] = NULL;
+		}
+		numModels = firstModel;
+		numInlinedProcClipModels = firstInlinedProcClipModel;
+		return false;
+	}
+
 	return true;
 }
@@ -492,6 +492,10 @@ private:			// CollisionMap_files.cpp
 	void			WriteBrushes( idFile *fp, cm_node_t *node );
 	void			WriteCollisionModel( idFile *fp, idCollisionModelLocal *model );
 	void			WriteCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+	void			CollectBinaryData_r( cm_node_t *node, idList<cm_polygon_t *> &polygons, idList<cm_brush_t *> &brushes, idList<const idMaterial *> &materials );
+	void			WriteBinaryNodes( idFile *fp, cm_node_t *node );
+	void			WriteBinaryCollisionModel( idFile *fp, idCollisionModelLocal *model );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
 					// loading
 	cm_node_t *		ParseNodes( idLexer *src, idCollisionModelLocal *model, cm_node_t *parent );
 	void			ParseVertices( idLexer *src, idCollisionModelLocal *model );
@@ -500,6 +504,9 @@ private:			// CollisionMap_files.cpp
 	void			ParseBrushes( idLexer *src, idCollisionModelLocal *model );
 	bool			ParseCollisionModel( idLexer *src );
 	bool			LoadCollisionModelFile( const char *name, unsigned int mapFileCRC );
+	cm_node_t *		ReadBinaryNodes( idFile *fp, idCollisionModelLocal *model, cm_node_t *parent, const struct cm_binaryIndex_s &index );
+	bool			ReadBinaryCollisionModel( idFile *fp );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC );
 
 private:			// CollisionMap_debug
 	int				ContentsFromString( const char *string ) const;
@@ -2490,6 +2490,8 @@ bool idEntity::RunPhysics( void ) {
 		return false;
 	}
 
+	idTickProfileScope profile( gameLocal.profilePhysics );
+
 	startTime = gameLocal.previousTime;
 	endTime = gameLocal.time;
 
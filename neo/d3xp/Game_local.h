@@ -106,6 +106,34 @@ typedef struct snapshot_s {
 	struct snapshot_s *		next;
 } snapshot_t;
 
+// the most writes an entity can make to its snapshot state and still be cached
+const int MAX_SNAPSHOT_CACHE_WRITES	= 1024;
+
+// the entity states written for a snapshot before the byte budget is applied
+const int MAX_SNAPSHOT_ENTITY_SIZE	= 16384;
+
+// the snapshot state of an entity, written once per server frame and delta compressed
+// against the baseline of every client that has the entity in its PVS
+typedef struct entitySnapshotCache_s {
+	int						serial;					// snapshotCacheSerial when the state was written
+	int						spawnId;
+	int						firstWrite;				// recorded writes in snapshotCacheWrites
+	int						numWrites;				// -1 if the entity can't be cached
+	idBitMsg				state;
+	byte					stateBuf[MAX_ENTITY_STATE_SIZE];
+} entitySnapshotCache_t;
+
+// the state of an entity that changed since the baseline of a client, a snapshot
+// takes the candidates with the highest priority that fit the byte budget
+typedef struct snapshotCandidate_s {
+	entityState_t *			newBase;
+	int						spawnOrder;
+	int						startBit;				// delta compressed state in the entity message
+	int						numBits;
+	float					priority;				// idMath::INFINITY if the client can't wait for it
+	bool					selected;
+} snapshotCandidate_t;
+
 const int MAX_EVENT_PARAM_SIZE		= 128;
 
 typedef struct entityNetEvent_s {
@@ -316,6 +344,12 @@ public:
 	idEntityPtr<idEntity>	lastGUIEnt;				// last entity with a GUI, used by Cmd_NextGUI_f
 	int						lastGUI;				// last GUI on the lastGUIEnt
 
+	int						profileThink;			// tick profiler scopes
+	int						profilePhysics;
+	int						profileEvents;
+	int						profileScripts;
+	int						profilePVS;
+
 #ifdef _D3XP
 	idEntityPtr<idEntity>	portalSkyEnt;
 	bool					portalSkyActive;
@@ -378,6 +412,7 @@ public:
 	virtual void			ServerClientBegin( int clientNum );
 	virtual void			ServerClientDisconnect( int clientNum );
 	virtual void			ServerWriteInitialReliableMessages( int clientNum );
+	virtual bool			ServerPrepareSnapshots( void );
 	virtual void			ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients );
 	virtual bool			ServerApplySnapshot( int clientNum, int sequence );
 	virtual void			ServerProcessReliableMessage( int clientNum, const idBitMsg &msg );
@@ -548,8 +583,15 @@ private:
 	entityState_t *			clientEntityStates[MAX_CLIENTS][MAX_GENTITIES];
 	int						clientPVS[MAX_CLIENTS][ENTITY_PVS_SIZE];
 	snapshot_t *			clientSnapshots[MAX_CLIENTS];
-	idBlockAlloc<entityState_t,256>entityStateAllocator;
-	idBlockAlloc<snapshot_t,64>snapshotAllocator;
+	float					clientSnapshotPriority[MAX_CLIENTS][MAX_GENTITIES];	// grows every snapshot an entity waits for
+	idList<snapshotCandidate_t>snapshotCandidates[MAX_CLIENTS];
+	idBlockAlloc<entityState_t,256>entityStateAllocators[MAX_CLIENTS];	// per client so snapshots can be written in parallel
+	idBlockAlloc<snapshot_t,64>snapshotAllocators[MAX_CLIENTS];
+	entitySnapshotCache_t *	snapshotCache[MAX_GENTITIES];
+	idBlockAlloc<entitySnapshotCache_t,64>snapshotCacheAllocator;
+	idList<deltaWrite_t>	snapshotCacheWrites;
+	int						snapshotCacheSerial;	// changes whenever the entity states may have changed
+	int						snapshotCacheWritesSerial;
 
 	idEventQueue			eventQueue;
 	idEventQueue			savedEventQueue;
@@ -598,6 +640,9 @@ private:
 	void					InitClientDeclRemap( int clientNum );
 	void					ServerSendDeclRemapToClient( int clientNum, declType_t type, int index );
 	void					FreeSnapshotsOlderThanSequence( int clientNum, int sequence );
+	const entitySnapshotCache_t *GetSnapshotCache( idEntity *ent );
+	float					GetSnapshotPriority( idEntity *ent, const idVec3 &viewOrigin, const idVec3 &viewDir ) const;
+	void					SelectSnapshotCandidates( int clientNum, int maxBits );
 	bool					ApplySnapshot( int clientNum, int sequence );
 	void					WriteGameStateToSnapshot( idBitMsgDelta &msg ) const;
 	void					ReadGameStateFromSnapshot( const idBitMsgDelta &msg );
@@ -778,5 +823,6 @@ const int	CINEMATIC_SKIP_DELAY	= SEC2MS( 2.0f );
 #include "script/Script_Compiler.h"
 #include "script/Script_Interpreter.h"
 #include "script/Script_Thread.h"
+#include "script/Script_Profiler.h"
 
 #endif	/* !__GAME_LOCAL_H__ */
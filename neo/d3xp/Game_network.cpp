@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "precompiled.h"
 #pragma hdrstop
 
+#include <mutex>
+
 #include "Game_local.h"
 
 /*
@@ -52,6 +54,9 @@ idCVar net_clientShowSnapshotRadius( "net_clientShowSnapshotRadius", "128", CVAR
 idCVar net_clientSmoothing( "net_clientSmoothing", "0.8", CVAR_GAME | CVAR_FLOAT, "smooth other clients angles and position.", 0.0f, 0.95f );
 idCVar net_clientSelfSmoothing( "net_clientSelfSmoothing", "0.6", CVAR_GAME | CVAR_FLOAT, "smooth self position if network causes prediction error.", 0.0f, 0.95f );
 idCVar net_clientMaxPrediction( "net_clientMaxPrediction", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of milliseconds a client can predict ahead of server." );
+idCVar net_serverSnapshotCache( "net_serverSnapshotCache", "1", CVAR_GAME | CVAR_BOOL | CVAR_NOCHEAT, "write the snapshot state of each entity once per server frame instead of once per client" );
+idCVar net_serverSnapshotBytes( "net_serverSnapshotBytes", "1200", CVAR_GAME | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of bytes of entity states in a snapshot, also limited by net_serverMaxClientRate. entities that don't fit wait for a later snapshot, 0 = no limit" );
+idCVar net_serverSnapshotPriorityRange( "net_serverSnapshotPriorityRange", "512", CVAR_GAME | CVAR_FLOAT | CVAR_NOCHEAT, "distance at which the snapshot priority of an entity is halved" );
 idCVar net_clientLagOMeter( "net_clientLagOMeter", "1", CVAR_GAME | CVAR_BOOL | CVAR_NOCHEAT | CVAR_ARCHIVE, "draw prediction graph" );
 
 /*
@@ -71,6 +76,9 @@ void idGameLocal::InitAsyncNetwork( void ) {
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( clientSnapshotPriority, 0, sizeof( clientSnapshotPriority ) );
+	memset( snapshotCache, 0, sizeof( snapshotCache ) );
+	snapshotCacheWritesSerial = -1;
 
 	eventQueue.Init();
 	savedEventQueue.Init();
@@ -88,13 +96,21 @@ idGameLocal::ShutdownAsyncNetwork
 ================
 */
 void idGameLocal::ShutdownAsyncNetwork( void ) {
-	entityStateAllocator.Shutdown();
-	snapshotAllocator.Shutdown();
+	for ( int i = 0; i < MAX_CLIENTS; i++ ) {
+		entityStateAllocators[i].Shutdown();
+		snapshotAllocators[i].Shutdown();
+	}
+	snapshotCacheAllocator.Shutdown();
+	snapshotCacheWrites.Clear();
+	for ( int i = 0; i < MAX_CLIENTS; i++ ) {
+		snapshotCandidates[i].Clear();
+	}
 	eventQueue.Shutdown();
 	savedEventQueue.Shutdown();
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( snapshotCache, 0, sizeof( snapshotCache ) );
 }
 
 /*
@@ -307,6 +323,9 @@ void idGameLocal::ServerClientBegin( int clientNum ) {
 	idBitMsg	outMsg;
 	byte		msgBuf[MAX_GAME_MESSAGE_SIZE];
 
+	// spawning the player changes the entity states outside of a game frame
+	snapshotCacheSerial++;
+
 	// initialize the decl remap
 	InitClientDeclRemap( clientNum );
 
@@ -341,6 +360,8 @@ void idGameLocal::ServerClientDisconnect( int clientNum ) {
 	idBitMsg	outMsg;
 	byte		msgBuf[MAX_GAME_MESSAGE_SIZE];
 
+	snapshotCacheSerial++;
+
 	outMsg.Init( msgBuf, sizeof( msgBuf ) );
 	outMsg.BeginWriting();
 	outMsg.WriteByte( GAME_RELIABLE_MESSAGE_DELETE_ENT );
@@ -353,9 +374,10 @@ void idGameLocal::ServerClientDisconnect( int clientNum ) {
 	// free entity states stored for this client
 	for ( i = 0; i < MAX_GENTITIES; i++ ) {
 		if ( clientEntityStates[ clientNum ][ i ] ) {
-			entityStateAllocator.Free( clientEntityStates[ clientNum ][ i ] );
+			entityStateAllocators[clientNum].Free( clientEntityStates[ clientNum ][ i ] );
 			clientEntityStates[ clientNum ][ i ] = NULL;
 		}
+		clientSnapshotPriority[ clientNum ][ i ] = 0.0f;
 	}
 
 	// clear the client PVS
@@ -460,14 +482,14 @@ void idGameLocal::FreeSnapshotsOlderThanSequence( int clientNum, int sequence )
 		if ( snapshot->sequence < sequence ) {
 			for ( state = snapshot->firstEntityState; state; state = snapshot->firstEntityState ) {
 				snapshot->firstEntityState = snapshot->firstEntityState->next;
-				entityStateAllocator.Free( state );
+				entityStateAllocators[clientNum].Free( state );
 			}
 			if ( lastSnapshot ) {
 				lastSnapshot->next = snapshot->next;
 			} else {
 				clientSnapshots[clientNum] = snapshot->next;
 			}
-			snapshotAllocator.Free( snapshot );
+			snapshotAllocators[clientNum].Free( snapshot );
 		} else {
 			lastSnapshot = snapshot;
 		}
@@ -490,7 +512,7 @@ bool idGameLocal::ApplySnapshot( int clientNum, int sequence ) {
 		if ( snapshot->sequence == sequence ) {
 			for ( state = snapshot->firstEntityState; state; state = state->next ) {
 				if ( clientEntityStates[clientNum][state->entityNumber] ) {
-					entityStateAllocator.Free( clientEntityStates[clientNum][state->entityNumber] );
+					entityStateAllocators[clientNum].Free( clientEntityStates[clientNum][state->entityNumber] );
 				}
 				clientEntityStates[clientNum][state->entityNumber] = state;
 			}
@@ -500,7 +522,7 @@ bool idGameLocal::ApplySnapshot( int clientNum, int sequence ) {
 			} else {
 				clientSnapshots[clientNum] = nextSnapshot;
 			}
-			snapshotAllocator.Free( snapshot );
+			snapshotAllocators[clientNum].Free( snapshot );
 			return true;
 		} else {
 			lastSnapshot = snapshot;
@@ -540,6 +562,188 @@ void idGameLocal::ReadGameStateFromSnapshot( const idBitMsgDelta &msg ) {
 	mpGame.ReadFromSnapshot( msg );
 }
 
+/*
+================
+idGameLocal::GetSnapshotCache
+
+Returns the snapshot state of the entity for this server frame, the entity writes it
+the first time it is in the PVS of a client.  Returns NULL if it isn't cached.
+================
+*/
+const entitySnapshotCache_t *idGameLocal::GetSnapshotCache( idEntity *ent ) {
+	idBitMsgDelta deltaMsg;
+
+	if ( !net_serverSnapshotCache.GetBool() ) {
+		return NULL;
+	}
+
+	// the recorded writes of the previous frames aren't used any more
+	if ( snapshotCacheWritesSerial != snapshotCacheSerial ) {
+		snapshotCacheWrites.SetNum( 0, false );
+		snapshotCacheWritesSerial = snapshotCacheSerial;
+	}
+
+	entitySnapshotCache_t *cache = snapshotCache[ ent->entityNumber ];
+	if ( !cache ) {
+		cache = snapshotCacheAllocator.Alloc();
+		snapshotCache[ ent->entityNumber ] = cache;
+	} else if ( cache->serial == snapshotCacheSerial && cache->spawnId == spawnIds[ ent->entityNumber ] ) {
+		return ( cache->numWrites >= 0 ) ? cache : NULL;
+	}
+
+	cache->serial = snapshotCacheSerial;
+	cache->spawnId = spawnIds[ ent->entityNumber ];
+	cache->firstWrite = snapshotCacheWrites.Num();
+	cache->state.Init( cache->stateBuf, sizeof( cache->stateBuf ) );
+	cache->state.BeginWriting();
+
+	snapshotCacheWrites.AssureSize( cache->firstWrite + MAX_SNAPSHOT_CACHE_WRITES );
+	deltaMsg.InitRecording( &cache->state, snapshotCacheWrites.Ptr() + cache->firstWrite, MAX_SNAPSHOT_CACHE_WRITES );
+
+	deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+	deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+	deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+
+	// write the class specific data to the state
+	ent->WriteToSnapshot( deltaMsg );
+
+	cache->numWrites = deltaMsg.GetNumRecordedWrites();
+	snapshotCacheWrites.SetNum( cache->firstWrite + Max( cache->numWrites, 0 ), false );
+
+	return ( cache->numWrites >= 0 ) ? cache : NULL;
+}
+
+// the current PVS handles are shared by the snapshots written at the same time
+static std::mutex snapshotPVSLock;
+
+/*
+================
+idGameLocal::GetSnapshotPriority
+
+Returns how much the snapshot priority of an entity grows for a client each time
+the entity changed.  Close entities in front of the view and players and
+projectiles grow faster than far away debris.
+================
+*/
+float idGameLocal::GetSnapshotPriority( idEntity *ent, const idVec3 &viewOrigin, const idVec3 &viewDir ) const {
+	idVec3 dir;
+	float dist, range, priority;
+
+	dir = ent->GetPhysics()->GetOrigin() - viewOrigin;
+	dist = dir.Length();
+
+	range = Max( net_serverSnapshotPriorityRange.GetFloat(), 1.0f );
+	priority = range / ( range + dist );
+
+	// twice as much in front of the view as behind it
+	if ( dist > 1.0f ) {
+		priority *= 1.5f + 0.5f * ( dir * viewDir ) / dist;
+	} else {
+		priority *= 2.0f;
+	}
+
+	if ( ent->IsType( idPlayer::GetClassType() ) ) {
+		priority *= 4.0f;
+	} else if ( ent->IsType( idProjectile::GetClassType() ) ) {
+		priority *= 2.0f;
+	} else if ( ent->IsType( idDebris::GetClassType() ) ) {
+		priority *= 0.25f;
+	}
+
+	return priority;
+}
+
+/*
+================
+SortSnapshotCandidatesByPriority
+================
+*/
+static int SortSnapshotCandidatesByPriority( const snapshotCandidate_t *a, const snapshotCandidate_t *b ) {
+	if ( a->priority > b->priority ) {
+		return -1;
+	}
+	if ( a->priority < b->priority ) {
+		return 1;
+	}
+	return a->spawnOrder - b->spawnOrder;
+}
+
+/*
+================
+SortSnapshotCandidatesBySpawnOrder
+================
+*/
+static int SortSnapshotCandidatesBySpawnOrder( const snapshotCandidate_t *a, const snapshotCandidate_t *b ) {
+	return a->spawnOrder - b->spawnOrder;
+}
+
+/*
+================
+idGameLocal::SelectSnapshotCandidates
+
+Selects the candidates with the highest priority that fit in maxBits, the ones
+the client can't wait for are always selected.  maxBits <= 0 selects all.
+================
+*/
+void idGameLocal::SelectSnapshotCandidates( int clientNum, int maxBits ) {
+	idList<snapshotCandidate_t> &candidates = snapshotCandidates[clientNum];
+	int i, numBits;
+
+	numBits = 0;
+	for ( i = 0; i < candidates.Num(); i++ ) {
+		numBits += candidates[i].numBits;
+	}
+
+	if ( maxBits <= 0 || numBits <= maxBits ) {
+		for ( i = 0; i < candidates.Num(); i++ ) {
+			candidates[i].selected = true;
+		}
+		return;
+	}
+
+	candidates.Sort( SortSnapshotCandidatesByPriority );
+	for ( i = 0; i < candidates.Num(); i++ ) {
+		if ( candidates[i].priority == idMath::INFINITY || candidates[i].numBits <= maxBits ) {
+			candidates[i].selected = true;
+			maxBits -= candidates[i].numBits;
+		}
+	}
+
+	// the entities are written in spawn order like the client thinks them
+	candidates.Sort( SortSnapshotCandidatesBySpawnOrder );
+}
+
+/*
+================
+idGameLocal::ServerPrepareSnapshots
+
+Updates everything the snapshots of this server frame would otherwise update on
+demand, after this ServerWriteSnapshot can run for several clients at the same time.
+Returns false if an entity has to write its state for every client, the snapshots
+have to be written one at a time then.
+================
+*/
+bool idGameLocal::ServerPrepareSnapshots( void ) {
+	idEntity *ent;
+	bool parallel = true;
+
+#if ASYNC_WRITE_TAGS
+	// the tags are taken from the shared random generator
+	parallel = false;
+#endif
+
+	for( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		// the PVS areas are updated lazily
+		ent->GetNumPVSAreas();
+
+		if ( ent->fl.networkSync && !GetSnapshotCache( ent ) ) {
+			parallel = false;
+		}
+	}
+
+	return parallel;
+}
+
 /*
 ================
 idGameLocal::ServerWriteSnapshot
@@ -548,13 +752,18 @@ idGameLocal::ServerWriteSnapshot
 ================
 */
 void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients ) {
-	int i, msgSize, msgWriteBit;
+	int i, msgSize, msgWriteBit, startBit, baseSpawnId, maxBytes, rateBytes, numBits;
 	idPlayer *player, *spectated = NULL;
 	idEntity *ent;
 	pvsHandle_t pvsHandle;
+	idBitMsg entityMsg;
+	byte entityBuf[MAX_SNAPSHOT_ENTITY_SIZE];
 	idBitMsgDelta deltaMsg;
 	snapshot_t *snapshot;
 	entityState_t *base, *newBase;
+	snapshotCandidate_t *candidate;
+	const entitySnapshotCache_t *cache;
+	idVec3 viewOrigin, viewDir;
 	int numSourceAreas, sourceAreas[ idEntity::MAX_PVS_AREAS ];
 
 	player = static_cast<idPlayer *>( entities[ clientNum ] );
@@ -571,7 +780,7 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 	FreeSnapshotsOlderThanSequence( clientNum, sequence - 64 );
 
 	// allocate new snapshot
-	snapshot = snapshotAllocator.Alloc();
+	snapshot = snapshotAllocators[clientNum].Alloc();
 	snapshot->sequence = sequence;
 	snapshot->firstEntityState = NULL;
 	snapshot->next = clientSnapshots[clientNum];
@@ -581,6 +790,7 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 	// get PVS for this player
 	// don't use PVSAreas for networking - PVSAreas depends on animations (and md5 bounds), which are not synchronized
 	numSourceAreas = gameRenderWorld->BoundsInAreas( spectated->GetPlayerPhysics()->GetAbsBounds(), sourceAreas, idEntity::MAX_PVS_AREAS );
+	snapshotPVSLock.lock();
 	pvsHandle = gameLocal.pvs.SetupCurrentPVS( sourceAreas, numSourceAreas, PVS_NORMAL );
 
 #ifdef _D3XP
@@ -596,6 +806,7 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 		pvsHandle = newPVS;
 	}
 #endif
+	snapshotPVSLock.unlock();
 
 #if ASYNC_WRITE_TAGS
 	idRandom tagRandom;
@@ -603,6 +814,17 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 	msg.WriteInt( tagRandom.GetSeed() );
 #endif
 
+	// the changed entities are written to the entity message first, the snapshot
+	// takes the ones with the highest priority that fit in the byte budget
+	entityMsg.Init( entityBuf, Min( (int)sizeof( entityBuf ), msg.GetRemainingSpace() ) );
+	entityMsg.BeginWriting();
+
+	idList<snapshotCandidate_t> &candidates = snapshotCandidates[clientNum];
+	candidates.SetNum( 0, false );
+
+	viewOrigin = spectated->GetEyePosition();
+	viewDir = spectated->viewAngles.ToForward();
+
 	// create the snapshot
 	for( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
 
@@ -620,40 +842,98 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 		}
 
 		// save the write state to which we can revert when the entity didn't change at all
-		msg.SaveWriteState( msgSize, msgWriteBit );
+		entityMsg.SaveWriteState( msgSize, msgWriteBit );
+		startBit = entityMsg.GetNumBitsWritten();
 
 		// write the entity to the snapshot
-		msg.WriteBits( ent->entityNumber, GENTITYNUM_BITS );
+		entityMsg.WriteBits( ent->entityNumber, GENTITYNUM_BITS );
 
 		base = clientEntityStates[clientNum][ent->entityNumber];
+		baseSpawnId = -1;
 		if ( base ) {
 			base->state.BeginReading();
+			baseSpawnId = base->state.ReadBits( 32 - GENTITYNUM_BITS );
+			base->state.BeginReading();
 		}
-		newBase = entityStateAllocator.Alloc();
+		newBase = entityStateAllocators[clientNum].Alloc();
 		newBase->entityNumber = ent->entityNumber;
 		newBase->state.Init( newBase->stateBuf, sizeof( newBase->stateBuf ) );
 		newBase->state.BeginWriting();
 
-		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
+		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &entityMsg );
 
-		deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+		// delta compress the state the entity wrote once for all clients
+		cache = GetSnapshotCache( ent );
+		if ( cache ) {
+			deltaMsg.WriteRecorded( cache->state, snapshotCacheWrites.Ptr() + cache->firstWrite, cache->numWrites );
+		} else {
+			deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+			deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+			deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
 
-		// write the class specific data to the snapshot
-		ent->WriteToSnapshot( deltaMsg );
+			// write the class specific data to the snapshot
+			ent->WriteToSnapshot( deltaMsg );
+		}
 
 		if ( !deltaMsg.HasChanged() ) {
-			msg.RestoreWriteState( msgSize, msgWriteBit );
-			entityStateAllocator.Free( newBase );
+			entityMsg.RestoreWriteState( msgSize, msgWriteBit );
+			entityStateAllocators[clientNum].Free( newBase );
+			clientSnapshotPriority[clientNum][ent->entityNumber] = 0.0f;
+			continue;
+		}
+
+		clientSnapshotPriority[clientNum][ent->entityNumber] += GetSnapshotPriority( ent, viewOrigin, viewDir );
+
+		candidate = &candidates.Alloc();
+		candidate->newBase = newBase;
+		candidate->spawnOrder = candidates.Num() - 1;
+		candidate->startBit = startBit;
+		candidate->numBits = entityMsg.GetNumBitsWritten() - startBit;
+		candidate->selected = false;
+
+		// the client would show the entity it has in this slot until the new one is sent,
+		// and drops the events of an entity it has never received
+		if ( ent->entityNumber == clientNum || ent == spectated || !base || baseSpawnId != ( spawnIds[ ent->entityNumber ] & ( ( 1 << ( 32 - GENTITYNUM_BITS ) ) - 1 ) ) ) {
+			candidate->priority = idMath::INFINITY;
 		} else {
-			newBase->next = snapshot->firstEntityState;
-			snapshot->firstEntityState = newBase;
+			candidate->priority = clientSnapshotPriority[clientNum][ent->entityNumber];
+		}
+	}
+
+	// the byte budget keeps the snapshots within the rate of the client
+	maxBytes = net_serverSnapshotBytes.GetInteger();
+	if ( maxBytes > 0 ) {
+		rateBytes = cvarSystem->GetCVarInteger( "net_serverMaxClientRate" ) * cvarSystem->GetCVarInteger( "net_serverSnapshotDelay" ) / 1000;
+		if ( rateBytes > 0 ) {
+			maxBytes = Min( maxBytes, rateBytes );
+		}
+	}
+	SelectSnapshotCandidates( clientNum, maxBytes << 3 );
+
+	// copy the selected entities to the snapshot, the others keep their priority and
+	// the client keeps their baseline state until a later snapshot includes them
+	for ( i = 0; i < candidates.Num(); i++ ) {
+		candidate = &candidates[i];
+		newBase = candidate->newBase;
+
+		if ( !candidate->selected ) {
+			entityStateAllocators[clientNum].Free( newBase );
+			continue;
+		}
+
+		entityMsg.RestoreReadState( ( candidate->startBit + 7 ) >> 3, candidate->startBit & 7 );
+		for ( numBits = candidate->numBits; numBits > 0; numBits -= 32 ) {
+			msg.WriteBits( entityMsg.ReadBits( Min( numBits, 32 ) ), Min( numBits, 32 ) );
+		}
+
+		clientSnapshotPriority[clientNum][newBase->entityNumber] = 0.0f;
+
+		newBase->next = snapshot->firstEntityState;
+		snapshot->firstEntityState = newBase;
 
 #if ASYNC_WRITE_TAGS
-			msg.WriteInt( tagRandom.RandomInt() );
+		msg.WriteInt( tagRandom.RandomInt() );
 #endif
-		}
 	}
 
 	msg.WriteBits( ENTITYNUM_NONE, GENTITYNUM_BITS );
@@ -674,14 +954,16 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 	}
 
 	// free the PVS
+	snapshotPVSLock.lock();
 	pvs.FreeCurrentPVS( pvsHandle );
+	snapshotPVSLock.unlock();
 
 	// write the game and player state to the snapshot
 	base = clientEntityStates[clientNum][ENTITYNUM_NONE];	// ENTITYNUM_NONE is used for the game and player state
 	if ( base ) {
 		base->state.BeginReading();
 	}
-	newBase = entityStateAllocator.Alloc();
+	newBase = entityStateAllocators[clientNum].Alloc();
 	newBase->entityNumber = ENTITYNUM_NONE;
 	newBase->next = snapshot->firstEntityState;
 	snapshot->firstEntityState = newBase;
@@ -799,6 +1081,8 @@ idGameLocal::ServerProcessReliableMessage
 void idGameLocal::ServerProcessReliableMessage( int clientNum, const idBitMsg &msg ) {
 	int id;
 
+	snapshotCacheSerial++;
+
 	id = msg.ReadByte();
 	switch( id ) {
 		case GAME_RELIABLE_MESSAGE_CHAT:
@@ -1011,7 +1295,7 @@ void idGameLocal::ClientReadSnapshot( int clientNum, int sequence, const int gam
 	snapshotEntities.Clear();
 
 	// allocate new snapshot
-	snapshot = snapshotAllocator.Alloc();
+	snapshot = snapshotAllocators[clientNum].Alloc();
 	snapshot->sequence = sequence;
 	snapshot->firstEntityState = NULL;
 	snapshot->next = clientSnapshots[clientNum];
@@ -1029,7 +1313,7 @@ void idGameLocal::ClientReadSnapshot( int clientNum, int sequence, const int gam
 		if ( base ) {
 			base->state.BeginReading();
 		}
-		newBase = entityStateAllocator.Alloc();
+		newBase = entityStateAllocators[clientNum].Alloc();
 		newBase->entityNumber = i;
 		newBase->next = snapshot->firstEntityState;
 		snapshot->firstEntityState = newBase;
@@ -1239,7 +1523,7 @@ void idGameLocal::ClientReadSnapshot( int clientNum, int sequence, const int gam
 	if ( base ) {
 		base->state.BeginReading();
 	}
-	newBase = entityStateAllocator.Alloc();
+	newBase = entityStateAllocators[clientNum].Alloc();
 	newBase->entityNumber = ENTITYNUM_NONE;
 	newBase->next = snapshot->firstEntityState;
 	snapshot->firstEntityState = newBase;
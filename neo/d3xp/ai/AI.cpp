@@ -1274,6 +1274,9 @@ void idAI::Think( void ) {
 				} else {
 					gameRenderWorld->DrawText(va("%d / %d", faces, calls), this->GetEyePosition() + aboveHead, 0.2500f, colorWhite, gameLocal.GetLocalPlayer()->viewAngles.ToMat3());
 				}
+				if (g_animLevelOfDetail.GetBool()) { // Animation update interval (ms) and the number of animators skipped last frame.
+					gameRenderWorld->DrawText(va("%d / %d", animator.GetLodInterval(), idAnimator::GetLodSkipped()), this->GetEyePosition() + aboveHead * 2.00f, 0.2500f, colorYellow, gameLocal.GetLocalPlayer()->viewAngles.ToMat3());
+				}
 			}
 		}
 	}
@@ -586,9 +586,18 @@ public:
 	int							AnimLength( int animnum ) const;
 	const idVec3				&TotalMovementDelta( int animnum ) const;
 
+	#if MD5_ENABLE_LODS > 0
+	int							GetLodInterval( void ) const { return lodInterval; }
+	static int					GetLodSkipped( void );
+	#endif
+
 private:
 	void						FreeData( void );
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						BlendFrame( int currentTime, const idJointQuat *defaultPose, int numJoints, idJointQuat *jointFrame, bool debugInfo ) const;
+	#if MD5_ENABLE_LODS > 0
+	int							LodInterval( int currentTime, bool &hold ) const;
+	#endif
 
 private:
 	const idDeclModelDef *		modelDef;
@@ -612,6 +621,15 @@ private:
 	idList<idJointQuat>			AFPoseJointFrame;
 	idBounds					AFPoseBounds;
 	int							AFPoseTime;
+
+	#if MD5_ENABLE_LODS > 0
+	int							lodInterval;			// update interval chosen by the last CreateFrame, 0 when updating every frame
+	int							lodFrameTime;			// time of the pose sampled into lodFrames[0]
+	int							lodNextTime;			// time of the pose sampled into lodFrames[numJoints], -1 when invalid
+	bool						lodHold;				// hold lodFrames[0] instead of interpolating towards the next pose
+	bool						lodHasAnim;
+	idJointQuat *				lodFrames;				// previous and next sampled poses
+	#endif
 };
 
 /*
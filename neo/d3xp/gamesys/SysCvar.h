@@ -56,6 +56,7 @@ extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
 extern idCVar	g_debugScript;
+extern idCVar	g_scriptCompiled;
 extern idCVar	g_debugMover;
 extern idCVar	g_debugTriggers;
 extern idCVar	g_debugCinematic;
@@ -101,6 +102,11 @@ extern idCVar	ai_showHealth;
 extern idCVar	ai_showLevelOfDetail;
 #endif
 
+#if MD5_ENABLE_LODS > 0
+extern idCVar	g_animLevelOfDetail;
+extern idCVar	g_animLevelOfDetailRange;
+#endif
+
 #if MD5_ENABLE_GIBS > 2 // DEBUG
 extern idCVar	ai_testDismemberment;
 #endif
@@ -38,6 +38,13 @@ typedef struct prstack_s {
 	int					stackbase;
 } prstack_t;
 
+// interpreter totals when a function was entered, for the inclusive script profile
+typedef struct profileFrame_s {
+	int64_t				instructions;
+	double				time;
+	int					session;
+} profileFrame_t;
+
 class idInterpreter {
 private:
 	prstack_t			callStack[ MAX_STACK_DEPTH ];
@@ -58,6 +65,15 @@ private:
 
 	idThread			*thread;
 
+	// script profiler
+	profileFrame_t		profileFrames[ MAX_STACK_DEPTH ];
+	int					profileSession;			// profiler session the totals belong to
+	bool				profiling;				// true while Execute runs with the profiler on
+	int					profileInstructions;	// instructions since the current function was entered or resumed
+	double				profileSegmentStart;
+	int64_t				profileTotalInstructions;
+	double				profileTotalTime;
+
 	void				PopParms( int numParms );
 	void				PushString( const char *string );
 	void				PushVector( const idVec3 &vector );
@@ -67,6 +83,8 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	varEval_t			GetCompiledVariable( const compiledOperand_t &operand );
+	varEval_t			GetCompiledAddress( const compiledStatement_t *cs );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
@@ -75,6 +93,12 @@ private:
 	void				CallEvent( const function_t *func, int argsize );
 	void				CallSysEvent( const function_t *func, int argsize );
 
+	void				ProfileSync( void );
+	void				ProfileSegment( void );
+
+	void				ExecuteStatement( const statement_t *st );
+	void				ExecuteCompiled( int runaway );
+
 public:
 	bool				doneProcessing;
 	bool				threadDying;
@@ -240,6 +264,21 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::GetCompiledVariable
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetCompiledVariable( const compiledOperand_t &operand ) {
+	if ( operand.onStack ) {
+		varEval_t val;
+		val.intPtr = ( int * )&localstack[ localstackBase + operand.value.stackOffset ];
+		return val;
+	} else {
+		return operand.value;
+	}
+}
+
 /*
 ================
 idInterpreter::GetEntity
@@ -271,6 +310,29 @@ ID_INLINE idScriptObject *idInterpreter::GetScriptObject( int entnum ) const {
 	return NULL;
 }
 
+/*
+====================
+idInterpreter::GetCompiledAddress
+
+Executes a compiled OP_ADDRESS and returns the address of the field, or NULL.
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetCompiledAddress( const compiledStatement_t *cs ) {
+	varEval_t		var_a;
+	varEval_t		var_c;
+	idScriptObject	*obj;
+
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	obj = GetScriptObject( *var_a.entityNumberPtr );
+	if ( obj ) {
+		var_c.evalPtr->bytePtr = &obj->data[ cs->b.value.ptrOffset ];
+	} else {
+		var_c.evalPtr->bytePtr = NULL;
+	}
+	return *var_c.evalPtr;
+}
+
 /*
 ====================
 idInterpreter::NextInstruction
@@ -444,6 +444,88 @@ typedef struct statement_s {
 
 /***********************************************************************
 
+compiledStatement_t
+
+Statements with their operands resolved ahead of time for the threaded
+interpreter.  There is exactly one compiled statement per statement, so
+instruction pointers, call stacks and savegames are shared with the
+classic interpreter.
+
+***********************************************************************/
+
+// handlers of the threaded interpreter.  everything without a handler of its
+// own runs through the classic interpreter as CS_GENERIC.
+typedef enum {
+	CS_GENERIC = 0,
+	CS_GOTO,
+	CS_IF,
+	CS_IFNOT,
+	CS_ADD_F,
+	CS_SUB_F,
+	CS_MUL_F,
+	CS_ADD_V,
+	CS_SUB_V,
+	CS_MUL_V,
+	CS_MUL_FV,
+	CS_MUL_VF,
+	CS_EQ_F,
+	CS_NE_F,
+	CS_LT,
+	CS_LE,
+	CS_GT,
+	CS_GE,
+	CS_EQ_E,
+	CS_NE_E,
+	CS_AND,
+	CS_OR,
+	CS_AND_BOOLBOOL,
+	CS_OR_BOOLBOOL,
+	CS_NOT_F,
+	CS_NOT_BOOL,
+	CS_NEG_F,
+	CS_UADD_F,
+	CS_USUB_F,
+	CS_UINC_F,
+	CS_UDEC_F,
+	CS_STORE_INT,					// 32 bit copies: floats, booleans, entities and objects
+	CS_STORE_V,
+	CS_ADDRESS,
+	CS_STOREP_INT,
+	CS_STOREP_V,
+	CS_INDIRECT_INT,
+	CS_INDIRECT_V,
+	CS_PUSH_INT,
+	CS_PUSH_V,
+
+	// superinstructions, which also execute the following statement
+	CS_EQ_F_IFNOT,
+	CS_NE_F_IFNOT,
+	CS_LT_IFNOT,
+	CS_LE_IFNOT,
+	CS_GT_IFNOT,
+	CS_GE_IFNOT,
+	CS_EQ_E_IFNOT,
+	CS_NE_E_IFNOT,
+	CS_ADDRESS_STOREP_INT,
+	CS_ADDRESS_STOREP_V,
+
+	NUM_COMPILED_HANDLERS
+} compiledHandler_t;
+
+typedef struct compiledOperand_s {
+	varEval_t		value;			// the variable's value, or its stack offset for locals
+	bool			onStack;
+} compiledOperand_t;
+
+typedef struct compiledStatement_s {
+	int					handler;
+	compiledOperand_t	a;
+	compiledOperand_t	b;
+	compiledOperand_t	c;
+} compiledStatement_t;
+
+/***********************************************************************
+
 idProgram
 
 Handles compiling and storage of script data.  Multiple idProgram objects
@@ -464,6 +546,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<compiledStatement_t>					compiledStatements;
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -478,6 +561,7 @@ private:
 	int											top_files;
 
 	void										CompileStats( void );
+	void										CompileStatements( void );
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
 
@@ -527,12 +611,14 @@ public:
 	function_t									&AllocFunction( idVarDef *def );
 	function_t									*GetFunction( int index );
 	int											GetFunctionIndex( const function_t *func );
+	int											NumFunctions( void ) { return functions.Num(); }
 
 	void										SetEntity( const char *name, idEntity *ent );
 
 	statement_t									*AllocStatement( void );
 	statement_t									&GetStatement( int index );
 	int											NumStatements( void ) { return statements.Num(); }
+	const compiledStatement_t					*GetCompiledStatements( void );
 
 	int											GetReturnedInteger( void );
 
@@ -545,6 +631,20 @@ public:
 	int											NumFilenames( void ) { return fileList.Num( ); }
 };
 
+/*
+================
+idProgram::GetCompiledStatements
+
+Statements compiled since the last call, such as map scripts, are compiled on demand.
+================
+*/
+ID_INLINE const compiledStatement_t *idProgram::GetCompiledStatements( void ) {
+	if ( compiledStatements.Num() != statements.Num() ) {
+		CompileStatements();
+	}
+	return compiledStatements.Ptr();
+}
+
 /*
 ================
 idProgram::GetStatement
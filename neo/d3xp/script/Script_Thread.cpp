@@ -678,7 +678,9 @@ bool idThread::Execute( void ) {
 
 	lastExecuteTime = gameLocal.time;
 	ClearWaitFor();
+	tickProfiler->BeginScope( gameLocal.profileScripts );
 	done = interpreter.Execute();
+	tickProfiler->EndScope( gameLocal.profileScripts );
 	if ( done ) {
 		End();
 		if ( interpreter.terminateOnExit ) {
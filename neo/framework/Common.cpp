@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 
 #include <SDL.h>
+#include <atomic>
 
 #include "ConsoleHistory.h"
 
@@ -80,6 +81,7 @@ idCVar com_asyncInput( "com_asyncInput", "0", CVAR_BOOL|CVAR_SYSTEM, "sample inp
 #define ASYNCSOUND_INFO "0: mix sound inline, 1 or 3: async update every 16ms 2: async update about every 100ms (original behavior)"
 idCVar com_asyncSound( "com_asyncSound", "1", CVAR_INTEGER|CVAR_SYSTEM, ASYNCSOUND_INFO, 0, 3 );
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "force generic platform independent SIMD" );
+idCVar com_numJobThreads( "com_numJobThreads", "0", CVAR_INTEGER | CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_NOCHEAT, "number of job threads, 0 = one per core minus the main thread", 0, MAX_JOB_THREADS );
 idCVar com_developer( "developer", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "developer mode" );
 idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "allow toggling console with the tilde key" );
 idCVar com_speeds( "com_speeds", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "show engine timings" );
@@ -218,6 +220,7 @@ private:
 	void						LoadGameDLLbyName( const char *dll, idStr& s );
 	void						UnloadGameDLL( void );
 	void						PrintLoadingMessage( const char *msg );
+	void						PrintThreadMessages( void );
 	void						FilterLangList( idStrList* list, idStr lang );
 
 	bool						com_fullyInitialized;
@@ -235,6 +238,10 @@ private:
 	idStrList					warningList;
 	idStrList					errorList;
 
+	idStrList					threadPrints;		// queued by the job threads, echoed by the main thread
+	idStrList					threadWarnings;
+	std::atomic<int>			numThreadPrints;
+
 	uintptr_t					gameDLL;
 
 	idLangDict					languageDict;
@@ -268,6 +275,8 @@ idCommonLocal::idCommonLocal( void ) {
 	rd_buffersize = 0;
 	rd_flush = NULL;
 
+	numThreadPrints = 0;
+
 	gameFrame = 0;
 	gameTimeResidual = 0;
 
@@ -384,6 +393,19 @@ void idCommonLocal::VPrintf( const char *fmt, va_list args ) {
 		Sys_Printf( "idCommon::VPrintf: truncated to %zd characters\n", strlen(msg)-1 );
 	}
 
+	// the console and the loading screen belong to the main thread, prints from
+	// the job threads are queued until the main thread prints or runs a frame
+	if ( !Sys_IsMainThread() ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+		threadPrints.Append( msg + timeLength );
+		numThreadPrints++;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+		return;
+	}
+	if ( numThreadPrints ) {
+		PrintThreadMessages();
+	}
+
 	if ( rd_buffer ) {
 		if ( (int)( strlen( msg ) + strlen( rd_buffer ) ) > ( rd_buffersize - 1 ) ) {
 			rd_flush( rd_buffer );
@@ -552,11 +574,44 @@ void idCommonLocal::Warning( const char *fmt, ... ) {
 
 	Printf( S_COLOR_YELLOW "[WARNING]: " S_COLOR_WHITE "%s\n", msg );
 
+	if ( !Sys_IsMainThread() ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+		threadWarnings.Append( msg );
+		numThreadPrints++;
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+		return;
+	}
+
 	if ( warningList.Num() < MAX_WARNING_LIST ) {
 		warningList.AddUnique( msg );
 	}
 }
 
+/*
+==================
+idCommonLocal::PrintThreadMessages
+
+Echoes the prints and warnings the job threads queued up, main thread only.
+==================
+*/
+void idCommonLocal::PrintThreadMessages( void ) {
+	idStrList	prints;
+	idStrList	warnings;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	prints.Swap( threadPrints );
+	warnings.Swap( threadWarnings );
+	numThreadPrints = 0;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+
+	for ( int i = 0; i < prints.Num(); i++ ) {
+		Printf( "%s", prints[i].c_str() );
+	}
+	for ( int i = 0; i < warnings.Num() && warningList.Num() < MAX_WARNING_LIST; i++ ) {
+		warningList.AddUnique( warnings[i] );
+	}
+}
+
 /*
 ==================
 idCommonLocal::PrintWarnings
@@ -665,6 +720,19 @@ void idCommonLocal::Error( const char *fmt, ... ) {
 
 	int code = ERP_DROP;
 
+	// other threads can't stop the session or shut down, the error is only thrown
+	// so the thread can catch it and raise it again on the main thread
+	if ( !Sys_IsMainThread() ) {
+		char threadError[MAX_PRINT_MSG_SIZE];
+
+		va_start( argptr, fmt );
+		idStr::vsnPrintf( threadError, sizeof( threadError ), fmt, argptr );
+		va_end( argptr );
+		threadError[sizeof( threadError ) - 1] = '\0';
+
+		throw idException( threadError );
+	}
+
 	// always turn this off after an error
 	com_refreshOnPrint = false;
 
@@ -1373,6 +1441,15 @@ static void Com_Freeze_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+=================
+Com_ListJobs_f
+=================
+*/
+static void Com_ListJobs_f( const idCmdArgs &args ) {
+	Sys_ListJobs();
+}
+
 /*
 =================
 Com_Crash_f
@@ -2384,6 +2461,7 @@ void idCommonLocal::InitCommands( void ) {
 	cmdSystem->AddCommand( "listDictKeys", idDict::ListKeys_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all keys used by dictionaries" );
 	cmdSystem->AddCommand( "listDictValues", idDict::ListValues_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all values used by dictionaries" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "listJobs", Com_ListJobs_f, CMD_FL_SYSTEM, "lists job threads and job list statistics" );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2451,6 +2529,11 @@ idCommonLocal::Frame
 void idCommonLocal::Frame( void ) {
 	try {
 
+		// echo what the job threads printed since the last frame
+		if ( numThreadPrints ) {
+			PrintThreadMessages();
+		}
+
 		// pump all the events
 		Sys_GenerateEvents();
 
@@ -2462,6 +2545,13 @@ void idCommonLocal::Frame( void ) {
 			InitSIMD();
 		}
 
+		// restart the job threads, no job list is running between frames
+		if ( com_numJobThreads.IsModified() ) {
+			Sys_ShutdownJobs();
+			Sys_InitJobs( com_numJobThreads.GetInteger() );
+			com_numJobThreads.ClearModified();
+		}
+
 		if ( com_enableDebuggerServer.IsModified() ) {
 			if ( com_enableDebuggerServer.GetBool() ) {
 				DebuggerServerInit();
@@ -2756,6 +2846,7 @@ void idCommonLocal::LoadGameDLL( void ) {
 	gameImport.declManager				= ::declManager;
 	gameImport.AASFileManager			= ::AASFileManager;
 	gameImport.collisionModelManager	= ::collisionModelManager;
+	gameImport.tickProfiler				= ::tickProfiler;
 
 	gameExport							= *GetGameAPI( &gameImport);
 
@@ -3075,6 +3166,10 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		// initialize processor specific SIMD implementation
 		InitSIMD();
 
+		// start the job threads
+		Sys_InitJobs( com_numJobThreads.GetInteger() );
+		com_numJobThreads.ClearModified();
+
 		// init commands
 		InitCommands();
 
@@ -3136,6 +3231,9 @@ void idCommonLocal::Shutdown( void ) {
 	// game specific shut down
 	ShutdownGame( false );
 
+	// stop the job threads
+	Sys_ShutdownJobs();
+
 	// shut down non-portable system services
 	Sys_Shutdown();
 
@@ -3250,6 +3348,9 @@ void idCommonLocal::InitGame( void ) {
 
 	PrintLoadingMessage( common->GetLanguageDict()->GetString( "#str_04347" ) );
 
+	// init the server tick profiler
+	tickProfiler->Init();
+
 	// init async network
 	idAsyncNetwork::Init();
 
@@ -3344,6 +3445,9 @@ void idCommonLocal::ShutdownGame( bool reloading ) {
 	// unload the game dll
 	UnloadGameDLL();
 
+	// shut down the server tick profiler
+	tickProfiler->Shutdown();
+
 	// dump warnings to "warnings.txt"
 #ifdef _DEBUG
 	DumpWarnings();
@@ -2486,6 +2486,309 @@ void idCompressor_LZW::DecompressBlock() {
 	blockSize = Min( writeByte, LZW_BLOCK_SIZE );
 }
 
+/*
+=================================================================================
+
+	idCompressor_RangeCoder
+
+	Adaptive binary range coder in the style of the LZMA entropy coder. Every
+	byte is coded as eight binary decisions down a bit tree. The probabilities
+	are selected by a small context taken from the previous byte and adapt
+	quickly so that short network messages already compress well. The first
+	output byte, which is always zero, is not written and the trailing zero
+	bytes are dropped because the decoder reads zeros past the end of the data.
+
+=================================================================================
+*/
+
+const int RC_TOP_VALUE		= 1 << 24;
+const int RC_PROB_BITS		= 11;
+const int RC_PROB_INIT		= 1 << ( RC_PROB_BITS - 1 );
+const int RC_MOVE_BITS		= 4;
+const int RC_NUM_CONTEXTS	= 4;
+
+class idCompressor_RangeCoder : public idCompressor_BitStream {
+public:
+					idCompressor_RangeCoder( void ) {}
+
+	void			Init( idFile *f, bool compress, int wordLength );
+	void			FinishCompress( void );
+
+	int				Write( const void *inData, int inLength );
+	int				Read( void *outData, int outLength );
+
+private:
+	unsigned short	probs[RC_NUM_CONTEXTS][256];
+	int				context;
+
+	uint64_t		low;
+	unsigned int	range;
+	unsigned int	code;
+	byte			cache;
+	int				cacheSize;
+	bool			firstByte;
+	bool			decoding;
+
+private:
+	void			PutByte( int b );
+	int				GetByte( void );
+	void			ShiftLow( void );
+	void			EncodeBit( unsigned short &prob, int bit );
+	int				DecodeBit( unsigned short &prob );
+	void			UpdateContext( int b );
+};
+
+/*
+================
+idCompressor_RangeCoder::Init
+================
+*/
+void idCompressor_RangeCoder::Init( idFile *f, bool compress, int wordLength ) {
+	int i, j;
+
+	idCompressor_BitStream::Init( f, compress, 8 );
+
+	for ( i = 0; i < RC_NUM_CONTEXTS; i++ ) {
+		for ( j = 0; j < 256; j++ ) {
+			probs[i][j] = RC_PROB_INIT;
+		}
+	}
+	context = 0;
+
+	low = 0;
+	range = 0xFFFFFFFF;
+	code = 0;
+	cache = 0;
+	cacheSize = 1;
+	firstByte = true;
+	decoding = false;
+}
+
+/*
+================
+idCompressor_RangeCoder::PutByte
+================
+*/
+ID_INLINE void idCompressor_RangeCoder::PutByte( int b ) {
+	if ( firstByte ) {
+		firstByte = false;
+		return;
+	}
+	if ( writeByte >= writeLength ) {
+		file->Write( buffer, writeByte );
+		writeByte = 0;
+	}
+	buffer[writeByte++] = b;
+	writeTotalBytes++;
+}
+
+/*
+================
+idCompressor_RangeCoder::GetByte
+================
+*/
+ID_INLINE int idCompressor_RangeCoder::GetByte( void ) {
+	if ( readByte >= readLength ) {
+		if ( readLength <= 0 ) {
+			return 0;
+		}
+		readLength = file->Read( buffer, sizeof( buffer ) );
+		readByte = 0;
+		if ( readLength <= 0 ) {
+			readLength = 0;
+			return 0;
+		}
+	}
+	readTotalBytes++;
+	return readData[readByte++];
+}
+
+/*
+================
+idCompressor_RangeCoder::ShiftLow
+================
+*/
+ID_INLINE void idCompressor_RangeCoder::ShiftLow( void ) {
+	if ( (unsigned int) low < 0xFF000000 || ( low >> 32 ) != 0 ) {
+		byte carry = (byte) ( low >> 32 );
+		byte b = cache;
+		do {
+			PutByte( (byte) ( b + carry ) );
+			b = 0xFF;
+		} while ( --cacheSize != 0 );
+		cache = (byte) ( (unsigned int) low >> 24 );
+	}
+	cacheSize++;
+	low = ( low & 0x00FFFFFF ) << 8;
+}
+
+/*
+================
+idCompressor_RangeCoder::EncodeBit
+================
+*/
+ID_INLINE void idCompressor_RangeCoder::EncodeBit( unsigned short &prob, int bit ) {
+	unsigned int bound = ( range >> RC_PROB_BITS ) * prob;
+	if ( !bit ) {
+		range = bound;
+		prob += ( ( 1 << RC_PROB_BITS ) - prob ) >> RC_MOVE_BITS;
+	} else {
+		low += bound;
+		range -= bound;
+		prob -= prob >> RC_MOVE_BITS;
+	}
+	while ( range < RC_TOP_VALUE ) {
+		range <<= 8;
+		ShiftLow();
+	}
+}
+
+/*
+================
+idCompressor_RangeCoder::DecodeBit
+================
+*/
+ID_INLINE int idCompressor_RangeCoder::DecodeBit( unsigned short &prob ) {
+	int bit;
+	unsigned int bound = ( range >> RC_PROB_BITS ) * prob;
+	if ( code < bound ) {
+		range = bound;
+		prob += ( ( 1 << RC_PROB_BITS ) - prob ) >> RC_MOVE_BITS;
+		bit = 0;
+	} else {
+		code -= bound;
+		range -= bound;
+		prob -= prob >> RC_MOVE_BITS;
+		bit = 1;
+	}
+	while ( range < RC_TOP_VALUE ) {
+		range <<= 8;
+		code = ( code << 8 ) | GetByte();
+	}
+	return bit;
+}
+
+/*
+================
+idCompressor_RangeCoder::UpdateContext
+
+  Network messages are mostly zeros, small values and sign extended negative values.
+================
+*/
+ID_INLINE void idCompressor_RangeCoder::UpdateContext( int b ) {
+	if ( b == 0 ) {
+		context = 0;
+	} else if ( b < 0x10 ) {
+		context = 1;
+	} else if ( b >= 0xF0 ) {
+		context = 2;
+	} else {
+		context = 3;
+	}
+}
+
+/*
+================
+idCompressor_RangeCoder::Write
+================
+*/
+int idCompressor_RangeCoder::Write( const void *inData, int inLength ) {
+	int i, j, c, node, bit;
+
+	if ( compress == false || inLength <= 0 ) {
+		return 0;
+	}
+
+	InitCompress( inData, inLength );
+
+	for ( i = 0; i < inLength; i++ ) {
+		c = readData[i];
+		node = 1;
+		for ( j = 7; j >= 0; j-- ) {
+			bit = ( c >> j ) & 1;
+			EncodeBit( probs[context][node], bit );
+			node = ( node << 1 ) | bit;
+		}
+		UpdateContext( c );
+	}
+	readTotalBytes += inLength;
+
+	return inLength;
+}
+
+/*
+================
+idCompressor_RangeCoder::FinishCompress
+================
+*/
+void idCompressor_RangeCoder::FinishCompress( void ) {
+	int i;
+
+	if ( compress == false ) {
+		return;
+	}
+
+	if ( !writeLength ) {
+		InitCompress( NULL, 0 );
+	}
+
+	// any value in [low, low + range) decodes the same, pick the one with the most trailing zeros
+	for ( i = 32; i > 0; i-- ) {
+		uint64_t mask = ( (uint64_t)1 << i ) - 1;
+		uint64_t value = ( low + mask ) & ~mask;
+		if ( value < low + range ) {
+			low = value;
+			break;
+		}
+	}
+
+	for ( i = 0; i < 5; i++ ) {
+		ShiftLow();
+	}
+
+	// the decoder reads zeros past the end of the data
+	while ( writeByte > 0 && buffer[writeByte - 1] == 0 ) {
+		writeByte--;
+		writeTotalBytes--;
+	}
+
+	idCompressor_BitStream::FinishCompress();
+}
+
+/*
+================
+idCompressor_RangeCoder::Read
+================
+*/
+int idCompressor_RangeCoder::Read( void *outData, int outLength ) {
+	int i, j, node;
+
+	if ( compress == true || outLength <= 0 ) {
+		return 0;
+	}
+
+	InitDecompress( outData, outLength );
+
+	if ( !decoding ) {
+		decoding = true;
+		for ( i = 0; i < 4; i++ ) {
+			code = ( code << 8 ) | GetByte();
+		}
+	}
+
+	for ( i = 0; i < outLength; i++ ) {
+		node = 1;
+		for ( j = 0; j < 8; j++ ) {
+			node = ( node << 1 ) | DecodeBit( probs[context][node] );
+		}
+		writeData[i] = node - 256;
+		UpdateContext( writeData[i] );
+	}
+	writeTotalBytes += outLength;
+
+	return outLength;
+}
+
 /*
 =================================================================================
 
@@ -2574,3 +2877,12 @@ idCompressor::AllocLZW
 idCompressor * idCompressor::AllocLZW( void ) {
 	return new idCompressor_LZW();
 }
+
+/*
+================
+idCompressor::AllocRangeCoder
+================
+*/
+idCompressor * idCompressor::AllocRangeCoder( void ) {
+	return new idCompressor_RangeCoder();
+}
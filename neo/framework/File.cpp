@@ -1280,6 +1280,7 @@ idFile_InZip::idFile_InZip( void ) {
 	name = "invalid";
 	zipFilePos = 0;
 	fileSize = 0;
+	crc = 0;
 	memset( &z, 0, sizeof( z ) );
 }
 
@@ -234,6 +234,8 @@ public:
 	virtual void			Flush( void );
 	virtual int				Seek( long offset, fsOrigin_t origin );
 
+	unsigned int			GetCRC( void ) const { return crc; }	// crc32 of the contents from the zip directory
+
 private:
 	idStr					name;			// name of the file in the pak
 	idStr					fullPath;		// full file path including pak file name
@@ -243,6 +245,7 @@ private:
 	unsigned long long int	zipFilePos;		// zip file info position in pak
 #endif
 	int						fileSize;		// size of the file
+	unsigned int			crc;			// crc32 of the uncompressed file
 	void *					z;				// unzip info
 };
 
@@ -2944,6 +2944,7 @@ idFile_InZip * idFileSystemLocal::ReadFileFromZip( pack_t *pak, fileInPack_t *pa
 	file->fullPath = pak->pakFilename + "/" + relativePath;
 	file->zipFilePos = pakFile->pos;
 	file->fileSize = file_info.uncompressed_size;
+	file->crc = file_info.crc;
 
 	return file;
 }
@@ -161,6 +161,9 @@ public:
 	// Writes initial reliable messages a client needs to recieve when first joining the game.
 	virtual void				ServerWriteInitialReliableMessages( int clientNum ) = 0;
 
+	// Prepares the snapshots of this server frame. If it returns true ServerWriteSnapshot may be called for several clients at the same time.
+	virtual bool				ServerPrepareSnapshots( void ) = 0;
+
 	// Writes a snapshot of the server game state for the given client.
 	virtual void				ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &msg, byte *clientInPVS, int numPVSClients ) = 0;
 
@@ -363,7 +366,7 @@ public:
 ===============================================================================
 */
 
-const int GAME_API_VERSION		= 9;
+const int GAME_API_VERSION		= 10;
 
 typedef struct {
 
@@ -381,6 +384,7 @@ typedef struct {
 	idDeclManager *				declManager;			// declaration manager
 	idAASFileManager *			AASFileManager;			// AAS file manager
 	idCollisionModelManager *	collisionModelManager;	// collision model manager
+	idTickProfiler *			tickProfiler;			// server tick profiler
 
 } gameImport_t;
 
@@ -77,6 +77,8 @@ Session_RescanSI_f
 */
 void Session_RescanSI_f( const idCmdArgs &args ) {
 	sessLocal.mapSpawnData.serverInfo = *cvarSystem->MoveCVarsToDict( CVAR_SERVERINFO );
+	// getInfo answers are built from the serverinfo
+	idAsyncNetwork::server.InvalidateInfoResponse();
 	if ( game && idAsyncNetwork::server.IsActive() ) {
 		game->SetServerInfo( sessLocal.mapSpawnData.serverInfo );
 	}
@@ -0,0 +1,497 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+idCVar com_tickProfile( "com_tickProfile", "1", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "profile the server frames, see tickProfile and tickProfileTrace" );
+
+const int MAX_TICK_SCOPES			= 32;
+const int TICK_HISTORY_MINUTES		= 15;
+const int TICK_MINUTE_MSEC			= 60 * 1000;
+const int TICK_BUCKET_STEPS			= 8;						// histogram buckets per power of two
+const int TICK_BUCKET_OCTAVES		= 23;						// microseconds up to 2^24, about 16 seconds
+const int TICK_NUM_BUCKETS			= TICK_BUCKET_STEPS * TICK_BUCKET_OCTAVES;
+const int MAX_TICK_EVENTS			= 65536;					// scope entries kept for the trace
+
+typedef struct tickScope_s {
+	const char *			name;
+	bool					idle;
+	int						depth;
+	double					startTime;
+	int						frameTime;							// microseconds in this scope during the current frame
+	int						frameCalls;
+} tickScope_t;
+
+typedef struct tickMinute_s {
+	int						startTime;							// Sys_Milliseconds at the start of the minute
+	int						numFrames;
+	int						calls[MAX_TICK_SCOPES];
+	int64_t					totalTime[MAX_TICK_SCOPES];
+	int						maxTime[MAX_TICK_SCOPES];
+	int						histogram[MAX_TICK_SCOPES][TICK_NUM_BUCKETS];
+} tickMinute_t;
+
+typedef struct tickEvent_s {
+	double					startTime;							// msec
+	int						duration;							// usec
+	short					scope;
+	short					depth;
+} tickEvent_t;
+
+class idTickProfilerLocal : public idTickProfiler {
+public:
+							idTickProfilerLocal( void );
+
+	virtual void			Init( void );
+	virtual void			Shutdown( void );
+	virtual int				RegisterScope( const char *name, bool idle = false );
+	virtual void			BeginScope( int scope );
+	virtual void			EndScope( int scope );
+	virtual void			BeginFrame( void );
+	virtual void			EndFrame( void );
+
+private:
+	tickScope_t				scopes[MAX_TICK_SCOPES];
+	int						numScopes;
+
+	bool					inFrame;
+	int						depth;
+
+	tickMinute_t *			minutes;							// TICK_HISTORY_MINUTES, newest at currentMinute
+	int						currentMinute;
+	int						numMinutes;
+
+	tickEvent_t *			events;								// MAX_TICK_EVENTS ring
+	int						numEvents;							// total, the ring keeps the last MAX_TICK_EVENTS
+
+	void					AddEvent( int scope, double startTime, int duration, int depth );
+	void					Clear( void );
+	void					PrintProfile( int numMinutes ) const;
+	bool					WriteTrace( const char *fileName ) const;
+
+	static int				TimeToBucket( int usec );
+	static int				BucketToTime( int bucket );
+	static int				Percentile( const int *histogram, int count, float fraction );
+
+	static void				TickProfile_f( const idCmdArgs &args );
+	static void				TickProfileClear_f( const idCmdArgs &args );
+	static void				TickProfileTrace_f( const idCmdArgs &args );
+};
+
+static idTickProfilerLocal	tickProfilerLocal;
+idTickProfiler *			tickProfiler = &tickProfilerLocal;
+
+/*
+================
+idTickProfilerLocal::idTickProfilerLocal
+================
+*/
+idTickProfilerLocal::idTickProfilerLocal( void ) {
+	memset( scopes, 0, sizeof( scopes ) );
+	numScopes = 0;
+	inFrame = false;
+	depth = 0;
+	minutes = NULL;
+	currentMinute = 0;
+	numMinutes = 0;
+	events = NULL;
+	numEvents = 0;
+}
+
+/*
+================
+idTickProfilerLocal::Init
+================
+*/
+void idTickProfilerLocal::Init( void ) {
+	minutes = (tickMinute_t *)Mem_ClearedAlloc( TICK_HISTORY_MINUTES * sizeof( minutes[0] ) );
+	events = (tickEvent_t *)Mem_Alloc( MAX_TICK_EVENTS * sizeof( events[0] ) );
+
+	// scope 0 is the whole frame
+	RegisterScope( "frame" );
+
+	Clear();
+
+	cmdSystem->AddCommand( "tickProfile", TickProfile_f, CMD_FL_SYSTEM, "prints the server frame time percentiles of the profiled scopes over the last minutes: tickProfile [minutes]" );
+	cmdSystem->AddCommand( "tickProfileClear", TickProfileClear_f, CMD_FL_SYSTEM, "clears the server frame profile" );
+	cmdSystem->AddCommand( "tickProfileTrace", TickProfileTrace_f, CMD_FL_SYSTEM, "writes the last profiled server frames as a Chrome trace: tickProfileTrace <file>" );
+}
+
+/*
+================
+idTickProfilerLocal::Shutdown
+================
+*/
+void idTickProfilerLocal::Shutdown( void ) {
+	cmdSystem->RemoveCommand( "tickProfile" );
+	cmdSystem->RemoveCommand( "tickProfileClear" );
+	cmdSystem->RemoveCommand( "tickProfileTrace" );
+
+	Mem_Free( minutes );
+	minutes = NULL;
+	Mem_Free( events );
+	events = NULL;
+	inFrame = false;
+}
+
+/*
+================
+idTickProfilerLocal::RegisterScope
+================
+*/
+int idTickProfilerLocal::RegisterScope( const char *name, bool idle ) {
+	int i;
+
+	for ( i = 0; i < numScopes; i++ ) {
+		if ( idStr::Icmp( scopes[i].name, name ) == 0 ) {
+			return i;
+		}
+	}
+	if ( numScopes >= MAX_TICK_SCOPES ) {
+		common->Warning( "idTickProfiler::RegisterScope: too many scopes, '%s' is not profiled", name );
+		return -1;
+	}
+
+	// the game can be reloaded so keep a copy of the name
+	tickScope_t &s = scopes[numScopes];
+	memset( &s, 0, sizeof( s ) );
+	s.name = Mem_CopyString( name );
+	s.idle = idle;
+	return numScopes++;
+}
+
+/*
+================
+idTickProfilerLocal::BeginScope
+================
+*/
+void idTickProfilerLocal::BeginScope( int scope ) {
+	if ( !inFrame || scope < 0 ) {
+		return;
+	}
+	tickScope_t &s = scopes[scope];
+	if ( s.depth++ == 0 ) {
+		s.startTime = Sys_MillisecondsPrecise();
+		depth++;
+	}
+}
+
+/*
+================
+idTickProfilerLocal::EndScope
+================
+*/
+void idTickProfilerLocal::EndScope( int scope ) {
+	if ( !inFrame || scope < 0 ) {
+		return;
+	}
+	tickScope_t &s = scopes[scope];
+	if ( s.depth == 0 || --s.depth > 0 ) {
+		return;
+	}
+	int usec = idMath::Ftoi( ( Sys_MillisecondsPrecise() - s.startTime ) * 1000.0 );
+	s.frameTime += usec;
+	s.frameCalls++;
+	depth--;
+	AddEvent( scope, s.startTime, usec, depth );
+}
+
+/*
+================
+idTickProfilerLocal::BeginFrame
+================
+*/
+void idTickProfilerLocal::BeginFrame( void ) {
+	if ( !com_tickProfile.GetBool() || !minutes ) {
+		inFrame = false;
+		return;
+	}
+	inFrame = true;
+	depth = 0;
+	BeginScope( 0 );
+}
+
+/*
+================
+idTickProfilerLocal::EndFrame
+================
+*/
+void idTickProfilerLocal::EndFrame( void ) {
+	int i, time, idleTime;
+
+	if ( !inFrame ) {
+		return;
+	}
+
+	// close any scope left open by an early return
+	for ( i = numScopes - 1; i >= 0; i-- ) {
+		if ( scopes[i].depth > 0 ) {
+			scopes[i].depth = 1;
+			EndScope( i );
+		}
+	}
+	inFrame = false;
+
+	time = Sys_Milliseconds();
+	if ( time - minutes[currentMinute].startTime >= TICK_MINUTE_MSEC ) {
+		currentMinute = ( currentMinute + 1 ) % TICK_HISTORY_MINUTES;
+		memset( &minutes[currentMinute], 0, sizeof( minutes[0] ) );
+		minutes[currentMinute].startTime = time;
+		numMinutes = Min( numMinutes + 1, TICK_HISTORY_MINUTES );
+	}
+
+	idleTime = 0;
+	for ( i = 1; i < numScopes; i++ ) {
+		if ( scopes[i].idle ) {
+			idleTime += scopes[i].frameTime;
+		}
+	}
+	scopes[0].frameTime = Max( scopes[0].frameTime - idleTime, 0 );
+
+	// every frame goes into every histogram, scopes that didn't run took no time
+	tickMinute_t &m = minutes[currentMinute];
+	m.numFrames++;
+	for ( i = 0; i < numScopes; i++ ) {
+		tickScope_t &s = scopes[i];
+		m.calls[i] += s.frameCalls;
+		m.totalTime[i] += s.frameTime;
+		m.maxTime[i] = Max( m.maxTime[i], s.frameTime );
+		m.histogram[i][TimeToBucket( s.frameTime )]++;
+		s.frameTime = 0;
+		s.frameCalls = 0;
+	}
+}
+
+/*
+================
+idTickProfilerLocal::AddEvent
+================
+*/
+void idTickProfilerLocal::AddEvent( int scope, double startTime, int duration, int depth ) {
+	tickEvent_t &e = events[numEvents & ( MAX_TICK_EVENTS - 1 )];
+	e.startTime = startTime;
+	e.duration = duration;
+	e.scope = scope;
+	e.depth = depth;
+	numEvents++;
+}
+
+/*
+================
+idTickProfilerLocal::Clear
+================
+*/
+void idTickProfilerLocal::Clear( void ) {
+	if ( !minutes ) {
+		return;
+	}
+	memset( minutes, 0, TICK_HISTORY_MINUTES * sizeof( minutes[0] ) );
+	currentMinute = 0;
+	numMinutes = 1;
+	minutes[0].startTime = Sys_Milliseconds();
+	numEvents = 0;
+}
+
+/*
+================
+idTickProfilerLocal::TimeToBucket
+
+  Buckets are exact below TICK_BUCKET_STEPS microseconds, above that
+  every power of two is split in TICK_BUCKET_STEPS buckets.
+================
+*/
+int idTickProfilerLocal::TimeToBucket( int usec ) {
+	int octave;
+
+	if ( usec < TICK_BUCKET_STEPS ) {
+		return Max( usec, 0 );
+	}
+	octave = idMath::ILog2( usec ) - 2;
+	if ( octave >= TICK_BUCKET_OCTAVES ) {
+		return TICK_NUM_BUCKETS - 1;
+	}
+	return octave * TICK_BUCKET_STEPS + ( ( usec >> ( octave - 1 ) ) & ( TICK_BUCKET_STEPS - 1 ) );
+}
+
+/*
+================
+idTickProfilerLocal::BucketToTime
+
+  Returns the middle of the bucket in microseconds.
+================
+*/
+int idTickProfilerLocal::BucketToTime( int bucket ) {
+	int octave, step;
+
+	if ( bucket < TICK_BUCKET_STEPS ) {
+		return bucket;
+	}
+	octave = bucket / TICK_BUCKET_STEPS;
+	step = bucket & ( TICK_BUCKET_STEPS - 1 );
+	return ( ( TICK_BUCKET_STEPS + step ) << ( octave - 1 ) ) + ( 1 << ( octave - 1 ) ) / 2;
+}
+
+/*
+================
+idTickProfilerLocal::Percentile
+================
+*/
+int idTickProfilerLocal::Percentile( const int *histogram, int count, float fraction ) {
+	int i, sum, target;
+
+	target = idMath::Ftoi( count * fraction );
+	for ( sum = 0, i = 0; i < TICK_NUM_BUCKETS; i++ ) {
+		sum += histogram[i];
+		if ( sum > target ) {
+			return BucketToTime( i );
+		}
+	}
+	return BucketToTime( TICK_NUM_BUCKETS - 1 );
+}
+
+/*
+================
+idTickProfilerLocal::PrintProfile
+================
+*/
+void idTickProfilerLocal::PrintProfile( int printMinutes ) const {
+	int				i, j, k, numFrames, calls, maxTime;
+	int64_t			totalTime;
+	static int		histogram[TICK_NUM_BUCKETS];
+
+	printMinutes = idMath::ClampInt( 1, numMinutes, printMinutes );
+
+	numFrames = 0;
+	for ( j = 0; j < printMinutes; j++ ) {
+		numFrames += minutes[( currentMinute - j + TICK_HISTORY_MINUTES ) % TICK_HISTORY_MINUTES].numFrames;
+	}
+	common->Printf( "%d frames in the last %d minute%s, times in msec\n", numFrames, printMinutes, printMinutes > 1 ? "s" : "" );
+	if ( !numFrames ) {
+		return;
+	}
+
+	common->Printf( "scope            calls/frame      avg      p50      p95      p99      max\n" );
+	for ( i = 0; i < numScopes; i++ ) {
+		calls = 0;
+		totalTime = 0;
+		maxTime = 0;
+		memset( histogram, 0, sizeof( histogram ) );
+		for ( j = 0; j < printMinutes; j++ ) {
+			const tickMinute_t &m = minutes[( currentMinute - j + TICK_HISTORY_MINUTES ) % TICK_HISTORY_MINUTES];
+			calls += m.calls[i];
+			totalTime += m.totalTime[i];
+			maxTime = Max( maxTime, m.maxTime[i] );
+			for ( k = 0; k < TICK_NUM_BUCKETS; k++ ) {
+				histogram[k] += m.histogram[i][k];
+			}
+		}
+		common->Printf( "%-16s %11.1f %8.3f %8.3f %8.3f %8.3f %8.3f\n", scopes[i].name, (float)calls / numFrames,
+						totalTime * 0.001f / numFrames,
+						Percentile( histogram, numFrames, 0.50f ) * 0.001f,
+						Percentile( histogram, numFrames, 0.95f ) * 0.001f,
+						Percentile( histogram, numFrames, 0.99f ) * 0.001f,
+						maxTime * 0.001f );
+	}
+}
+
+/*
+================
+idTickProfilerLocal::WriteTrace
+
+  Writes the Chrome trace event format, chrome://tracing and Perfetto load it.
+================
+*/
+bool idTickProfilerLocal::WriteTrace( const char *fileName ) const {
+	int			i, first;
+	idFile *	f;
+
+	f = fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		return false;
+	}
+
+	first = Max( numEvents - MAX_TICK_EVENTS, 0 );
+
+	f->Printf( "{\"traceEvents\":[\n" );
+	for ( i = first; i < numEvents; i++ ) {
+		const tickEvent_t &e = events[i & ( MAX_TICK_EVENTS - 1 )];
+		f->Printf( "{\"name\":\"%s\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.0f,\"dur\":%d}%s\n",
+					scopes[e.scope].name, e.startTime * 1000.0, e.duration, i < numEvents - 1 ? "," : "" );
+	}
+	f->Printf( "],\"displayTimeUnit\":\"ms\"}\n" );
+
+	fileSystem->CloseFile( f );
+	return true;
+}
+
+/*
+================
+idTickProfilerLocal::TickProfile_f
+================
+*/
+void idTickProfilerLocal::TickProfile_f( const idCmdArgs &args ) {
+	if ( !tickProfilerLocal.minutes ) {
+		return;
+	}
+	tickProfilerLocal.PrintProfile( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 1 );
+}
+
+/*
+================
+idTickProfilerLocal::TickProfileClear_f
+================
+*/
+void idTickProfilerLocal::TickProfileClear_f( const idCmdArgs &args ) {
+	tickProfilerLocal.Clear();
+}
+
+/*
+================
+idTickProfilerLocal::TickProfileTrace_f
+================
+*/
+void idTickProfilerLocal::TickProfileTrace_f( const idCmdArgs &args ) {
+	idStr fileName;
+
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: tickProfileTrace <file>\n" );
+		return;
+	}
+	if ( !tickProfilerLocal.events ) {
+		return;
+	}
+
+	fileName = args.Argv( 1 );
+	fileName.DefaultFileExtension( ".json" );
+	if ( !tickProfilerLocal.WriteTrace( fileName ) ) {
+		common->Printf( "couldn't write %s\n", fileName.c_str() );
+		return;
+	}
+	common->Printf( "wrote %d scope entries to %s\n", Min( tickProfilerLocal.numEvents, MAX_TICK_EVENTS ), fileName.c_str() );
+}
@@ -0,0 +1,81 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __TICKPROFILER_H__
+#define __TICKPROFILER_H__
+
+/*
+===============================================================================
+
+	Server tick profiler.
+
+	Named scopes are timed every server frame. The time spent in a scope
+	during a frame is added to a histogram for the current minute, the
+	tickProfile command prints the percentiles over the last minutes. The
+	most recent scope entries are kept for the tickProfileTrace command
+	which writes them as a Chrome trace.
+
+	Scopes nest and their times are inclusive. A scope entered again while
+	it is already open is only timed once. Scopes may only be used from
+	the main thread.
+
+===============================================================================
+*/
+
+class idTickProfiler {
+public:
+	virtual					~idTickProfiler( void ) {}
+
+	virtual void			Init( void ) = 0;
+	virtual void			Shutdown( void ) = 0;
+
+							// returns the handle of the scope with the given name, registers the scope if needed
+							// idle scopes don't count towards the frame time
+	virtual int				RegisterScope( const char *name, bool idle = false ) = 0;
+
+	virtual void			BeginScope( int scope ) = 0;
+	virtual void			EndScope( int scope ) = 0;
+
+							// a frame collects the scope times until it ends
+	virtual void			BeginFrame( void ) = 0;
+	virtual void			EndFrame( void ) = 0;
+};
+
+extern idTickProfiler *		tickProfiler;
+
+// times the lifetime of the object
+class idTickProfileScope {
+public:
+							idTickProfileScope( int scope ) { this->scope = scope; tickProfiler->BeginScope( scope ); }
+							~idTickProfileScope( void ) { tickProfiler->EndScope( scope ); }
+
+private:
+	int						scope;
+};
+
+#endif /* !__TICKPROFILER_H__ */
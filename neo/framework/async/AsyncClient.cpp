@@ -1129,6 +1129,11 @@ void idAsyncClient::ProcessConnectResponseMessage( const netadr_t from, const id
 	serverGameTime = msg.ReadInt();
 	msg.ReadDeltaDict( serverSI, NULL );
 
+	// servers that don't send the compression only know run length compression
+	if ( msg.GetRemaingData() > 0 ) {
+		channel.SetCompression( (netCompression_t)idMath::ClampInt( NET_COMPRESSION_RUNLENGTH, NET_COMPRESSION_MAX - 1, msg.ReadByte() ) );
+	}
+
 	InitGame( serverGameInitId, serverGameFrame, serverGameTime, serverSI );
 
 	// load map
@@ -1660,6 +1665,7 @@ void idAsyncClient::SetupConnection( void ) {
 		msg.WriteString( cvarSystem->GetCVarString( "password" ), -1, false );
 		// do not make the protocol depend on PB
 		msg.WriteShort( 0 );
+		msg.WriteByte( idAsyncNetwork::clientCompression.GetInteger() );
 		clientPort.SendPacket( serverAddress, msg.GetData(), msg.GetSize() );
 #if ID_ENFORCE_KEY_CLIENT
 		if ( idAsyncNetwork::LANServer.GetBool() ) {
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 
 #include "AsyncNetwork.h"
+#include "NetBots.h"
 
 idAsyncServer		idAsyncNetwork::server;
 idAsyncClient		idAsyncNetwork::client;
@@ -43,6 +44,7 @@ idCVar				idAsyncNetwork::serverDedicated( "net_serverDedicated", "1", CVAR_SERV
 idCVar				idAsyncNetwork::serverDedicated( "net_serverDedicated", "0", CVAR_SERVERINFO | CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "1 = text console dedicated server, 2 = graphical dedicated server", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 #endif
 idCVar				idAsyncNetwork::serverSnapshotDelay( "net_serverSnapshotDelay", "50", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "delay between snapshots in milliseconds" );
+idCVar				idAsyncNetwork::serverParallelSnapshots( "net_serverParallelSnapshots", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_NOCHEAT, "write the snapshots of all clients of a dedicated server at the same time on the job threads" );
 idCVar				idAsyncNetwork::serverMaxClientRate( "net_serverMaxClientRate", "16000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE | CVAR_NOCHEAT, "maximum rate to a client in bytes/sec" );
 idCVar				idAsyncNetwork::clientMaxRate( "net_clientMaxRate", "16000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE | CVAR_NOCHEAT, "maximum rate requested by client from server in bytes/sec" );
 idCVar				idAsyncNetwork::serverMaxUsercmdRelay( "net_serverMaxUsercmdRelay", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of usercmds from other clients the server relays to a client", 1, MAX_USERCMD_RELAY, idCmdSystem::ArgCompletion_Integer<1,MAX_USERCMD_RELAY> );
@@ -51,6 +53,11 @@ idCVar				idAsyncNetwork::serverClientTimeout( "net_serverClientTimeout", "40",
 idCVar				idAsyncNetwork::clientServerTimeout( "net_clientServerTimeout", "40", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "server time out in seconds" );
 idCVar				idAsyncNetwork::serverDrawClient( "net_serverDrawClient", "-1", CVAR_SYSTEM | CVAR_INTEGER, "number of client for which to draw view on server" );
 idCVar				idAsyncNetwork::serverRemoteConsolePassword( "net_serverRemoteConsolePassword", "", CVAR_SYSTEM | CVAR_NOCHEAT, "remote console password" );
+idCVar				idAsyncNetwork::serverInfoCacheTime( "net_serverInfoCacheTime", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "milliseconds the info response to server queries is reused for, 0 builds it for every query" );
+idCVar				idAsyncNetwork::serverOOBRate( "net_serverOOBRate", "10", CVAR_SYSTEM | CVAR_FLOAT | CVAR_NOCHEAT, "connectionless messages per second the server accepts from an address, 0 accepts all" );
+idCVar				idAsyncNetwork::serverCompression( "net_serverCompression", "1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "best message compression the server agrees to: 0 - run length, 1 - range coder", 0, NET_COMPRESSION_MAX - 1, idCmdSystem::ArgCompletion_Integer<0,NET_COMPRESSION_MAX - 1> );
+idCVar				idAsyncNetwork::clientCompression( "net_clientCompression", "1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "message compression the client asks the server for: 0 - run length, 1 - range coder", 0, NET_COMPRESSION_MAX - 1, idCmdSystem::ArgCompletion_Integer<0,NET_COMPRESSION_MAX - 1> );
+idCVar				idAsyncNetwork::serverOOBBurst( "net_serverOOBBurst", "20", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "connectionless messages the server accepts from an address at once" );
 idCVar				idAsyncNetwork::clientPrediction( "net_clientPrediction", "16", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "additional client side prediction in milliseconds" );
 idCVar				idAsyncNetwork::clientMaxPrediction( "net_clientMaxPrediction", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of milliseconds a client can predict ahead of server." );
 idCVar				idAsyncNetwork::clientUsercmdBackup( "net_clientUsercmdBackup", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "number of usercmds to resend" );
@@ -105,6 +112,10 @@ void idAsyncNetwork::Init( void ) {
 	cmdSystem->AddCommand( "kick", Kick_f, CMD_FL_SYSTEM, "kick a client by connection number" );
 	cmdSystem->AddCommand( "checkNewVersion", CheckNewVersion_f, CMD_FL_SYSTEM, "check if a new version of the game is available" );
 	cmdSystem->AddCommand( "updateUI", UpdateUI_f, CMD_FL_SYSTEM, "internal - cause a sync down of game-modified userinfo" );
+	cmdSystem->AddCommand( "netCompressRecord", NetCompressRecord_f, CMD_FL_SYSTEM, "records the uncompressed network messages to a file, without a file name stops recording" );
+	cmdSystem->AddCommand( "netCompressBench", NetCompressBench_f, CMD_FL_SYSTEM, "compresses recorded network messages with every compressor and reports ratio and speed" );
+
+	netBots.Init();
 }
 
 /*
@@ -153,12 +164,14 @@ idAsyncNetwork::Shutdown
 ==================
 */
 void idAsyncNetwork::Shutdown( void ) {
+	netBots.Shutdown();
 	client.serverList.Shutdown();
 	client.DisconnectFromServer();
 	client.ClearServers();
 	client.ClosePort();
 	server.Kill();
 	server.ClosePort();
+	idMsgChannel::StopRecording();
 }
 
 /*
@@ -173,7 +186,16 @@ void idAsyncNetwork::RunFrame( void ) {
 		usercmdGen->InhibitUsercmd( INHIBIT_ASYNC, false );
 	}
 	client.RunFrame();
+
+	double startTime = Sys_MillisecondsPrecise();
+	if ( server.IsActive() ) {
+		tickProfiler->BeginFrame();
+	}
 	server.RunFrame();
+	tickProfiler->EndFrame();
+	netBots.AddServerFrameTime( Sys_MillisecondsPrecise() - startTime );
+
+	netBots.RunFrame();
 }
 
 /*
@@ -487,6 +509,127 @@ void idAsyncNetwork::UpdateUI_f( const idCmdArgs &args ) {
 	server.UpdateUI( clientNum );
 }
 
+/*
+=================
+idAsyncNetwork::NetCompressRecord_f
+=================
+*/
+void idAsyncNetwork::NetCompressRecord_f( const idCmdArgs &args ) {
+	if ( args.Argc() < 2 ) {
+		idMsgChannel::StopRecording();
+		return;
+	}
+	idStr fileName = args.Argv( 1 );
+	fileName.DefaultFileExtension( ".netrec" );
+	idMsgChannel::StartRecording( fileName );
+}
+
+/*
+=================
+idAsyncNetwork::NetCompressBench_f
+=================
+*/
+void idAsyncNetwork::NetCompressBench_f( const idCmdArgs &args ) {
+	typedef struct {
+		const char *	name;
+		idCompressor *	compressor;
+		int				wordLength;
+	} benchCompressor_t;
+
+	benchCompressor_t compressors[] = {
+		{ "run length (net)",	idMsgChannel::AllocCompressor( NET_COMPRESSION_RUNLENGTH ),	3 },
+		{ "range coder (net)",	idMsgChannel::AllocCompressor( NET_COMPRESSION_RANGE ),		8 },
+		{ "huffman",			idCompressor::AllocHuffman(),								8 },
+		{ "arithmetic",			idCompressor::AllocArithmetic(),							8 },
+		{ "lzss",				idCompressor::AllocLZSS(),									8 },
+		{ "lzw",				idCompressor::AllocLZW(),									8 },
+	};
+	const int numCompressors = sizeof( compressors ) / sizeof( compressors[0] );
+
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: netCompressBench <file>\n" );
+		for ( int i = 0; i < numCompressors; i++ ) {
+			delete compressors[i].compressor;
+		}
+		return;
+	}
+
+	idStr fileName = args.Argv( 1 );
+	fileName.DefaultFileExtension( ".netrec" );
+
+	byte *data;
+	int length = fileSystem->ReadFile( fileName, (void **)&data );
+	if ( length <= 0 ) {
+		common->Printf( "couldn't read %s\n", fileName.c_str() );
+		for ( int i = 0; i < numCompressors; i++ ) {
+			delete compressors[i].compressor;
+		}
+		return;
+	}
+
+	common->Printf( "%-20s %12s %12s %8s %12s %12s\n", "compressor", "bytes in", "bytes out", "ratio", "encode ns/B", "decode ns/B" );
+
+	for ( int i = 0; i < numCompressors; i++ ) {
+		idCompressor *compressor = compressors[i].compressor;
+		int bytesIn = 0, bytesOut = 0, numMessages = 0, numErrors = 0;
+		double encodeTime = 0.0, decodeTime = 0.0, start;
+		byte compressedBuf[MAX_MESSAGE_SIZE * 2];
+		byte decompressedBuf[MAX_MESSAGE_SIZE];
+
+		for ( int offset = 0; offset + 4 <= length; ) {
+			int size = LittleInt( *(int *)( data + offset ) );
+			offset += 4;
+			if ( size < 0 || size > MAX_MESSAGE_SIZE || offset + size > length ) {
+				common->Warning( "%s is corrupt", fileName.c_str() );
+				break;
+			}
+
+			idBitMsg compressedMsg;
+			compressedMsg.Init( compressedBuf, sizeof( compressedBuf ) );
+
+			start = Sys_MillisecondsPrecise();
+			{
+				idFile_BitMsg file( compressedMsg );
+				compressor->Init( &file, true, compressors[i].wordLength );
+				compressor->Write( data + offset, size );
+				compressor->FinishCompress();
+			}
+			encodeTime += Sys_MillisecondsPrecise() - start;
+
+			// the const constructor opens the file for reading
+			const idBitMsg &readMsg = compressedMsg;
+			readMsg.BeginReading();
+
+			start = Sys_MillisecondsPrecise();
+			{
+				idFile_BitMsg file( readMsg );
+				compressor->Init( &file, false, compressors[i].wordLength );
+				compressor->Read( decompressedBuf, size );
+			}
+			decodeTime += Sys_MillisecondsPrecise() - start;
+
+			if ( memcmp( decompressedBuf, data + offset, size ) != 0 ) {
+				numErrors++;
+			}
+
+			bytesIn += size;
+			bytesOut += compressedMsg.GetSize();
+			numMessages++;
+			offset += size;
+		}
+
+		common->Printf( "%-20s %12d %12d %7.1f%% %12.1f %12.1f%s\n", compressors[i].name, bytesIn, bytesOut,
+						bytesIn ? bytesOut * 100.0f / bytesIn : 0.0f,
+						bytesIn ? encodeTime * 1000000.0 / bytesIn : 0.0,
+						bytesIn ? decodeTime * 1000000.0 / bytesIn : 0.0,
+						numErrors ? va( " (%d of %d messages differ)", numErrors, numMessages ) : "" );
+
+		delete compressor;
+	}
+
+	fileSystem->FreeFile( data );
+}
+
 /*
 ===============
 idAsyncNetwork::BuildInvalidKeyMsg
@@ -139,6 +139,7 @@ public:
 	static idCVar			allowCheats;					// allow cheats
 	static idCVar			serverDedicated;				// if set run a dedicated server
 	static idCVar			serverSnapshotDelay;			// number of milliseconds between snapshots
+	static idCVar			serverParallelSnapshots;		// write the snapshots of a dedicated server on the job threads
 	static idCVar			serverMaxClientRate;			// maximum outgoing rate to clients
 	static idCVar			clientMaxRate;					// maximum rate from server requested by client
 	static idCVar			serverMaxUsercmdRelay;			// maximum number of usercmds relayed to other clients
@@ -147,6 +148,11 @@ public:
 	static idCVar			clientServerTimeout;			// time out in seconds for server
 	static idCVar			serverDrawClient;				// the server draws the view of this client
 	static idCVar			serverRemoteConsolePassword;	// remote console password
+	static idCVar			serverInfoCacheTime;			// milliseconds the server keeps its cached info response
+	static idCVar			serverOOBRate;					// connectionless messages per second accepted from an address
+	static idCVar			serverOOBBurst;					// connectionless messages accepted from an address at once
+	static idCVar			serverCompression;				// best message compression the server agrees to
+	static idCVar			clientCompression;				// message compression the client asks for
 	static idCVar			clientPrediction;				// how many additional milliseconds the clients runs ahead
 	static idCVar			clientMaxPrediction;			// max milliseconds into the future a client can run prediction
 	static idCVar			clientUsercmdBackup;			// how many usercmds the client sends from previous frames
@@ -182,6 +188,8 @@ private:
 	static void				Kick_f( const idCmdArgs &args );
 	static void				CheckNewVersion_f( const idCmdArgs &args );
 	static void				UpdateUI_f( const idCmdArgs &args );
+	static void				NetCompressRecord_f( const idCmdArgs &args );
+	static void				NetCompressBench_f( const idCmdArgs &args );
 };
 
 #endif /* !__ASYNCNETWORK_H__ */
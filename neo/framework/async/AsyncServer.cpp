@@ -40,6 +40,15 @@ const int NOINPUT_IDLE_TIME				= 30000;
 
 const int HEARTBEAT_MSEC				= 5*60*1000;
 
+typedef struct snapshotJob_s {
+	idAsyncServer *		server;
+	int					clientNum;
+	idBitMsg			msg;
+	byte				msgBuf[MAX_MESSAGE_SIZE];
+} snapshotJob_t;
+
+static snapshotJob_t	snapshotJobs[MAX_ASYNC_CLIENTS];
+
 // must be kept in sync with authReplyMsg_t
 const char* authReplyMsg[] = {
 	//	"Waiting for authorization",
@@ -87,8 +96,24 @@ idAsyncServer::idAsyncServer( void ) {
 	serverReloadingEngine = false;
 	nextHeartbeatTime = 0;
 	nextAsyncStatsTime = 0;
+	portStatsTime = 0;
 	noRconOutput = true;
 	lastAuthTime = 0;
+	snapshotJobList = NULL;
+	profileNetWait = -1;
+	profileNetRead = -1;
+	profileGame = -1;
+	profileSnapshots = -1;
+	profileNetWrite = -1;
+
+	infoResponseSize = 0;
+	infoResponseTime = 0;
+	infoResponseClients = 0;
+	infoResponseValid = false;
+	memset( oobLimits, 0, sizeof( oobLimits ) );
+	numInfoRequests = 0;
+	numInfoBuilds = 0;
+	numOOBDropped = 0;
 
 	memset( stats_outrate, 0, sizeof( stats_outrate ) );
 	stats_current = 0;
@@ -191,6 +216,23 @@ void idAsyncServer::Spawn( void ) {
 
 	nextHeartbeatTime = 0;
 	nextAsyncStatsTime = 0;
+	portStatsTime = 0;
+
+	InvalidateInfoResponse();
+	memset( oobLimits, 0, sizeof( oobLimits ) );
+	numInfoRequests = 0;
+	numInfoBuilds = 0;
+	numOOBDropped = 0;
+
+	if ( !snapshotJobList ) {
+		snapshotJobList = Sys_AllocJobList( "snapshots" );
+	}
+
+	profileNetWait = tickProfiler->RegisterScope( "netWait", true );
+	profileNetRead = tickProfiler->RegisterScope( "netRead" );
+	profileGame = tickProfiler->RegisterScope( "game" );
+	profileSnapshots = tickProfiler->RegisterScope( "snapshots" );
+	profileNetWrite = tickProfiler->RegisterScope( "netWrite" );
 
 	ExecuteMapChange();
 }
@@ -231,6 +273,9 @@ void idAsyncServer::Kill( void ) {
 
 	active = false;
 
+	Sys_FreeJobList( snapshotJobList );
+	snapshotJobList = NULL;
+
 	// shutdown any current game
 	session->Stop();
 }
@@ -251,6 +296,8 @@ void idAsyncServer::ExecuteMapChange( void ) {
 
 	assert( active );
 
+	InvalidateInfoResponse();
+
 	// reset any pureness
 	fileSystem->ClearPureChecksums();
 
@@ -926,6 +973,8 @@ void idAsyncServer::SendUserInfoBroadcast( int userInfoNum, const idDict &info,
 	}
 
 	sessLocal.mapSpawnData.userInfo[userInfoNum] = *gameInfo;
+
+	InvalidateInfoResponse();
 }
 
 /*
@@ -1134,22 +1183,28 @@ void idAsyncServer::SendGameInitToClient( int clientNum ) {
 
 /*
 ==================
-idAsyncServer::SendSnapshotToClient
+idAsyncServer::IsSnapshotDue
 ==================
 */
-bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
+bool idAsyncServer::IsSnapshotDue( int clientNum ) const {
+	return ( serverTime - clients[clientNum].lastSnapshotTime >= idAsyncNetwork::serverSnapshotDelay.GetInteger() );
+}
+
+/*
+==================
+idAsyncServer::WriteSnapshotToClient
+
+  Only touches the state of the given client, snapshots of several clients
+  are written at the same time when the game allows it.
+==================
+*/
+void idAsyncServer::WriteSnapshotToClient( int clientNum, idBitMsg &msg ) {
 	int			i, j, index, numUsercmds;
-	idBitMsg	msg;
-	byte		msgBuf[MAX_MESSAGE_SIZE];
 	usercmd_t *	last;
 	byte		clientInPVS[MAX_ASYNC_CLIENTS >> 3];
 
 	serverClient_t &client = clients[clientNum];
 
-	if ( serverTime - client.lastSnapshotTime < idAsyncNetwork::serverSnapshotDelay.GetInteger() ) {
-		return false;
-	}
-
 	if ( idAsyncNetwork::verbose.GetInteger() == 2 ) {
 		common->Printf( "sending snapshot to client %d: gameInitId = %d, gameFrame = %d, gameTime = %d\n", clientNum, gameInitId, gameFrame, gameTime );
 	}
@@ -1158,7 +1213,6 @@ bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
 	client.clientAheadTime = client.gameTime - ( gameTime + gameTimeResidual );
 
 	// write the snapshot
-	msg.Init( msgBuf, sizeof( msgBuf ) );
 	msg.WriteInt( gameInitId );
 	msg.WriteByte( SERVER_UNRELIABLE_MESSAGE_SNAPSHOT );
 	msg.WriteInt( client.snapshotSequence );
@@ -1196,16 +1250,91 @@ bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
 		}
 	}
 	msg.WriteByte( MAX_ASYNC_CLIENTS );
+}
+
+/*
+==================
+idAsyncServer::FinishSnapshotToClient
+==================
+*/
+void idAsyncServer::FinishSnapshotToClient( int clientNum, const idBitMsg &msg ) {
+	serverClient_t &client = clients[clientNum];
 
 	client.channel.SendMessage( serverPort, serverTime, msg );
 
 	client.lastSnapshotTime = serverTime;
 	client.snapshotSequence++;
 	client.numDuplicatedUsercmds = 0;
+}
+
+/*
+==================
+idAsyncServer::SendSnapshotToClient
+==================
+*/
+bool idAsyncServer::SendSnapshotToClient( int clientNum ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	if ( !IsSnapshotDue( clientNum ) ) {
+		return false;
+	}
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	WriteSnapshotToClient( clientNum, msg );
+	FinishSnapshotToClient( clientNum, msg );
 
 	return true;
 }
 
+/*
+==================
+idAsyncServer::WriteSnapshotJob
+==================
+*/
+void idAsyncServer::WriteSnapshotJob( void *data ) {
+	snapshotJob_t *job = static_cast<snapshotJob_t *>( data );
+
+	job->server->WriteSnapshotToClient( job->clientNum, job->msg );
+}
+
+/*
+==================
+idAsyncServer::SendSnapshotsToClients
+
+  Writes the snapshots of all given clients on the job threads. The messages
+  are sent afterwards in client order on this thread, reliable messages the
+  game queues while writing the snapshots go out with the same messages no
+  matter in which order the jobs ran.
+==================
+*/
+void idAsyncServer::SendSnapshotsToClients( const int *clientNums, int numClients ) {
+	int i;
+
+	for ( i = 0; i < numClients; i++ ) {
+		snapshotJob_t &job = snapshotJobs[i];
+		job.server = this;
+		job.clientNum = clientNums[i];
+		job.msg.Init( job.msgBuf, sizeof( job.msgBuf ) );
+	}
+
+	if ( numClients > 1 && game->ServerPrepareSnapshots() ) {
+		for ( i = 0; i < numClients; i++ ) {
+			snapshotJobList->AddJob( WriteSnapshotJob, &snapshotJobs[i] );
+		}
+		snapshotJobList->Submit();
+		snapshotJobList->Wait();
+	} else {
+		for ( i = 0; i < numClients; i++ ) {
+			WriteSnapshotJob( &snapshotJobs[i] );
+		}
+	}
+
+	for ( i = 0; i < numClients; i++ ) {
+		FinishSnapshotToClient( snapshotJobs[i].clientNum, snapshotJobs[i].msg );
+	}
+}
+
 /*
 ==================
 idAsyncServer::ProcessUnreliableClientMessage
@@ -1667,7 +1796,7 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 	byte		msgBuf[ MAX_MESSAGE_SIZE ];
 	char		guid[ 12 ];
 	char		password[ 17 ];
-	int			i, ichallenge, islot, numClients;
+	int			i, ichallenge, islot, numClients, compression;
 
 	protocol = msg.ReadInt();
 
@@ -1765,6 +1894,15 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 	// if authState == CDK_PUREOK, the check was already performed once before entering pure checks
 	// but meanwhile, the max players may have been reached
 	msg.ReadString( password, sizeof( password ) );
+	msg.ReadShort();	// PB
+
+	// clients that don't send the compression they want only know run length compression
+	compression = NET_COMPRESSION_RUNLENGTH;
+	if ( msg.GetRemaingData() > 0 ) {
+		compression = idMath::ClampInt( NET_COMPRESSION_RUNLENGTH, NET_COMPRESSION_MAX - 1, msg.ReadByte() );
+		compression = Min( compression, idAsyncNetwork::serverCompression.GetInteger() );
+	}
+
 	char reason[MAX_STRING_CHARS];
 	allowReply_t reply = game->ServerAllowClient( numClients, Sys_NetAdrToString( from ), guid, password, reason );
 	if ( reply != ALLOW_YES ) {
@@ -1830,6 +1968,7 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 		if ( clientNum < MAX_ASYNC_CLIENTS ) {
 			// initialize
 			clients[ clientNum ].channel.Init( from, serverId );
+			clients[ clientNum ].channel.SetCompression( (netCompression_t)compression );
 			strncpy( clients[ clientNum ].guid, guid, 12 );
 			clients[ clientNum ].guid[11] = 0;
 			break;
@@ -1853,6 +1992,7 @@ void idAsyncServer::ProcessConnectMessage( const netadr_t from, const idBitMsg &
 	outMsg.WriteInt( gameFrame );
 	outMsg.WriteInt( gameTime );
 	outMsg.WriteDeltaDict( sessLocal.mapSpawnData.serverInfo, NULL );
+	outMsg.WriteByte( compression );
 
 	serverPort.SendPacket( from, outMsg.GetData(), outMsg.GetSize() );
 
@@ -2033,26 +2173,16 @@ void idAsyncServer::ProcessRemoteConsoleMessage( const netadr_t from, const idBi
 
 /*
 ==================
-idAsyncServer::ProcessGetInfoMessage
+idAsyncServer::BuildInfoResponse
+
+Writes the part of the "infoResponse" that is the same for every query.
 ==================
 */
-void idAsyncServer::ProcessGetInfoMessage( const netadr_t from, const idBitMsg &msg ) {
-	int			i, challenge;
+void idAsyncServer::BuildInfoResponse( unsigned int clientMask ) {
+	int			i;
 	idBitMsg	outMsg;
-	byte		msgBuf[MAX_MESSAGE_SIZE];
 
-	if ( !IsActive() ) {
-		return;
-	}
-
-	common->DPrintf( "Sending info response to %s\n", Sys_NetAdrToString( from ) );
-
-	challenge = msg.ReadInt();
-
-	outMsg.Init( msgBuf, sizeof( msgBuf ) );
-	outMsg.WriteShort( CONNECTIONLESS_MESSAGE_ID );
-	outMsg.WriteString( "infoResponse" );
-	outMsg.WriteInt( challenge );
+	outMsg.Init( infoResponseBuf, sizeof( infoResponseBuf ) );
 	outMsg.WriteInt( ASYNC_PROTOCOL_VERSION );
 	outMsg.WriteDeltaDict( sessLocal.mapSpawnData.serverInfo, NULL );
 
@@ -2074,6 +2204,52 @@ void idAsyncServer::ProcessGetInfoMessage( const netadr_t from, const idBitMsg &
 	//          Sending -1 (instead of nothing at all) restores compatibility with id's masterserver.
 	outMsg.WriteInt( -1 );
 
+	infoResponseSize = outMsg.GetSize();
+	infoResponseTime = Sys_Milliseconds();
+	infoResponseClients = clientMask;
+	infoResponseValid = true;
+	numInfoBuilds++;
+}
+
+/*
+==================
+idAsyncServer::ProcessGetInfoMessage
+==================
+*/
+void idAsyncServer::ProcessGetInfoMessage( const netadr_t from, const idBitMsg &msg ) {
+	int				i, challenge;
+	unsigned int	clientMask;
+	idBitMsg		outMsg;
+	byte			msgBuf[MAX_MESSAGE_SIZE];
+
+	if ( !IsActive() ) {
+		return;
+	}
+
+	common->DPrintf( "Sending info response to %s\n", Sys_NetAdrToString( from ) );
+
+	challenge = msg.ReadInt();
+
+	numInfoRequests++;
+
+	// rebuild the response when a client connected or disconnected, pings and rates are refreshed after net_serverInfoCacheTime
+	clientMask = 0;
+	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
+		if ( clients[i].clientState >= SCS_CONNECTED ) {
+			clientMask |= 1u << i;
+		}
+	}
+	if ( !infoResponseValid || clientMask != infoResponseClients ||
+			Sys_Milliseconds() - infoResponseTime >= idAsyncNetwork::serverInfoCacheTime.GetInteger() ) {
+		BuildInfoResponse( clientMask );
+	}
+
+	outMsg.Init( msgBuf, sizeof( msgBuf ) );
+	outMsg.WriteShort( CONNECTIONLESS_MESSAGE_ID );
+	outMsg.WriteString( "infoResponse" );
+	outMsg.WriteInt( challenge );
+	outMsg.WriteData( infoResponseBuf, infoResponseSize );
+
 	serverPort.SendPacket( from, outMsg.GetData(), outMsg.GetSize() );
 }
 
@@ -2101,6 +2277,69 @@ void idAsyncServer::PrintLocalServerInfo( void ) {
 						sessLocal.mapSpawnData.userInfo[i].GetString( "ui_name", "Player" ),
 						client.clientPing, client.channel.GetMaxOutgoingRate() );
 	}
+	common->Printf( "%d info requests, %d info response rebuilds, %d connectionless messages dropped\n",
+					numInfoRequests, numInfoBuilds, numOOBDropped );
+}
+
+/*
+==================
+idAsyncServer::AllowConnectionlessMessage
+
+Token bucket per address, refilled with net_serverOOBRate tokens per second up to net_serverOOBBurst.
+==================
+*/
+bool idAsyncServer::AllowConnectionlessMessage( const netadr_t from ) {
+	int				i, index, oldest, time;
+	unsigned int	hash;
+	float			rate, burst;
+
+	rate = idAsyncNetwork::serverOOBRate.GetFloat();
+	if ( rate <= 0.0f || from.type != NA_IP ) {
+		return true;
+	}
+
+	// never limit the auth server
+	if ( Sys_CompareNetAdrBase( from, idAsyncNetwork::GetMasterAddress() ) ) {
+		return true;
+	}
+
+	burst = Max( idAsyncNetwork::serverOOBBurst.GetInteger(), 1 );
+	time = Sys_Milliseconds();
+
+	hash = ( ( (unsigned int)from.ip[0] << 24 ) | ( (unsigned int)from.ip[1] << 16 ) | ( (unsigned int)from.ip[2] << 8 ) | (unsigned int)from.ip[3] ) * 2654435761u;
+	hash >>= 22;	// 32 - log2( MAX_OOB_LIMITS )
+
+	index = -1;
+	oldest = -1;
+	for ( i = 0; i < OOB_LIMIT_PROBES; i++ ) {
+		int j = ( hash + i ) & ( MAX_OOB_LIMITS - 1 );
+		if ( oobLimits[j].address.type == NA_IP && Sys_CompareNetAdrBase( oobLimits[j].address, from ) ) {
+			index = j;
+			break;
+		}
+		if ( oldest == -1 || oobLimits[j].lastTime < oobLimits[oldest].lastTime ) {
+			oldest = j;
+		}
+	}
+
+	if ( index == -1 ) {
+		// a new address replaces the least recently heard from
+		index = oldest;
+		oobLimits[index].address = from;
+		oobLimits[index].lastTime = time;
+		oobLimits[index].tokens = burst;
+	}
+
+	oobLimit_t &limit = oobLimits[index];
+	limit.tokens = Min( limit.tokens + ( time - limit.lastTime ) * rate * 0.001f, burst );
+	limit.lastTime = time;
+
+	if ( limit.tokens < 1.0f ) {
+		numOOBDropped++;
+		return false;
+	}
+	limit.tokens -= 1.0f;
+	return true;
 }
 
 /*
@@ -2111,6 +2350,10 @@ idAsyncServer::ConnectionlessMessage
 bool idAsyncServer::ConnectionlessMessage( const netadr_t from, const idBitMsg &msg ) {
 	char		string[MAX_STRING_CHARS*2];  // M. Quinn - Even Balance - PB Packets need more than 1024
 
+	if ( !AllowConnectionlessMessage( from ) ) {
+		return false;
+	}
+
 	msg.ReadString( string, sizeof( string ) );
 
 	// info request
@@ -2357,6 +2600,8 @@ void idAsyncServer::RunFrame( void ) {
 	netadr_t	from;
 	int			outgoingRate, incomingRate;
 	float		outgoingCompression, incomingCompression;
+	bool		parallelSnapshots;
+	int			snapshotClients[MAX_ASYNC_CLIENTS], numSnapshotClients;
 
 	msec = UpdateTime( 100 );
 
@@ -2377,14 +2622,18 @@ void idAsyncServer::RunFrame( void ) {
 		do {
 
 			// blocking read with game time residual timeout
+			tickProfiler->BeginScope( profileNetWait );
 			newPacket = serverPort.GetPacketBlocking( from, msgBuf, size, sizeof( msgBuf ), USERCMD_MSEC - gameTimeResidual - 1 );
+			tickProfiler->EndScope( profileNetWait );
 			if ( newPacket ) {
 				msg.Init( msgBuf, sizeof( msgBuf ) );
 				msg.SetSize( size );
 				msg.BeginReading();
+				tickProfiler->BeginScope( profileNetRead );
 				if ( ProcessMessage( from, msg ) ) {
 					return;	// return because rcon was used
 				}
+				tickProfiler->EndScope( profileNetRead );
 			}
 
 			msec = UpdateTime( 100 );
@@ -2404,6 +2653,7 @@ void idAsyncServer::RunFrame( void ) {
 		idAsyncNetwork::idleServer.SetBool( !idAsyncNetwork::idleServer.GetBool() );
 		// the need to propagate right away, only this
 		sessLocal.mapSpawnData.serverInfo.Set( "si_idleServer", idAsyncNetwork::idleServer.GetString() );
+		InvalidateInfoResponse();
 		game->SetServerInfo( sessLocal.mapSpawnData.serverInfo );
 	}
 
@@ -2442,7 +2692,9 @@ void idAsyncServer::RunFrame( void ) {
 		DuplicateUsercmds( gameFrame, gameTime );
 
 		// advance game
+		tickProfiler->BeginScope( profileGame );
 		gameReturn_t ret = game->RunFrame( userCmds[gameFrame & ( MAX_USERCMD_BACKUP - 1 ) ] );
+		tickProfiler->EndScope( profileGame );
 
 		idAsyncNetwork::ExecuteSessionCommand( ret.sessionCommand );
 
@@ -2455,6 +2707,15 @@ void idAsyncServer::RunFrame( void ) {
 	// duplicate usercmds so there is always at least one available to send with snapshots
 	DuplicateUsercmds( gameFrame, gameTime );
 
+	// a dedicated server collects the clients that get a snapshot and writes them all at once
+	parallelSnapshots = idAsyncNetwork::serverDedicated.GetBool() && idAsyncNetwork::serverParallelSnapshots.GetBool() && Sys_NumJobThreads() > 0;
+	numSnapshotClients = 0;
+
+	tickProfiler->BeginScope( profileSnapshots );
+
+	// queue the outgoing packets so they leave with as few system calls as possible
+	serverPort.BeginSendBatch();
+
 	// send snapshots to connected clients
 	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
 		serverClient_t &client = clients[i];
@@ -2480,7 +2741,9 @@ void idAsyncServer::RunFrame( void ) {
 		}
 
 		if ( client.clientState == SCS_INGAME ) {
-			if ( !SendSnapshotToClient( i ) ) {
+			if ( parallelSnapshots && IsSnapshotDue( i ) ) {
+				snapshotClients[numSnapshotClients++] = i;
+			} else if ( !SendSnapshotToClient( i ) ) {
 				SendPingToClient( i );
 			}
 		} else {
@@ -2488,6 +2751,16 @@ void idAsyncServer::RunFrame( void ) {
 		}
 	}
 
+	if ( numSnapshotClients ) {
+		SendSnapshotsToClients( snapshotClients, numSnapshotClients );
+	}
+
+	tickProfiler->EndScope( profileSnapshots );
+
+	tickProfiler->BeginScope( profileNetWrite );
+	serverPort.FlushSendBatch();
+	tickProfiler->EndScope( profileNetWrite );
+
 	if ( com_showAsyncStats.GetBool() ) {
 
 		UpdateAsyncStatsAvg();
@@ -2514,6 +2787,13 @@ void idAsyncServer::RunFrame( void ) {
 			GetAsyncStatsAvgMsg( msg );
 			common->Printf( "%s\n", msg.c_str() );
 
+			int portStatsMsec = Max( serverTime - portStatsTime, 1 );
+			common->Printf( "packets in = %d/s with %d recv calls/s, packets out = %d/s with %d send calls/s\n",
+							serverPort.packetsRead * 1000 / portStatsMsec, serverPort.receiveCalls * 1000 / portStatsMsec,
+							serverPort.packetsWritten * 1000 / portStatsMsec, serverPort.sendCalls * 1000 / portStatsMsec );
+			serverPort.ResetStats();
+			portStatsTime = serverTime;
+
 			nextAsyncStatsTime = serverTime + 1000;
 		}
 	}
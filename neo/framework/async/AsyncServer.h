@@ -44,6 +44,11 @@ const int MAX_CHALLENGES				= 1024;
 // if we don't hear from authorize server, assume it is down
 const int AUTHORIZE_TIMEOUT				= 5000;
 
+// number of addresses the connectionless message rate limiter keeps track of, must be a power of two
+const int MAX_OOB_LIMITS				= 1024;
+// number of slots searched for an address before the least recently used one is replaced
+const int OOB_LIMIT_PROBES				= 4;
+
 // states for the server's authorization process
 typedef enum {
 	CDK_WAIT = 0,	// we are waiting for a confirm/deny from auth
@@ -90,6 +95,13 @@ typedef struct challenge_s {
 	char				guid[12];		// guid
 } challenge_t;
 
+// token bucket of an address sending connectionless messages
+typedef struct oobLimit_s {
+	netadr_t			address;
+	int					lastTime;		// time tokens were last added
+	float				tokens;			// number of messages the address may still send
+} oobLimit_t;
+
 typedef enum {
 	SCS_FREE,			// can be reused for a new connection
 	SCS_ZOMBIE,			// client has been disconnected, but don't reuse connection for a couple seconds
@@ -175,6 +187,9 @@ public:
 
 	void				PrintLocalServerInfo( void );
 
+						// drop the cached getInfo answer after the serverinfo changes
+	void				InvalidateInfoResponse( void ) { infoResponseValid = false; }
+
 private:
 	bool				active;						// true if server is active
 	int					realTime;					// absolute time
@@ -198,6 +213,7 @@ private:
 
 	int					nextHeartbeatTime;
 	int					nextAsyncStatsTime;
+	int					portStatsTime;			// server time the port statistics were last reset
 
 	bool				serverReloadingEngine;		// flip-flop to not loop over when net_serverReloadEngine is on
 
@@ -205,6 +221,27 @@ private:
 
 	int					lastAuthTime;				// global for auth server timeout
 
+	idParallelJobList *	snapshotJobList;			// writes the snapshots of a dedicated server on the job threads
+
+	int					profileNetWait;				// tick profiler scopes
+	int					profileNetRead;
+	int					profileGame;
+	int					profileSnapshots;
+	int					profileNetWrite;
+
+	// the "infoResponse" after the challenge, rebuilt when the serverinfo or the player list changes
+	byte				infoResponseBuf[MAX_MESSAGE_SIZE];
+	int					infoResponseSize;
+	int					infoResponseTime;			// time the cached response was built
+	unsigned int	infoResponseClients;		// bit mask of the clients in the cached response
+	bool				infoResponseValid;
+
+	oobLimit_t			oobLimits[MAX_OOB_LIMITS];	// connectionless message rate per address
+
+	int					numInfoRequests;			// "getInfo" requests answered
+	int					numInfoBuilds;				// times the cached "infoResponse" was rebuilt
+	int					numOOBDropped;				// connectionless messages dropped by the rate limiter
+
 	// track the max outgoing rate over the last few secs to watch for spikes
 	// dependent on net_serverSnapshotDelay. 50ms, for a 3 seconds backlog -> 60 samples
 	static const int	stats_numsamples = 60;
@@ -232,13 +269,20 @@ private:
 	bool				SendEmptyToClient( int clientNum, bool force = false );
 	bool				SendPingToClient( int clientNum );
 	void				SendGameInitToClient( int clientNum );
+	bool				IsSnapshotDue( int clientNum ) const;
+	void				WriteSnapshotToClient( int clientNum, idBitMsg &msg );
+	void				FinishSnapshotToClient( int clientNum, const idBitMsg &msg );
 	bool				SendSnapshotToClient( int clientNum );
+	void				SendSnapshotsToClients( const int *clientNums, int numClients );
+	static void			WriteSnapshotJob( void *data );
 	void				ProcessUnreliableClientMessage( int clientNum, const idBitMsg &msg );
 	void				ProcessReliableClientMessages( int clientNum );
 	void				ProcessChallengeMessage( const netadr_t from, const idBitMsg &msg );
 	void				ProcessConnectMessage( const netadr_t from, const idBitMsg &msg );
 	void				ProcessRemoteConsoleMessage( const netadr_t from, const idBitMsg &msg );
+	void				BuildInfoResponse( unsigned int clientMask );
 	void				ProcessGetInfoMessage( const netadr_t from, const idBitMsg &msg );
+	bool				AllowConnectionlessMessage( const netadr_t from );
 	bool				ConnectionlessMessage( const netadr_t from, const idBitMsg &msg );
 	bool				ProcessMessage( const netadr_t from, idBitMsg &msg );
 	void				ProcessAuthMessage( const idBitMsg &msg );
@@ -31,6 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "MsgChannel.h"
 
+static idFile *		recordFile = NULL;		// uncompressed message data written for netCompressBench
+
 /*
 
 packet header
@@ -259,7 +261,8 @@ void idMsgChannel::Init( const netadr_t adr, const int id ) {
 	this->remoteAddress = adr;
 	this->id = id;
 	this->maxRate = 50000;
-	this->compressor = idCompressor::AllocRunLength_ZeroBased();
+	this->compression = NET_COMPRESSION_RUNLENGTH;
+	this->compressor = AllocCompressor( compression );
 
 	lastSendTime = 0;
 	lastDataBytes = 0;
@@ -292,6 +295,62 @@ void idMsgChannel::Shutdown( void ) {
 	compressor = NULL;
 }
 
+/*
+===============
+idMsgChannel::SetCompression
+================
+*/
+void idMsgChannel::SetCompression( netCompression_t compression ) {
+	if ( compression == this->compression && compressor ) {
+		return;
+	}
+	delete compressor;
+	this->compression = compression;
+	this->compressor = AllocCompressor( compression );
+}
+
+/*
+===============
+idMsgChannel::AllocCompressor
+================
+*/
+idCompressor *idMsgChannel::AllocCompressor( netCompression_t compression ) {
+	switch( compression ) {
+		case NET_COMPRESSION_RANGE:
+			return idCompressor::AllocRangeCoder();
+		default:
+			return idCompressor::AllocRunLength_ZeroBased();
+	}
+}
+
+/*
+===============
+idMsgChannel::StartRecording
+================
+*/
+void idMsgChannel::StartRecording( const char *fileName ) {
+	StopRecording();
+	recordFile = fileSystem->OpenFileWrite( fileName );
+	if ( !recordFile ) {
+		common->Warning( "idMsgChannel::StartRecording: couldn't open %s", fileName );
+		return;
+	}
+	common->Printf( "recording network messages to %s\n", fileName );
+}
+
+/*
+===============
+idMsgChannel::StopRecording
+================
+*/
+void idMsgChannel::StopRecording( void ) {
+	if ( recordFile ) {
+		common->Printf( "stopped recording network messages\n" );
+		fileSystem->CloseFile( recordFile );
+		recordFile = NULL;
+	}
+}
+
 /*
 =================
 idMsgChannel::ResetRate
@@ -346,6 +405,11 @@ void idMsgChannel::WriteMessageData( idBitMsg &out, const idBitMsg &msg ) {
 	// write data
 	tmp.WriteData( msg.GetData(), msg.GetSize() );
 
+	if ( recordFile ) {
+		recordFile->WriteInt( tmp.GetSize() );
+		recordFile->Write( tmp.GetData(), tmp.GetSize() );
+	}
+
 	// write message size
 	out.WriteShort( tmp.GetSize() );
 
@@ -52,6 +52,13 @@ If you have questions concerning this license or the applicable additional terms
 
 #define MAX_MSG_QUEUE_SIZE				16384		// must be a power of 2
 
+// compression of the message data, negotiated at connect
+typedef enum {
+	NET_COMPRESSION_RUNLENGTH,		// zero based run length, understood by every client and server
+	NET_COMPRESSION_RANGE,			// adaptive context range coder
+	NET_COMPRESSION_MAX
+} netCompression_t;
+
 
 class idMsgQueue {
 public:
@@ -93,6 +100,17 @@ public:
 	void			Shutdown( void );
 	void			ResetRate( void );
 
+					// Sets the compression of the message data, both sides of the channel must use the same.
+	void			SetCompression( netCompression_t compression );
+	netCompression_t GetCompression( void ) const { return compression; }
+
+					// Allocates the compressor for the given compression.
+	static idCompressor *AllocCompressor( netCompression_t compression );
+
+					// Writes the uncompressed data of all sent messages to a file for netCompressBench.
+	static void		StartRecording( const char *fileName );
+	static void		StopRecording( void );
+
 					// Sets the maximum outgoing rate.
 	void			SetMaxOutgoingRate( int rate ) { maxRate = rate; }
 
@@ -149,6 +167,7 @@ private:
 	int				id;				// our identification used instead of port number
 	int				maxRate;		// maximum number of bytes that may go out per second
 	idCompressor *	compressor;		// compressor used for data compression
+	netCompression_t compression;
 
 	// variables to control the outgoing rate
 	int				lastSendTime;	// last time data was sent out
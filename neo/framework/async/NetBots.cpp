@@ -0,0 +1,785 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "AsyncNetwork.h"
+#include "NetBots.h"
+
+const int BOT_CONNECT_RESEND_TIME	= 1000;
+const int BOT_CONNECT_INTERVAL		= 250;		// bots start their handshakes this far apart
+
+idNetBots	netBots;
+
+/*
+==================
+idNetBot::idNetBot
+==================
+*/
+idNetBot::idNetBot( void ) {
+	botNum = 0;
+	state = BOT_FREE;
+	memset( &serverAddress, 0, sizeof( serverAddress ) );
+	clientId = 0;
+	clientNum = 0;
+	serverId = 0;
+	serverChallenge = 0;
+	lastConnectTime = 0;
+	lastFrameTime = 0;
+	gameInitId = 0;
+	gameFrame = 0;
+	gameTime = 0;
+	serverMessageSequence = 0;
+	snapshotSequence = 0;
+	memset( userCmds, 0, sizeof( userCmds ) );
+	memset( userCmdSendTime, 0, sizeof( userCmdSendTime ) );
+	nextMoveTime = 0;
+	memset( &move, 0, sizeof( move ) );
+	turnSpeed = 0;
+	viewYaw = 0;
+	ClearStats( 0 );
+}
+
+/*
+==================
+idNetBot::Connect
+==================
+*/
+void idNetBot::Connect( int botNum, const netadr_t adr, int time ) {
+	Disconnect();
+
+	if ( !port.InitForPort( PORT_ANY ) ) {
+		common->Warning( "bot %d: couldn't open a port", botNum );
+		return;
+	}
+
+	this->botNum = botNum;
+	serverAddress = adr;
+	clientId = ( time + botNum ) & CONNECTIONLESS_MESSAGE_ID_MASK;
+	random.SetSeed( time + botNum );
+
+	// don't start all handshakes at once
+	state = BOT_CHALLENGING;
+	lastConnectTime = time + botNum * BOT_CONNECT_INTERVAL - BOT_CONNECT_RESEND_TIME;
+
+	ClearStats( time );
+}
+
+/*
+==================
+idNetBot::Disconnect
+==================
+*/
+void idNetBot::Disconnect( void ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	if ( state == BOT_FREE ) {
+		return;
+	}
+
+	if ( state == BOT_INGAME ) {
+		msg.Init( msgBuf, sizeof( msgBuf ) );
+		msg.WriteByte( CLIENT_RELIABLE_MESSAGE_DISCONNECT );
+		msg.WriteString( "disconnect" );
+		channel.SendReliableMessage( msg );
+
+		for ( int i = 0; i < 3; i++ ) {
+			msg.Init( msgBuf, sizeof( msgBuf ) );
+			msg.WriteInt( serverMessageSequence );
+			msg.WriteInt( gameInitId );
+			msg.WriteInt( snapshotSequence );
+			msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_EMPTY );
+			channel.SendMessage( port, Sys_Milliseconds(), msg );
+			while ( channel.UnsentFragmentsLeft() ) {
+				channel.SendNextFragment( port, Sys_Milliseconds() );
+			}
+		}
+		channel.Shutdown();
+	}
+
+	port.Close();
+	state = BOT_FREE;
+}
+
+/*
+==================
+idNetBot::ClearStats
+==================
+*/
+void idNetBot::ClearStats( int time ) {
+	statsTime = time;
+	numSnapshots = 0;
+	snapshotBytes = 0;
+	maxSnapshotBytes = 0;
+	packetBytes = 0;
+	lastSnapshotTime = 0;
+	maxSnapshotInterval = 0;
+	lastRoundTripFrame = 0;
+	numRoundTrips = 0;
+	roundTripTime = 0;
+	maxRoundTripTime = 0;
+}
+
+/*
+==================
+idNetBot::PrintStats
+==================
+*/
+void idNetBot::PrintStats( int time ) const {
+	static const char *stateNames[] = { "free", "challenging", "connecting", "ingame" };
+	float seconds = Max( time - statsTime, 1 ) * 0.001f;
+
+	if ( state != BOT_INGAME ) {
+		common->Printf( "%3d %-11s\n", botNum, stateNames[state] );
+		return;
+	}
+
+	common->Printf( "%3d %-11s %6d %8.1f %8d %8d %8.1f %8.1f %8d %8d\n", botNum, stateNames[state], clientNum,
+					numSnapshots / seconds,
+					numSnapshots ? (float)snapshotBytes / numSnapshots : 0.0f, maxSnapshotBytes,
+					(int)( packetBytes / seconds ),
+					numRoundTrips ? (float)roundTripTime / numRoundTrips : 0.0f, maxRoundTripTime,
+					maxSnapshotInterval );
+}
+
+/*
+==================
+idNetBot::RunFrame
+==================
+*/
+void idNetBot::RunFrame( int time ) {
+	netadr_t	from;
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	int			size;
+
+	if ( state == BOT_FREE ) {
+		return;
+	}
+
+	while ( port.GetPacket( from, msgBuf, size, sizeof( msgBuf ) ) ) {
+		packetBytes += size;
+		msg.Init( msgBuf, sizeof( msgBuf ) );
+		msg.SetSize( size );
+		msg.BeginReading();
+		ProcessMessage( from, msg, time );
+		if ( state == BOT_FREE ) {
+			return;
+		}
+	}
+
+	if ( state == BOT_INGAME ) {
+		if ( channel.UnsentFragmentsLeft() ) {
+			channel.SendNextFragment( port, time );
+		}
+		SendUsercmds( time );
+	} else {
+		SetupConnection( time );
+	}
+}
+
+/*
+==================
+idNetBot::SetupConnection
+==================
+*/
+void idNetBot::SetupConnection( int time ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	if ( time - lastConnectTime < BOT_CONNECT_RESEND_TIME ) {
+		return;
+	}
+	lastConnectTime = time;
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteShort( CONNECTIONLESS_MESSAGE_ID );
+
+	if ( state == BOT_CHALLENGING ) {
+		msg.WriteString( "challenge" );
+		msg.WriteInt( clientId );
+	} else {
+		msg.WriteString( "connect" );
+		msg.WriteInt( ASYNC_PROTOCOL_VERSION );
+		msg.WriteInt( declManager->GetChecksum() );
+		msg.WriteInt( serverChallenge );
+		msg.WriteShort( clientId );
+		msg.WriteInt( idAsyncNetwork::clientMaxRate.GetInteger() );
+		msg.WriteString( "" );	// guid
+		msg.WriteString( cvarSystem->GetCVarString( "password" ), -1, false );
+		msg.WriteShort( 0 );	// PB
+		msg.WriteByte( idAsyncNetwork::clientCompression.GetInteger() );
+	}
+
+	port.SendPacket( serverAddress, msg.GetData(), msg.GetSize() );
+}
+
+/*
+==================
+idNetBot::ProcessMessage
+==================
+*/
+void idNetBot::ProcessMessage( const netadr_t from, idBitMsg &msg, int time ) {
+	int id;
+
+	id = msg.ReadShort();
+
+	if ( id == CONNECTIONLESS_MESSAGE_ID ) {
+		ConnectionlessMessage( from, msg, time );
+		return;
+	}
+
+	if ( state != BOT_INGAME || msg.GetRemaingData() < 4 ) {
+		return;
+	}
+
+	if ( !Sys_CompareNetAdrBase( from, channel.GetRemoteAddress() ) || id != serverId ) {
+		return;
+	}
+
+	if ( !channel.Process( from, time, msg, serverMessageSequence ) ) {
+		return;		// out of order, duplicated, fragment, etc.
+	}
+
+	ProcessReliableMessages();
+	if ( state == BOT_INGAME ) {
+		ProcessUnreliableMessage( msg, time );
+	}
+}
+
+/*
+==================
+idNetBot::ConnectionlessMessage
+==================
+*/
+void idNetBot::ConnectionlessMessage( const netadr_t from, const idBitMsg &msg, int time ) {
+	char string[MAX_STRING_CHARS];
+
+	if ( !Sys_CompareNetAdrBase( from, serverAddress ) ) {
+		return;
+	}
+
+	msg.ReadString( string, sizeof( string ) );
+
+	if ( idStr::Icmp( string, "challengeResponse" ) == 0 ) {
+		if ( state != BOT_CHALLENGING ) {
+			return;
+		}
+		serverChallenge = msg.ReadInt();
+		serverId = msg.ReadShort();
+		serverAddress = from;
+		state = BOT_CONNECTING;
+		lastConnectTime = time - BOT_CONNECT_RESEND_TIME;
+		return;
+	}
+
+	if ( idStr::Icmp( string, "connectResponse" ) == 0 ) {
+		idDict serverSI;
+
+		if ( state != BOT_CONNECTING ) {
+			return;
+		}
+		channel.Init( from, clientId );
+		clientNum = msg.ReadInt();
+		gameInitId = msg.ReadInt();
+		gameFrame = msg.ReadInt();
+		gameTime = msg.ReadInt();
+		msg.ReadDeltaDict( serverSI, NULL );
+		if ( msg.GetRemaingData() > 0 ) {
+			channel.SetCompression( (netCompression_t)idMath::ClampInt( NET_COMPRESSION_RUNLENGTH, NET_COMPRESSION_MAX - 1, msg.ReadByte() ) );
+		}
+		if ( serverSI.GetBool( "si_pure" ) ) {
+			common->Warning( "bot %d: bots don't answer pure checks and won't enter the game on a pure server", botNum );
+		}
+
+		serverMessageSequence = 0;
+		snapshotSequence = 0;
+		memset( userCmds, 0, sizeof( userCmds ) );
+		memset( userCmdSendTime, 0, sizeof( userCmdSendTime ) );
+		lastFrameTime = time;
+		state = BOT_INGAME;
+
+		common->Printf( "bot %d connected as client %d\n", botNum, clientNum );
+
+		SendUserInfo();
+		return;
+	}
+
+	if ( idStr::Icmp( string, "print" ) == 0 ) {
+		int opcode = msg.ReadInt();
+		if ( opcode == SERVER_PRINT_GAMEDENY ) {
+			msg.ReadInt();
+		}
+		msg.ReadString( string, sizeof( string ) );
+		common->Printf( "bot %d: %s\n", botNum, common->GetLanguageDict()->GetString( string ) );
+		if ( opcode == SERVER_PRINT_BADCHALLENGE && state == BOT_CONNECTING ) {
+			state = BOT_CHALLENGING;
+		}
+		return;
+	}
+
+	if ( idStr::Icmp( string, "disconnect" ) == 0 ) {
+		common->Printf( "bot %d: disconnected by the server\n", botNum );
+		Disconnect();
+		return;
+	}
+}
+
+/*
+==================
+idNetBot::ProcessReliableMessages
+==================
+*/
+void idNetBot::ProcessReliableMessages( void ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	char		string[MAX_STRING_CHARS];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+
+	while ( channel.GetReliableMessage( msg ) ) {
+		switch( msg.ReadByte() ) {
+			case SERVER_RELIABLE_MESSAGE_DISCONNECT: {
+				// sent to every client whenever any client leaves
+				int disconnectNum = msg.ReadInt();
+				msg.ReadString( string, sizeof( string ) );
+				if ( disconnectNum != clientNum ) {
+					break;
+				}
+				common->Printf( "bot %d: disconnected, %s\n", botNum, common->GetLanguageDict()->GetString( string ) );
+				channel.Shutdown();
+				port.Close();
+				state = BOT_FREE;
+				return;
+			}
+			default: {
+				// bots don't run the game
+				break;
+			}
+		}
+	}
+}
+
+/*
+==================
+idNetBot::ProcessUnreliableMessage
+==================
+*/
+void idNetBot::ProcessUnreliableMessage( const idBitMsg &msg, int time ) {
+	int i, serverGameInitId, snapshotGameFrame, snapshotGameTime, aheadOfServer, receivedGameTime;
+
+	serverGameInitId = msg.ReadInt();
+
+	switch( msg.ReadByte() ) {
+		case SERVER_UNRELIABLE_MESSAGE_PING: {
+			SendPingResponse( msg.ReadInt(), time );
+			break;
+		}
+		case SERVER_UNRELIABLE_MESSAGE_GAMEINIT: {
+			gameInitId = serverGameInitId;
+			gameFrame = msg.ReadInt();
+			gameTime = msg.ReadInt();
+			memset( userCmds, 0, sizeof( userCmds ) );
+			memset( userCmdSendTime, 0, sizeof( userCmdSendTime ) );
+			lastRoundTripFrame = 0;
+			channel.ResetRate();
+			break;
+		}
+		case SERVER_UNRELIABLE_MESSAGE_SNAPSHOT: {
+			if ( serverGameInitId != gameInitId ) {
+				break;
+			}
+
+			snapshotSequence = msg.ReadInt();
+			snapshotGameFrame = msg.ReadInt();
+			snapshotGameTime = msg.ReadInt();
+			msg.ReadByte();		// duplicated user commands
+			aheadOfServer = msg.ReadShort();
+
+			numSnapshots++;
+			snapshotBytes += msg.GetSize();
+			maxSnapshotBytes = Max( maxSnapshotBytes, msg.GetSize() );
+			if ( lastSnapshotTime ) {
+				maxSnapshotInterval = Max( maxSnapshotInterval, time - lastSnapshotTime );
+			}
+			lastSnapshotTime = time;
+
+			// the snapshot tells how far ahead the newest user command the server received was,
+			// the round trip is the time from sending that user command to receiving the snapshot
+			receivedGameTime = snapshotGameTime + aheadOfServer;
+			for ( i = 0; i < MAX_USERCMD_BACKUP; i++ ) {
+				const usercmd_t &cmd = userCmds[i];
+				if ( cmd.gameFrame > lastRoundTripFrame && userCmdSendTime[i] &&
+						cmd.gameTime >= receivedGameTime && cmd.gameTime < receivedGameTime + USERCMD_MSEC ) {
+					int rtt = time - userCmdSendTime[i];
+					lastRoundTripFrame = cmd.gameFrame;
+					numRoundTrips++;
+					roundTripTime += rtt;
+					maxRoundTripTime = Max( maxRoundTripTime, rtt );
+					break;
+				}
+			}
+
+			// stay ahead of the server like a real client
+			if ( gameTime < snapshotGameTime || gameTime > snapshotGameTime + idAsyncNetwork::clientMaxPrediction.GetInteger() ) {
+				gameFrame = snapshotGameFrame;
+				gameTime = snapshotGameTime;
+			} else if ( aheadOfServer < idAsyncNetwork::clientPrediction.GetInteger() ) {
+				NextUsercmd( userCmds[( gameFrame + 1 ) & ( MAX_USERCMD_BACKUP - 1 )], time );
+			}
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+}
+
+/*
+==================
+idNetBot::SendUserInfo
+==================
+*/
+void idNetBot::SendUserInfo( void ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	idDict		info;
+
+	info = *cvarSystem->MoveCVarsToDict( CVAR_USERINFO );
+	info.Set( "ui_name", va( "bot%d", botNum ) );
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteByte( CLIENT_RELIABLE_MESSAGE_CLIENTINFO );
+	msg.WriteDeltaDict( info, NULL );
+	channel.SendReliableMessage( msg );
+}
+
+/*
+==================
+idNetBot::SendPingResponse
+==================
+*/
+void idNetBot::SendPingResponse( int pingTime, int time ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteInt( serverMessageSequence );
+	msg.WriteInt( gameInitId );
+	msg.WriteInt( snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_PINGRESPONSE );
+	msg.WriteInt( pingTime );
+	channel.SendMessage( port, time, msg );
+}
+
+/*
+==================
+idNetBot::NextUsercmd
+
+  Advances the game frame and writes a user command for it. The bot runs
+  and strafes in random directions while turning, jumping and firing now
+  and then.
+==================
+*/
+void idNetBot::NextUsercmd( usercmd_t &cmd, int time ) {
+	static const signed char moves[] = { 127, 127, 0, -127 };
+	static const signed char strafes[] = { -127, 0, 0, 127 };
+
+	if ( time >= nextMoveTime ) {
+		nextMoveTime = time + 500 + random.RandomInt( 1500 );
+		move.forwardmove = moves[random.RandomInt( 4 )];
+		move.rightmove = strafes[random.RandomInt( 4 )];
+		move.upmove = random.RandomFloat() < 0.1f ? 127 : 0;
+		move.buttons = BUTTON_RUN | ( random.RandomFloat() < 0.3f ? BUTTON_ATTACK : 0 );
+		turnSpeed = (int)( random.CRandomFloat() * ANGLE2SHORT( 5.0f ) );
+	}
+
+	gameFrame++;
+	gameTime += USERCMD_MSEC;
+	viewYaw += turnSpeed;
+
+	cmd = move;
+	cmd.gameFrame = gameFrame;
+	cmd.gameTime = gameTime;
+	cmd.duplicateCount = 0;
+	cmd.angles[PITCH] = 0;
+	cmd.angles[YAW] = (short)viewYaw;
+	cmd.angles[ROLL] = 0;
+	cmd.mx = 0;
+	cmd.my = 0;
+	cmd.impulse = 0;
+	cmd.flags = 0;
+	cmd.sequence = gameFrame;
+
+	userCmdSendTime[gameFrame & ( MAX_USERCMD_BACKUP - 1 )] = 0;
+}
+
+/*
+==================
+idNetBot::SendUsercmds
+==================
+*/
+void idNetBot::SendUsercmds( int time ) {
+	int			i, numUsercmds, index;
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	usercmd_t *	last;
+
+	// don't catch up after a long stall
+	if ( time - lastFrameTime > 1000 ) {
+		lastFrameTime = time - USERCMD_MSEC;
+	}
+
+	if ( time - lastFrameTime < USERCMD_MSEC ) {
+		return;
+	}
+	while ( time - lastFrameTime >= USERCMD_MSEC ) {
+		lastFrameTime += USERCMD_MSEC;
+		NextUsercmd( userCmds[( gameFrame + 1 ) & ( MAX_USERCMD_BACKUP - 1 )], time );
+	}
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteInt( serverMessageSequence );
+	msg.WriteInt( gameInitId );
+	msg.WriteInt( snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_USERCMD );
+	msg.WriteShort( idAsyncNetwork::clientPrediction.GetInteger() );
+
+	numUsercmds = idMath::ClampInt( 0, 10, idAsyncNetwork::clientUsercmdBackup.GetInteger() ) + 1;
+
+	msg.WriteInt( gameFrame );
+	msg.WriteByte( numUsercmds );
+	for ( last = NULL, i = gameFrame - numUsercmds + 1; i <= gameFrame; i++ ) {
+		index = i & ( MAX_USERCMD_BACKUP - 1 );
+		idAsyncNetwork::WriteUserCmdDelta( msg, userCmds[index], last );
+		last = &userCmds[index];
+		if ( !userCmdSendTime[index] ) {
+			userCmdSendTime[index] = time;
+		}
+	}
+
+	channel.SendMessage( port, time, msg );
+	while ( channel.UnsentFragmentsLeft() ) {
+		channel.SendNextFragment( port, time );
+	}
+}
+
+/*
+==================
+idNetBots::idNetBots
+==================
+*/
+idNetBots::idNetBots( void ) {
+	memset( bots, 0, sizeof( bots ) );
+	numBots = 0;
+	memset( &serverAddress, 0, sizeof( serverAddress ) );
+	startTime = 0;
+	numServerFrames = 0;
+	serverFrameTime = 0.0;
+	maxServerFrameTime = 0.0;
+}
+
+/*
+==================
+idNetBots::Init
+==================
+*/
+void idNetBots::Init( void ) {
+	cmdSystem->AddCommand( "netBots", NetBots_f, CMD_FL_SYSTEM, "connects headless bots to a server: netBots <count> [address], the local server by default" );
+	cmdSystem->AddCommand( "netBotsStop", NetBotsStop_f, CMD_FL_SYSTEM, "disconnects the headless bots" );
+	cmdSystem->AddCommand( "netBotsStats", NetBotsStats_f, CMD_FL_SYSTEM, "prints snapshot sizes, round trip times and server frame times seen by the headless bots, 'clear' restarts them" );
+}
+
+/*
+==================
+idNetBots::Shutdown
+==================
+*/
+void idNetBots::Shutdown( void ) {
+	Stop();
+	for ( int i = 0; i < MAX_NET_BOTS; i++ ) {
+		delete bots[i];
+		bots[i] = NULL;
+	}
+}
+
+/*
+==================
+idNetBots::RunFrame
+==================
+*/
+void idNetBots::RunFrame( void ) {
+	int time;
+
+	if ( !numBots ) {
+		return;
+	}
+
+	time = Sys_Milliseconds();
+	for ( int i = 0; i < numBots; i++ ) {
+		bots[i]->RunFrame( time );
+	}
+}
+
+/*
+==================
+idNetBots::AddServerFrameTime
+==================
+*/
+void idNetBots::AddServerFrameTime( double msec ) {
+	if ( !numBots || !idAsyncNetwork::server.IsActive() ) {
+		return;
+	}
+	numServerFrames++;
+	serverFrameTime += msec;
+	maxServerFrameTime = Max( maxServerFrameTime, msec );
+}
+
+/*
+==================
+idNetBots::Start
+==================
+*/
+void idNetBots::Start( int num, const netadr_t adr ) {
+	Stop();
+
+	serverAddress = adr;
+	numBots = idMath::ClampInt( 0, MAX_NET_BOTS, num );
+	startTime = Sys_Milliseconds();
+
+	for ( int i = 0; i < numBots; i++ ) {
+		if ( !bots[i] ) {
+			bots[i] = new idNetBot;
+		}
+		bots[i]->Connect( i, adr, startTime );
+	}
+	ClearStats();
+
+	common->Printf( "connecting %d bots to %s\n", numBots, Sys_NetAdrToString( adr ) );
+}
+
+/*
+==================
+idNetBots::Stop
+==================
+*/
+void idNetBots::Stop( void ) {
+	for ( int i = 0; i < numBots; i++ ) {
+		bots[i]->Disconnect();
+	}
+	numBots = 0;
+}
+
+/*
+==================
+idNetBots::ClearStats
+==================
+*/
+void idNetBots::ClearStats( void ) {
+	int time = Sys_Milliseconds();
+	for ( int i = 0; i < numBots; i++ ) {
+		bots[i]->ClearStats( time );
+	}
+	numServerFrames = 0;
+	serverFrameTime = 0.0;
+	maxServerFrameTime = 0.0;
+}
+
+/*
+==================
+idNetBots::PrintStats
+==================
+*/
+void idNetBots::PrintStats( void ) {
+	int time = Sys_Milliseconds();
+
+	common->Printf( "bot state       client  snaps/s  avg size max size  bytes/s  avg rtt  max rtt max snap gap\n" );
+	for ( int i = 0; i < numBots; i++ ) {
+		bots[i]->PrintStats( time );
+	}
+	if ( numServerFrames ) {
+		common->Printf( "server frames: %d, avg %.2f msec, max %.2f msec\n", numServerFrames, serverFrameTime / numServerFrames, maxServerFrameTime );
+	}
+}
+
+/*
+==================
+idNetBots::NetBots_f
+==================
+*/
+void idNetBots::NetBots_f( const idCmdArgs &args ) {
+	netadr_t adr;
+
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: netBots <count> [address]\n" );
+		return;
+	}
+
+	if ( args.Argc() > 2 ) {
+		if ( !Sys_StringToNetAdr( args.Argv( 2 ), &adr, true ) ) {
+			common->Printf( "couldn't resolve %s\n", args.Argv( 2 ) );
+			return;
+		}
+		if ( adr.port == 0 ) {
+			adr.port = PORT_SERVER;
+		}
+	} else {
+		if ( !idAsyncNetwork::server.IsActive() ) {
+			common->Printf( "no local server running, give the server address\n" );
+			return;
+		}
+		Sys_StringToNetAdr( "localhost", &adr, true );
+		adr.port = idAsyncNetwork::server.GetPort();
+	}
+
+	netBots.Start( atoi( args.Argv( 1 ) ), adr );
+}
+
+/*
+==================
+idNetBots::NetBotsStop_f
+==================
+*/
+void idNetBots::NetBotsStop_f( const idCmdArgs &args ) {
+	netBots.Stop();
+}
+
+/*
+==================
+idNetBots::NetBotsStats_f
+==================
+*/
+void idNetBots::NetBotsStats_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "clear" ) == 0 ) {
+		netBots.ClearStats();
+		return;
+	}
+	netBots.PrintStats();
+}
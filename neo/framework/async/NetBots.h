@@ -0,0 +1,152 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __NETBOTS_H__
+#define __NETBOTS_H__
+
+/*
+===============================================================================
+
+  Headless clients to put load on a server.
+
+  Every bot has its own UDP port and message channel, goes through the
+  regular challenge and connect handshake and sends a stream of random
+  user commands. Bots don't run the game, snapshots are only measured and
+  acknowledged. The bots can run in the dedicated server they connect to
+  or in a separate process.
+
+===============================================================================
+*/
+
+const int MAX_NET_BOTS					= MAX_ASYNC_CLIENTS;
+
+typedef enum {
+	BOT_FREE,				// not connected
+	BOT_CHALLENGING,		// sending challenge packets to the server
+	BOT_CONNECTING,			// sending connect packets to the server
+	BOT_INGAME				// sending user commands to the server
+} netBotState_t;
+
+class idNetBot {
+public:
+						idNetBot( void );
+
+	void				Connect( int botNum, const netadr_t adr, int time );
+	void				Disconnect( void );
+	void				RunFrame( int time );
+	void				PrintStats( int time ) const;
+	void				ClearStats( int time );
+
+	netBotState_t		GetState( void ) const { return state; }
+
+private:
+	int					botNum;
+	netBotState_t		state;
+	idPort				port;
+	idMsgChannel		channel;
+	netadr_t			serverAddress;
+	int					clientId;
+	int					clientNum;
+	int					serverId;
+	int					serverChallenge;
+	int					lastConnectTime;
+	int					lastFrameTime;
+
+	int					gameInitId;
+	int					gameFrame;
+	int					gameTime;
+	int					serverMessageSequence;
+	int					snapshotSequence;
+
+	usercmd_t			userCmds[MAX_USERCMD_BACKUP];
+	int					userCmdSendTime[MAX_USERCMD_BACKUP];	// time each user command was sent
+
+	idRandom			random;
+	int					nextMoveTime;							// time the bot changes its movement
+	usercmd_t			move;
+	int					turnSpeed;								// yaw change per user command
+	int					viewYaw;
+
+	// statistics since the last ClearStats
+	int					statsTime;
+	int					numSnapshots;
+	int					snapshotBytes;
+	int					maxSnapshotBytes;
+	int					packetBytes;
+	int					lastSnapshotTime;
+	int					maxSnapshotInterval;
+	int					lastRoundTripFrame;						// newest user command the round trip was measured for
+	int					numRoundTrips;
+	int					roundTripTime;
+	int					maxRoundTripTime;
+
+	void				ProcessMessage( const netadr_t from, idBitMsg &msg, int time );
+	void				ConnectionlessMessage( const netadr_t from, const idBitMsg &msg, int time );
+	void				ProcessReliableMessages( void );
+	void				ProcessUnreliableMessage( const idBitMsg &msg, int time );
+	void				SetupConnection( int time );
+	void				SendUserInfo( void );
+	void				SendPingResponse( int pingTime, int time );
+	void				SendUsercmds( int time );
+	void				NextUsercmd( usercmd_t &cmd, int time );
+};
+
+class idNetBots {
+public:
+						idNetBots( void );
+
+	void				Init( void );
+	void				Shutdown( void );
+	void				RunFrame( void );
+
+						// server frame times are only known when the bots run in the server
+	void				AddServerFrameTime( double msec );
+
+private:
+	idNetBot *			bots[MAX_NET_BOTS];
+	int					numBots;
+	netadr_t			serverAddress;
+	int					startTime;
+
+	int					numServerFrames;
+	double				serverFrameTime;
+	double				maxServerFrameTime;
+
+	void				Start( int num, const netadr_t adr );
+	void				Stop( void );
+	void				PrintStats( void );
+	void				ClearStats( void );
+
+	static void			NetBots_f( const idCmdArgs &args );
+	static void			NetBotsStop_f( const idCmdArgs &args );
+	static void			NetBotsStats_f( const idCmdArgs &args );
+};
+
+extern idNetBots		netBots;
+
+#endif /* !__NETBOTS_H__ */
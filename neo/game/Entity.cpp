@@ -2415,6 +2415,8 @@ bool idEntity::RunPhysics( void ) {
 		return false;
 	}
 
+	idTickProfileScope profile( gameLocal.profilePhysics );
+
 	startTime = gameLocal.previousTime;
 	endTime = gameLocal.time;
 
@@ -48,6 +48,7 @@ idUserInterfaceManager *	uiManager = NULL;
 idDeclManager *				declManager = NULL;
 idAASFileManager *			AASFileManager = NULL;
 idCollisionModelManager *	collisionModelManager = NULL;
+idTickProfiler *			tickProfiler = NULL;
 idCVar *					idCVar::staticVars = NULL;
 
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL|CVAR_SYSTEM, "force generic platform independent SIMD" );
@@ -93,6 +94,7 @@ extern "C" ID_GAME_API gameExport_t *GetGameAPI( gameImport_t *import ) {
 		declManager					= import->declManager;
 		AASFileManager				= import->AASFileManager;
 		collisionModelManager		= import->collisionModelManager;
+		tickProfiler				= import->tickProfiler;
 	}
 
 	// set interface pointers used by idLib
@@ -131,6 +133,7 @@ void TestGameAPI( void ) {
 	testImport.declManager				= ::declManager;
 	testImport.AASFileManager			= ::AASFileManager;
 	testImport.collisionModelManager	= ::collisionModelManager;
+	testImport.tickProfiler				= ::tickProfiler;
 
 	testExport = *GetGameAPI( &testImport );
 }
@@ -221,10 +224,19 @@ void idGameLocal::Clear( void ) {
 	newInfo.Clear();
 	lastGUIEnt = NULL;
 	lastGUI = 0;
+	profileThink = -1;
+	profilePhysics = -1;
+	profileEvents = -1;
+	profileScripts = -1;
+	profilePVS = -1;
 
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	memset( clientSnapshotPriority, 0, sizeof( clientSnapshotPriority ) );
+	memset( snapshotCache, 0, sizeof( snapshotCache ) );
+	snapshotCacheSerial = 0;
+	snapshotCacheWritesSerial = -1;
 
 	eventQueue.Init();
 	savedEventQueue.Init();
@@ -311,6 +323,12 @@ void idGameLocal::Init( void ) {
 
 	InitConsoleCommands();
 
+	profileThink = tickProfiler->RegisterScope( "think" );
+	profilePhysics = tickProfiler->RegisterScope( "physics" );
+	profileEvents = tickProfiler->RegisterScope( "events" );
+	profileScripts = tickProfiler->RegisterScope( "scripts" );
+	profilePVS = tickProfiler->RegisterScope( "pvs" );
+
 	// load default scripts
 	program.Startup( SCRIPT_DEFAULT );
 
@@ -2234,6 +2252,7 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 	} else do {
 		// update the game time
 		framenum++;
+		snapshotCacheSerial++;
 		previousTime = time;
 		time += msec;
 		realClientTime = time;
@@ -2276,13 +2295,16 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 		UpdateGravity();
 
 		// create a merged pvs for all players
+		tickProfiler->BeginScope( profilePVS );
 		SetupPlayerPVS();
+		tickProfiler->EndScope( profilePVS );
 
 		// sort the active entity list
 		SortActiveEntityList();
 
 		timer_think.Clear();
 		timer_think.Start();
+		tickProfiler->BeginScope( profileThink );
 
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
@@ -2337,13 +2359,16 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 			numEntitiesToDeactivate = 0;
 		}
 
+		tickProfiler->EndScope( profileThink );
 		timer_think.Stop();
 		timer_events.Clear();
 		timer_events.Start();
+		tickProfiler->BeginScope( profileEvents );
 
 		// service any pending events
 		idEvent::ServiceEvents();
 
+		tickProfiler->EndScope( profileEvents );
 		timer_events.Stop();
 
 		// free the player pvs
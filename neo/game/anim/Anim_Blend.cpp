@@ -3057,6 +3057,15 @@ idAnimator::idAnimator() {
 
 	frameBounds.Clear();
 
+#if MD5_ENABLE_LODS > 0
+	lodInterval				= 0;
+	lodFrameTime			= 0;
+	lodNextTime				= -1;
+	lodHold					= false;
+	lodHasAnim				= false;
+	lodFrames				= NULL;
+#endif
+
 	AFPoseJoints.SetGranularity( 1 );
 	AFPoseJointMods.SetGranularity( 1 );
 	AFPoseJointFrame.SetGranularity( 1 );
@@ -3268,6 +3277,11 @@ void idAnimator::FreeData( void ) {
 	joints = NULL;
 	numJoints = 0;
 
+#if MD5_ENABLE_LODS > 0
+	Mem_Free16( lodFrames );
+	lodFrames = NULL;
+#endif
+
 	modelDef = NULL;
 
 	ForceUpdate();
@@ -3282,6 +3296,11 @@ void idAnimator::PushAnims( int channelNum, int currentTime, int blendTime ) {
 	int			i;
 	idAnimBlend *channel;
 
+#if MD5_ENABLE_LODS > 0
+	// the channel is about to change so the sampled poses no longer apply
+	lodNextTime = -1;
+#endif
+
 	channel = channels[ channelNum ];
 	if ( !channel[ 0 ].GetWeight( currentTime ) || ( channel[ 0 ].starttime == currentTime ) ) {
 		return;
@@ -3602,6 +3621,9 @@ void idAnimator::SyncAnimChannels( int channelNum, int fromChannelNum, int curre
 		toBlend.blendEndValue = 0.0f;
 	}
 	toBlend.SetWeight( weight, currentTime - 1, blendTime );
+#if MD5_ENABLE_LODS > 0
+	lodNextTime = -1;
+#endif
 
 	// disable framecommands on the current channel so that commands aren't called twice
 	toBlend.AllowFrameCommands( false );
@@ -4216,67 +4238,18 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 
 /*
 =====================
-idAnimator::CreateFrame
+idAnimator::BlendFrame
+
+Blends all channels at the given time into jointFrame starting from the default pose.
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force ) {
+bool idAnimator::BlendFrame( int currentTime, const idJointQuat *defaultPose, int numJoints, idJointQuat *jointFrame, bool debugInfo ) const {
 	int					i, j;
-	int					numJoints;
-	int					parentNum;
 	bool				hasAnim;
-	bool				debugInfo;
 	float				baseBlend;
 	float				blendWeight;
 	const idAnimBlend *	blend;
-	const int *			jointParent;
-	const jointMod_t *	jointMod;
-	const idJointQuat *	defaultPose;
-
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
-
-	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
-		return false;
-	}
-
-	if ( !modelDef || !modelDef->ModelHandle() ) {
-		return false;
-	}
-
-	if ( !force && !r_showSkel.GetInteger() ) {
-		if ( lastTransformTime == currentTime ) {
-			return false;
-		}
-		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
-			return false;
-		}
-	}
-
-	lastTransformTime = currentTime;
-	stoppedAnimatingUpdate = false;
-
-	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
-		debugInfo = true;
-		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
-		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
-	} else {
-		debugInfo = false;
-	}
 
-	// init the joint buffer
-	if ( AFPoseJoints.Num() ) {
-		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
-		defaultPose = AFPoseJointFrame.Ptr();
-	} else {
-		defaultPose = modelDef->GetDefaultPose();
-	}
-
-	if ( !defaultPose ) {
-		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
-		return false;
-	}
-
-	numJoints = modelDef->Joints().Num();
-	idJointQuat *jointFrame = ( idJointQuat * )_alloca16( numJoints * sizeof( jointFrame[0] ) );
 	SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
 
 	hasAnim = false;
@@ -4341,6 +4314,206 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		hasAnim = true;
 	}
 
+	return hasAnim;
+}
+
+#if MD5_ENABLE_LODS > 0
+static int animLodSkipFrame = -1;
+static int animLodSkipCount = 0;
+static int animLodSkipLast = 0;
+
+/*
+=====================
+idAnimator::GetLodSkipped
+
+Number of animators that reused sampled poses instead of blending during the last complete game frame.
+=====================
+*/
+int idAnimator::GetLodSkipped( void ) {
+	if ( animLodSkipFrame == gameLocal.framenum ) {
+		return animLodSkipLast;
+	}
+	if ( animLodSkipFrame == gameLocal.framenum - 1 ) {
+		return animLodSkipCount;
+	}
+	return 0;
+}
+
+/*
+=====================
+idAnimator::LodInterval
+
+Returns how many milliseconds the blended pose may be reused for, 0 to blend every frame.
+Entities outside the player PVS hold their pose, distant ones interpolate between poses
+sampled at 15 or 7.5 Hz depending on which r_lodRangeIncrements band they fall in.
+=====================
+*/
+int idAnimator::LodInterval( int currentTime, bool &hold ) const {
+	static idCVar	r_lodRangeIncrements( "r_lodRangeIncrements", "120.00", CVAR_RENDERER | CVAR_FLOAT, "Range increment for each LOD level (in inches)." );
+	int				interval;
+	idPlayer *		player;
+
+	hold = false;
+
+	if ( !g_animLevelOfDetail.GetBool() || gameLocal.isMultiplayer || !entity || AFPoseJoints.Num() ) {
+		return 0;
+	}
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || entity == player || entity->GetBindMaster() == player ) {
+		return 0;
+	}
+
+	if ( gameLocal.GetPlayerPVS().i != -1 ) {
+		hold = !gameLocal.InPlayerPVS( entity );
+	} else {
+		// the player PVS only exists while the game frame runs, keep the previous decision when called from the renderer
+		hold = ( lodNextTime != -1 ) && lodHold;
+	}
+
+	if ( hold ) {
+		interval = gameLocal.msec * 8;
+	} else {
+		int range = g_animLevelOfDetailRange.GetInteger();
+		float steps = ( entity->GetPhysics()->GetOrigin() - player->firstPersonViewOrigin ).LengthFast() / Max( r_lodRangeIncrements.GetFloat(), 1.0f );
+		if ( steps >= 2 * range ) {
+			interval = gameLocal.msec * 8;
+		} else if ( steps >= range ) {
+			interval = gameLocal.msec * 4;
+		} else {
+			return 0;
+		}
+	}
+
+	// blend the last frames of an animation at full rate so it comes to rest on its final pose
+	if ( !IsAnimating( currentTime + interval ) ) {
+		hold = false;
+		return 0;
+	}
+
+	return interval;
+}
+#endif
+
+/*
+=====================
+idAnimator::CreateFrame
+=====================
+*/
+bool idAnimator::CreateFrame( int currentTime, bool force ) {
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	bool				debugInfo;
+	const int *			jointParent;
+	const jointMod_t *	jointMod;
+	const idJointQuat *	defaultPose;
+
+	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
+	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
+		return false;
+	}
+
+	if ( !modelDef || !modelDef->ModelHandle() ) {
+		return false;
+	}
+
+	if ( !force && !r_showSkel.GetInteger() ) {
+		if ( lastTransformTime == currentTime ) {
+			return false;
+		}
+		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+			return false;
+		}
+	}
+
+	lastTransformTime = currentTime;
+	stoppedAnimatingUpdate = false;
+
+	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
+		debugInfo = true;
+		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
+		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
+	} else {
+		debugInfo = false;
+	}
+
+	// init the joint buffer
+	if ( AFPoseJoints.Num() ) {
+		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
+		defaultPose = AFPoseJointFrame.Ptr();
+	} else {
+		defaultPose = modelDef->GetDefaultPose();
+	}
+
+	if ( !defaultPose ) {
+		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
+		return false;
+	}
+
+	numJoints = modelDef->Joints().Num();
+	idJointQuat *jointFrame = ( idJointQuat * )_alloca16( numJoints * sizeof( jointFrame[0] ) );
+
+#if MD5_ENABLE_LODS > 0
+	bool hold = false;
+
+	lodInterval = 0;
+	if ( !force && !debugInfo && !r_showSkel.GetInteger() ) {
+		lodInterval = LodInterval( currentTime, hold );
+	}
+
+	if ( !lodInterval ) {
+		lodNextTime = -1;
+		hasAnim = BlendFrame( currentTime, defaultPose, numJoints, jointFrame, debugInfo );
+	} else if ( lodNextTime != -1 && lodHold == hold && currentTime > lodFrameTime && currentTime < lodNextTime ) {
+		// between two sampled poses
+		if ( animLodSkipFrame != gameLocal.framenum ) {
+			animLodSkipLast = ( animLodSkipFrame == gameLocal.framenum - 1 ) ? animLodSkipCount : 0;
+			animLodSkipFrame = gameLocal.framenum;
+			animLodSkipCount = 0;
+		}
+		animLodSkipCount++;
+
+		if ( hold ) {
+			// the joints still contain the sampled pose
+			return false;
+		}
+
+		int *index = ( int * )_alloca16( numJoints * sizeof( index[0] ) );
+		for( i = 0; i < numJoints; i++ ) {
+			index[i] = i;
+		}
+		SIMDProcessor->Memcpy( jointFrame, lodFrames, numJoints * sizeof( jointFrame[0] ) );
+		SIMDProcessor->BlendJoints( jointFrame, lodFrames + numJoints, ( float )( currentTime - lodFrameTime ) / ( float )( lodNextTime - lodFrameTime ), index, numJoints );
+		hasAnim = true;
+	} else if ( hold ) {
+		hasAnim = BlendFrame( currentTime, defaultPose, numJoints, jointFrame, false );
+		lodFrameTime = currentTime;
+		lodNextTime = currentTime + lodInterval;
+		lodHold = true;
+	} else {
+		// sample the current pose and the one an interval ahead to interpolate towards
+		if ( !lodFrames ) {
+			lodFrames = ( idJointQuat * )Mem_Alloc16( 2 * numJoints * sizeof( lodFrames[0] ) );
+		}
+		if ( !lodHold && lodNextTime == currentTime ) {
+			SIMDProcessor->Memcpy( lodFrames, lodFrames + numJoints, numJoints * sizeof( lodFrames[0] ) );
+			hasAnim = lodHasAnim;
+		} else {
+			hasAnim = BlendFrame( currentTime, defaultPose, numJoints, lodFrames, false );
+		}
+		lodHasAnim = BlendFrame( currentTime + lodInterval, defaultPose, numJoints, lodFrames + numJoints, false );
+		lodFrameTime = currentTime;
+		lodNextTime = currentTime + lodInterval;
+		lodHold = false;
+		SIMDProcessor->Memcpy( jointFrame, lodFrames, numJoints * sizeof( jointFrame[0] ) );
+	}
+#else
+	hasAnim = BlendFrame( currentTime, defaultPose, numJoints, jointFrame, debugInfo );
+#endif
+
 	if ( !hasAnim && !jointMods.Num() ) {
 		// no animations were updated
 		return false;
@@ -4467,6 +4640,9 @@ idAnimator::ForceUpdate
 void idAnimator::ForceUpdate( void ) {
 	lastTransformTime = -1;
 	forceUpdate = true;
+#if MD5_ENABLE_LODS > 0
+	lodNextTime = -1;
+#endif
 }
 
 /*
@@ -121,6 +121,7 @@ idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugDamage(				"g_debugDamage",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugWeapon(				"g_debugWeapon",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugScript(				"g_debugScript",			"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_scriptCompiled(			"g_scriptCompiled",			"1",			CVAR_GAME | CVAR_BOOL, "run scripts on the threaded interpreter with pre-resolved operands and superinstructions, 0 = classic interpreter" );
 idCVar g_debugMover(				"g_debugMover",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugTriggers(				"g_debugTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugCinematic(			"g_debugCinematic",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -165,6 +166,11 @@ idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL
 idCVar ai_showLevelOfDetail(		"ai_showLevelOfDetail",		"0",			CVAR_GAME | CVAR_INTEGER, "Draws the AI's current LOD above its head.");
 #endif
 
+#if MD5_ENABLE_LODS > 0
+idCVar g_animLevelOfDetail(			"g_animLevelOfDetail",		"1",			CVAR_GAME | CVAR_BOOL, "Throttles skeletal animation of distant or unseen entities, interpolating between poses sampled at 15 or 7.5 Hz.");
+idCVar g_animLevelOfDetailRange(	"g_animLevelOfDetailRange",	"10",			CVAR_GAME | CVAR_INTEGER, "Number of r_lodRangeIncrements steps beyond which animation is sampled at 15 Hz (7.5 Hz beyond twice that).", 1, 35, idCmdSystem::ArgCompletion_Integer<1,35> );
+#endif
+
 #if MD5_ENABLE_GIBS > 2 // DEBUG
 idCVar ai_testDismemberment(		"ai_testDismemberment",		"0",			CVAR_GAME | CVAR_INTEGER, "Selects the active gib damage evaluation.");
 #endif
@@ -34,6 +34,9 @@ If you have questions concerning this license or the applicable additional terms
 // HvG: Debugger support
 extern bool updateGameDebugger( idInterpreter *interpreter, idProgram *program, int instructionPointer );
 
+// engine cvar, bound to the engine's copy on registration
+idCVar com_enableDebuggerServer( "com_enableDebuggerServer", "0", CVAR_BOOL | CVAR_SYSTEM, "toggle debugger server and try to connect to com_dbgClientAdr" );
+
 /*
 ================
 idInterpreter::idInterpreter()
@@ -45,6 +48,13 @@ idInterpreter::idInterpreter() {
 	debug = 0;
 	memset( localstack, 0, sizeof( localstack ) );
 	memset( callStack, 0, sizeof( callStack ) );
+	memset( profileFrames, 0, sizeof( profileFrames ) );
+	profileSession = 0;
+	profiling = false;
+	profileInstructions = 0;
+	profileSegmentStart = 0.0;
+	profileTotalInstructions = 0;
+	profileTotalTime = 0.0;
 	Reset();
 }
 
@@ -627,6 +637,19 @@ void idInterpreter::EnterFunction( const function_t *func, bool clearStack ) {
 		}
 	}
 
+	if ( scriptProfiler.IsRunning() ) {
+		// the caller's instructions up to here are its own
+		ProfileSync();
+		if ( profiling ) {
+			ProfileSegment();
+		}
+		profileFrame_t &frame = profileFrames[ callStackDepth - 1 ];
+		frame.instructions = profileTotalInstructions;
+		frame.time = profileTotalTime;
+		frame.session = profileSession;
+		scriptProfiler.AddCall( func );
+	}
+
 	currentFunction = func;
 	assert( !func->eventdef );
 	NextInstruction( func->firstStatement );
@@ -682,6 +705,14 @@ void idInterpreter::LeaveFunction( idVarDef *returnDef ) {
 		}
 	}
 
+	if ( profiling ) {
+		ProfileSegment();
+		const profileFrame_t &frame = profileFrames[ callStackDepth - 1 ];
+		if ( frame.session == profileSession ) {
+			scriptProfiler.AddInclusive( currentFunction, profileTotalInstructions - frame.instructions, profileTotalTime - frame.time );
+		}
+	}
+
 	// remove locals from the stack
 	PopParms( currentFunction->locals );
 	assert( localstackUsed == localstackBase );
@@ -827,7 +858,13 @@ void idInterpreter::CallEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	eventEntity->ProcessEventArgPtr( evdef, data );
+	if ( profiling ) {
+		double startTime = sys->GetMillisecondsPrecise();
+		eventEntity->ProcessEventArgPtr( evdef, data );
+		scriptProfiler.AddEvent( evdef, sys->GetMillisecondsPrecise() - startTime );
+	} else {
+		eventEntity->ProcessEventArgPtr( evdef, data );
+	}
 
 	if ( !multiFrameEvent ) {
 		if ( popParms ) {
@@ -957,925 +994,1486 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	thread->ProcessEventArgPtr( evdef, data );
+	if ( profiling ) {
+		double startTime = sys->GetMillisecondsPrecise();
+		thread->ProcessEventArgPtr( evdef, data );
+		scriptProfiler.AddEvent( evdef, sys->GetMillisecondsPrecise() - startTime );
+	} else {
+		thread->ProcessEventArgPtr( evdef, data );
+	}
 	if ( popParms ) {
 		PopParms( popParms );
 	}
 	popParms = 0;
 }
 
+/*
+================
+idInterpreter::ProfileSync
+
+Drops the totals and call frames of an earlier profiler session.
+================
+*/
+void idInterpreter::ProfileSync( void ) {
+	if ( profileSession != scriptProfiler.GetSession() ) {
+		profileSession = scriptProfiler.GetSession();
+		profileInstructions = 0;
+		profileTotalInstructions = 0;
+		profileTotalTime = 0.0;
+	}
+}
+
+/*
+================
+idInterpreter::ProfileSegment
+
+Adds the instructions and time since the current function was entered
+or resumed to the function.
+================
+*/
+void idInterpreter::ProfileSegment( void ) {
+	double now = sys->GetMillisecondsPrecise();
+	double time = now - profileSegmentStart;
+
+	if ( currentFunction ) {
+		scriptProfiler.AddExclusive( currentFunction, profileInstructions, time );
+	}
+	profileTotalInstructions += profileInstructions;
+	profileTotalTime += time;
+	profileInstructions = 0;
+	profileSegmentStart = now;
+}
+
 /*
 ====================
-idInterpreter::Execute
+idInterpreter::ExecuteStatement
 ====================
 */
-bool idInterpreter::Execute( void ) {
+void idInterpreter::ExecuteStatement( const statement_t *st ) {
 	varEval_t	var_a;
 	varEval_t	var_b;
 	varEval_t	var_c;
 	varEval_t	var;
-	statement_t	*st;
-	int			runaway;
 	idThread	*newThread;
 	float		floatVal;
 	idScriptObject *obj;
 	const function_t *func;
 
-	if ( threadDying || !currentFunction ) {
-		return true;
-	}
+	switch( st->op ) {
+	case OP_RETURN:
+		LeaveFunction( st->a );
+		break;
 
-	if ( multiFrameEvent ) {
-		// move to previous instruction and call it again
-		instructionPointer--;
-	}
+	case OP_THREAD:
+		newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
+		newThread->Start();
 
-	runaway = 5000000;
+		// return the thread number to the script
+		gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
+		PopParms( st->b->value.argSize );
+		break;
 
-	doneProcessing = false;
-	while( !doneProcessing && !threadDying ) {
-		instructionPointer++;
+	case OP_OBJTHREAD:
+		var_a = GetVariable( st->a );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
+			assert( st->c->value.argSize == func->parmTotal );
+			newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
+			newThread->Start();
 
-		if ( !--runaway ) {
-			Error( "runaway loop error" );
+			// return the thread number to the script
+			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
+		} else {
+			// return a null thread to the script
+			gameLocal.program.ReturnFloat( 0.0f );
 		}
+		PopParms( st->c->value.argSize );
+		break;
 
-		// next statement
-		st = &gameLocal.program.GetStatement( instructionPointer );
+	case OP_CALL:
+		EnterFunction( st->a->value.functionPtr, false );
+		break;
 
-		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
-			&& g_debugScript.GetBool( ) ) 
-		{
-			static int lastLineNumber = -1;
-			if ( lastLineNumber != gameLocal.program.GetStatement ( instructionPointer ).linenumber ) {
-				gameLocal.Printf ( "%s (%d)\n", 
-					gameLocal.program.GetFilename ( gameLocal.program.GetStatement ( instructionPointer ).file ),
-					gameLocal.program.GetStatement ( instructionPointer ).linenumber
-					);
-				lastLineNumber = gameLocal.program.GetStatement ( instructionPointer ).linenumber;
-			}
+	case OP_EVENTCALL:
+		CallEvent( st->a->value.functionPtr, st->b->value.argSize );
+		break;
+
+	case OP_OBJECTCALL:
+		var_a = GetVariable( st->a );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
+			EnterFunction( func, false );
+		} else {
+			// return a 'safe' value
+			gameLocal.program.ReturnVector( vec3_zero );
+			gameLocal.program.ReturnString( "" );
+			PopParms( st->c->value.argSize );
 		}
+		break;
 
-		switch( st->op ) {
-		case OP_RETURN:
-			LeaveFunction( st->a );
-			break;
+	case OP_SYSCALL:
+		CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
+		break;
 
-		case OP_THREAD:
-			newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
-			newThread->Start();
+	case OP_IFNOT:
+		var_a = GetVariable( st->a );
+		if ( *var_a.intPtr == 0 ) {
+			NextInstruction( instructionPointer + st->b->value.jumpOffset );
+		}
+		break;
 
-			// return the thread number to the script
-			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
-			PopParms( st->b->value.argSize );
-			break;
+	case OP_IF:
+		var_a = GetVariable( st->a );
+		if ( *var_a.intPtr != 0 ) {
+			NextInstruction( instructionPointer + st->b->value.jumpOffset );
+		}
+		break;
 
-		case OP_OBJTHREAD:
-			var_a = GetVariable( st->a );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
-				assert( st->c->value.argSize == func->parmTotal );
-				newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
-				newThread->Start();
-
-				// return the thread number to the script
-				gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
-			} else {
-				// return a null thread to the script
-				gameLocal.program.ReturnFloat( 0.0f );
-			}
-			PopParms( st->c->value.argSize );
-			break;
+	case OP_GOTO:
+		NextInstruction( instructionPointer + st->a->value.jumpOffset );
+		break;
 
-		case OP_CALL:
-			EnterFunction( st->a->value.functionPtr, false );
-			break;
+	case OP_ADD_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
+		break;
 
-		case OP_EVENTCALL:
-			CallEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+	case OP_ADD_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+		break;
 
-		case OP_OBJECTCALL:
-			var_a = GetVariable( st->a );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
-				EnterFunction( func, false );
-			} else {
-				// return a 'safe' value
-				gameLocal.program.ReturnVector( vec3_zero );
-				gameLocal.program.ReturnString( "" );
-				PopParms( st->c->value.argSize );
-			}
-			break;
+	case OP_ADD_S:
+		SetString( st->c, GetString( st->a ) );
+		AppendString( st->c, GetString( st->b ) );
+		break;
 
-		case OP_SYSCALL:
-			CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+	case OP_ADD_FS:
+		var_a = GetVariable( st->a );
+		SetString( st->c, FloatToString( *var_a.floatPtr ) );
+		AppendString( st->c, GetString( st->b ) );
+		break;
 
-		case OP_IFNOT:
-			var_a = GetVariable( st->a );
-			if ( *var_a.intPtr == 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
-			}
-			break;
+	case OP_ADD_SF:
+		var_b = GetVariable( st->b );
+		SetString( st->c, GetString( st->a ) );
+		AppendString( st->c, FloatToString( *var_b.floatPtr ) );
+		break;
 
-		case OP_IF:
-			var_a = GetVariable( st->a );
-			if ( *var_a.intPtr != 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
-			}
-			break;
+	case OP_ADD_VS:
+		var_a = GetVariable( st->a );
+		SetString( st->c, var_a.vectorPtr->ToString() );
+		AppendString( st->c, GetString( st->b ) );
+		break;
 
-		case OP_GOTO:
-			NextInstruction( instructionPointer + st->a->value.jumpOffset );
-			break;
+	case OP_ADD_SV:
+		var_b = GetVariable( st->b );
+		SetString( st->c, GetString( st->a ) );
+		AppendString( st->c, var_b.vectorPtr->ToString() );
+		break;
 
-		case OP_ADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
-			break;
+	case OP_SUB_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
+		break;
 
-		case OP_ADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
-			break;
+	case OP_SUB_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
+		break;
 
-		case OP_ADD_S:
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
+	case OP_MUL_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
+		break;
 
-		case OP_ADD_FS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, FloatToString( *var_a.floatPtr ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
+	case OP_MUL_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
+		break;
 
-		case OP_ADD_SF:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, FloatToString( *var_b.floatPtr ) );
-			break;
+	case OP_MUL_FV:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
+		break;
 
-		case OP_ADD_VS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, var_a.vectorPtr->ToString() );
-			AppendString( st->c, GetString( st->b ) );
-			break;
+	case OP_MUL_VF:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
+		break;
 
-		case OP_ADD_SV:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, var_b.vectorPtr->ToString() );
-			break;
+	case OP_DIV_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
 
-		case OP_SUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
-			break;
+		if ( *var_b.floatPtr == 0.0f ) {
+			Warning( "Divide by zero" );
+			*var_c.floatPtr = idMath::INFINITY;
+		} else {
+			*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
+		}
+		break;
 
-		case OP_SUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
-			break;
+	case OP_MOD_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable ( st->c );
 
-		case OP_MUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
-			break;
+		if ( *var_b.floatPtr == 0.0f ) {
+			Warning( "Divide by zero" );
+			*var_c.floatPtr = *var_a.floatPtr;
+		} else {
+			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
+		}
+		break;
 
-		case OP_MUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
-			break;
+	case OP_BITAND:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
+		break;
 
-		case OP_MUL_FV:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
-			break;
+	case OP_BITOR:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
+		break;
 
-		case OP_MUL_VF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
-			break;
+	case OP_GE:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+		break;
 
-		case OP_DIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+	case OP_LE:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+		break;
 
-			if ( *var_b.floatPtr == 0.0f ) {
-				Warning( "Divide by zero" );
-				*var_c.floatPtr = idMath::INFINITY;
-			} else {
-				*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
-			}
-			break;
+	case OP_GT:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+		break;
 
-		case OP_MOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable ( st->c );
+	case OP_LT:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+		break;
 
-			if ( *var_b.floatPtr == 0.0f ) {
-				Warning( "Divide by zero" );
-				*var_c.floatPtr = *var_a.floatPtr;
-			} else {
-				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
-			}
-			break;
+	case OP_AND:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
+		break;
 
-		case OP_BITAND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
-			break;
+	case OP_AND_BOOLF:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
+		break;
 
-		case OP_BITOR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
-			break;
+	case OP_AND_FBOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
+		break;
 
-		case OP_GE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
-			break;
+	case OP_AND_BOOLBOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
+		break;
 
-		case OP_LE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
-			break;
+	case OP_OR:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
+		break;
 
-		case OP_GT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
-			break;
+	case OP_OR_BOOLF:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
+		break;
 
-		case OP_LT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
-			break;
+	case OP_OR_FBOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
+		break;
 
-		case OP_AND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
-			break;
+	case OP_OR_BOOLBOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
+		break;
 
-		case OP_AND_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
-			break;
+	case OP_NOT_BOOL:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.intPtr == 0 );
+		break;
 
-		case OP_AND_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
-			break;
+	case OP_NOT_F:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+		break;
 
-		case OP_AND_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
-			break;
+	case OP_NOT_V:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
+		break;
 
-		case OP_OR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
-			break;
+	case OP_NOT_S:
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
+		break;
 
-		case OP_OR_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
-			break;
+	case OP_NOT_ENT:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
+		break;
 
-		case OP_OR_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
-			break;
+	case OP_NEG_F:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = -*var_a.floatPtr;
+		break;
 
-		case OP_OR_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
-			break;
+	case OP_NEG_V:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.vectorPtr = -*var_a.vectorPtr;
+		break;
 
-		case OP_NOT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.intPtr == 0 );
-			break;
+	case OP_INT_F:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
+		break;
 
-		case OP_NOT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
-			break;
+	case OP_EQ_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+		break;
 
-		case OP_NOT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
-			break;
+	case OP_EQ_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
+		break;
 
-		case OP_NOT_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
-			break;
+	case OP_EQ_S:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
+		break;
 
-		case OP_NOT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
-			break;
+	case OP_EQ_E:
+	case OP_EQ_EO:
+	case OP_EQ_OE:
+	case OP_EQ_OO:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+		break;
 
-		case OP_NEG_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = -*var_a.floatPtr;
-			break;
+	case OP_NE_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+		break;
 
-		case OP_NEG_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.vectorPtr = -*var_a.vectorPtr;
-			break;
+	case OP_NE_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
+		break;
 
-		case OP_INT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
-			break;
+	case OP_NE_S:
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
+		break;
 
-		case OP_EQ_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
-			break;
+	case OP_NE_E:
+	case OP_NE_EO:
+	case OP_NE_OE:
+	case OP_NE_OO:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+		break;
 
-		case OP_EQ_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
-			break;
+	case OP_UADD_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr += *var_a.floatPtr;
+		break;
 
-		case OP_EQ_S:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
-			break;
+	case OP_UADD_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.vectorPtr += *var_a.vectorPtr;
+		break;
 
-		case OP_EQ_E:
-		case OP_EQ_EO:
-		case OP_EQ_OE:
-		case OP_EQ_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
-			break;
+	case OP_USUB_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr -= *var_a.floatPtr;
+		break;
 
-		case OP_NE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
-			break;
+	case OP_USUB_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.vectorPtr -= *var_a.vectorPtr;
+		break;
 
-		case OP_NE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
-			break;
+	case OP_UMUL_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr *= *var_a.floatPtr;
+		break;
 
-		case OP_NE_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
-			break;
+	case OP_UMUL_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.vectorPtr *= *var_a.floatPtr;
+		break;
 
-		case OP_NE_E:
-		case OP_NE_EO:
-		case OP_NE_OE:
-		case OP_NE_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
-			break;
+	case OP_UDIV_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
 
-		case OP_UADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr += *var_a.floatPtr;
-			break;
+		if ( *var_a.floatPtr == 0.0f ) {
+			Warning( "Divide by zero" );
+			*var_b.floatPtr = idMath::INFINITY;
+		} else {
+			*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
+		}
+		break;
 
-		case OP_UADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.vectorPtr += *var_a.vectorPtr;
-			break;
+	case OP_UDIV_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
 
-		case OP_USUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr -= *var_a.floatPtr;
-			break;
+		if ( *var_a.floatPtr == 0.0f ) {
+			Warning( "Divide by zero" );
+			var_b.vectorPtr->Set( idMath::INFINITY, idMath::INFINITY, idMath::INFINITY );
+		} else {
+			*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
+		}
+		break;
 
-		case OP_USUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.vectorPtr -= *var_a.vectorPtr;
-			break;
+	case OP_UMOD_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
 
-		case OP_UMUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr *= *var_a.floatPtr;
-			break;
+		if ( *var_a.floatPtr == 0.0f ) {
+			Warning( "Divide by zero" );
+			*var_b.floatPtr = *var_a.floatPtr;
+		} else {
+			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
+		}
+		break;
 
-		case OP_UMUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.vectorPtr *= *var_a.floatPtr;
-			break;
+	case OP_UOR_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
+		break;
 
-		case OP_UDIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+	case OP_UAND_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
+		break;
 
-			if ( *var_a.floatPtr == 0.0f ) {
-				Warning( "Divide by zero" );
-				*var_b.floatPtr = idMath::INFINITY;
-			} else {
-				*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
-			}
-			break;
+	case OP_UINC_F:
+		var_a = GetVariable( st->a );
+		( *var_a.floatPtr )++;
+		break;
 
-		case OP_UDIV_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+	case OP_UINCP_F:
+		var_a = GetVariable( st->a );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			( *var.floatPtr )++;
+		}
+		break;
 
-			if ( *var_a.floatPtr == 0.0f ) {
-				Warning( "Divide by zero" );
-				var_b.vectorPtr->Set( idMath::INFINITY, idMath::INFINITY, idMath::INFINITY );
-			} else {
-				*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
-			}
-			break;
+	case OP_UDEC_F:
+		var_a = GetVariable( st->a );
+		( *var_a.floatPtr )--;
+		break;
 
-		case OP_UMOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+	case OP_UDECP_F:
+		var_a = GetVariable( st->a );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			( *var.floatPtr )--;
+		}
+		break;
 
-			if ( *var_a.floatPtr == 0.0f ) {
-				Warning( "Divide by zero" );
-				*var_b.floatPtr = *var_a.floatPtr;
-			} else {
-				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
-			}
-			break;
+	case OP_COMP_F:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
+		break;
+
+	case OP_STORE_F:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr = *var_a.floatPtr;
+		break;
+
+	case OP_STORE_ENT:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+		break;
+
+	case OP_STORE_BOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.intPtr = *var_a.intPtr;
+		break;
+
+	case OP_STORE_OBJENT:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( !obj ) {
+			*var_b.entityNumberPtr = 0;
+		} else if ( !obj->GetTypeDef()->Inherits( st->b->TypeDef() ) ) {
+			//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->b->TypeDef()->Name() );
+			*var_b.entityNumberPtr = 0;
+		} else {
+			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+		}
+		break;
+
+	case OP_STORE_OBJ:
+	case OP_STORE_ENTOBJ:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+		break;
+
+	case OP_STORE_S:
+		SetString( st->b, GetString( st->a ) );
+		break;
+
+	case OP_STORE_V:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.vectorPtr = *var_a.vectorPtr;
+		break;
+
+	case OP_STORE_FTOS:
+		var_a = GetVariable( st->a );
+		SetString( st->b, FloatToString( *var_a.floatPtr ) );
+		break;
+
+	case OP_STORE_BTOS:
+		var_a = GetVariable( st->a );
+		SetString( st->b, *var_a.intPtr ? "true" : "false" );
+		break;
+
+	case OP_STORE_VTOS:
+		var_a = GetVariable( st->a );
+		SetString( st->b, var_a.vectorPtr->ToString() );
+		break;
+
+	case OP_STORE_FTOBOOL:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		if ( *var_a.floatPtr != 0.0f ) {
+			*var_b.intPtr = 1;
+		} else {
+			*var_b.intPtr = 0;
+		}
+		break;
+
+	case OP_STORE_BOOLTOF:
+		var_a = GetVariable( st->a );
+		var_b = GetVariable( st->b );
+		*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
+		break;
 
-		case OP_UOR_F:
+	case OP_STOREP_F:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
-			break;
+			*var_b.evalPtr->floatPtr = *var_a.floatPtr;
+		}
+		break;
 
-		case OP_UAND_F:
+	case OP_STOREP_ENT:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
-			break;
+			*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
+		}
+		break;
 
-		case OP_UINC_F:
+	case OP_STOREP_FLD:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
 			var_a = GetVariable( st->a );
-			( *var_a.floatPtr )++;
-			break;
+			*var_b.evalPtr->intPtr = *var_a.intPtr;
+		}
+		break;
 
-		case OP_UINCP_F:
+	case OP_STOREP_BOOL:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
 			var_a = GetVariable( st->a );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				( *var.floatPtr )++;
-			}
-			break;
+			*var_b.evalPtr->intPtr = *var_a.intPtr;
+		}
+		break;
 
-		case OP_UDEC_F:
+	case OP_STOREP_S:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+			idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
+		}
+		break;
+
+	case OP_STOREP_V:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
 			var_a = GetVariable( st->a );
-			( *var_a.floatPtr )--;
-			break;
+			*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
+		}
+		break;
 
-		case OP_UDECP_F:
+	case OP_STOREP_FTOS:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
 			var_a = GetVariable( st->a );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				( *var.floatPtr )--;
+			idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
+		}
+		break;
+
+	case OP_STOREP_BTOS:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
+			var_a = GetVariable( st->a );
+			if ( *var_a.floatPtr != 0.0f ) {
+				idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
+			} else {
+				idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
 			}
-			break;
+		}
+		break;
 
-		case OP_COMP_F:
+	case OP_STOREP_VTOS:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
 			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
-			break;
+			idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
+		}
+		break;
 
-		case OP_STORE_F:
+	case OP_STOREP_FTOBOOL:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr = *var_a.floatPtr;
-			break;
+			if ( *var_a.floatPtr != 0.0f ) {
+				*var_b.evalPtr->intPtr = 1;
+			} else {
+				*var_b.evalPtr->intPtr = 0;
+			}
+		}
+		break;
 
-		case OP_STORE_ENT:
+	case OP_STOREP_BOOLTOF:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+			*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
+		}
+		break;
 
-		case OP_STORE_BOOL:
+	case OP_STOREP_OBJ:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.intPtr = *var_a.intPtr;
-			break;
+			*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
+		}
+		break;
 
-		case OP_STORE_OBJENT:
+	case OP_STOREP_OBJENT:
+		var_b = GetVariable( st->b );
+		if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
 			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
-				*var_b.entityNumberPtr = 0;
-			} else if ( !obj->GetTypeDef()->Inherits( st->b->TypeDef() ) ) {
-				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->b->TypeDef()->Name() );
-				*var_b.entityNumberPtr = 0;
+				*var_b.evalPtr->entityNumberPtr = 0;
+
+			// st->b points to type_pointer, which is just a temporary that gets its type reassigned, so we store the real type in st->c
+			// so that we can do a type check during run time since we don't know what type the script object is at compile time because it
+			// comes from an entity
+			} else if ( !obj->GetTypeDef()->Inherits( st->c->TypeDef() ) ) {
+				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->c->TypeDef()->Name() );
+				*var_b.evalPtr->entityNumberPtr = 0;
 			} else {
-				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+		}
+		break;
 
-		case OP_STORE_OBJ:
-		case OP_STORE_ENTOBJ:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+	case OP_ADDRESS:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var_c.evalPtr->bytePtr = &obj->data[ st->b->value.ptrOffset ];
+		} else {
+			var_c.evalPtr->bytePtr = NULL;
+		}
+		break;
 
-		case OP_STORE_S:
-			SetString( st->b, GetString( st->a ) );
-			break;
+	case OP_INDIRECT_F:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			*var_c.floatPtr = *var.floatPtr;
+		} else {
+			*var_c.floatPtr = 0.0f;
+		}
+		break;
 
-		case OP_STORE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.vectorPtr = *var_a.vectorPtr;
-			break;
+	case OP_INDIRECT_ENT:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			*var_c.entityNumberPtr = *var.entityNumberPtr;
+		} else {
+			*var_c.entityNumberPtr = 0;
+		}
+		break;
 
-		case OP_STORE_FTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, FloatToString( *var_a.floatPtr ) );
-			break;
+	case OP_INDIRECT_BOOL:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			*var_c.intPtr = *var.intPtr;
+		} else {
+			*var_c.intPtr = 0;
+		}
+		break;
 
-		case OP_STORE_BTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, *var_a.intPtr ? "true" : "false" );
-			break;
+	case OP_INDIRECT_S:
+		var_a = GetVariable( st->a );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			SetString( st->c, var.stringPtr );
+		} else {
+			SetString( st->c, "" );
+		}
+		break;
 
-		case OP_STORE_VTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, var_a.vectorPtr->ToString() );
-			break;
+	case OP_INDIRECT_V:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( obj ) {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			*var_c.vectorPtr = *var.vectorPtr;
+		} else {
+			var_c.vectorPtr->Zero();
+		}
+		break;
 
-		case OP_STORE_FTOBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			if ( *var_a.floatPtr != 0.0f ) {
-				*var_b.intPtr = 1;
-			} else {
-				*var_b.intPtr = 0;
-			}
-			break;
+	case OP_INDIRECT_OBJ:
+		var_a = GetVariable( st->a );
+		var_c = GetVariable( st->c );
+		obj = GetScriptObject( *var_a.entityNumberPtr );
+		if ( !obj ) {
+			*var_c.entityNumberPtr = 0;
+		} else {
+			var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+			*var_c.entityNumberPtr = *var.entityNumberPtr;
+		}
+		break;
 
-		case OP_STORE_BOOLTOF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
-			break;
+	case OP_PUSH_F:
+		var_a = GetVariable( st->a );
+		Push( *var_a.intPtr );
+		break;
 
-		case OP_STOREP_F:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->floatPtr = *var_a.floatPtr;
-			}
-			break;
+	case OP_PUSH_FTOS:
+		var_a = GetVariable( st->a );
+		PushString( FloatToString( *var_a.floatPtr ) );
+		break;
 
-		case OP_STOREP_ENT:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
-			}
-			break;
+	case OP_PUSH_BTOF:
+		var_a = GetVariable( st->a );
+		floatVal = *var_a.intPtr;
+		Push( *reinterpret_cast<int *>( &floatVal ) );
+		break;
 
-		case OP_STOREP_FLD:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->intPtr = *var_a.intPtr;
-			}
-			break;
+	case OP_PUSH_FTOB:
+		var_a = GetVariable( st->a );
+		if ( *var_a.floatPtr != 0.0f ) {
+			Push( 1 );
+		} else {
+			Push( 0 );
+		}
+		break;
 
-		case OP_STOREP_BOOL:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->intPtr = *var_a.intPtr;
-			}
-			break;
+	case OP_PUSH_VTOS:
+		var_a = GetVariable( st->a );
+		PushString( var_a.vectorPtr->ToString() );
+		break;
 
-		case OP_STOREP_S:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
-			}
-			break;
+	case OP_PUSH_BTOS:
+		var_a = GetVariable( st->a );
+		PushString( *var_a.intPtr ? "true" : "false" );
+		break;
 
-		case OP_STOREP_V:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
-			}
-			break;
+	case OP_PUSH_ENT:
+		var_a = GetVariable( st->a );
+		Push( *var_a.entityNumberPtr );
+		break;
 
-		case OP_STOREP_FTOS:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
-				idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
-			}
-			break;
+	case OP_PUSH_S:
+		PushString( GetString( st->a ) );
+		break;
 
-		case OP_STOREP_BTOS:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
-				if ( *var_a.floatPtr != 0.0f ) {
-					idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
-				} else {
-					idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
-				}
-			}
-			break;
+	case OP_PUSH_V:
+		var_a = GetVariable( st->a );
+		PushVector(*var_a.vectorPtr);
+		break;
 
-		case OP_STOREP_VTOS:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
-				idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
-			}
-			break;
+	case OP_PUSH_OBJ:
+		var_a = GetVariable( st->a );
+		Push( *var_a.entityNumberPtr );
+		break;
 
-		case OP_STOREP_FTOBOOL:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
-				if ( *var_a.floatPtr != 0.0f ) {
-					*var_b.evalPtr->intPtr = 1;
-				} else {
-					*var_b.evalPtr->intPtr = 0;
-				}
-			}
-			break;
+	case OP_PUSH_OBJENT:
+		var_a = GetVariable( st->a );
+		Push( *var_a.entityNumberPtr );
+		break;
 
-		case OP_STOREP_BOOLTOF:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
-			}
-			break;
+	case OP_BREAK:
+	case OP_CONTINUE:
+	default:
+		Error( "Bad opcode %i", st->op );
+		break;
+	}
+}
 
-		case OP_STOREP_OBJ:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
-				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
-			}
-			break;
+/*
+====================
+idInterpreter::ExecuteCompiled
 
-		case OP_STOREP_OBJENT:
-			var_b = GetVariable( st->b );
-			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
-				obj = GetScriptObject( *var_a.entityNumberPtr );
-				if ( !obj ) {
-					*var_b.evalPtr->entityNumberPtr = 0;
-
-				// st->b points to type_pointer, which is just a temporary that gets its type reassigned, so we store the real type in st->c
-				// so that we can do a type check during run time since we don't know what type the script object is at compile time because it
-				// comes from an entity
-				} else if ( !obj->GetTypeDef()->Inherits( st->c->TypeDef() ) ) {
-					//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->c->TypeDef()->Name() );
-					*var_b.evalPtr->entityNumberPtr = 0;
-				} else {
-					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
-				}
-			}
-			break;
+Threaded interpreter over the compiled statements.  Uses computed gotos
+where the compiler supports them and a switch otherwise.  Statements
+without a handler of their own, including everything that can call
+functions or events, are run by ExecuteStatement.
+====================
+*/
+#if defined( __GNUC__ )
+#define CS_THREADED_DISPATCH
+#endif
+
+#ifdef CS_THREADED_DISPATCH
+#define CS_HANDLER( handler )	label_##handler
+#else
+#define CS_HANDLER( handler )	case handler
+#endif
+
+// moves on to the statement following a superinstruction
+#define CS_NEXT_STATEMENT()							\
+	instructionPointer++;							\
+	if ( !--runaway ) {								\
+		Error( "runaway loop error" );				\
+	}												\
+	if ( profiling ) {								\
+		profileInstructions++;						\
+	}												\
+	cs = &statements[ instructionPointer ]
+
+void idInterpreter::ExecuteCompiled( int runaway ) {
+	const compiledStatement_t *statements;
+	const compiledStatement_t *cs;
+	varEval_t	var_a;
+	varEval_t	var_b;
+	varEval_t	var_c;
+	varEval_t	var;
+	idScriptObject *obj;
+	bool		result;
+
+#ifdef CS_THREADED_DISPATCH
+	// must be in the same order as compiledHandler_t
+	static const void * const handlers[ NUM_COMPILED_HANDLERS ] = {
+		&&label_CS_GENERIC,
+		&&label_CS_GOTO,
+		&&label_CS_IF,
+		&&label_CS_IFNOT,
+		&&label_CS_ADD_F,
+		&&label_CS_SUB_F,
+		&&label_CS_MUL_F,
+		&&label_CS_ADD_V,
+		&&label_CS_SUB_V,
+		&&label_CS_MUL_V,
+		&&label_CS_MUL_FV,
+		&&label_CS_MUL_VF,
+		&&label_CS_EQ_F,
+		&&label_CS_NE_F,
+		&&label_CS_LT,
+		&&label_CS_LE,
+		&&label_CS_GT,
+		&&label_CS_GE,
+		&&label_CS_EQ_E,
+		&&label_CS_NE_E,
+		&&label_CS_AND,
+		&&label_CS_OR,
+		&&label_CS_AND_BOOLBOOL,
+		&&label_CS_OR_BOOLBOOL,
+		&&label_CS_NOT_F,
+		&&label_CS_NOT_BOOL,
+		&&label_CS_NEG_F,
+		&&label_CS_UADD_F,
+		&&label_CS_USUB_F,
+		&&label_CS_UINC_F,
+		&&label_CS_UDEC_F,
+		&&label_CS_STORE_INT,
+		&&label_CS_STORE_V,
+		&&label_CS_ADDRESS,
+		&&label_CS_STOREP_INT,
+		&&label_CS_STOREP_V,
+		&&label_CS_INDIRECT_INT,
+		&&label_CS_INDIRECT_V,
+		&&label_CS_PUSH_INT,
+		&&label_CS_PUSH_V,
+		&&label_CS_EQ_F_IFNOT,
+		&&label_CS_NE_F_IFNOT,
+		&&label_CS_LT_IFNOT,
+		&&label_CS_LE_IFNOT,
+		&&label_CS_GT_IFNOT,
+		&&label_CS_GE_IFNOT,
+		&&label_CS_EQ_E_IFNOT,
+		&&label_CS_NE_E_IFNOT,
+		&&label_CS_ADDRESS_STOREP_INT,
+		&&label_CS_ADDRESS_STOREP_V
+	};
+#endif
+
+next:
+	// only generic statements can end the thread or compile new statements
+	if ( doneProcessing || threadDying ) {
+		return;
+	}
+	statements = gameLocal.program.GetCompiledStatements();
 
-		case OP_ADDRESS:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var_c.evalPtr->bytePtr = &obj->data[ st->b->value.ptrOffset ];
-			} else {
-				var_c.evalPtr->bytePtr = NULL;
-			}
-			break;
+fetch:
+	instructionPointer++;
 
-		case OP_INDIRECT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				*var_c.floatPtr = *var.floatPtr;
-			} else {
-				*var_c.floatPtr = 0.0f;
-			}
-			break;
+	if ( !--runaway ) {
+		Error( "runaway loop error" );
+	}
 
-		case OP_INDIRECT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				*var_c.entityNumberPtr = *var.entityNumberPtr;
-			} else {
-				*var_c.entityNumberPtr = 0;
-			}
-			break;
+	if ( profiling ) {
+		profileInstructions++;
+	}
 
-		case OP_INDIRECT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				*var_c.intPtr = *var.intPtr;
-			} else {
-				*var_c.intPtr = 0;
-			}
-			break;
+	cs = &statements[ instructionPointer ];
 
-		case OP_INDIRECT_S:
-			var_a = GetVariable( st->a );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				SetString( st->c, var.stringPtr );
-			} else {
-				SetString( st->c, "" );
-			}
-			break;
+#ifdef CS_THREADED_DISPATCH
+	goto *handlers[ cs->handler ];
+#else
+	switch( cs->handler ) {
+	default:
+#endif
 
-		case OP_INDIRECT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				*var_c.vectorPtr = *var.vectorPtr;
-			} else {
-				var_c.vectorPtr->Zero();
-			}
-			break;
+CS_HANDLER( CS_GENERIC ):
+	ExecuteStatement( &gameLocal.program.GetStatement( instructionPointer ) );
+	goto next;
 
-		case OP_INDIRECT_OBJ:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
-			obj = GetScriptObject( *var_a.entityNumberPtr );
-			if ( !obj ) {
-				*var_c.entityNumberPtr = 0;
-			} else {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				*var_c.entityNumberPtr = *var.entityNumberPtr;
-			}
-			break;
+CS_HANDLER( CS_GOTO ):
+	NextInstruction( instructionPointer + cs->a.value.jumpOffset );
+	goto fetch;
 
-		case OP_PUSH_F:
-			var_a = GetVariable( st->a );
-			Push( *var_a.intPtr );
-			break;
+CS_HANDLER( CS_IF ):
+	var_a = GetCompiledVariable( cs->a );
+	if ( *var_a.intPtr != 0 ) {
+		NextInstruction( instructionPointer + cs->b.value.jumpOffset );
+	}
+	goto fetch;
 
-		case OP_PUSH_FTOS:
-			var_a = GetVariable( st->a );
-			PushString( FloatToString( *var_a.floatPtr ) );
-			break;
+CS_HANDLER( CS_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	if ( *var_a.intPtr == 0 ) {
+		NextInstruction( instructionPointer + cs->b.value.jumpOffset );
+	}
+	goto fetch;
+
+CS_HANDLER( CS_ADD_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_SUB_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_MUL_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_ADD_V ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+	goto fetch;
+
+CS_HANDLER( CS_SUB_V ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
+	goto fetch;
+
+CS_HANDLER( CS_MUL_V ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
+	goto fetch;
+
+CS_HANDLER( CS_MUL_FV ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
+	goto fetch;
+
+CS_HANDLER( CS_MUL_VF ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_EQ_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_NE_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_LT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_LE ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_GT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_GE ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+	goto fetch;
+
+CS_HANDLER( CS_EQ_E ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+	goto fetch;
+
+CS_HANDLER( CS_NE_E ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+	goto fetch;
+
+CS_HANDLER( CS_AND ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
+	goto fetch;
+
+CS_HANDLER( CS_OR ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
+	goto fetch;
+
+CS_HANDLER( CS_AND_BOOLBOOL ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
+	goto fetch;
+
+CS_HANDLER( CS_OR_BOOLBOOL ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
+	goto fetch;
+
+CS_HANDLER( CS_NOT_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+	goto fetch;
+
+CS_HANDLER( CS_NOT_BOOL ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = ( *var_a.intPtr == 0 );
+	goto fetch;
+
+CS_HANDLER( CS_NEG_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = -*var_a.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_UADD_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	*var_b.floatPtr += *var_a.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_USUB_F ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	*var_b.floatPtr -= *var_a.floatPtr;
+	goto fetch;
+
+CS_HANDLER( CS_UINC_F ):
+	var_a = GetCompiledVariable( cs->a );
+	( *var_a.floatPtr )++;
+	goto fetch;
+
+CS_HANDLER( CS_UDEC_F ):
+	var_a = GetCompiledVariable( cs->a );
+	( *var_a.floatPtr )--;
+	goto fetch;
+
+CS_HANDLER( CS_STORE_INT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	*var_b.intPtr = *var_a.intPtr;
+	goto fetch;
+
+CS_HANDLER( CS_STORE_V ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	*var_b.vectorPtr = *var_a.vectorPtr;
+	goto fetch;
+
+CS_HANDLER( CS_ADDRESS ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	obj = GetScriptObject( *var_a.entityNumberPtr );
+	if ( obj ) {
+		var_c.evalPtr->bytePtr = &obj->data[ cs->b.value.ptrOffset ];
+	} else {
+		var_c.evalPtr->bytePtr = NULL;
+	}
+	goto fetch;
 
-		case OP_PUSH_BTOF:
-			var_a = GetVariable( st->a );
-			floatVal = *var_a.intPtr;
-			Push( *reinterpret_cast<int *>( &floatVal ) );
-			break;
+CS_HANDLER( CS_STOREP_INT ):
+	var_b = GetCompiledVariable( cs->b );
+	if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
+		var_a = GetCompiledVariable( cs->a );
+		*var_b.evalPtr->intPtr = *var_a.intPtr;
+	}
+	goto fetch;
 
-		case OP_PUSH_FTOB:
-			var_a = GetVariable( st->a );
-			if ( *var_a.floatPtr != 0.0f ) {
-				Push( 1 );
-			} else {
-				Push( 0 );
-			}
-			break;
+CS_HANDLER( CS_STOREP_V ):
+	var_b = GetCompiledVariable( cs->b );
+	if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
+		var_a = GetCompiledVariable( cs->a );
+		*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
+	}
+	goto fetch;
+
+CS_HANDLER( CS_INDIRECT_INT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	obj = GetScriptObject( *var_a.entityNumberPtr );
+	if ( obj ) {
+		var.bytePtr = &obj->data[ cs->b.value.ptrOffset ];
+		*var_c.intPtr = *var.intPtr;
+	} else {
+		*var_c.intPtr = 0;
+	}
+	goto fetch;
+
+CS_HANDLER( CS_INDIRECT_V ):
+	var_a = GetCompiledVariable( cs->a );
+	var_c = GetCompiledVariable( cs->c );
+	obj = GetScriptObject( *var_a.entityNumberPtr );
+	if ( obj ) {
+		var.bytePtr = &obj->data[ cs->b.value.ptrOffset ];
+		*var_c.vectorPtr = *var.vectorPtr;
+	} else {
+		var_c.vectorPtr->Zero();
+	}
+	goto fetch;
+
+CS_HANDLER( CS_PUSH_INT ):
+	var_a = GetCompiledVariable( cs->a );
+	Push( *var_a.intPtr );
+	goto fetch;
+
+CS_HANDLER( CS_PUSH_V ):
+	var_a = GetCompiledVariable( cs->a );
+	PushVector( *var_a.vectorPtr );
+	goto fetch;
+
+CS_HANDLER( CS_EQ_F_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr == *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_NE_F_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr != *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_LT_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr < *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_LE_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr <= *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_GT_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr > *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_GE_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.floatPtr >= *var_b.floatPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_EQ_E_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_NE_E_IFNOT ):
+	var_a = GetCompiledVariable( cs->a );
+	var_b = GetCompiledVariable( cs->b );
+	result = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
+	goto ifnot;
+
+CS_HANDLER( CS_ADDRESS_STOREP_INT ):
+	var = GetCompiledAddress( cs );
+	CS_NEXT_STATEMENT();
+	if ( var.bytePtr ) {
+		var_a = GetCompiledVariable( cs->a );
+		*var.intPtr = *var_a.intPtr;
+	}
+	goto fetch;
+
+CS_HANDLER( CS_ADDRESS_STOREP_V ):
+	var = GetCompiledAddress( cs );
+	CS_NEXT_STATEMENT();
+	if ( var.bytePtr ) {
+		var_a = GetCompiledVariable( cs->a );
+		*var.vectorPtr = *var_a.vectorPtr;
+	}
+	goto fetch;
 
-		case OP_PUSH_VTOS:
-			var_a = GetVariable( st->a );
-			PushString( var_a.vectorPtr->ToString() );
-			break;
+#ifndef CS_THREADED_DISPATCH
+	}
+#endif
+
+ifnot:
+	// the comparison result is still stored for anything reading it later
+	var_c = GetCompiledVariable( cs->c );
+	*var_c.floatPtr = result;
+	CS_NEXT_STATEMENT();
+	if ( !result ) {
+		NextInstruction( instructionPointer + cs->b.value.jumpOffset );
+	}
+	goto fetch;
+}
 
-		case OP_PUSH_BTOS:
-			var_a = GetVariable( st->a );
-			PushString( *var_a.intPtr ? "true" : "false" );
-			break;
+#undef CS_NEXT_STATEMENT
+#undef CS_HANDLER
+#undef CS_THREADED_DISPATCH
 
-		case OP_PUSH_ENT:
-			var_a = GetVariable( st->a );
-			Push( *var_a.entityNumberPtr );
-			break;
 
-		case OP_PUSH_S:
-			PushString( GetString( st->a ) );
-			break;
+/*
+====================
+idInterpreter::Execute
+====================
+*/
+bool idInterpreter::Execute( void ) {
+	statement_t	*st;
+	int			runaway;
 
-		case OP_PUSH_V:
-			var_a = GetVariable( st->a );
-			PushVector(*var_a.vectorPtr);
-			break;
+	if ( threadDying || !currentFunction ) {
+		return true;
+	}
 
-		case OP_PUSH_OBJ:
-			var_a = GetVariable( st->a );
-			Push( *var_a.entityNumberPtr );
-			break;
+	if ( multiFrameEvent ) {
+		// move to previous instruction and call it again
+		instructionPointer--;
+	}
 
-		case OP_PUSH_OBJENT:
-			var_a = GetVariable( st->a );
-			Push( *var_a.entityNumberPtr );
-			break;
+	runaway = 5000000;
 
-		case OP_BREAK:
-		case OP_CONTINUE:
-		default:
-			Error( "Bad opcode %i", st->op );
-			break;
+	profiling = scriptProfiler.IsRunning();
+	if ( profiling ) {
+		ProfileSync();
+		profileInstructions = 0;
+		profileSegmentStart = sys->GetMillisecondsPrecise();
+	}
+
+	doneProcessing = false;
+
+	// the threaded interpreter runs until the thread is done processing, which skips the
+	// classic loop below.  it doesn't report to the script debugger.
+	if ( g_scriptCompiled.GetBool() && !debug && !g_debugScript.GetBool() && !com_enableDebuggerServer.GetBool() ) {
+		ExecuteCompiled( runaway );
+	}
+
+	while( !doneProcessing && !threadDying ) {
+		instructionPointer++;
+
+		if ( !--runaway ) {
+			Error( "runaway loop error" );
 		}
+
+		if ( profiling ) {
+			profileInstructions++;
+		}
+
+		// next statement
+		st = &gameLocal.program.GetStatement( instructionPointer );
+
+		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
+			&& g_debugScript.GetBool( ) ) 
+		{
+			static int lastLineNumber = -1;
+			if ( lastLineNumber != gameLocal.program.GetStatement ( instructionPointer ).linenumber ) {
+				gameLocal.Printf ( "%s (%d)\n", 
+					gameLocal.program.GetFilename ( gameLocal.program.GetStatement ( instructionPointer ).file ),
+					gameLocal.program.GetStatement ( instructionPointer ).linenumber
+					);
+				lastLineNumber = gameLocal.program.GetStatement ( instructionPointer ).linenumber;
+			}
+		}
+
+		ExecuteStatement( st );
+	}
+
+	if ( profiling ) {
+		ProfileSegment();
+		profiling = false;
 	}
 
 	return threadDying;
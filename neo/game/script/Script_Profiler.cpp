@@ -0,0 +1,335 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "../Game_local.h"
+
+idScriptProfiler	scriptProfiler;
+
+typedef struct profileSort_s {
+	int					index;
+	double				time;
+} profileSort_t;
+
+/*
+================
+ProfileSortCompare
+================
+*/
+static int ProfileSortCompare( const profileSort_t *a, const profileSort_t *b ) {
+	if ( a->time > b->time ) {
+		return -1;
+	}
+	if ( a->time < b->time ) {
+		return 1;
+	}
+	return a->index - b->index;
+}
+
+/*
+================
+idScriptProfiler::idScriptProfiler
+================
+*/
+idScriptProfiler::idScriptProfiler( void ) {
+	running = false;
+	session = 0;
+	startTime = 0.0;
+	runTime = 0.0;
+}
+
+/*
+================
+idScriptProfiler::Start
+================
+*/
+void idScriptProfiler::Start( void ) {
+	if ( running ) {
+		return;
+	}
+	if ( functions.Num() != MAX_FUNCS ) {
+		Clear();
+	}
+	running = true;
+	session++;
+	startTime = sys->GetMillisecondsPrecise();
+}
+
+/*
+================
+idScriptProfiler::Stop
+================
+*/
+void idScriptProfiler::Stop( void ) {
+	if ( !running ) {
+		return;
+	}
+	runTime += sys->GetMillisecondsPrecise() - startTime;
+	running = false;
+}
+
+/*
+================
+idScriptProfiler::Clear
+================
+*/
+void idScriptProfiler::Clear( void ) {
+	functions.SetNum( MAX_FUNCS );
+	memset( functions.Ptr(), 0, functions.MemoryUsed() );
+	events.SetNum( MAX_EVENTS );
+	memset( events.Ptr(), 0, events.MemoryUsed() );
+	runTime = 0.0;
+	startTime = sys->GetMillisecondsPrecise();
+}
+
+/*
+================
+idScriptProfiler::ClearFunctions
+================
+*/
+void idScriptProfiler::ClearFunctions( int firstFunction ) {
+	for ( int i = firstFunction; i < functions.Num(); i++ ) {
+		memset( &functions[i], 0, sizeof( functions[i] ) );
+	}
+}
+
+/*
+================
+idScriptProfiler::RunTime
+================
+*/
+double idScriptProfiler::RunTime( void ) const {
+	if ( running ) {
+		return runTime + sys->GetMillisecondsPrecise() - startTime;
+	}
+	return runTime;
+}
+
+/*
+================
+idScriptProfiler::AddCall
+================
+*/
+void idScriptProfiler::AddCall( const function_t *func ) {
+	functions[gameLocal.program.GetFunctionIndex( func )].calls++;
+}
+
+/*
+================
+idScriptProfiler::AddExclusive
+================
+*/
+void idScriptProfiler::AddExclusive( const function_t *func, int instructions, double time ) {
+	scriptFunctionProfile_t &p = functions[gameLocal.program.GetFunctionIndex( func )];
+	p.exclusiveInstructions += instructions;
+	p.exclusiveTime += time;
+}
+
+/*
+================
+idScriptProfiler::AddInclusive
+================
+*/
+void idScriptProfiler::AddInclusive( const function_t *func, int64_t instructions, double time ) {
+	scriptFunctionProfile_t &p = functions[gameLocal.program.GetFunctionIndex( func )];
+	p.inclusiveInstructions += instructions;
+	p.inclusiveTime += time;
+}
+
+/*
+================
+idScriptProfiler::AddEvent
+================
+*/
+void idScriptProfiler::AddEvent( const idEventDef *evdef, double time ) {
+	scriptEventProfile_t &p = events[evdef->GetEventNum()];
+	p.calls++;
+	p.time += time;
+}
+
+/*
+================
+idScriptProfiler::SortFunctions
+================
+*/
+void idScriptProfiler::SortFunctions( idList<int> &sorted ) const {
+	idList<profileSort_t> sort;
+	int i;
+
+	for ( i = 0; i < functions.Num() && i < gameLocal.program.NumFunctions(); i++ ) {
+		if ( functions[i].calls || functions[i].exclusiveInstructions ) {
+			profileSort_t &s = sort.Alloc();
+			s.index = i;
+			s.time = functions[i].exclusiveTime;
+		}
+	}
+	sort.Sort( ProfileSortCompare );
+
+	sorted.SetNum( sort.Num() );
+	for ( i = 0; i < sort.Num(); i++ ) {
+		sorted[i] = sort[i].index;
+	}
+}
+
+/*
+================
+idScriptProfiler::SortEvents
+================
+*/
+void idScriptProfiler::SortEvents( idList<int> &sorted ) const {
+	idList<profileSort_t> sort;
+	int i;
+
+	for ( i = 0; i < events.Num() && i < idEventDef::NumEventCommands(); i++ ) {
+		if ( events[i].calls ) {
+			profileSort_t &s = sort.Alloc();
+			s.index = i;
+			s.time = events[i].time;
+		}
+	}
+	sort.Sort( ProfileSortCompare );
+
+	sorted.SetNum( sort.Num() );
+	for ( i = 0; i < sort.Num(); i++ ) {
+		sorted[i] = sort[i].index;
+	}
+}
+
+/*
+================
+idScriptProfiler::Print
+
+  Prints the functions and events that took the most time.
+================
+*/
+void idScriptProfiler::Print( int count ) const {
+	idList<int>	sorted;
+	int			i;
+	double		seconds;
+
+	seconds = Max( RunTime() * 0.001, 0.001 );
+	gameLocal.Printf( "script profile of %.1f seconds%s\n", seconds, running ? ", running" : "" );
+
+	SortFunctions( sorted );
+	gameLocal.Printf( "%-40s %8s %10s %10s %10s %10s\n", "function", "calls", "excl instr", "excl ms/s", "incl ms/s", "usec/call" );
+	for ( i = 0; i < sorted.Num() && i < count; i++ ) {
+		const scriptFunctionProfile_t &p = functions[sorted[i]];
+		gameLocal.Printf( "%-40s %8d %10lld %10.3f %10.3f %10.1f\n", gameLocal.program.GetFunction( sorted[i] )->Name(), p.calls,
+							(long long)p.exclusiveInstructions, p.exclusiveTime / seconds, p.inclusiveTime / seconds,
+							p.calls ? p.inclusiveTime * 1000.0 / p.calls : 0.0 );
+	}
+
+	SortEvents( sorted );
+	gameLocal.Printf( "%-40s %8s %10s %10s\n", "event", "calls", "ms/s", "usec/call" );
+	for ( i = 0; i < sorted.Num() && i < count; i++ ) {
+		const scriptEventProfile_t &p = events[sorted[i]];
+		gameLocal.Printf( "%-40s %8d %10.3f %10.1f\n", idEventDef::GetEventCommand( sorted[i] )->GetName(), p.calls,
+							p.time / seconds, p.time * 1000.0 / p.calls );
+	}
+}
+
+/*
+================
+idScriptProfiler::Write
+
+  Writes all functions and events sorted by time.
+================
+*/
+bool idScriptProfiler::Write( const char *fileName ) const {
+	idList<int>	sorted;
+	idFile *	f;
+	int			i;
+	double		seconds;
+
+	f = fileSystem->OpenFileWrite( fileName );
+	if ( !f ) {
+		return false;
+	}
+
+	seconds = Max( RunTime() * 0.001, 0.001 );
+	f->Printf( "script profile of %.1f seconds, times in msec\n\n", seconds );
+
+	SortFunctions( sorted );
+	f->Printf( "%-48s %10s %14s %14s %12s %12s %10s  %s\n", "function", "calls", "excl instr", "incl instr", "excl time", "incl time", "usec/call", "file" );
+	for ( i = 0; i < sorted.Num(); i++ ) {
+		const scriptFunctionProfile_t &p = functions[sorted[i]];
+		const function_t *func = gameLocal.program.GetFunction( sorted[i] );
+		const statement_t &st = gameLocal.program.GetStatement( func->firstStatement );
+		f->Printf( "%-48s %10d %14lld %14lld %12.3f %12.3f %10.1f  %s(%d)\n", func->Name(), p.calls,
+					(long long)p.exclusiveInstructions, (long long)p.inclusiveInstructions, p.exclusiveTime, p.inclusiveTime,
+					p.calls ? p.inclusiveTime * 1000.0 / p.calls : 0.0,
+					gameLocal.program.GetFilename( st.file ), st.linenumber );
+	}
+
+	SortEvents( sorted );
+	f->Printf( "\n%-48s %10s %12s %10s\n", "event", "calls", "time", "usec/call" );
+	for ( i = 0; i < sorted.Num(); i++ ) {
+		const scriptEventProfile_t &p = events[sorted[i]];
+		f->Printf( "%-48s %10d %12.3f %10.1f\n", idEventDef::GetEventCommand( sorted[i] )->GetName(), p.calls,
+					p.time, p.time * 1000.0 / p.calls );
+	}
+
+	fileSystem->CloseFile( f );
+	return true;
+}
+
+/*
+================
+idScriptProfiler::ScriptProfile_f
+================
+*/
+void idScriptProfiler::ScriptProfile_f( const idCmdArgs &args ) {
+	const char *cmd = args.Argv( 1 );
+
+	if ( idStr::Icmp( cmd, "start" ) == 0 ) {
+		scriptProfiler.Start();
+		gameLocal.Printf( "script profiler started\n" );
+	} else if ( idStr::Icmp( cmd, "stop" ) == 0 ) {
+		scriptProfiler.Stop();
+		gameLocal.Printf( "script profiler stopped\n" );
+	} else if ( idStr::Icmp( cmd, "clear" ) == 0 ) {
+		scriptProfiler.Clear();
+	} else if ( idStr::Icmp( cmd, "dump" ) == 0 ) {
+		if ( scriptProfiler.functions.Num() == 0 ) {
+			gameLocal.Printf( "the script profiler hasn't run\n" );
+			return;
+		}
+		idStr fileName = args.Argc() > 2 ? args.Argv( 2 ) : "scriptprofile";
+		fileName.DefaultFileExtension( ".txt" );
+		scriptProfiler.Print( 20 );
+		if ( scriptProfiler.Write( fileName ) ) {
+			gameLocal.Printf( "wrote %s\n", fileName.c_str() );
+		} else {
+			gameLocal.Printf( "couldn't write %s\n", fileName.c_str() );
+		}
+	} else {
+		gameLocal.Printf( "usage: scriptProfile start | stop | clear | dump [file]\n" );
+	}
+}
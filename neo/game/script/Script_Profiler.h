@@ -0,0 +1,97 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SCRIPT_PROFILER_H__
+#define __SCRIPT_PROFILER_H__
+
+/*
+===============================================================================
+
+	Script profiler.
+
+	Counts the calls, instructions and time of every script function and
+	the calls and time of the events called from script. The exclusive
+	counts of a function are its own instructions plus the events it calls,
+	the inclusive counts add the script functions it calls. Time is only
+	counted while the thread runs, a thread that waits costs nothing.
+
+===============================================================================
+*/
+
+typedef struct scriptFunctionProfile_s {
+	int					calls;
+	int64_t				exclusiveInstructions;
+	int64_t				inclusiveInstructions;
+	double				exclusiveTime;			// msec
+	double				inclusiveTime;
+} scriptFunctionProfile_t;
+
+typedef struct scriptEventProfile_s {
+	int					calls;
+	double				time;					// msec
+} scriptEventProfile_t;
+
+class idScriptProfiler {
+public:
+						idScriptProfiler( void );
+
+	void				Start( void );
+	void				Stop( void );
+	void				Clear( void );
+						// clears the functions from the given index on, the map script functions are replaced on map changes
+	void				ClearFunctions( int firstFunction );
+	void				Print( int count ) const;
+	bool				Write( const char *fileName ) const;
+
+	bool				IsRunning( void ) const { return running; }
+	int					GetSession( void ) const { return session; }
+
+	void				AddCall( const function_t *func );
+	void				AddExclusive( const function_t *func, int instructions, double time );
+	void				AddInclusive( const function_t *func, int64_t instructions, double time );
+	void				AddEvent( const idEventDef *evdef, double time );
+
+	static void			ScriptProfile_f( const idCmdArgs &args );
+
+private:
+	bool				running;
+	int					session;				// changes on every start so interpreters drop calls from before
+	double				startTime;
+	double				runTime;				// msec the profiler ran before the last start
+
+	idList<scriptFunctionProfile_t>	functions;	// indexed by idProgram::GetFunctionIndex
+	idList<scriptEventProfile_t>	events;		// indexed by idEventDef::GetEventNum
+
+	double				RunTime( void ) const;
+	void				SortFunctions( idList<int> &sorted ) const;
+	void				SortEvents( idList<int> &sorted ) const;
+};
+
+extern idScriptProfiler	scriptProfiler;
+
+#endif /* !__SCRIPT_PROFILER_H__ */
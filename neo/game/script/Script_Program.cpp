@@ -1756,6 +1756,185 @@ void idProgram::FinishCompilation( void ) {
 	for( i = 0; i < numVariables; i++ ) {
 		variableDefaults[ i ] = variables[ i ];
 	}
+
+	CompileStatements();
+}
+
+/*
+==============
+CompileOperand
+==============
+*/
+static void CompileOperand( compiledOperand_t &out, const idVarDef *def ) {
+	if ( !def ) {
+		out.value.bytePtr = NULL;
+		out.onStack = false;
+	} else if ( def->initialized == idVarDef::stackVariable ) {
+		out.value.bytePtr = NULL;
+		out.value.stackOffset = def->value.stackOffset;
+		out.onStack = true;
+	} else {
+		out.value = def->value;
+		out.onStack = false;
+	}
+}
+
+/*
+==============
+CompiledHandler
+
+Returns the threaded interpreter handler for a single statement.
+==============
+*/
+static int CompiledHandler( int op ) {
+	switch( op ) {
+	case OP_GOTO:			return CS_GOTO;
+	case OP_IF:				return CS_IF;
+	case OP_IFNOT:			return CS_IFNOT;
+	case OP_ADD_F:			return CS_ADD_F;
+	case OP_SUB_F:			return CS_SUB_F;
+	case OP_MUL_F:			return CS_MUL_F;
+	case OP_ADD_V:			return CS_ADD_V;
+	case OP_SUB_V:			return CS_SUB_V;
+	case OP_MUL_V:			return CS_MUL_V;
+	case OP_MUL_FV:			return CS_MUL_FV;
+	case OP_MUL_VF:			return CS_MUL_VF;
+	case OP_EQ_F:			return CS_EQ_F;
+	case OP_NE_F:			return CS_NE_F;
+	case OP_LT:				return CS_LT;
+	case OP_LE:				return CS_LE;
+	case OP_GT:				return CS_GT;
+	case OP_GE:				return CS_GE;
+	case OP_AND:			return CS_AND;
+	case OP_OR:				return CS_OR;
+	case OP_AND_BOOLBOOL:	return CS_AND_BOOLBOOL;
+	case OP_OR_BOOLBOOL:	return CS_OR_BOOLBOOL;
+	case OP_NOT_F:			return CS_NOT_F;
+	case OP_NOT_BOOL:		return CS_NOT_BOOL;
+	case OP_NEG_F:			return CS_NEG_F;
+	case OP_UADD_F:			return CS_UADD_F;
+	case OP_USUB_F:			return CS_USUB_F;
+	case OP_UINC_F:			return CS_UINC_F;
+	case OP_UDEC_F:			return CS_UDEC_F;
+	case OP_STORE_V:		return CS_STORE_V;
+	case OP_ADDRESS:		return CS_ADDRESS;
+	case OP_STOREP_V:		return CS_STOREP_V;
+	case OP_INDIRECT_V:		return CS_INDIRECT_V;
+	case OP_PUSH_V:			return CS_PUSH_V;
+
+	case OP_EQ_E:
+	case OP_EQ_EO:
+	case OP_EQ_OE:
+	case OP_EQ_OO:
+		return CS_EQ_E;
+
+	case OP_NE_E:
+	case OP_NE_EO:
+	case OP_NE_OE:
+	case OP_NE_OO:
+		return CS_NE_E;
+
+	case OP_STORE_F:
+	case OP_STORE_ENT:
+	case OP_STORE_BOOL:
+	case OP_STORE_OBJ:
+	case OP_STORE_ENTOBJ:
+		return CS_STORE_INT;
+
+	case OP_STOREP_F:
+	case OP_STOREP_ENT:
+	case OP_STOREP_FLD:
+	case OP_STOREP_BOOL:
+	case OP_STOREP_OBJ:
+		return CS_STOREP_INT;
+
+	case OP_INDIRECT_F:
+	case OP_INDIRECT_ENT:
+	case OP_INDIRECT_BOOL:
+	case OP_INDIRECT_OBJ:
+		return CS_INDIRECT_INT;
+
+	case OP_PUSH_F:
+	case OP_PUSH_ENT:
+	case OP_PUSH_OBJ:
+	case OP_PUSH_OBJENT:
+		return CS_PUSH_INT;
+
+	default:
+		return CS_GENERIC;
+	}
+}
+
+/*
+==============
+FusedHandler
+
+Returns the superinstruction for a statement and the one following it,
+or CS_GENERIC when the pair can't be fused.
+==============
+*/
+static int FusedHandler( int handler, const statement_t &st, const statement_t &next ) {
+	switch( handler ) {
+	case CS_EQ_F:
+	case CS_NE_F:
+	case CS_LT:
+	case CS_LE:
+	case CS_GT:
+	case CS_GE:
+	case CS_EQ_E:
+	case CS_NE_E:
+		if ( next.op == OP_IFNOT && next.a == st.c ) {
+			return CS_EQ_F_IFNOT + ( handler - CS_EQ_F );
+		}
+		break;
+
+	case CS_ADDRESS:
+		if ( next.b == st.c ) {
+			if ( CompiledHandler( next.op ) == CS_STOREP_INT ) {
+				return CS_ADDRESS_STOREP_INT;
+			} else if ( next.op == OP_STOREP_V ) {
+				return CS_ADDRESS_STOREP_V;
+			}
+		}
+		break;
+	}
+
+	return CS_GENERIC;
+}
+
+/*
+==============
+idProgram::CompileStatements
+
+Resolves the operands of the statements compiled since the last call for the
+threaded interpreter and fuses common statement pairs into superinstructions.
+==============
+*/
+void idProgram::CompileStatements( void ) {
+	int i;
+	int start;
+	int fused;
+
+	// the last compiled statement may fuse with the first new one
+	start = Max( 0, Min( compiledStatements.Num(), statements.Num() ) - 1 );
+	compiledStatements.SetNum( statements.Num(), false );
+
+	for( i = start; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+		compiledStatement_t &cs = compiledStatements[ i ];
+
+		cs.handler = CompiledHandler( st.op );
+		CompileOperand( cs.a, st.a );
+		CompileOperand( cs.b, st.b );
+		CompileOperand( cs.c, st.c );
+	}
+
+	for( i = start; i < statements.Num() - 1; i++ ) {
+		fused = FusedHandler( compiledStatements[ i ].handler, statements[ i ], statements[ i + 1 ] );
+		if ( fused != CS_GENERIC ) {
+			compiledStatements[ i ].handler = fused;
+		}
+	}
 }
 
 /*
@@ -1937,6 +2116,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	compiledStatements.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -2146,8 +2326,11 @@ void idProgram::Restart( void ) {
 		functions[ i ].Clear();
 	}
 	functions.SetNum( top_functions	);
+	scriptProfiler.ClearFunctions( top_functions );
 
 	statements.SetNum( top_statements );
+	// the last statement is compiled again in case it was fused with a map script statement
+	compiledStatements.SetNum( Max( 0, Min( compiledStatements.Num(), top_statements - 1 ) ), false );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
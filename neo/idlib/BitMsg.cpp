@@ -650,6 +650,11 @@ void idBitMsgDelta::WriteBits( int value, int numBits ) {
 		newBase->WriteBits( value, numBits );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_BITS, numBits, 0, value );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteBits( value, numBits );
 		changed = true;
@@ -675,6 +680,11 @@ void idBitMsgDelta::WriteDelta( int oldValue, int newValue, int numBits ) {
 		newBase->WriteBits( newValue, numBits );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_DELTA, numBits, oldValue, newValue );
+		return;
+	}
+
 	if ( !base ) {
 		if ( oldValue == newValue ) {
 			writeDelta->WriteBits( 0, 1 );
@@ -772,6 +782,11 @@ void idBitMsgDelta::WriteString( const char *s, int maxLength ) {
 		newBase->WriteString( s, maxLength );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_STRING, maxLength, 0, 0 );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteString( s, maxLength );
 		changed = true;
@@ -798,6 +813,11 @@ void idBitMsgDelta::WriteData( const void *data, int length ) {
 		newBase->WriteData( data, length );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_DATA, length, 0, 0 );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteData( data, length );
 		changed = true;
@@ -825,6 +845,11 @@ void idBitMsgDelta::WriteDict( const idDict &dict ) {
 		newBase->WriteDeltaDict( dict, NULL );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_DICT, 0, 0, 0 );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteDeltaDict( dict, NULL );
 		changed = true;
@@ -845,6 +870,11 @@ void idBitMsgDelta::WriteDeltaByteCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 8 );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_BYTECOUNTER, 8, oldValue, newValue );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteDeltaByteCounter( oldValue, newValue );
 		changed = true;
@@ -870,6 +900,11 @@ void idBitMsgDelta::WriteDeltaShortCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 16 );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_SHORTCOUNTER, 16, oldValue, newValue );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteDeltaShortCounter( oldValue, newValue );
 		changed = true;
@@ -895,6 +930,11 @@ void idBitMsgDelta::WriteDeltaIntCounter( int oldValue, int newValue ) {
 		newBase->WriteBits( newValue, 32 );
 	}
 
+	if ( recordedWrites ) {
+		RecordWrite( DELTAWRITE_INTCOUNTER, 32, oldValue, newValue );
+		return;
+	}
+
 	if ( !base ) {
 		writeDelta->WriteDeltaIntCounter( oldValue, newValue );
 		changed = true;
@@ -910,6 +950,64 @@ void idBitMsgDelta::WriteDeltaIntCounter( int oldValue, int newValue ) {
 	}
 }
 
+/*
+================
+idBitMsgDelta::WriteRecorded
+
+The values are taken from the recorded writes, only strings, data and dictionaries are read from the state.
+The state is read through a local message so several threads can replay the same state at once.
+================
+*/
+void idBitMsgDelta::WriteRecorded( const idBitMsg &sharedState, const deltaWrite_t *writes, int numWrites ) {
+	char	buffer[MAX_DATA_BUFFER];
+	idDict	dict;
+	idBitMsg state;
+
+	state.Init( sharedState.GetData(), sharedState.GetSize() );
+	state.SetSize( sharedState.GetSize() );
+	state.BeginReading();
+
+	for ( int i = 0; i < numWrites; i++ ) {
+		const deltaWrite_t &write = writes[i];
+
+		switch( write.type ) {
+			case DELTAWRITE_BITS:
+				state.ReadBits( write.numBits );
+				WriteBits( write.value, write.numBits );
+				break;
+			case DELTAWRITE_DELTA:
+				state.ReadBits( write.numBits );
+				WriteDelta( write.oldValue, write.value, write.numBits );
+				break;
+			case DELTAWRITE_STRING:
+				state.ReadString( buffer, sizeof( buffer ) );
+				WriteString( buffer, write.numBits );
+				break;
+			case DELTAWRITE_DATA:
+				assert( write.numBits < sizeof( buffer ) );
+				state.ReadData( buffer, write.numBits );
+				WriteData( buffer, write.numBits );
+				break;
+			case DELTAWRITE_DICT:
+				state.ReadDeltaDict( dict, NULL );
+				WriteDict( dict );
+				break;
+			case DELTAWRITE_BYTECOUNTER:
+				state.ReadBits( 8 );
+				WriteDeltaByteCounter( write.oldValue, write.value );
+				break;
+			case DELTAWRITE_SHORTCOUNTER:
+				state.ReadBits( 16 );
+				WriteDeltaShortCounter( write.oldValue, write.value );
+				break;
+			case DELTAWRITE_INTCOUNTER:
+				state.ReadBits( 32 );
+				WriteDeltaIntCounter( write.oldValue, write.value );
+				break;
+		}
+	}
+}
+
 /*
 ================
 idBitMsgDelta::ReadString
@@ -436,6 +436,25 @@ ID_INLINE float idBitMsg::ReadDeltaFloat( float oldValue, int exponentBits, int
 ===============================================================================
 */
 
+// a write to an idBitMsgDelta, recorded so the same state can be delta compressed against other bases
+typedef enum {
+	DELTAWRITE_BITS,
+	DELTAWRITE_DELTA,
+	DELTAWRITE_STRING,
+	DELTAWRITE_DATA,
+	DELTAWRITE_DICT,
+	DELTAWRITE_BYTECOUNTER,
+	DELTAWRITE_SHORTCOUNTER,
+	DELTAWRITE_INTCOUNTER
+} deltaWriteType_t;
+
+typedef struct {
+	short			type;			// deltaWriteType_t
+	short			numBits;		// the length for data, the maximum length for strings
+	int				oldValue;		// for delta and counter writes
+	int				value;
+} deltaWrite_t;
+
 class idBitMsgDelta {
 public:
 					idBitMsgDelta();
@@ -445,6 +464,12 @@ public:
 	void			Init( const idBitMsg *base, idBitMsg *newBase, const idBitMsg *delta );
 	bool			HasChanged( void ) const;
 
+					// only writes the new base, and records the writes so WriteRecorded can repeat them
+	void			InitRecording( idBitMsg *newBase, deltaWrite_t *writes, int maxWrites );
+	int				GetNumRecordedWrites( void ) const;		// -1 if there were more than maxWrites
+					// repeats recorded writes against the base, state is the new base they were recorded to
+	void			WriteRecorded( const idBitMsg &state, const deltaWrite_t *writes, int numWrites );
+
 	void			WriteBits( int value, int numBits );
 	void			WriteChar( int c );
 	void			WriteByte( int c );
@@ -501,10 +526,14 @@ private:
 	idBitMsg *		writeDelta;		// delta from base to new base for writing
 	const idBitMsg *readDelta;		// delta from base to new base for reading
 	mutable bool	changed;		// true if the new base is different from the base
+	deltaWrite_t *	recordedWrites;	// set while recording
+	int				maxRecordedWrites;
+	int				numRecordedWrites;
 
 private:
 	void			WriteDelta( int oldValue, int newValue, int numBits );
 	int				ReadDelta( int oldValue, int numBits ) const;
+	void			RecordWrite( int type, int numBits, int oldValue, int value );
 };
 
 ID_INLINE idBitMsgDelta::idBitMsgDelta() {
@@ -513,6 +542,9 @@ ID_INLINE idBitMsgDelta::idBitMsgDelta() {
 	writeDelta = NULL;
 	readDelta = NULL;
 	changed = false;
+	recordedWrites = NULL;
+	maxRecordedWrites = 0;
+	numRecordedWrites = 0;
 }
 
 ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, idBitMsg *delta ) {
@@ -521,6 +553,7 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, idB
 	this->writeDelta = delta;
 	this->readDelta = delta;
 	this->changed = false;
+	this->recordedWrites = NULL;
 }
 
 ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, const idBitMsg *delta ) {
@@ -529,12 +562,40 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, con
 	this->writeDelta = NULL;
 	this->readDelta = delta;
 	this->changed = false;
+	this->recordedWrites = NULL;
+}
+
+ID_INLINE void idBitMsgDelta::InitRecording( idBitMsg *newBase, deltaWrite_t *writes, int maxWrites ) {
+	this->base = NULL;
+	this->newBase = newBase;
+	this->writeDelta = NULL;
+	this->readDelta = NULL;
+	this->changed = true;
+	this->recordedWrites = writes;
+	this->maxRecordedWrites = maxWrites;
+	this->numRecordedWrites = 0;
 }
 
 ID_INLINE bool idBitMsgDelta::HasChanged( void ) const {
 	return changed;
 }
 
+ID_INLINE int idBitMsgDelta::GetNumRecordedWrites( void ) const {
+	return numRecordedWrites;
+}
+
+ID_INLINE void idBitMsgDelta::RecordWrite( int type, int numBits, int oldValue, int value ) {
+	if ( numRecordedWrites < 0 || numRecordedWrites >= maxRecordedWrites ) {
+		numRecordedWrites = -1;
+		return;
+	}
+	deltaWrite_t &write = recordedWrites[numRecordedWrites++];
+	write.type = type;
+	write.numBits = numBits;
+	write.oldValue = oldValue;
+	write.value = value;
+}
+
 ID_INLINE void idBitMsgDelta::WriteChar( int c ) {
 	WriteBits( c, -8 );
 }
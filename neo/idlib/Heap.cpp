@@ -33,6 +33,8 @@ If you have questions concerning this license or the applicable additional terms
 	#define USE_LIBC_MALLOC		0
 #endif
 
+#include <atomic>
+
 #ifndef CRASH_ON_STATIC_ALLOCATION
 //	#define CRASH_ON_STATIC_ALLOCATION
 #endif
@@ -988,6 +990,17 @@ static memoryStats_t	mem_total_allocs = { 0, 0x0fffffff, -1, 0 };
 static memoryStats_t	mem_frame_allocs;
 static memoryStats_t	mem_frame_frees;
 
+// idHeap isn't thread-safe and the job threads allocate as well, so the small and
+// medium heaps (and the stats) are guarded by a spin lock. Allocations are short
+// enough that this never contends for long.
+static std::atomic_flag	mem_lock = ATOMIC_FLAG_INIT;
+
+class idHeapLock {
+public:
+					idHeapLock( void ) { while ( mem_lock.test_and_set( std::memory_order_acquire ) ) {} }
+					~idHeapLock( void ) { mem_lock.clear( std::memory_order_release ); }
+};
+
 /*
 ==================
 Mem_ClearFrameStats
@@ -1074,6 +1087,7 @@ void *Mem_Alloc( const int size ) {
 #endif
 		return malloc( size );
 	}
+	idHeapLock lock;
 	void *mem = mem_heap->Allocate( size );
 	Mem_UpdateAllocStats( mem_heap->Msize( mem ) );
 	return mem;
@@ -1095,6 +1109,7 @@ void Mem_Free( void *ptr ) {
 		free( ptr );
 		return;
 	}
+	idHeapLock lock;
 	Mem_UpdateFreeStats( mem_heap->Msize( ptr ) );
 	mem_heap->Free( ptr );
 }
@@ -42,6 +42,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "Simd_SSE.h"
 #include "Simd_SSE2.h"
 #include "Simd_SSE3.h"
+#include "Simd_SSE2Intrin.h"
+#include "Simd_AVX2.h"
 
 idSIMDProcessor	*	processor = NULL;			// pointer to SIMD processor
 idSIMDProcessor *	generic = NULL;				// pointer to generic SIMD implementation
@@ -77,6 +79,14 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 	} else {
 
 		if ( !processor ) {
+#ifdef ID_SIMD_SSE2_INTRINSICS
+			// the intrinsics implementations cover the whole processor interface
+			if ( ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_AVX2 ) ) {
+				processor = new idSIMD_AVX2;
+			} else if ( ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
+				processor = new idSIMD_SSE2Intrin;
+			} else
+#endif
 			if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) ) {
 				processor = new idSIMD_SSE3;
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
@@ -2718,6 +2728,68 @@ void TestOverlayPointCull( void ) {
 	PrintClocks( va( "   simd->OverlayPointCull() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestCullBounds
+============
+*/
+void TestCullBounds( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( idPlane planes[6] );
+	ALIGN16( float bounds[6*COUNT] );
+	ALIGN16( byte culled1[COUNT] );
+	ALIGN16( byte culled2[COUNT] );
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	planes[0].SetNormal( idVec3(  0.3f,  0.2f,  0.9f ) );
+	planes[1].SetNormal( idVec3( -0.9f,  0.2f,  0.3f ) );
+	planes[2].SetNormal( idVec3(  0.2f, -0.9f,  0.3f ) );
+	planes[3].SetNormal( idVec3(  0.0f,  1.0f,  0.0f ) );
+	planes[4].SetNormal( idVec3(  0.5f, -0.5f, -0.7f ) );
+	planes[5].SetNormal( idVec3( -1.0f,  0.0f,  0.0f ) );
+	for ( i = 0; i < 6; i++ ) {
+		planes[i].Normalize( false );
+		planes[i][3] = -5.0f;
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			float center = srnd.CRandomFloat() * 10.0f;
+			float extent = srnd.RandomFloat() * 2.0f;
+			bounds[j * COUNT + i] = center - extent;
+			bounds[( j + 3 ) * COUNT + i] = center + extent;
+		}
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->CullBounds( culled1, planes, 6, bounds, COUNT, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->CullBounds()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->CullBounds( culled2, planes, 6, bounds, COUNT, COUNT );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( culled1[i] != culled2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->CullBounds() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestDeriveTriPlanes
@@ -4019,8 +4091,22 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 				return;
 			}
 			p_simd = new idSIMD_SSE3();
+#ifdef ID_SIMD_SSE2_INTRINSICS
+		} else if ( idStr::Icmp( argString, "SSE2INTRIN" ) == 0 ) {
+			if ( !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_SSE2 ) ) {
+				common->Printf( "CPU does not support SSE & SSE2\n" );
+				return;
+			}
+			p_simd = new idSIMD_SSE2Intrin();
+		} else if ( idStr::Icmp( argString, "AVX2" ) == 0 ) {
+			if ( !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_SSE2 ) || !( cpuid & CPUID_AVX2 ) ) {
+				common->Printf( "CPU does not support SSE & SSE2 & AVX2\n" );
+				return;
+			}
+			p_simd = new idSIMD_AVX2();
+#endif
 		} else {
-			common->Printf( "invalid argument, use: MMX, SSE, SSE2, SSE3\n" );
+			common->Printf( "invalid argument, use: MMX, SSE, SSE2, SSE3, SSE2INTRIN, AVX2\n" );
 			return;
 		}
 	}
@@ -4067,6 +4153,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 	TestTracePointCull();
 	TestDecalPointCull();
 	TestOverlayPointCull();
+	TestCullBounds();
 	TestDeriveTriPlanes();
 	TestDeriveTangents();
 	TestDeriveUnsmoothedTangents();
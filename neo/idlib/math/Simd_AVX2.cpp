@@ -0,0 +1,814 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Simd_Generic.h"
+#include "Simd_SSE2Intrin.h"
+#include "Simd_AVX2.h"
+
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//===============================================================
+#ifdef ID_SIMD_SSE2_INTRINSICS
+
+#include <immintrin.h>
+
+// MSVC accepts AVX intrinsics without any flags, GCC and Clang need them enabled per function
+#if defined(__GNUC__)
+	#define ID_AVX2		__attribute__((target("avx2")))
+#else
+	#define ID_AVX2
+#endif
+
+#define R_SHUFFLEPS( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
+
+// runs VECOP on eight floats at a time and SCALAROP on the remaining floats
+#define SIMD_LOOP8( VECOP, SCALAROP )	{ int _IX; for ( _IX = 0; _IX <= count - 8; _IX += 8 ) { VECOP( _IX ); } for ( ; _IX < count; _IX++ ) { SCALAROP( _IX ); } }
+
+/*
+============
+Combine
+============
+*/
+static ID_INLINE ID_AVX2 __m256 Combine( const __m128 lo, const __m128 hi ) {
+	return _mm256_insertf128_ps( _mm256_castps128_ps256( lo ), hi, 1 );
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "SSE2 & AVX2 intrinsics";
+}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = constant + src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Add( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_add_ps( c, _mm256_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = src[(X)] + constant
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = src0[i] + src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Add( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_add_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] + src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = constant - src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Sub( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_sub_ps( c, _mm256_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant - src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = src0[i] - src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Sub( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_sub_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] - src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = constant * src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Mul( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_mul_ps( c, _mm256_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant * src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Mul( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_mul_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] * src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = constant / src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Div( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_div_ps( c, _mm256_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant / src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = src0[i] / src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Div( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_div_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] / src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += constant * src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_add_ps( _mm256_loadu_ps( dst + (X) ), _mm256_mul_ps( c, _mm256_loadu_ps( src + (X) ) ) ) )
+#define OPER(X) dst[(X)] += constant * src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += src0[i] * src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_add_ps( _mm256_loadu_ps( dst + (X) ), _mm256_mul_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) ) )
+#define OPER(X) dst[(X)] += src0[(X)] * src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= constant * src[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MulSub( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_sub_ps( _mm256_loadu_ps( dst + (X) ), _mm256_mul_ps( c, _mm256_loadu_ps( src + (X) ) ) ) )
+#define OPER(X) dst[(X)] -= constant * src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= src0[i] * src1[i];
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MulSub( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_sub_ps( _mm256_loadu_ps( dst + (X) ), _mm256_mul_ps( _mm256_loadu_ps( src0 + (X) ), _mm256_loadu_ps( src1 + (X) ) ) ) )
+#define OPER(X) dst[(X)] -= src0[(X)] * src1[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	int i;
+
+	for ( i = 0; i <= count - 16; i += 16 ) {
+		sum0 = _mm256_add_ps( sum0, _mm256_mul_ps( _mm256_loadu_ps( src1 + i + 0 ), _mm256_loadu_ps( src2 + i + 0 ) ) );
+		sum1 = _mm256_add_ps( sum1, _mm256_mul_ps( _mm256_loadu_ps( src1 + i + 8 ), _mm256_loadu_ps( src2 + i + 8 ) ) );
+	}
+	if ( i <= count - 8 ) {
+		sum0 = _mm256_add_ps( sum0, _mm256_mul_ps( _mm256_loadu_ps( src1 + i ), _mm256_loadu_ps( src2 + i ) ) );
+		i += 8;
+	}
+	sum0 = _mm256_add_ps( sum0, sum1 );
+
+	__m128 s = _mm_add_ps( _mm256_castps256_ps128( sum0 ), _mm256_extractf128_ps( sum0, 1 ) );
+	s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+	s = _mm_add_ss( s, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	float sum = _mm_cvtss_f32( s );
+
+	for ( ; i < count; i++ ) {
+		sum += src1[i] * src2[i];
+	}
+	dot = sum;
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i <= count - 8; i += 8 ) {
+		__m256 v = _mm256_loadu_ps( src + i );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+
+	__m128 mn = _mm_min_ps( _mm256_castps256_ps128( vmin ), _mm256_extractf128_ps( vmin, 1 ) );
+	__m128 mx = _mm_max_ps( _mm256_castps256_ps128( vmax ), _mm256_extractf128_ps( vmax, 1 ) );
+	mn = _mm_min_ps( mn, _mm_movehl_ps( mn, mn ) );
+	mx = _mm_max_ps( mx, _mm_movehl_ps( mx, mx ) );
+	mn = _mm_min_ss( mn, _mm_shuffle_ps( mn, mn, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	mx = _mm_max_ss( mx, _mm_shuffle_ps( mx, mx, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_load_ss( src + i );
+		mn = _mm_min_ss( mn, v );
+		mx = _mm_max_ss( mx, v );
+	}
+	_mm_store_ss( &min, mn );
+	_mm_store_ss( &max, mx );
+}
+
+/*
+============
+idSIMD_AVX2::Clamp
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::Clamp( float *dst, const float *src, const float min, const float max, const int count ) {
+	const __m256 vmin = _mm256_set1_ps( min );
+	const __m256 vmax = _mm256_set1_ps( max );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( src + (X) ), vmin ), vmax ) )
+#define OPER(X) dst[(X)] = src[(X)] < min ? min : src[(X)] > max ? max : src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::ClampMin
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::ClampMin( float *dst, const float *src, const float min, const int count ) {
+	const __m256 vmin = _mm256_set1_ps( min );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_max_ps( _mm256_loadu_ps( src + (X) ), vmin ) )
+#define OPER(X) dst[(X)] = src[(X)] < min ? min : src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+idSIMD_AVX2::ClampMax
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::ClampMax( float *dst, const float *src, const float max, const int count ) {
+	const __m256 vmax = _mm256_set1_ps( max );
+#define OPER8(X) _mm256_storeu_ps( dst + (X), _mm256_min_ps( _mm256_loadu_ps( src + (X) ), vmax ) )
+#define OPER(X) dst[(X)] = src[(X)] > max ? max : src[(X)]
+	SIMD_LOOP8( OPER8, OPER )
+#undef OPER8
+#undef OPER
+}
+
+/*
+============
+LoadQuats8
+
+  loads the quaternions of eight joints as structure of arrays
+============
+*/
+static ID_INLINE ID_AVX2 void LoadQuats8( const idJointQuat *jq, __m256 &x, __m256 &y, __m256 &z, __m256 &w ) {
+	__m128 x0 = _mm_loadu_ps( jq[0].q.ToFloatPtr() );
+	__m128 y0 = _mm_loadu_ps( jq[1].q.ToFloatPtr() );
+	__m128 z0 = _mm_loadu_ps( jq[2].q.ToFloatPtr() );
+	__m128 w0 = _mm_loadu_ps( jq[3].q.ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( x0, y0, z0, w0 );
+
+	__m128 x1 = _mm_loadu_ps( jq[4].q.ToFloatPtr() );
+	__m128 y1 = _mm_loadu_ps( jq[5].q.ToFloatPtr() );
+	__m128 z1 = _mm_loadu_ps( jq[6].q.ToFloatPtr() );
+	__m128 w1 = _mm_loadu_ps( jq[7].q.ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( x1, y1, z1, w1 );
+
+	x = Combine( x0, x1 );
+	y = Combine( y0, y1 );
+	z = Combine( z0, z1 );
+	w = Combine( w0, w1 );
+}
+
+/*
+============
+StoreRows8
+
+  transposes one matrix row of eight joints back into the joint matrices
+============
+*/
+static ID_INLINE ID_AVX2 void StoreRows8( float *m, const __m256 c0, const __m256 c1, const __m256 c2, const __m256 c3 ) {
+	__m128 a0 = _mm256_castps256_ps128( c0 );
+	__m128 a1 = _mm256_castps256_ps128( c1 );
+	__m128 a2 = _mm256_castps256_ps128( c2 );
+	__m128 a3 = _mm256_castps256_ps128( c3 );
+	_MM_TRANSPOSE4_PS( a0, a1, a2, a3 );
+	_mm_storeu_ps( m + 0 * 12, a0 );
+	_mm_storeu_ps( m + 1 * 12, a1 );
+	_mm_storeu_ps( m + 2 * 12, a2 );
+	_mm_storeu_ps( m + 3 * 12, a3 );
+
+	__m128 b0 = _mm256_extractf128_ps( c0, 1 );
+	__m128 b1 = _mm256_extractf128_ps( c1, 1 );
+	__m128 b2 = _mm256_extractf128_ps( c2, 1 );
+	__m128 b3 = _mm256_extractf128_ps( c3, 1 );
+	_MM_TRANSPOSE4_PS( b0, b1, b2, b3 );
+	_mm_storeu_ps( m + 4 * 12, b0 );
+	_mm_storeu_ps( m + 5 * 12, b1 );
+	_mm_storeu_ps( m + 6 * 12, b2 );
+	_mm_storeu_ps( m + 7 * 12, b3 );
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	int i;
+
+	assert( sizeof( idJointQuat ) == 7 * sizeof( float ) );
+	assert( sizeof( idJointMat ) == 12 * sizeof( float ) );
+
+	for ( i = 0; i <= numJoints - 8; i += 8 ) {
+		const idJointQuat *jq = jointQuats + i;
+		__m256 x, y, z, w;
+
+		LoadQuats8( jq, x, y, z, w );
+
+		const __m256 x2 = _mm256_add_ps( x, x );
+		const __m256 y2 = _mm256_add_ps( y, y );
+		const __m256 z2 = _mm256_add_ps( z, z );
+
+		const __m256 xx = _mm256_mul_ps( x, x2 );
+		const __m256 xy = _mm256_mul_ps( x, y2 );
+		const __m256 xz = _mm256_mul_ps( x, z2 );
+		const __m256 yy = _mm256_mul_ps( y, y2 );
+		const __m256 yz = _mm256_mul_ps( y, z2 );
+		const __m256 zz = _mm256_mul_ps( z, z2 );
+		const __m256 wx = _mm256_mul_ps( w, x2 );
+		const __m256 wy = _mm256_mul_ps( w, y2 );
+		const __m256 wz = _mm256_mul_ps( w, z2 );
+
+		float *m = jointMats[i].ToFloatPtr();
+
+		StoreRows8( m + 0,	_mm256_sub_ps( one, _mm256_add_ps( yy, zz ) ),
+							_mm256_add_ps( xy, wz ),
+							_mm256_sub_ps( xz, wy ),
+							_mm256_setr_ps( jq[0].t.x, jq[1].t.x, jq[2].t.x, jq[3].t.x, jq[4].t.x, jq[5].t.x, jq[6].t.x, jq[7].t.x ) );
+
+		StoreRows8( m + 4,	_mm256_sub_ps( xy, wz ),
+							_mm256_sub_ps( one, _mm256_add_ps( xx, zz ) ),
+							_mm256_add_ps( yz, wx ),
+							_mm256_setr_ps( jq[0].t.y, jq[1].t.y, jq[2].t.y, jq[3].t.y, jq[4].t.y, jq[5].t.y, jq[6].t.y, jq[7].t.y ) );
+
+		StoreRows8( m + 8,	_mm256_add_ps( xz, wy ),
+							_mm256_sub_ps( yz, wx ),
+							_mm256_sub_ps( one, _mm256_add_ps( xx, yy ) ),
+							_mm256_setr_ps( jq[0].t.z, jq[1].t.z, jq[2].t.z, jq[3].t.z, jq[4].t.z, jq[5].t.z, jq[6].t.z, jq[7].t.z ) );
+	}
+
+	if ( i < numJoints ) {
+		idSIMD_SSE2Intrin::ConvertJointQuatsToJointMats( jointMats + i, jointQuats + i, numJoints - i );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+  the first two joint rows are done as a single 256 bit vector
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+	int i, j;
+
+	for ( j = i = 0; i < numVerts; i++ ) {
+		__m256 sum01 = _mm256_setzero_ps();
+		__m128 sum2 = _mm_setzero_ps();
+
+		while( 1 ) {
+			const float *m = (const float *)( jointsPtr + index[j*2+0] );
+			const __m128 w = _mm_loadu_ps( weights[j].ToFloatPtr() );
+			sum01 = _mm256_add_ps( sum01, _mm256_mul_ps( _mm256_loadu_ps( m + 0 ), Combine( w, w ) ) );
+			sum2 = _mm_add_ps( sum2, _mm_mul_ps( _mm_loadu_ps( m + 8 ), w ) );
+			if ( index[j*2+1] != 0 ) {
+				break;
+			}
+			j++;
+		}
+		j++;
+
+		__m128 sum0 = _mm256_castps256_ps128( sum01 );
+		__m128 sum1 = _mm256_extractf128_ps( sum01, 1 );
+		__m128 sum3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS( sum0, sum1, sum2, sum3 );
+		const __m128 v = _mm_add_ps( _mm_add_ps( sum0, sum1 ), _mm_add_ps( sum2, sum3 ) );
+
+		float *xyz = verts[i].xyz.ToFloatPtr();
+		_mm_store_sd( (double *) xyz, _mm_castps_pd( v ) );
+		_mm_store_ss( xyz + 2, _mm_movehl_ps( v, v ) );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TracePointCull
+
+  the distances plus and minus the radius to all four planes are a single vector
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	__m128 px = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 py = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 pz = _mm_loadu_ps( planes[2].ToFloatPtr() );
+	__m128 pd = _mm_loadu_ps( planes[3].ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( px, py, pz, pd );
+
+	const __m256 px8 = Combine( px, px );
+	const __m256 py8 = Combine( py, py );
+	const __m256 pz8 = Combine( pz, pz );
+	const __m256 pd8 = _mm256_add_ps( Combine( pd, pd ), _mm256_setr_ps( radius, radius, radius, radius, -radius, -radius, -radius, -radius ) );
+	int tOr = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const float *v = verts[i].xyz.ToFloatPtr();
+		const __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps(	_mm256_mul_ps( px8, _mm256_broadcast_ss( v + 0 ) ),
+																		_mm256_mul_ps( py8, _mm256_broadcast_ss( v + 1 ) ) ),
+																		_mm256_mul_ps( pz8, _mm256_broadcast_ss( v + 2 ) ) ), pd8 );
+
+		const int bits = _mm256_movemask_ps( d ) ^ 0x0F;		// flip lower four bits
+
+		tOr |= bits;
+		cullBits[i] = (byte) bits;
+	}
+
+	totalOr = (byte) tOr;
+}
+
+/*
+============
+idSIMD_AVX2::DecalPointCull
+
+  the distances to all six planes are a single vector
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	__m128 p0x = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 p0y = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 p0z = _mm_loadu_ps( planes[2].ToFloatPtr() );
+	__m128 p0d = _mm_loadu_ps( planes[3].ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( p0x, p0y, p0z, p0d );
+
+	__m128 p1x = _mm_loadu_ps( planes[4].ToFloatPtr() );
+	__m128 p1y = _mm_loadu_ps( planes[5].ToFloatPtr() );
+	__m128 p1z = _mm_setzero_ps();
+	__m128 p1d = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( p1x, p1y, p1z, p1d );
+
+	const __m256 px = Combine( p0x, p1x );
+	const __m256 py = Combine( p0y, p1y );
+	const __m256 pz = Combine( p0z, p1z );
+	const __m256 pd = Combine( p0d, p1d );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const float *v = verts[i].xyz.ToFloatPtr();
+		const __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps(	_mm256_mul_ps( px, _mm256_broadcast_ss( v + 0 ) ),
+																		_mm256_mul_ps( py, _mm256_broadcast_ss( v + 1 ) ) ),
+																		_mm256_mul_ps( pz, _mm256_broadcast_ss( v + 2 ) ) ), pd );
+
+		cullBits[i] = (byte)( ( _mm256_movemask_ps( d ) & 0x3F ) ^ 0x3F );		// flip lower 6 bits
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CullBounds
+
+  eight bounds at a time, the rest go through the SSE2 version
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::CullBounds( byte *culled, const idPlane *planes, const int numPlanes, const float *bounds, const int stride, const int numBounds ) {
+	const __m256 zero = _mm256_setzero_ps();
+	int i;
+
+	for ( i = 0; i + 8 <= numBounds; i += 8 ) {
+		__m256 out = zero;
+
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const idPlane &p = planes[j];
+
+			const __m256 x = _mm256_loadu_ps( bounds + ( p[0] > 0.0f ? 0 : 3 ) * stride + i );
+			const __m256 y = _mm256_loadu_ps( bounds + ( p[1] > 0.0f ? 1 : 4 ) * stride + i );
+			const __m256 z = _mm256_loadu_ps( bounds + ( p[2] > 0.0f ? 2 : 5 ) * stride + i );
+
+			const __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps(	_mm256_mul_ps( _mm256_set1_ps( p[0] ), x ),
+																			_mm256_mul_ps( _mm256_set1_ps( p[1] ), y ) ),
+																			_mm256_mul_ps( _mm256_set1_ps( p[2] ), z ) ), _mm256_set1_ps( p[3] ) );
+
+			out = _mm256_or_ps( out, _mm256_cmp_ps( d, zero, _CMP_GE_OQ ) );
+			if ( _mm256_movemask_ps( out ) == 0xFF ) {
+				break;
+			}
+		}
+
+		const int bits = _mm256_movemask_ps( out );
+		for ( int k = 0; k < 8; k++ ) {
+			culled[i+k] = (byte)( ( bits >> k ) & 1 );
+		}
+	}
+
+	idSIMD_SSE2Intrin::CullBounds( culled + i, planes, numPlanes, bounds + i, stride, numBounds - i );
+}
+
+/*
+============
+idSIMD_AVX2::CreateShadowCache
+============
+*/
+ID_AVX2 int VPCALL idSIMD_AVX2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+	const __m256 light = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 0.0f, lightOrigin.x, lightOrigin.y, lightOrigin.z, 0.0f );
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		// R_SetupProjection() builds the projection matrix with a slight crunch
+		// for depth, which keeps this w=0 division from rasterizing right at the
+		// wrap around point and causing depth fighting with the rear caps
+		_mm256_storeu_ps( vertexCache[outVerts].ToFloatPtr(), _mm256_sub_ps( _mm256_or_ps( Combine( v, v ), w ), light ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_AVX2::CreateVertexProgramShadowCache
+============
+*/
+ID_AVX2 int VPCALL idSIMD_AVX2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m256 w = _mm256_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm256_storeu_ps( vertexCache[i*2].ToFloatPtr(), _mm256_or_ps( Combine( v, v ), w ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerMono
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	const float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	const float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m256 vol = _mm256_setr_ps(	lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR,
+									lastV[0] + 2.0f * incL, lastV[1] + 2.0f * incR, lastV[0] + 3.0f * incL, lastV[1] + 3.0f * incR );
+	const __m256 inc = _mm256_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m128 s = _mm_loadu_ps( samples + j );
+		const __m256 s2 = Combine( _mm_unpacklo_ps( s, s ), _mm_unpackhi_ps( s, s ) );
+		_mm256_storeu_ps( mixBuffer + j*2, _mm256_add_ps( _mm256_loadu_ps( mixBuffer + j*2 ), _mm256_mul_ps( s2, vol ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundTwoSpeakerStereo
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	const float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	const float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m256 vol = _mm256_setr_ps(	lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR,
+									lastV[0] + 2.0f * incL, lastV[1] + 2.0f * incR, lastV[0] + 3.0f * incL, lastV[1] + 3.0f * incR );
+	const __m256 inc = _mm256_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		_mm256_storeu_ps( mixBuffer + j*2, _mm256_add_ps( _mm256_loadu_ps( mixBuffer + j*2 ), _mm256_mul_ps( _mm256_loadu_ps( samples + j*2 ), vol ) ) );
+		vol = _mm256_add_ps( vol, inc );
+	}
+}
+
+/*
+============
+SetupSixSpeakerVolumes
+
+  four samples for six speakers are 24 floats spread over three vectors
+============
+*/
+static ID_INLINE ID_AVX2 void SetupSixSpeakerVolumes( const float lastV[6], const float currentV[6], __m256 vol[3], __m256 inc[3] ) {
+	ALIGN16( float v[24] );
+	ALIGN16( float d[24] );
+
+	for ( int n = 0; n < 24; n++ ) {
+		const int k = n % 6;
+		const float i = ( currentV[k] - lastV[k] ) / MIXBUFFER_SAMPLES;
+		v[n] = lastV[k] + ( n / 6 ) * i;
+		d[n] = 4.0f * i;
+	}
+	for ( int n = 0; n < 3; n++ ) {
+		vol[n] = _mm256_loadu_ps( v + n * 8 );
+		inc[n] = _mm256_loadu_ps( d + n * 8 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerMono
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m256 vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupSixSpeakerVolumes( lastV, currentV, vol, inc );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		const __m128 s = _mm_loadu_ps( samples + i );
+		const __m128 s0 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		const __m128 s1 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		const __m128 s2 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 2, 2 ) );
+		const __m128 s3 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 3, 3, 3, 3 ) );
+		float *mix = mixBuffer + i * 6;
+		_mm256_storeu_ps( mix +  0, _mm256_add_ps( _mm256_loadu_ps( mix +  0 ), _mm256_mul_ps( Combine( s0, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 1, 1 ) ) ), vol[0] ) ) );
+		_mm256_storeu_ps( mix +  8, _mm256_add_ps( _mm256_loadu_ps( mix +  8 ), _mm256_mul_ps( Combine( s1, s2 ), vol[1] ) ) );
+		_mm256_storeu_ps( mix + 16, _mm256_add_ps( _mm256_loadu_ps( mix + 16 ), _mm256_mul_ps( Combine( _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 3, 3 ) ), s3 ), vol[2] ) ) );
+		vol[0] = _mm256_add_ps( vol[0], inc[0] );
+		vol[1] = _mm256_add_ps( vol[1], inc[1] );
+		vol[2] = _mm256_add_ps( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerStereo
+
+  the left channel goes to speakers 0, 2, 3 and 4, the right channel to speakers 1 and 5
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m256 vol[3], inc[3];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	SetupSixSpeakerVolumes( lastV, currentV, vol, inc );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 4 ) {
+		const __m128 s = _mm_loadu_ps( samples + i * 2 + 0 );
+		const __m128 t = _mm_loadu_ps( samples + i * 2 + 4 );
+		float *mix = mixBuffer + i * 6;
+		_mm256_storeu_ps( mix +  0, _mm256_add_ps( _mm256_loadu_ps( mix +  0 ), _mm256_mul_ps( Combine( _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 1, 0, 0 ) ), s ), vol[0] ) ) );
+		_mm256_storeu_ps( mix +  8, _mm256_add_ps( _mm256_loadu_ps( mix +  8 ), _mm256_mul_ps( Combine( _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 2, 3 ) ), _mm_shuffle_ps( t, t, R_SHUFFLEPS( 0, 1, 0, 0 ) ) ), vol[1] ) ) );
+		_mm256_storeu_ps( mix + 16, _mm256_add_ps( _mm256_loadu_ps( mix + 16 ), _mm256_mul_ps( Combine( t, _mm_shuffle_ps( t, t, R_SHUFFLEPS( 2, 2, 2, 3 ) ) ), vol[2] ) ) );
+		vol[0] = _mm256_add_ps( vol[0], inc[0] );
+		vol[1] = _mm256_add_ps( vol[1], inc[1] );
+		vol[2] = _mm256_add_ps( vol[2], inc[2] );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixedSoundToSamples
+============
+*/
+ID_AVX2 void VPCALL idSIMD_AVX2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m256 min = _mm256_set1_ps( -32768.0f );
+	const __m256 max = _mm256_set1_ps( 32767.0f );
+	int i;
+
+	for ( i = 0; i <= numSamples - 16; i += 16 ) {
+		const __m256i s0 = _mm256_cvttps_epi32( _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( mixBuffer + i + 0 ), min ), max ) );
+		const __m256i s1 = _mm256_cvttps_epi32( _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( mixBuffer + i + 8 ), min ), max ) );
+		// the pack works per 128 bit lane, put the four 64 bit groups back in order
+		const __m256i s = _mm256_permute4x64_epi64( _mm256_packs_epi32( s0, s1 ), R_SHUFFLEPS( 0, 2, 1, 3 ) );
+		_mm256_storeu_si256( (__m256i *)( samples + i ), s );
+	}
+	if ( i < numSamples ) {
+		idSIMD_SSE2Intrin::MixedSoundToSamples( samples + i, mixBuffer + i, numSamples - i );
+	}
+}
+
+#endif /* ID_SIMD_SSE2_INTRINSICS */
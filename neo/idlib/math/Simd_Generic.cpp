@@ -2437,6 +2437,36 @@ void VPCALL idSIMD_Generic::OverlayPointCull( byte *cullBits, idVec2 *texCoords,
 	}
 }
 
+/*
+============
+idSIMD_Generic::CullBounds
+
+  The bounds are stored as six arrays stride floats apart, the mins x, y, z followed
+  by the maxs x, y, z.  culled[i] is set to 1 if the i-th bounds is completely on the
+  positive side of one of the planes, with the same test as the corners of a box.
+============
+*/
+void VPCALL idSIMD_Generic::CullBounds( byte *culled, const idPlane *planes, const int numPlanes, const float *bounds, const int stride, const int numBounds ) {
+	int i, j;
+
+	for ( i = 0; i < numBounds; i++ ) {
+		byte out = 0;
+
+		for ( j = 0; j < numPlanes && !out; j++ ) {
+			const idPlane &p = planes[j];
+
+			// the corner that is the furthest to the negative side of the plane
+			const float x = bounds[ ( p[0] > 0.0f ? 0 : 3 ) * stride + i ];
+			const float y = bounds[ ( p[1] > 0.0f ? 1 : 4 ) * stride + i ];
+			const float z = bounds[ ( p[2] > 0.0f ? 2 : 5 ) * stride + i ];
+
+			out = ( p[0] * x + p[1] * y + p[2] * z + p[3] >= 0.0f );
+		}
+
+		culled[i] = out;
+	}
+}
+
 /*
 ============
 idSIMD_Generic::DeriveTriPlanes
@@ -0,0 +1,2690 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Simd_Generic.h"
+#include "Simd_SSE2Intrin.h"
+
+
+//===============================================================
+//
+//	SSE2 intrinsics implementation of idSIMDProcessor
+//
+//===============================================================
+#ifdef ID_SIMD_SSE2_INTRINSICS
+
+#include <emmintrin.h>
+
+#define R_SHUFFLEPS( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
+
+// runs VECOP on four floats at a time and SCALAROP on the remaining floats
+#define SIMD_LOOP4( VECOP, SCALAROP )	{ int _IX; for ( _IX = 0; _IX <= count - 4; _IX += 4 ) { VECOP( _IX ); } for ( ; _IX < count; _IX++ ) { SCALAROP( _IX ); } }
+
+// runs VECOP on arrays padded to a multiple of four floats, unaligned access is as fast as aligned on current CPUs
+// and ALIGN16 is not honored on every platform
+#define SIMD_LOOP16( VECOP )			{ int _IX; for ( _IX = 0; _IX < count; _IX += 4 ) { VECOP( _IX ); } }
+
+/*
+============
+LoadVec3x4
+
+  loads four consecutive idVec3 and transposes them into x, y and z vectors
+============
+*/
+static ID_INLINE void LoadVec3x4( const float *p, __m128 &x, __m128 &y, __m128 &z ) {
+	__m128 a = _mm_loadu_ps( p + 0 );		// x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps( p + 4 );		// y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps( p + 8 );		// z2 x3 y3 z3
+
+	__m128 t = _mm_shuffle_ps( b, c, R_SHUFFLEPS( 2, 2, 1, 1 ) );
+	x = _mm_shuffle_ps( a, t, R_SHUFFLEPS( 0, 3, 0, 2 ) );
+	t = _mm_shuffle_ps( a, b, R_SHUFFLEPS( 1, 1, 0, 0 ) );
+	y = _mm_shuffle_ps( t, _mm_shuffle_ps( b, c, R_SHUFFLEPS( 3, 3, 2, 2 ) ), R_SHUFFLEPS( 0, 2, 0, 2 ) );
+	t = _mm_shuffle_ps( a, b, R_SHUFFLEPS( 2, 2, 1, 1 ) );
+	z = _mm_shuffle_ps( t, _mm_shuffle_ps( c, c, R_SHUFFLEPS( 0, 0, 3, 3 ) ), R_SHUFFLEPS( 0, 2, 0, 2 ) );
+}
+
+/*
+============
+LoadVec3
+
+  loads a single idVec3 without reading past the end of it, the last component is zero
+============
+*/
+static ID_INLINE __m128 LoadVec3( const float *p ) {
+	return _mm_movelh_ps( _mm_castpd_ps( _mm_load_sd( (const double *) p ) ), _mm_load_ss( p + 2 ) );
+}
+
+/*
+============
+StoreVec3
+
+  stores the first three components without touching the memory behind them
+============
+*/
+static ID_INLINE void StoreVec3( float *p, const __m128 v ) {
+	_mm_store_sd( (double *) p, _mm_castps_pd( v ) );
+	_mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+}
+
+/*
+============
+HorizontalAdd
+============
+*/
+static ID_INLINE float HorizontalAdd( const __m128 v ) {
+	__m128 t = _mm_add_ps( v, _mm_movehl_ps( v, v ) );
+	t = _mm_add_ss( t, _mm_shuffle_ps( t, t, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( t );
+}
+
+/*
+============
+Select
+
+  returns a where the mask is set and b elsewhere
+============
+*/
+static ID_INLINE __m128 Select( const __m128 mask, const __m128 a, const __m128 b ) {
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+/*
+============
+ReciprocalSqrt
+
+  estimate refined with one Newton-Raphson iteration, a zero input results
+  in a large finite value instead of infinity just like idMath::RSqrt
+============
+*/
+static ID_INLINE __m128 ReciprocalSqrt( __m128 x ) {
+	x = _mm_max_ps( x, _mm_set1_ps( FLT_MIN ) );
+	const __m128 r = _mm_rsqrt_ps( x );
+	const __m128 xrr = _mm_mul_ps( _mm_mul_ps( x, r ), r );
+	return _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( 0.5f ), r ), _mm_sub_ps( _mm_set1_ps( 3.0f ), xrr ) );
+}
+
+/*
+============
+ATan16
+
+  same polynomial as idMath::ATan16 for y >= 0 and x >= 0
+============
+*/
+static ID_INLINE __m128 ATan16( const __m128 y, const __m128 x ) {
+	const __m128 mask = _mm_cmpgt_ps( y, x );
+	const __m128 a = _mm_div_ps( _mm_min_ps( x, y ), _mm_max_ps( x, y ) );
+	const __m128 s = _mm_mul_ps( a, a );
+	__m128 r = _mm_set1_ps( 0.0028662257f );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -0.0161657367f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 0.0429096138f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -0.0752896400f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 0.1065626393f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -0.1420889944f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 0.1999355085f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -0.3333314528f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 1.0f ) );
+	r = _mm_mul_ps( r, a );
+	return Select( mask, _mm_sub_ps( _mm_set1_ps( idMath::HALF_PI ), r ), r );
+}
+
+/*
+============
+Sin16
+
+  same polynomial as idMath::Sin16 for a in the range [0, PI/2]
+============
+*/
+static ID_INLINE __m128 Sin16( const __m128 a ) {
+	const __m128 s = _mm_mul_ps( a, a );
+	__m128 r = _mm_set1_ps( -2.39e-08f );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 2.7526e-06f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -1.98409e-04f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 8.3333315e-03f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( -1.666666664e-01f ) );
+	r = _mm_add_ps( _mm_mul_ps( r, s ), _mm_set1_ps( 1.0f ) );
+	return _mm_mul_ps( r, a );
+}
+
+/*
+============
+DotRow
+============
+*/
+static ID_INLINE float DotRow( const float *a, const float *b, const int n ) {
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+	int i;
+	for ( i = 0; i <= n - 8; i += 8 ) {
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( a + i + 0 ), _mm_loadu_ps( b + i + 0 ) ) );
+		sum1 = _mm_add_ps( sum1, _mm_mul_ps( _mm_loadu_ps( a + i + 4 ), _mm_loadu_ps( b + i + 4 ) ) );
+	}
+	if ( i <= n - 4 ) {
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+		i += 4;
+	}
+	float sum = HorizontalAdd( _mm_add_ps( sum0, sum1 ) );
+	for ( ; i < n; i++ ) {
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+/*
+============
+MulAddRow
+
+  dst[i] += src[i] * s;
+============
+*/
+static ID_INLINE void MulAddRow( float *dst, const float *src, const float s, const int n ) {
+	const __m128 vs = _mm_set1_ps( s );
+	int i;
+	for ( i = 0; i <= n - 4; i += 4 ) {
+		_mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src + i ), vs ) ) );
+	}
+	for ( ; i < n; i++ ) {
+		dst[i] += src[i] * s;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::GetName
+============
+*/
+const char * idSIMD_SSE2Intrin::GetName( void ) const {
+	return "SSE2 intrinsics";
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Add
+
+  dst[i] = constant + src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Add( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( c, _mm_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = src[(X)] + constant
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Add
+
+  dst[i] = src0[i] + src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Add( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] + src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Sub
+
+  dst[i] = constant - src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Sub( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( c, _mm_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant - src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Sub
+
+  dst[i] = src0[i] - src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Sub( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] - src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Mul
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Mul( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_mul_ps( c, _mm_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant * src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Mul
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Mul( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_mul_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] * src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Div
+
+  dst[i] = constant / src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Div( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_div_ps( c, _mm_loadu_ps( src + (X) ) ) )
+#define OPER(X) dst[(X)] = constant / src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Div
+
+  dst[i] = src0[i] / src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Div( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_div_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) )
+#define OPER(X) dst[(X)] = src0[(X)] / src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MulAdd
+
+  dst[i] += constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MulAdd( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( _mm_loadu_ps( dst + (X) ), _mm_mul_ps( c, _mm_loadu_ps( src + (X) ) ) ) )
+#define OPER(X) dst[(X)] += constant * src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MulAdd
+
+  dst[i] += src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MulAdd( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( _mm_loadu_ps( dst + (X) ), _mm_mul_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) ) )
+#define OPER(X) dst[(X)] += src0[(X)] * src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MulSub
+
+  dst[i] -= constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MulSub( float *dst, const float constant, const float *src, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( _mm_loadu_ps( dst + (X) ), _mm_mul_ps( c, _mm_loadu_ps( src + (X) ) ) ) )
+#define OPER(X) dst[(X)] -= constant * src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MulSub
+
+  dst[i] -= src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MulSub( float *dst, const float *src0, const float *src1, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( _mm_loadu_ps( dst + (X) ), _mm_mul_ps( _mm_loadu_ps( src0 + (X) ), _mm_loadu_ps( src1 + (X) ) ) ) )
+#define OPER(X) dst[(X)] -= src0[(X)] * src1[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idVec3 &constant, const idVec3 *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x, y, z;
+		LoadVec3x4( src[i].ToFloatPtr(), x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant * src[i].Normal() + src[i][3];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idVec3 &constant, const idPlane *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, _mm_add_ps( d, w ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].Normal() + src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant * src[i].xyz;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idVec3 &constant, const idDrawVert *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant.x );
+	const __m128 cy = _mm_set1_ps( constant.y );
+	const __m128 cz = _mm_set1_ps( constant.z );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].xyz.ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].xyz.ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].xyz.ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].xyz;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x, y, z;
+		LoadVec3x4( src[i].ToFloatPtr(), x, y, z );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, _mm_add_ps( d, cd ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idPlane &constant, const idPlane *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, _mm_add_ps( d, _mm_mul_ps( cd, w ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = constant.Normal() * src[i].xyz + constant[3];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idPlane &constant, const idDrawVert *src, const int count ) {
+	const __m128 cx = _mm_set1_ps( constant[0] );
+	const __m128 cy = _mm_set1_ps( constant[1] );
+	const __m128 cz = _mm_set1_ps( constant[2] );
+	const __m128 cd = _mm_set1_ps( constant[3] );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x = _mm_loadu_ps( src[i+0].xyz.ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( src[i+1].xyz.ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( src[i+2].xyz.ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( src[i+3].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, x ), _mm_mul_ps( cy, y ) ), _mm_mul_ps( cz, z ) );
+		_mm_storeu_ps( dst + i, _mm_add_ps( d, cd ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].xyz + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float *dst, const idVec3 *src0, const idVec3 *src1, const int count ) {
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 x0, y0, z0, x1, y1, z1;
+		LoadVec3x4( src0[i].ToFloatPtr(), x0, y0, z0 );
+		LoadVec3x4( src1[i].ToFloatPtr(), x1, y1, z1 );
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x0, x1 ), _mm_mul_ps( y0, y1 ) ), _mm_mul_ps( z0, z1 ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	dot = DotRow( src1, src2, count );
+}
+
+/*
+============
+PackCompare16
+
+  packs the masks of sixteen float compares into sixteen bytes
+============
+*/
+static ID_INLINE __m128i PackCompare16( const __m128 m0, const __m128 m1, const __m128 m2, const __m128 m3 ) {
+	__m128i lo = _mm_packs_epi32( _mm_castps_si128( m0 ), _mm_castps_si128( m1 ) );
+	__m128i hi = _mm_packs_epi32( _mm_castps_si128( m2 ), _mm_castps_si128( m3 ) );
+	return _mm_packs_epi16( lo, hi );
+}
+
+#define COMPARE_CONSTANT( CMPPS, CMP )																\
+	const __m128 c = _mm_set1_ps( constant );														\
+	const __m128i one = _mm_set1_epi8( 1 );															\
+	int i;																							\
+	for ( i = 0; i <= count - 16; i += 16 ) {														\
+		__m128i m = PackCompare16(	CMPPS( _mm_loadu_ps( src0 + i +  0 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i +  4 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i +  8 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i + 12 ), c ) );					\
+		_mm_storeu_si128( (__m128i *)( dst + i ), _mm_and_si128( m, one ) );						\
+	}																								\
+	for ( ; i < count; i++ ) {																		\
+		dst[i] = src0[i] CMP constant;																\
+	}
+
+#define COMPARE_CONSTANT_BITNUM( CMPPS, CMP )														\
+	const __m128 c = _mm_set1_ps( constant );														\
+	const __m128i bit = _mm_set1_epi8( (char)( 1 << bitNum ) );										\
+	int i;																							\
+	for ( i = 0; i <= count - 16; i += 16 ) {														\
+		__m128i m = PackCompare16(	CMPPS( _mm_loadu_ps( src0 + i +  0 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i +  4 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i +  8 ), c ),						\
+									CMPPS( _mm_loadu_ps( src0 + i + 12 ), c ) );					\
+		__m128i d = _mm_loadu_si128( (const __m128i *)( dst + i ) );								\
+		_mm_storeu_si128( (__m128i *)( dst + i ), _mm_or_si128( d, _mm_and_si128( m, bit ) ) );	\
+	}																								\
+	for ( ; i < count; i++ ) {																		\
+		dst[i] |= ( src0[i] CMP constant ) << bitNum;												\
+	}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpGT
+
+  dst[i] = src0[i] > constant;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpGT( byte *dst, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT( _mm_cmpgt_ps, > )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpGT
+
+  dst[i] |= ( src0[i] > constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpGT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT_BITNUM( _mm_cmpgt_ps, > )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpGE
+
+  dst[i] = src0[i] >= constant;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpGE( byte *dst, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT( _mm_cmpge_ps, >= )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpGE
+
+  dst[i] |= ( src0[i] >= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpGE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT_BITNUM( _mm_cmpge_ps, >= )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpLT
+
+  dst[i] = src0[i] < constant;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpLT( byte *dst, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT( _mm_cmplt_ps, < )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpLT
+
+  dst[i] |= ( src0[i] < constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpLT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT_BITNUM( _mm_cmplt_ps, < )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpLE
+
+  dst[i] = src0[i] <= constant;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpLE( byte *dst, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT( _mm_cmple_ps, <= )
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CmpLE
+
+  dst[i] |= ( src0[i] <= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CmpLE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	COMPARE_CONSTANT_BITNUM( _mm_cmple_ps, <= )
+}
+
+#undef COMPARE_CONSTANT
+#undef COMPARE_CONSTANT_BITNUM
+
+/*
+============
+idSIMD_SSE2Intrin::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m128 vmin = _mm_set1_ps( idMath::INFINITY );
+	__m128 vmax = _mm_set1_ps( -idMath::INFINITY );
+	int i;
+
+	for ( i = 0; i <= count - 4; i += 4 ) {
+		__m128 v = _mm_loadu_ps( src + i );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	vmin = _mm_min_ps( vmin, _mm_movehl_ps( vmin, vmin ) );
+	vmax = _mm_max_ps( vmax, _mm_movehl_ps( vmax, vmax ) );
+	vmin = _mm_min_ss( vmin, _mm_shuffle_ps( vmin, vmin, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	vmax = _mm_max_ss( vmax, _mm_shuffle_ps( vmax, vmax, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+	for ( ; i < count; i++ ) {
+		__m128 v = _mm_load_ss( src + i );
+		vmin = _mm_min_ss( vmin, v );
+		vmax = _mm_max_ss( vmax, v );
+	}
+	_mm_store_ss( &min, vmin );
+	_mm_store_ss( &max, vmax );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	__m128 vmin = _mm_set1_ps( idMath::INFINITY );
+	__m128 vmax = _mm_set1_ps( -idMath::INFINITY );
+	const float *p = src->ToFloatPtr();
+	int i;
+
+	for ( i = 0; i <= count - 2; i += 2 ) {
+		__m128 v = _mm_loadu_ps( p + i * 2 );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	vmin = _mm_min_ps( vmin, _mm_movehl_ps( vmin, vmin ) );
+	vmax = _mm_max_ps( vmax, _mm_movehl_ps( vmax, vmax ) );
+	if ( i < count ) {
+		__m128 v = _mm_castpd_ps( _mm_load_sd( (const double *)( p + i * 2 ) ) );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	_mm_store_sd( (double *) min.ToFloatPtr(), _mm_castps_pd( vmin ) );
+	_mm_store_sd( (double *) max.ToFloatPtr(), _mm_castps_pd( vmax ) );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	__m128 vmin = _mm_set1_ps( idMath::INFINITY );
+	__m128 vmax = _mm_set1_ps( -idMath::INFINITY );
+	int i;
+
+	// reading four floats is safe for all but the last vector
+	for ( i = 0; i < count - 1; i++ ) {
+		__m128 v = _mm_loadu_ps( src[i].ToFloatPtr() );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	if ( i < count ) {
+		__m128 v = LoadVec3( src[i].ToFloatPtr() );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	StoreVec3( min.ToFloatPtr(), vmin );
+	StoreVec3( max.ToFloatPtr(), vmax );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	__m128 vmin = _mm_set1_ps( idMath::INFINITY );
+	__m128 vmax = _mm_set1_ps( -idMath::INFINITY );
+
+	for ( int i = 0; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[i].xyz.ToFloatPtr() );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	StoreVec3( min.ToFloatPtr(), vmin );
+	StoreVec3( max.ToFloatPtr(), vmax );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MinMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int *indexes, const int count ) {
+	__m128 vmin = _mm_set1_ps( idMath::INFINITY );
+	__m128 vmax = _mm_set1_ps( -idMath::INFINITY );
+
+	for ( int i = 0; i < count; i++ ) {
+		__m128 v = _mm_loadu_ps( src[indexes[i]].xyz.ToFloatPtr() );
+		vmin = _mm_min_ps( vmin, v );
+		vmax = _mm_max_ps( vmax, v );
+	}
+	StoreVec3( min.ToFloatPtr(), vmin );
+	StoreVec3( max.ToFloatPtr(), vmax );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Clamp
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Clamp( float *dst, const float *src, const float min, const float max, const int count ) {
+	const __m128 vmin = _mm_set1_ps( min );
+	const __m128 vmax = _mm_set1_ps( max );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_min_ps( _mm_max_ps( _mm_loadu_ps( src + (X) ), vmin ), vmax ) )
+#define OPER(X) dst[(X)] = src[(X)] < min ? min : src[(X)] > max ? max : src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::ClampMin
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::ClampMin( float *dst, const float *src, const float min, const int count ) {
+	const __m128 vmin = _mm_set1_ps( min );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_max_ps( _mm_loadu_ps( src + (X) ), vmin ) )
+#define OPER(X) dst[(X)] = src[(X)] < min ? min : src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::ClampMax
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::ClampMax( float *dst, const float *src, const float max, const int count ) {
+	const __m128 vmax = _mm_set1_ps( max );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_min_ps( _mm_loadu_ps( src + (X) ), vmax ) )
+#define OPER(X) dst[(X)] = src[(X)] > max ? max : src[(X)]
+	SIMD_LOOP4( OPER4, OPER )
+#undef OPER4
+#undef OPER
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Zero16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Zero16( float *dst, const int count ) {
+	const __m128 zero = _mm_setzero_ps();
+#define OPER4(X) _mm_storeu_ps( dst + (X), zero )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Negate16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Negate16( float *dst, const int count ) {
+	const __m128 signBit = _mm_castsi128_ps( _mm_set1_epi32( (int)0x80000000 ) );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_xor_ps( _mm_loadu_ps( dst + (X) ), signBit ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Copy16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Copy16( float *dst, const float *src, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_loadu_ps( src + (X) ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Add16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Add16( float *dst, const float *src1, const float *src2, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( _mm_loadu_ps( src1 + (X) ), _mm_loadu_ps( src2 + (X) ) ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Sub16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Sub16( float *dst, const float *src1, const float *src2, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( _mm_loadu_ps( src1 + (X) ), _mm_loadu_ps( src2 + (X) ) ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::Mul16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::Mul16( float *dst, const float *src1, const float constant, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_mul_ps( _mm_loadu_ps( src1 + (X) ), c ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::AddAssign16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::AddAssign16( float *dst, const float *src, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_add_ps( _mm_loadu_ps( dst + (X) ), _mm_loadu_ps( src + (X) ) ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::SubAssign16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::SubAssign16( float *dst, const float *src, const int count ) {
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_sub_ps( _mm_loadu_ps( dst + (X) ), _mm_loadu_ps( src + (X) ) ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MulAssign16
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MulAssign16( float *dst, const float constant, const int count ) {
+	const __m128 c = _mm_set1_ps( constant );
+#define OPER4(X) _mm_storeu_ps( dst + (X), _mm_mul_ps( _mm_loadu_ps( dst + (X) ), c ) )
+	SIMD_LOOP16( OPER4 )
+#undef OPER4
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_MultiplyVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_MultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumColumns() );
+	assert( dst.GetSize() >= mat.GetNumRows() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < numRows; i++ ) {
+		dstPtr[i] = DotRow( mat[i], vPtr, numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_MultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_MultiplyAddVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumColumns() );
+	assert( dst.GetSize() >= mat.GetNumRows() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < numRows; i++ ) {
+		dstPtr[i] += DotRow( mat[i], vPtr, numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_MultiplySubVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_MultiplySubVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumColumns() );
+	assert( dst.GetSize() >= mat.GetNumRows() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < numRows; i++ ) {
+		dstPtr[i] -= DotRow( mat[i], vPtr, numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_TransposeMultiplyVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_TransposeMultiplyVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumRows() );
+	assert( dst.GetSize() >= mat.GetNumColumns() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	memset( dstPtr, 0, numColumns * sizeof( float ) );
+	for ( int i = 0; i < numRows; i++ ) {
+		MulAddRow( dstPtr, mat[i], vPtr[i], numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_TransposeMultiplyAddVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_TransposeMultiplyAddVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumRows() );
+	assert( dst.GetSize() >= mat.GetNumColumns() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < numRows; i++ ) {
+		MulAddRow( dstPtr, mat[i], vPtr[i], numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_TransposeMultiplySubVecX
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_TransposeMultiplySubVecX( idVecX &dst, const idMatX &mat, const idVecX &vec ) {
+	assert( vec.GetSize() >= mat.GetNumRows() );
+	assert( dst.GetSize() >= mat.GetNumColumns() );
+
+	const int numRows = mat.GetNumRows();
+	const int numColumns = mat.GetNumColumns();
+	const float *vPtr = vec.ToFloatPtr();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < numRows; i++ ) {
+		MulAddRow( dstPtr, mat[i], -vPtr[i], numColumns );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_MultiplyMatX
+
+	dst = m1 * m2, computed one destination row at a time
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_MultiplyMatX( idMatX &dst, const idMatX &m1, const idMatX &m2 ) {
+	assert( m1.GetNumColumns() == m2.GetNumRows() );
+
+	const int k = m1.GetNumRows();
+	const int n = m1.GetNumColumns();
+	const int l = m2.GetNumColumns();
+	float *dstPtr = dst.ToFloatPtr();
+
+	for ( int i = 0; i < k; i++ ) {
+		const float *m1Ptr = m1[i];
+		memset( dstPtr, 0, l * sizeof( float ) );
+		for ( int j = 0; j < n; j++ ) {
+			MulAddRow( dstPtr, m2[j], m1Ptr[j], l );
+		}
+		dstPtr += l;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_TransposeMultiplyMatX
+
+	dst = m1.Transpose() * m2, accumulated over the shared rows
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_TransposeMultiplyMatX( idMatX &dst, const idMatX &m1, const idMatX &m2 ) {
+	assert( m1.GetNumRows() == m2.GetNumRows() );
+
+	const int n = m1.GetNumRows();
+	const int k = m1.GetNumColumns();
+	const int l = m2.GetNumColumns();
+	float *dstPtr = dst.ToFloatPtr();
+
+	memset( dstPtr, 0, k * l * sizeof( float ) );
+	for ( int r = 0; r < n; r++ ) {
+		const float *m1Ptr = m1[r];
+		const float *m2Ptr = m2[r];
+		for ( int i = 0; i < k; i++ ) {
+			MulAddRow( dstPtr + i * l, m2Ptr, m1Ptr[i], l );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_LowerTriangularSolve
+
+  solves x in Lx = b for the n * n sub-matrix of L
+  if skip > 0 the first skip elements of x are assumed to be valid already
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_LowerTriangularSolve( const idMatX &L, float *x, const float *b, const int n, int skip ) {
+	for ( int i = skip; i < n; i++ ) {
+		x[i] = b[i] - DotRow( L[i], x, i );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_LowerTriangularSolveTranspose
+
+  solves x in L'x = b for the n * n sub-matrix of L
+  L has to be a lower triangular matrix with (implicit) ones on the diagonal
+  x == b is allowed
+
+  each solved x[i] is subtracted from the remaining unknowns along row i of L
+  so all memory access is contiguous
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MatX_LowerTriangularSolveTranspose( const idMatX &L, float *x, const float *b, const int n ) {
+	if ( x != b ) {
+		memcpy( x, b, n * sizeof( float ) );
+	}
+	for ( int i = n - 1; i > 0; i-- ) {
+		MulAddRow( x, L[i], -x[i], i );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MatX_LDLTFactor
+
+  in-place factorization LDL' of the n * n sub-matrix of mat
+  the reciprocal of the diagonal elements are stored in invDiag
+============
+*/
+bool VPCALL idSIMD_SSE2Intrin::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const int n ) {
+	int i, j;
+	float *v, *diag, *mptr;
+	float s, sum, d;
+
+	v = (float *) _alloca16( n * sizeof( float ) );
+	diag = (float *) _alloca16( n * sizeof( float ) );
+
+	for ( i = 0; i < n; i++ ) {
+		mptr = mat[i];
+
+		// v = D * L[i]
+		for ( j = 0; j <= i - 4; j += 4 ) {
+			_mm_storeu_ps( v + j, _mm_mul_ps( _mm_loadu_ps( diag + j ), _mm_loadu_ps( mptr + j ) ) );
+		}
+		for ( ; j < i; j++ ) {
+			v[j] = diag[j] * mptr[j];
+		}
+
+		sum = mptr[i] - DotRow( v, mptr, i );
+		if ( sum == 0.0f ) {
+			return false;
+		}
+
+		mptr[i] = sum;
+		diag[i] = sum;
+		invDiag[i] = d = 1.0f / sum;
+
+		for ( j = i + 1; j < n; j++ ) {
+			mptr = mat[j];
+			s = DotRow( mptr, v, i );
+			mptr[i] = ( mptr[i] - s ) * d;
+		}
+	}
+	return true;
+}
+
+/*
+============
+idSIMD_SSE2Intrin::BlendJoints
+
+  slerps four joints at a time with the same approximations as idQuat::Slerp
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) {
+	int i;
+
+	if ( lerp <= 0.0f ) {
+		return;
+	} else if ( lerp >= 1.0f ) {
+		for ( i = 0; i < numJoints; i++ ) {
+			int j = index[i];
+			joints[j] = blendJoints[j];
+		}
+		return;
+	}
+
+	const __m128 vlerp = _mm_set1_ps( lerp );
+	const __m128 vlerp1 = _mm_set1_ps( 1.0f - lerp );
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 epsilon = _mm_set1_ps( 1e-6f );
+	const __m128 signBit = _mm_castsi128_ps( _mm_set1_epi32( (int)0x80000000 ) );
+
+	for ( i = 0; i <= numJoints - 4; i += 4 ) {
+		const int n0 = index[i+0];
+		const int n1 = index[i+1];
+		const int n2 = index[i+2];
+		const int n3 = index[i+3];
+
+		__m128 qx = _mm_loadu_ps( joints[n0].q.ToFloatPtr() );
+		__m128 qy = _mm_loadu_ps( joints[n1].q.ToFloatPtr() );
+		__m128 qz = _mm_loadu_ps( joints[n2].q.ToFloatPtr() );
+		__m128 qw = _mm_loadu_ps( joints[n3].q.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( qx, qy, qz, qw );
+
+		__m128 bx = _mm_loadu_ps( blendJoints[n0].q.ToFloatPtr() );
+		__m128 by = _mm_loadu_ps( blendJoints[n1].q.ToFloatPtr() );
+		__m128 bz = _mm_loadu_ps( blendJoints[n2].q.ToFloatPtr() );
+		__m128 bw = _mm_loadu_ps( blendJoints[n3].q.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( bx, by, bz, bw );
+
+		__m128 cosom = _mm_add_ps( _mm_add_ps( _mm_mul_ps( qx, bx ), _mm_mul_ps( qy, by ) ),
+									_mm_add_ps( _mm_mul_ps( qz, bz ), _mm_mul_ps( qw, bw ) ) );
+
+		// take the shortest path
+		const __m128 sign = _mm_and_ps( cosom, signBit );
+		cosom = _mm_xor_ps( cosom, sign );
+		bx = _mm_xor_ps( bx, sign );
+		by = _mm_xor_ps( by, sign );
+		bz = _mm_xor_ps( bz, sign );
+		bw = _mm_xor_ps( bw, sign );
+
+		// fall back to a linear interpolation for very small angles
+		const __m128 useSlerp = _mm_cmpgt_ps( _mm_sub_ps( one, cosom ), epsilon );
+
+		const __m128 sinSqr = _mm_max_ps( _mm_sub_ps( one, _mm_mul_ps( cosom, cosom ) ), _mm_set1_ps( FLT_MIN ) );
+		const __m128 sinom = _mm_div_ps( one, _mm_sqrt_ps( sinSqr ) );
+		const __m128 omega = ATan16( _mm_mul_ps( sinSqr, sinom ), cosom );
+
+		__m128 scale0 = _mm_mul_ps( Sin16( _mm_mul_ps( vlerp1, omega ) ), sinom );
+		__m128 scale1 = _mm_mul_ps( Sin16( _mm_mul_ps( vlerp, omega ) ), sinom );
+		scale0 = Select( useSlerp, scale0, vlerp1 );
+		scale1 = Select( useSlerp, scale1, vlerp );
+
+		qx = _mm_add_ps( _mm_mul_ps( scale0, qx ), _mm_mul_ps( scale1, bx ) );
+		qy = _mm_add_ps( _mm_mul_ps( scale0, qy ), _mm_mul_ps( scale1, by ) );
+		qz = _mm_add_ps( _mm_mul_ps( scale0, qz ), _mm_mul_ps( scale1, bz ) );
+		qw = _mm_add_ps( _mm_mul_ps( scale0, qw ), _mm_mul_ps( scale1, bw ) );
+		_MM_TRANSPOSE4_PS( qx, qy, qz, qw );
+
+		_mm_storeu_ps( joints[n0].q.ToFloatPtr(), qx );
+		_mm_storeu_ps( joints[n1].q.ToFloatPtr(), qy );
+		_mm_storeu_ps( joints[n2].q.ToFloatPtr(), qz );
+		_mm_storeu_ps( joints[n3].q.ToFloatPtr(), qw );
+
+		joints[n0].t.Lerp( joints[n0].t, blendJoints[n0].t, lerp );
+		joints[n1].t.Lerp( joints[n1].t, blendJoints[n1].t, lerp );
+		joints[n2].t.Lerp( joints[n2].t, blendJoints[n2].t, lerp );
+		joints[n3].t.Lerp( joints[n3].t, blendJoints[n3].t, lerp );
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		int j = index[i];
+		joints[j].q.Slerp( joints[j].q, blendJoints[j].q, lerp );
+		joints[j].t.Lerp( joints[j].t, blendJoints[j].t, lerp );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::ConvertJointQuatsToJointMats
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	const __m128 one = _mm_set1_ps( 1.0f );
+	int i;
+
+	assert( sizeof( idJointQuat ) == 7 * sizeof( float ) );
+	assert( sizeof( idJointMat ) == 12 * sizeof( float ) );
+
+	for ( i = 0; i <= numJoints - 4; i += 4 ) {
+		const idJointQuat *jq = jointQuats + i;
+
+		__m128 x = _mm_loadu_ps( jq[0].q.ToFloatPtr() );
+		__m128 y = _mm_loadu_ps( jq[1].q.ToFloatPtr() );
+		__m128 z = _mm_loadu_ps( jq[2].q.ToFloatPtr() );
+		__m128 w = _mm_loadu_ps( jq[3].q.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+
+		const __m128 x2 = _mm_add_ps( x, x );
+		const __m128 y2 = _mm_add_ps( y, y );
+		const __m128 z2 = _mm_add_ps( z, z );
+
+		const __m128 xx = _mm_mul_ps( x, x2 );
+		const __m128 xy = _mm_mul_ps( x, y2 );
+		const __m128 xz = _mm_mul_ps( x, z2 );
+		const __m128 yy = _mm_mul_ps( y, y2 );
+		const __m128 yz = _mm_mul_ps( y, z2 );
+		const __m128 zz = _mm_mul_ps( z, z2 );
+		const __m128 wx = _mm_mul_ps( w, x2 );
+		const __m128 wy = _mm_mul_ps( w, y2 );
+		const __m128 wz = _mm_mul_ps( w, z2 );
+
+		__m128 r00 = _mm_sub_ps( one, _mm_add_ps( yy, zz ) );
+		__m128 r01 = _mm_add_ps( xy, wz );
+		__m128 r02 = _mm_sub_ps( xz, wy );
+		__m128 r03 = _mm_setr_ps( jq[0].t.x, jq[1].t.x, jq[2].t.x, jq[3].t.x );
+
+		__m128 r10 = _mm_sub_ps( xy, wz );
+		__m128 r11 = _mm_sub_ps( one, _mm_add_ps( xx, zz ) );
+		__m128 r12 = _mm_add_ps( yz, wx );
+		__m128 r13 = _mm_setr_ps( jq[0].t.y, jq[1].t.y, jq[2].t.y, jq[3].t.y );
+
+		__m128 r20 = _mm_add_ps( xz, wy );
+		__m128 r21 = _mm_sub_ps( yz, wx );
+		__m128 r22 = _mm_sub_ps( one, _mm_add_ps( xx, yy ) );
+		__m128 r23 = _mm_setr_ps( jq[0].t.z, jq[1].t.z, jq[2].t.z, jq[3].t.z );
+
+		_MM_TRANSPOSE4_PS( r00, r01, r02, r03 );
+		_MM_TRANSPOSE4_PS( r10, r11, r12, r13 );
+		_MM_TRANSPOSE4_PS( r20, r21, r22, r23 );
+
+		float *m = jointMats[i].ToFloatPtr();
+		_mm_storeu_ps( m +  0, r00 );
+		_mm_storeu_ps( m +  4, r10 );
+		_mm_storeu_ps( m +  8, r20 );
+		_mm_storeu_ps( m + 12, r01 );
+		_mm_storeu_ps( m + 16, r11 );
+		_mm_storeu_ps( m + 20, r21 );
+		_mm_storeu_ps( m + 24, r02 );
+		_mm_storeu_ps( m + 28, r12 );
+		_mm_storeu_ps( m + 32, r22 );
+		_mm_storeu_ps( m + 36, r03 );
+		_mm_storeu_ps( m + 40, r13 );
+		_mm_storeu_ps( m + 44, r23 );
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		jointMats[i].SetRotation( jointQuats[i].q.ToMat3() );
+		jointMats[i].SetTranslation( jointQuats[i].t );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::TransformJoints
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m128 translationMask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+
+	for ( int i = firstJoint; i <= lastJoint; i++ ) {
+		assert( parents[i] < i );
+		const float *p = jointMats[parents[i]].ToFloatPtr();
+		float *m = jointMats[i].ToFloatPtr();
+
+		const __m128 m0 = _mm_loadu_ps( m + 0 );
+		const __m128 m1 = _mm_loadu_ps( m + 4 );
+		const __m128 m2 = _mm_loadu_ps( m + 8 );
+		const __m128 p0 = _mm_loadu_ps( p + 0 );
+		const __m128 p1 = _mm_loadu_ps( p + 4 );
+		const __m128 p2 = _mm_loadu_ps( p + 8 );
+
+		// row r of the result is p[r][0] * m0 + p[r][1] * m1 + p[r][2] * m2 + ( 0, 0, 0, p[r][3] )
+		__m128 r0 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		__m128 r1 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		__m128 r2 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		r0 = _mm_add_ps( r0, _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+		r1 = _mm_add_ps( r1, _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+		r2 = _mm_add_ps( r2, _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+		r0 = _mm_add_ps( r0, _mm_and_ps( p0, translationMask ) );
+		r1 = _mm_add_ps( r1, _mm_and_ps( p1, translationMask ) );
+		r2 = _mm_add_ps( r2, _mm_and_ps( p2, translationMask ) );
+
+		_mm_storeu_ps( m + 0, r0 );
+		_mm_storeu_ps( m + 4, r1 );
+		_mm_storeu_ps( m + 8, r2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::UntransformJoints
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::UntransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m128 translationMask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+
+	for ( int i = lastJoint; i >= firstJoint; i-- ) {
+		assert( parents[i] < i );
+		const float *p = jointMats[parents[i]].ToFloatPtr();
+		float *m = jointMats[i].ToFloatPtr();
+
+		__m128 p0 = _mm_loadu_ps( p + 0 );
+		__m128 p1 = _mm_loadu_ps( p + 4 );
+		__m128 p2 = _mm_loadu_ps( p + 8 );
+
+		// remove the parent translation first
+		const __m128 m0 = _mm_sub_ps( _mm_loadu_ps( m + 0 ), _mm_and_ps( p0, translationMask ) );
+		const __m128 m1 = _mm_sub_ps( _mm_loadu_ps( m + 4 ), _mm_and_ps( p1, translationMask ) );
+		const __m128 m2 = _mm_sub_ps( _mm_loadu_ps( m + 8 ), _mm_and_ps( p2, translationMask ) );
+
+		// row r of the result is p[0][r] * m0 + p[1][r] * m1 + p[2][r] * m2
+		__m128 p3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS( p0, p1, p2, p3 );
+
+		__m128 r0 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		__m128 r1 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		__m128 r2 = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 0, 0, 0, 0 ) ), m0 ), _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 1, 1, 1, 1 ) ), m1 ) );
+		r0 = _mm_add_ps( r0, _mm_mul_ps( _mm_shuffle_ps( p0, p0, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+		r1 = _mm_add_ps( r1, _mm_mul_ps( _mm_shuffle_ps( p1, p1, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+		r2 = _mm_add_ps( r2, _mm_mul_ps( _mm_shuffle_ps( p2, p2, R_SHUFFLEPS( 2, 2, 2, 2 ) ), m2 ) );
+
+		_mm_storeu_ps( m + 0, r0 );
+		_mm_storeu_ps( m + 4, r1 );
+		_mm_storeu_ps( m + 8, r2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::TransformVerts
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+	int i, j;
+
+	for ( j = i = 0; i < numVerts; i++ ) {
+		__m128 sum0 = _mm_setzero_ps();
+		__m128 sum1 = _mm_setzero_ps();
+		__m128 sum2 = _mm_setzero_ps();
+
+		while( 1 ) {
+			const float *m = (const float *)( jointsPtr + index[j*2+0] );
+			const __m128 w = _mm_loadu_ps( weights[j].ToFloatPtr() );
+			sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( m + 0 ), w ) );
+			sum1 = _mm_add_ps( sum1, _mm_mul_ps( _mm_loadu_ps( m + 4 ), w ) );
+			sum2 = _mm_add_ps( sum2, _mm_mul_ps( _mm_loadu_ps( m + 8 ), w ) );
+			if ( index[j*2+1] != 0 ) {
+				break;
+			}
+			j++;
+		}
+		j++;
+
+		__m128 sum3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS( sum0, sum1, sum2, sum3 );
+		StoreVec3( verts[i].xyz.ToFloatPtr(), _mm_add_ps( _mm_add_ps( sum0, sum1 ), _mm_add_ps( sum2, sum3 ) ) );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::TracePointCull
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	__m128 px = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 py = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 pz = _mm_loadu_ps( planes[2].ToFloatPtr() );
+	__m128 pd = _mm_loadu_ps( planes[3].ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( px, py, pz, pd );
+
+	const __m128 r = _mm_set1_ps( radius );
+	int tOr = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m128 x = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		const __m128 y = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		const __m128 z = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 2, 2, 2, 2 ) );
+		const __m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, x ), _mm_mul_ps( py, y ) ), _mm_mul_ps( pz, z ) ), pd );
+
+		int bits = _mm_movemask_ps( _mm_add_ps( d, r ) );
+		bits |= _mm_movemask_ps( _mm_sub_ps( d, r ) ) << 4;
+		bits ^= 0x0F;		// flip lower four bits
+
+		tOr |= bits;
+		cullBits[i] = (byte) bits;
+	}
+
+	totalOr = (byte) tOr;
+}
+
+/*
+============
+idSIMD_SSE2Intrin::DecalPointCull
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	__m128 p0x = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 p0y = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 p0z = _mm_loadu_ps( planes[2].ToFloatPtr() );
+	__m128 p0d = _mm_loadu_ps( planes[3].ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( p0x, p0y, p0z, p0d );
+
+	__m128 p1x = _mm_loadu_ps( planes[4].ToFloatPtr() );
+	__m128 p1y = _mm_loadu_ps( planes[5].ToFloatPtr() );
+	__m128 p1z = _mm_setzero_ps();
+	__m128 p1d = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( p1x, p1y, p1z, p1d );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m128 x = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		const __m128 y = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		const __m128 z = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 2, 2, 2, 2 ) );
+		const __m128 d0 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( p0x, x ), _mm_mul_ps( p0y, y ) ), _mm_mul_ps( p0z, z ) ), p0d );
+		const __m128 d1 = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( p1x, x ), _mm_mul_ps( p1y, y ) ), _mm_mul_ps( p1z, z ) ), p1d );
+
+		int bits = _mm_movemask_ps( d0 );
+		bits |= ( _mm_movemask_ps( d1 ) & 3 ) << 4;
+
+		cullBits[i] = (byte)( bits ^ 0x3F );		// flip lower 6 bits
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::OverlayPointCull
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	// ( plane0, plane1, plane0, plane1 ) transposed
+	__m128 px = _mm_loadu_ps( planes[0].ToFloatPtr() );
+	__m128 py = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	__m128 pz = px;
+	__m128 pd = py;
+	_MM_TRANSPOSE4_PS( px, py, pz, pd );
+
+	// ( d0, d1, 1 - d0, 1 - d1 )
+	const __m128 scale = _mm_setr_ps( 1.0f, 1.0f, -1.0f, -1.0f );
+	const __m128 bias = _mm_setr_ps( 0.0f, 0.0f, 1.0f, 1.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_loadu_ps( verts[i].xyz.ToFloatPtr() );
+		const __m128 x = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		const __m128 y = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		const __m128 z = _mm_shuffle_ps( v, v, R_SHUFFLEPS( 2, 2, 2, 2 ) );
+		const __m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, x ), _mm_mul_ps( py, y ) ), _mm_mul_ps( pz, z ) ), pd );
+
+		_mm_store_sd( (double *) texCoords[i].ToFloatPtr(), _mm_castps_pd( d ) );
+		cullBits[i] = (byte) _mm_movemask_ps( _mm_add_ps( _mm_mul_ps( d, scale ), bias ) );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CullBounds
+
+  four bounds at a time, the planes pick the same corners for all of them
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CullBounds( byte *culled, const idPlane *planes, const int numPlanes, const float *bounds, const int stride, const int numBounds ) {
+	const __m128 zero = _mm_setzero_ps();
+	int i;
+
+	for ( i = 0; i + 4 <= numBounds; i += 4 ) {
+		__m128 out = zero;
+
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const idPlane &p = planes[j];
+
+			const __m128 x = _mm_loadu_ps( bounds + ( p[0] > 0.0f ? 0 : 3 ) * stride + i );
+			const __m128 y = _mm_loadu_ps( bounds + ( p[1] > 0.0f ? 1 : 4 ) * stride + i );
+			const __m128 z = _mm_loadu_ps( bounds + ( p[2] > 0.0f ? 2 : 5 ) * stride + i );
+
+			const __m128 d = _mm_add_ps( _mm_add_ps( _mm_add_ps(	_mm_mul_ps( _mm_set1_ps( p[0] ), x ),
+																	_mm_mul_ps( _mm_set1_ps( p[1] ), y ) ),
+																	_mm_mul_ps( _mm_set1_ps( p[2] ), z ) ), _mm_set1_ps( p[3] ) );
+
+			out = _mm_or_ps( out, _mm_cmpge_ps( d, zero ) );
+			if ( _mm_movemask_ps( out ) == 0x0F ) {
+				break;
+			}
+		}
+
+		const int bits = _mm_movemask_ps( out );
+		culled[i+0] = (byte)( ( bits >> 0 ) & 1 );
+		culled[i+1] = (byte)( ( bits >> 1 ) & 1 );
+		culled[i+2] = (byte)( ( bits >> 2 ) & 1 );
+		culled[i+3] = (byte)( ( bits >> 3 ) & 1 );
+	}
+
+	idSIMD_Generic::CullBounds( culled + i, planes, numPlanes, bounds + i, stride, numBounds - i );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::DeriveTriPlanes
+
+	Derives a plane equation for each triangle.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	for ( i = 0; i <= numIndexes - 12; i += 12 ) {
+		__m128 ax = _mm_loadu_ps( verts[indexes[i+0]].xyz.ToFloatPtr() );
+		__m128 ay = _mm_loadu_ps( verts[indexes[i+3]].xyz.ToFloatPtr() );
+		__m128 az = _mm_loadu_ps( verts[indexes[i+6]].xyz.ToFloatPtr() );
+		__m128 aw = _mm_loadu_ps( verts[indexes[i+9]].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( ax, ay, az, aw );
+
+		__m128 bx = _mm_loadu_ps( verts[indexes[i+1]].xyz.ToFloatPtr() );
+		__m128 by = _mm_loadu_ps( verts[indexes[i+4]].xyz.ToFloatPtr() );
+		__m128 bz = _mm_loadu_ps( verts[indexes[i+7]].xyz.ToFloatPtr() );
+		__m128 bw = _mm_loadu_ps( verts[indexes[i+10]].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( bx, by, bz, bw );
+
+		__m128 cx = _mm_loadu_ps( verts[indexes[i+2]].xyz.ToFloatPtr() );
+		__m128 cy = _mm_loadu_ps( verts[indexes[i+5]].xyz.ToFloatPtr() );
+		__m128 cz = _mm_loadu_ps( verts[indexes[i+8]].xyz.ToFloatPtr() );
+		__m128 cw = _mm_loadu_ps( verts[indexes[i+11]].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( cx, cy, cz, cw );
+
+		const __m128 d0x = _mm_sub_ps( bx, ax );
+		const __m128 d0y = _mm_sub_ps( by, ay );
+		const __m128 d0z = _mm_sub_ps( bz, az );
+		const __m128 d1x = _mm_sub_ps( cx, ax );
+		const __m128 d1y = _mm_sub_ps( cy, ay );
+		const __m128 d1z = _mm_sub_ps( cz, az );
+
+		__m128 nx = _mm_sub_ps( _mm_mul_ps( d1y, d0z ), _mm_mul_ps( d1z, d0y ) );
+		__m128 ny = _mm_sub_ps( _mm_mul_ps( d1z, d0x ), _mm_mul_ps( d1x, d0z ) );
+		__m128 nz = _mm_sub_ps( _mm_mul_ps( d1x, d0y ), _mm_mul_ps( d1y, d0x ) );
+
+		const __m128 f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+
+		__m128 nd = _mm_sub_ps( _mm_setzero_ps(), _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, ax ), _mm_mul_ps( ny, ay ) ), _mm_mul_ps( nz, az ) ) );
+		_MM_TRANSPOSE4_PS( nx, ny, nz, nd );
+
+		_mm_storeu_ps( planes[0].ToFloatPtr(), nx );
+		_mm_storeu_ps( planes[1].ToFloatPtr(), ny );
+		_mm_storeu_ps( planes[2].ToFloatPtr(), nz );
+		_mm_storeu_ps( planes[3].ToFloatPtr(), nd );
+		planes += 4;
+	}
+
+	for ( ; i < numIndexes; i += 3 ) {
+		const idDrawVert *a, *b, *c;
+		float d0[3], d1[3], f;
+		idVec3 n;
+
+		a = verts + indexes[i + 0];
+		b = verts + indexes[i + 1];
+		c = verts + indexes[i + 2];
+
+		d0[0] = b->xyz[0] - a->xyz[0];
+		d0[1] = b->xyz[1] - a->xyz[1];
+		d0[2] = b->xyz[2] - a->xyz[2];
+
+		d1[0] = c->xyz[0] - a->xyz[0];
+		d1[1] = c->xyz[1] - a->xyz[1];
+		d1[2] = c->xyz[2] - a->xyz[2];
+
+		n[0] = d1[1] * d0[2] - d1[2] * d0[1];
+		n[1] = d1[2] * d0[0] - d1[0] * d0[2];
+		n[2] = d1[0] * d0[1] - d1[1] * d0[0];
+
+		f = idMath::RSqrt( n.x * n.x + n.y * n.y + n.z * n.z );
+
+		n.x *= f;
+		n.y *= f;
+		n.z *= f;
+
+		planes->SetNormal( n );
+		planes->FitThroughPoint( a->xyz );
+		planes++;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::DeriveTangents
+
+	Derives the normal and orthogonal tangent vectors for the triangle vertices.
+	The per triangle math is done for four triangles at a time, accumulating
+	into the vertices stays scalar because triangles share vertices.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i, j;
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	const __m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( (int)0x80000000 ) );
+
+	ALIGN16( float tri[9][4] );
+
+	for ( i = 0; i < numIndexes; i += 12 ) {
+		const int numTris = Min( 4, ( numIndexes - i ) / 3 );
+		idDrawVert *vert[4][3];
+
+		for ( j = 0; j < 4; j++ ) {
+			// replicate the last triangle to fill up the vectors
+			const int t = i + Min( j, numTris - 1 ) * 3;
+			vert[j][0] = verts + indexes[t + 0];
+			vert[j][1] = verts + indexes[t + 1];
+			vert[j][2] = verts + indexes[t + 2];
+		}
+
+		// the fourth component of xyz is st[0]
+		__m128 ax = _mm_loadu_ps( vert[0][0]->xyz.ToFloatPtr() );
+		__m128 ay = _mm_loadu_ps( vert[1][0]->xyz.ToFloatPtr() );
+		__m128 az = _mm_loadu_ps( vert[2][0]->xyz.ToFloatPtr() );
+		__m128 as = _mm_loadu_ps( vert[3][0]->xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( ax, ay, az, as );
+		const __m128 at = _mm_setr_ps( vert[0][0]->st[1], vert[1][0]->st[1], vert[2][0]->st[1], vert[3][0]->st[1] );
+
+		__m128 bx = _mm_loadu_ps( vert[0][1]->xyz.ToFloatPtr() );
+		__m128 by = _mm_loadu_ps( vert[1][1]->xyz.ToFloatPtr() );
+		__m128 bz = _mm_loadu_ps( vert[2][1]->xyz.ToFloatPtr() );
+		__m128 bs = _mm_loadu_ps( vert[3][1]->xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( bx, by, bz, bs );
+		const __m128 bt = _mm_setr_ps( vert[0][1]->st[1], vert[1][1]->st[1], vert[2][1]->st[1], vert[3][1]->st[1] );
+
+		__m128 cx = _mm_loadu_ps( vert[0][2]->xyz.ToFloatPtr() );
+		__m128 cy = _mm_loadu_ps( vert[1][2]->xyz.ToFloatPtr() );
+		__m128 cz = _mm_loadu_ps( vert[2][2]->xyz.ToFloatPtr() );
+		__m128 cs = _mm_loadu_ps( vert[3][2]->xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( cx, cy, cz, cs );
+		const __m128 ct = _mm_setr_ps( vert[0][2]->st[1], vert[1][2]->st[1], vert[2][2]->st[1], vert[3][2]->st[1] );
+
+		const __m128 d0x = _mm_sub_ps( bx, ax );
+		const __m128 d0y = _mm_sub_ps( by, ay );
+		const __m128 d0z = _mm_sub_ps( bz, az );
+		const __m128 d0s = _mm_sub_ps( bs, as );
+		const __m128 d0t = _mm_sub_ps( bt, at );
+
+		const __m128 d1x = _mm_sub_ps( cx, ax );
+		const __m128 d1y = _mm_sub_ps( cy, ay );
+		const __m128 d1z = _mm_sub_ps( cz, az );
+		const __m128 d1s = _mm_sub_ps( cs, as );
+		const __m128 d1t = _mm_sub_ps( ct, at );
+
+		// normal
+		__m128 nx = _mm_sub_ps( _mm_mul_ps( d1y, d0z ), _mm_mul_ps( d1z, d0y ) );
+		__m128 ny = _mm_sub_ps( _mm_mul_ps( d1z, d0x ), _mm_mul_ps( d1x, d0z ) );
+		__m128 nz = _mm_sub_ps( _mm_mul_ps( d1x, d0y ), _mm_mul_ps( d1y, d0x ) );
+		__m128 f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+
+		// area sign bit
+		const __m128 area = _mm_sub_ps( _mm_mul_ps( d0s, d1t ), _mm_mul_ps( d0t, d1s ) );
+		const __m128 signBit = _mm_and_ps( area, signMask );
+
+		// first tangent
+		__m128 t0x = _mm_sub_ps( _mm_mul_ps( d0x, d1t ), _mm_mul_ps( d0t, d1x ) );
+		__m128 t0y = _mm_sub_ps( _mm_mul_ps( d0y, d1t ), _mm_mul_ps( d0t, d1y ) );
+		__m128 t0z = _mm_sub_ps( _mm_mul_ps( d0z, d1t ), _mm_mul_ps( d0t, d1z ) );
+		f = _mm_xor_ps( ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( t0x, t0x ), _mm_mul_ps( t0y, t0y ) ), _mm_mul_ps( t0z, t0z ) ) ), signBit );
+		t0x = _mm_mul_ps( t0x, f );
+		t0y = _mm_mul_ps( t0y, f );
+		t0z = _mm_mul_ps( t0z, f );
+
+		// second tangent
+		__m128 t1x = _mm_sub_ps( _mm_mul_ps( d0s, d1x ), _mm_mul_ps( d0x, d1s ) );
+		__m128 t1y = _mm_sub_ps( _mm_mul_ps( d0s, d1y ), _mm_mul_ps( d0y, d1s ) );
+		__m128 t1z = _mm_sub_ps( _mm_mul_ps( d0s, d1z ), _mm_mul_ps( d0z, d1s ) );
+		f = _mm_xor_ps( ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( t1x, t1x ), _mm_mul_ps( t1y, t1y ) ), _mm_mul_ps( t1z, t1z ) ) ), signBit );
+		t1x = _mm_mul_ps( t1x, f );
+		t1y = _mm_mul_ps( t1y, f );
+		t1z = _mm_mul_ps( t1z, f );
+
+		// planes
+		__m128 px = nx;
+		__m128 py = ny;
+		__m128 pz = nz;
+		__m128 pd = _mm_sub_ps( _mm_setzero_ps(), _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, ax ), _mm_mul_ps( ny, ay ) ), _mm_mul_ps( nz, az ) ) );
+		_MM_TRANSPOSE4_PS( px, py, pz, pd );
+		const __m128 p[4] = { px, py, pz, pd };
+		for ( j = 0; j < numTris; j++ ) {
+			_mm_storeu_ps( planes[j].ToFloatPtr(), p[j] );
+		}
+		planes += numTris;
+
+		_mm_storeu_ps( tri[0], nx );
+		_mm_storeu_ps( tri[1], ny );
+		_mm_storeu_ps( tri[2], nz );
+		_mm_storeu_ps( tri[3], t0x );
+		_mm_storeu_ps( tri[4], t0y );
+		_mm_storeu_ps( tri[5], t0z );
+		_mm_storeu_ps( tri[6], t1x );
+		_mm_storeu_ps( tri[7], t1y );
+		_mm_storeu_ps( tri[8], t1z );
+
+		for ( j = 0; j < numTris; j++ ) {
+			const idVec3 n( tri[0][j], tri[1][j], tri[2][j] );
+			const idVec3 t0( tri[3][j], tri[4][j], tri[5][j] );
+			const idVec3 t1( tri[6][j], tri[7][j], tri[8][j] );
+
+			for ( int k = 0; k < 3; k++ ) {
+				idDrawVert *v = vert[j][k];
+				const int vi = indexes[i + j * 3 + k];
+				if ( used[vi] ) {
+					v->normal += n;
+					v->tangents[0] += t0;
+					v->tangents[1] += t1;
+				} else {
+					v->normal = n;
+					v->tangents[0] = t0;
+					v->tangents[1] = t1;
+					used[vi] = true;
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::DeriveUnsmoothedTangents
+
+	Derives the normal and orthogonal tangent vectors for the triangle vertices.
+	For each vertex the normal and tangent vectors are derived from a single dominant triangle.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts ) {
+	int i;
+
+	for ( i = 0; i <= numVerts - 4; i += 4 ) {
+		const idDrawVert *a = verts + i;
+		const dominantTri_s *dt = dominantTris + i;
+		const idDrawVert *b[4] = { verts + dt[0].v2, verts + dt[1].v2, verts + dt[2].v2, verts + dt[3].v2 };
+		const idDrawVert *c[4] = { verts + dt[0].v3, verts + dt[1].v3, verts + dt[2].v3, verts + dt[3].v3 };
+
+		__m128 ax = _mm_loadu_ps( a[0].xyz.ToFloatPtr() );
+		__m128 ay = _mm_loadu_ps( a[1].xyz.ToFloatPtr() );
+		__m128 az = _mm_loadu_ps( a[2].xyz.ToFloatPtr() );
+		__m128 aw = _mm_loadu_ps( a[3].xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( ax, ay, az, aw );
+		const __m128 at = _mm_setr_ps( a[0].st[1], a[1].st[1], a[2].st[1], a[3].st[1] );
+
+		__m128 bx = _mm_loadu_ps( b[0]->xyz.ToFloatPtr() );
+		__m128 by = _mm_loadu_ps( b[1]->xyz.ToFloatPtr() );
+		__m128 bz = _mm_loadu_ps( b[2]->xyz.ToFloatPtr() );
+		__m128 bw = _mm_loadu_ps( b[3]->xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( bx, by, bz, bw );
+		const __m128 bt = _mm_setr_ps( b[0]->st[1], b[1]->st[1], b[2]->st[1], b[3]->st[1] );
+
+		__m128 cx = _mm_loadu_ps( c[0]->xyz.ToFloatPtr() );
+		__m128 cy = _mm_loadu_ps( c[1]->xyz.ToFloatPtr() );
+		__m128 cz = _mm_loadu_ps( c[2]->xyz.ToFloatPtr() );
+		__m128 cw = _mm_loadu_ps( c[3]->xyz.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( cx, cy, cz, cw );
+		const __m128 ct = _mm_setr_ps( c[0]->st[1], c[1]->st[1], c[2]->st[1], c[3]->st[1] );
+
+		const __m128 s0 = _mm_setr_ps( dt[0].normalizationScale[0], dt[1].normalizationScale[0], dt[2].normalizationScale[0], dt[3].normalizationScale[0] );
+		const __m128 s1 = _mm_setr_ps( dt[0].normalizationScale[1], dt[1].normalizationScale[1], dt[2].normalizationScale[1], dt[3].normalizationScale[1] );
+		const __m128 s2 = _mm_setr_ps( dt[0].normalizationScale[2], dt[1].normalizationScale[2], dt[2].normalizationScale[2], dt[3].normalizationScale[2] );
+
+		const __m128 d0 = _mm_sub_ps( bx, ax );
+		const __m128 d1 = _mm_sub_ps( by, ay );
+		const __m128 d2 = _mm_sub_ps( bz, az );
+		const __m128 d4 = _mm_sub_ps( bt, at );
+		const __m128 d5 = _mm_sub_ps( cx, ax );
+		const __m128 d6 = _mm_sub_ps( cy, ay );
+		const __m128 d7 = _mm_sub_ps( cz, az );
+		const __m128 d9 = _mm_sub_ps( ct, at );
+
+		__m128 n0 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d6, d2 ), _mm_mul_ps( d7, d1 ) ) );
+		__m128 n1 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d7, d0 ), _mm_mul_ps( d5, d2 ) ) );
+		__m128 n2 = _mm_mul_ps( s2, _mm_sub_ps( _mm_mul_ps( d5, d1 ), _mm_mul_ps( d6, d0 ) ) );
+
+		__m128 t0 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d0, d9 ), _mm_mul_ps( d4, d5 ) ) );
+		__m128 t1 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d1, d9 ), _mm_mul_ps( d4, d6 ) ) );
+		__m128 t2 = _mm_mul_ps( s0, _mm_sub_ps( _mm_mul_ps( d2, d9 ), _mm_mul_ps( d4, d7 ) ) );
+
+		__m128 t3 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n2, t1 ), _mm_mul_ps( n1, t2 ) ) );
+		__m128 t4 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n0, t2 ), _mm_mul_ps( n2, t0 ) ) );
+		__m128 t5 = _mm_mul_ps( s1, _mm_sub_ps( _mm_mul_ps( n1, t0 ), _mm_mul_ps( n0, t1 ) ) );
+
+		ALIGN16( float last[4] );
+		_mm_storeu_ps( last, t5 );
+
+		// normal, tangents[0] and tangents[1] are nine consecutive floats
+		_MM_TRANSPOSE4_PS( n0, n1, n2, t0 );
+		_MM_TRANSPOSE4_PS( t1, t2, t3, t4 );
+
+		_mm_storeu_ps( verts[i+0].normal.ToFloatPtr(), n0 );
+		_mm_storeu_ps( verts[i+0].normal.ToFloatPtr() + 4, t1 );
+		verts[i+0].tangents[1][2] = last[0];
+		_mm_storeu_ps( verts[i+1].normal.ToFloatPtr(), n1 );
+		_mm_storeu_ps( verts[i+1].normal.ToFloatPtr() + 4, t2 );
+		verts[i+1].tangents[1][2] = last[1];
+		_mm_storeu_ps( verts[i+2].normal.ToFloatPtr(), n2 );
+		_mm_storeu_ps( verts[i+2].normal.ToFloatPtr() + 4, t3 );
+		verts[i+2].tangents[1][2] = last[2];
+		_mm_storeu_ps( verts[i+3].normal.ToFloatPtr(), t0 );
+		_mm_storeu_ps( verts[i+3].normal.ToFloatPtr() + 4, t4 );
+		verts[i+3].tangents[1][2] = last[3];
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		idDrawVert *a, *b, *c;
+		float d0, d1, d2, d4;
+		float d5, d6, d7, d9;
+		float s0, s1, s2;
+		float n0, n1, n2;
+		float t0, t1, t2;
+		float t3, t4, t5;
+
+		const dominantTri_s &dt = dominantTris[i];
+
+		a = verts + i;
+		b = verts + dt.v2;
+		c = verts + dt.v3;
+
+		d0 = b->xyz[0] - a->xyz[0];
+		d1 = b->xyz[1] - a->xyz[1];
+		d2 = b->xyz[2] - a->xyz[2];
+		d4 = b->st[1] - a->st[1];
+
+		d5 = c->xyz[0] - a->xyz[0];
+		d6 = c->xyz[1] - a->xyz[1];
+		d7 = c->xyz[2] - a->xyz[2];
+		d9 = c->st[1] - a->st[1];
+
+		s0 = dt.normalizationScale[0];
+		s1 = dt.normalizationScale[1];
+		s2 = dt.normalizationScale[2];
+
+		n0 = s2 * ( d6 * d2 - d7 * d1 );
+		n1 = s2 * ( d7 * d0 - d5 * d2 );
+		n2 = s2 * ( d5 * d1 - d6 * d0 );
+
+		t0 = s0 * ( d0 * d9 - d4 * d5 );
+		t1 = s0 * ( d1 * d9 - d4 * d6 );
+		t2 = s0 * ( d2 * d9 - d4 * d7 );
+
+		t3 = s1 * ( n2 * t1 - n1 * t2 );
+		t4 = s1 * ( n0 * t2 - n2 * t0 );
+		t5 = s1 * ( n1 * t0 - n0 * t1 );
+
+		a->normal[0] = n0;
+		a->normal[1] = n1;
+		a->normal[2] = n2;
+
+		a->tangents[0][0] = t0;
+		a->tangents[0][1] = t1;
+		a->tangents[0][2] = t2;
+
+		a->tangents[1][0] = t3;
+		a->tangents[1][1] = t4;
+		a->tangents[1][2] = t5;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::NormalizeTangents
+
+	Normalizes each vertex normal and projects and normalizes the
+	tangent vectors onto the plane orthogonal to the vertex normal.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::NormalizeTangents( idDrawVert *verts, const int numVerts ) {
+	int i;
+
+	for ( i = 0; i <= numVerts - 4; i += 4 ) {
+		idDrawVert *v = verts + i;
+
+		// normal, tangents[0] and tangents[1] are nine consecutive floats
+		__m128 nx = _mm_loadu_ps( v[0].normal.ToFloatPtr() );
+		__m128 ny = _mm_loadu_ps( v[1].normal.ToFloatPtr() );
+		__m128 nz = _mm_loadu_ps( v[2].normal.ToFloatPtr() );
+		__m128 ax = _mm_loadu_ps( v[3].normal.ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( nx, ny, nz, ax );
+
+		__m128 ay = _mm_loadu_ps( v[0].normal.ToFloatPtr() + 4 );
+		__m128 az = _mm_loadu_ps( v[1].normal.ToFloatPtr() + 4 );
+		__m128 bx = _mm_loadu_ps( v[2].normal.ToFloatPtr() + 4 );
+		__m128 by = _mm_loadu_ps( v[3].normal.ToFloatPtr() + 4 );
+		_MM_TRANSPOSE4_PS( ay, az, bx, by );
+
+		__m128 bz = _mm_setr_ps( v[0].tangents[1][2], v[1].tangents[1][2], v[2].tangents[1][2], v[3].tangents[1][2] );
+
+		__m128 f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) ) );
+		nx = _mm_mul_ps( nx, f );
+		ny = _mm_mul_ps( ny, f );
+		nz = _mm_mul_ps( nz, f );
+
+		__m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, nx ), _mm_mul_ps( ay, ny ) ), _mm_mul_ps( az, nz ) );
+		ax = _mm_sub_ps( ax, _mm_mul_ps( d, nx ) );
+		ay = _mm_sub_ps( ay, _mm_mul_ps( d, ny ) );
+		az = _mm_sub_ps( az, _mm_mul_ps( d, nz ) );
+		f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, ax ), _mm_mul_ps( ay, ay ) ), _mm_mul_ps( az, az ) ) );
+		ax = _mm_mul_ps( ax, f );
+		ay = _mm_mul_ps( ay, f );
+		az = _mm_mul_ps( az, f );
+
+		d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( bx, nx ), _mm_mul_ps( by, ny ) ), _mm_mul_ps( bz, nz ) );
+		bx = _mm_sub_ps( bx, _mm_mul_ps( d, nx ) );
+		by = _mm_sub_ps( by, _mm_mul_ps( d, ny ) );
+		bz = _mm_sub_ps( bz, _mm_mul_ps( d, nz ) );
+		f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( bx, bx ), _mm_mul_ps( by, by ) ), _mm_mul_ps( bz, bz ) ) );
+		bx = _mm_mul_ps( bx, f );
+		by = _mm_mul_ps( by, f );
+		bz = _mm_mul_ps( bz, f );
+
+		ALIGN16( float last[4] );
+		_mm_storeu_ps( last, bz );
+
+		_MM_TRANSPOSE4_PS( nx, ny, nz, ax );
+		_MM_TRANSPOSE4_PS( ay, az, bx, by );
+
+		_mm_storeu_ps( v[0].normal.ToFloatPtr(), nx );
+		_mm_storeu_ps( v[0].normal.ToFloatPtr() + 4, ay );
+		v[0].tangents[1][2] = last[0];
+		_mm_storeu_ps( v[1].normal.ToFloatPtr(), ny );
+		_mm_storeu_ps( v[1].normal.ToFloatPtr() + 4, az );
+		v[1].tangents[1][2] = last[1];
+		_mm_storeu_ps( v[2].normal.ToFloatPtr(), nz );
+		_mm_storeu_ps( v[2].normal.ToFloatPtr() + 4, bx );
+		v[2].tangents[1][2] = last[2];
+		_mm_storeu_ps( v[3].normal.ToFloatPtr(), ax );
+		_mm_storeu_ps( v[3].normal.ToFloatPtr() + 4, by );
+		v[3].tangents[1][2] = last[3];
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		idVec3 &v = verts[i].normal;
+		float f;
+
+		f = idMath::RSqrt( v.x * v.x + v.y * v.y + v.z * v.z );
+		v.x *= f; v.y *= f; v.z *= f;
+
+		for ( int j = 0; j < 2; j++ ) {
+			idVec3 &t = verts[i].tangents[j];
+
+			t -= ( t * v ) * v;
+			f = idMath::RSqrt( t.x * t.x + t.y * t.y + t.z * t.z );
+			t.x *= f; t.y *= f; t.z *= f;
+		}
+	}
+}
+
+/*
+============
+LoadTextureSpace
+
+  loads the xyz, normal and tangents of four vertices as structure of arrays
+============
+*/
+static ID_INLINE void LoadTextureSpace( const idDrawVert *v, __m128 xyz[3], __m128 t0[3], __m128 t1[3], __m128 n[3] ) {
+	__m128 w;
+
+	xyz[0] = _mm_loadu_ps( v[0].xyz.ToFloatPtr() );
+	xyz[1] = _mm_loadu_ps( v[1].xyz.ToFloatPtr() );
+	xyz[2] = _mm_loadu_ps( v[2].xyz.ToFloatPtr() );
+	w = _mm_loadu_ps( v[3].xyz.ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( xyz[0], xyz[1], xyz[2], w );
+
+	n[0] = _mm_loadu_ps( v[0].normal.ToFloatPtr() );
+	n[1] = _mm_loadu_ps( v[1].normal.ToFloatPtr() );
+	n[2] = _mm_loadu_ps( v[2].normal.ToFloatPtr() );
+	t0[0] = _mm_loadu_ps( v[3].normal.ToFloatPtr() );
+	_MM_TRANSPOSE4_PS( n[0], n[1], n[2], t0[0] );
+
+	t0[1] = _mm_loadu_ps( v[0].normal.ToFloatPtr() + 4 );
+	t0[2] = _mm_loadu_ps( v[1].normal.ToFloatPtr() + 4 );
+	t1[0] = _mm_loadu_ps( v[2].normal.ToFloatPtr() + 4 );
+	t1[1] = _mm_loadu_ps( v[3].normal.ToFloatPtr() + 4 );
+	_MM_TRANSPOSE4_PS( t0[1], t0[2], t1[0], t1[1] );
+
+	t1[2] = _mm_setr_ps( v[0].tangents[1][2], v[1].tangents[1][2], v[2].tangents[1][2], v[3].tangents[1][2] );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CreateTextureSpaceLightVectors
+
+	Calculates light vectors in texture space for the given triangle vertices.
+	For each vertex the direction towards the light origin is projected onto texture space.
+	The light vectors are only calculated for the vertices referenced by the indexes.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CreateTextureSpaceLightVectors( idVec3 *lightVectors, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( i = numIndexes - 1; i >= 0; i-- ) {
+		used[indexes[i]] = true;
+	}
+
+	const __m128 lx = _mm_set1_ps( lightOrigin.x );
+	const __m128 ly = _mm_set1_ps( lightOrigin.y );
+	const __m128 lz = _mm_set1_ps( lightOrigin.z );
+
+	ALIGN16( float out[3][4] );
+
+	for ( i = 0; i <= numVerts - 4; i += 4 ) {
+		if ( !( used[i+0] | used[i+1] | used[i+2] | used[i+3] ) ) {
+			continue;
+		}
+
+		__m128 xyz[3], t0[3], t1[3], n[3];
+		LoadTextureSpace( verts + i, xyz, t0, t1, n );
+
+		const __m128 dx = _mm_sub_ps( lx, xyz[0] );
+		const __m128 dy = _mm_sub_ps( ly, xyz[1] );
+		const __m128 dz = _mm_sub_ps( lz, xyz[2] );
+
+		_mm_storeu_ps( out[0], _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, t0[0] ), _mm_mul_ps( dy, t0[1] ) ), _mm_mul_ps( dz, t0[2] ) ) );
+		_mm_storeu_ps( out[1], _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, t1[0] ), _mm_mul_ps( dy, t1[1] ) ), _mm_mul_ps( dz, t1[2] ) ) );
+		_mm_storeu_ps( out[2], _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, n[0] ), _mm_mul_ps( dy, n[1] ) ), _mm_mul_ps( dz, n[2] ) ) );
+
+		for ( int j = 0; j < 4; j++ ) {
+			if ( used[i+j] ) {
+				lightVectors[i+j][0] = out[0][j];
+				lightVectors[i+j][1] = out[1][j];
+				lightVectors[i+j][2] = out[2][j];
+			}
+		}
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		if ( !used[i] ) {
+			continue;
+		}
+
+		const idDrawVert *v = &verts[i];
+
+		idVec3 lightDir = lightOrigin - v->xyz;
+
+		lightVectors[i][0] = lightDir * v->tangents[0];
+		lightVectors[i][1] = lightDir * v->tangents[1];
+		lightVectors[i][2] = lightDir * v->normal;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CreateSpecularTextureCoords
+
+	Calculates specular texture coordinates for the given triangle vertices.
+	For each vertex the normalized direction towards the light origin is added to the
+	normalized direction towards the view origin and the result is projected onto texture space.
+	The texture coordinates are only calculated for the vertices referenced by the indexes.
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	for ( i = numIndexes - 1; i >= 0; i-- ) {
+		used[indexes[i]] = true;
+	}
+
+	const __m128 lx = _mm_set1_ps( lightOrigin.x );
+	const __m128 ly = _mm_set1_ps( lightOrigin.y );
+	const __m128 lz = _mm_set1_ps( lightOrigin.z );
+	const __m128 vx = _mm_set1_ps( viewOrigin.x );
+	const __m128 vy = _mm_set1_ps( viewOrigin.y );
+	const __m128 vz = _mm_set1_ps( viewOrigin.z );
+
+	for ( i = 0; i <= numVerts - 4; i += 4 ) {
+		if ( !( used[i+0] | used[i+1] | used[i+2] | used[i+3] ) ) {
+			continue;
+		}
+
+		__m128 xyz[3], t0[3], t1[3], n[3];
+		LoadTextureSpace( verts + i, xyz, t0, t1, n );
+
+		__m128 ldx = _mm_sub_ps( lx, xyz[0] );
+		__m128 ldy = _mm_sub_ps( ly, xyz[1] );
+		__m128 ldz = _mm_sub_ps( lz, xyz[2] );
+		__m128 f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( ldx, ldx ), _mm_mul_ps( ldy, ldy ) ), _mm_mul_ps( ldz, ldz ) ) );
+		ldx = _mm_mul_ps( ldx, f );
+		ldy = _mm_mul_ps( ldy, f );
+		ldz = _mm_mul_ps( ldz, f );
+
+		__m128 vdx = _mm_sub_ps( vx, xyz[0] );
+		__m128 vdy = _mm_sub_ps( vy, xyz[1] );
+		__m128 vdz = _mm_sub_ps( vz, xyz[2] );
+		f = ReciprocalSqrt( _mm_add_ps( _mm_add_ps( _mm_mul_ps( vdx, vdx ), _mm_mul_ps( vdy, vdy ) ), _mm_mul_ps( vdz, vdz ) ) );
+		ldx = _mm_add_ps( ldx, _mm_mul_ps( vdx, f ) );
+		ldy = _mm_add_ps( ldy, _mm_mul_ps( vdy, f ) );
+		ldz = _mm_add_ps( ldz, _mm_mul_ps( vdz, f ) );
+
+		__m128 s = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ldx, t0[0] ), _mm_mul_ps( ldy, t0[1] ) ), _mm_mul_ps( ldz, t0[2] ) );
+		__m128 t = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ldx, t1[0] ), _mm_mul_ps( ldy, t1[1] ) ), _mm_mul_ps( ldz, t1[2] ) );
+		__m128 r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ldx, n[0] ), _mm_mul_ps( ldy, n[1] ) ), _mm_mul_ps( ldz, n[2] ) );
+		__m128 q = _mm_set1_ps( 1.0f );
+		_MM_TRANSPOSE4_PS( s, t, r, q );
+
+		if ( used[i+0] ) {
+			_mm_storeu_ps( texCoords[i+0].ToFloatPtr(), s );
+		}
+		if ( used[i+1] ) {
+			_mm_storeu_ps( texCoords[i+1].ToFloatPtr(), t );
+		}
+		if ( used[i+2] ) {
+			_mm_storeu_ps( texCoords[i+2].ToFloatPtr(), r );
+		}
+		if ( used[i+3] ) {
+			_mm_storeu_ps( texCoords[i+3].ToFloatPtr(), q );
+		}
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		if ( !used[i] ) {
+			continue;
+		}
+
+		const idDrawVert *v = &verts[i];
+
+		idVec3 lightDir = lightOrigin - v->xyz;
+		idVec3 viewDir = viewOrigin - v->xyz;
+
+		float ilength;
+
+		ilength = idMath::RSqrt( lightDir * lightDir );
+		lightDir[0] *= ilength;
+		lightDir[1] *= ilength;
+		lightDir[2] *= ilength;
+
+		ilength = idMath::RSqrt( viewDir * viewDir );
+		viewDir[0] *= ilength;
+		viewDir[1] *= ilength;
+		viewDir[2] *= ilength;
+
+		lightDir += viewDir;
+
+		texCoords[i][0] = lightDir * v->tangents[0];
+		texCoords[i][1] = lightDir * v->tangents[1];
+		texCoords[i][2] = lightDir * v->normal;
+		texCoords[i][3] = 1.0f;
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CreateShadowCache
+============
+*/
+int VPCALL idSIMD_SSE2Intrin::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 w = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+	const __m128 light = _mm_setr_ps( lightOrigin.x, lightOrigin.y, lightOrigin.z, 0.0f );
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm_storeu_ps( vertexCache[outVerts+0].ToFloatPtr(), _mm_or_ps( v, w ) );
+		// R_SetupProjection() builds the projection matrix with a slight crunch
+		// for depth, which keeps this w=0 division from rasterizing right at the
+		// wrap around point and causing depth fighting with the rear caps
+		_mm_storeu_ps( vertexCache[outVerts+1].ToFloatPtr(), _mm_sub_ps( v, light ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_SSE2Intrin::CreateVertexProgramShadowCache
+============
+*/
+int VPCALL idSIMD_SSE2Intrin::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 w = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm_storeu_ps( vertexCache[i*2+0].ToFloatPtr(), _mm_or_ps( v, w ) );
+		_mm_storeu_ps( vertexCache[i*2+1].ToFloatPtr(), v );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+ConvertPCM4
+
+  converts four 16 bit samples to floats
+============
+*/
+static ID_INLINE __m128 ConvertPCM4( const short *src ) {
+	const __m128i s = _mm_loadl_epi64( (const __m128i *) src );
+	return _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 ) );
+}
+
+/*
+============
+idSIMD_SSE2Intrin::UpSamplePCMTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void idSIMD_SSE2Intrin::UpSamplePCMTo44kHz( float *dest, const short *src, const int numSamples, const int kHz, const int numChannels ) {
+	int i;
+
+	if ( kHz == 11025 ) {
+		if ( numChannels == 1 ) {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = ConvertPCM4( src + i );
+				_mm_storeu_ps( dest + i*4 +  0, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 0, 0 ) ) );
+				_mm_storeu_ps( dest + i*4 +  4, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+				_mm_storeu_ps( dest + i*4 +  8, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 2, 2 ) ) );
+				_mm_storeu_ps( dest + i*4 + 12, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 3, 3, 3, 3 ) ) );
+			}
+			for ( ; i < numSamples; i++ ) {
+				dest[i*4+0] = dest[i*4+1] = dest[i*4+2] = dest[i*4+3] = (float) src[i+0];
+			}
+		} else {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = ConvertPCM4( src + i );
+				const __m128 lo = _mm_movelh_ps( s, s );
+				const __m128 hi = _mm_movehl_ps( s, s );
+				_mm_storeu_ps( dest + i*4 +  0, lo );
+				_mm_storeu_ps( dest + i*4 +  4, lo );
+				_mm_storeu_ps( dest + i*4 +  8, hi );
+				_mm_storeu_ps( dest + i*4 + 12, hi );
+			}
+			for ( ; i < numSamples; i += 2 ) {
+				dest[i*4+0] = dest[i*4+2] = dest[i*4+4] = dest[i*4+6] = (float) src[i+0];
+				dest[i*4+1] = dest[i*4+3] = dest[i*4+5] = dest[i*4+7] = (float) src[i+1];
+			}
+		}
+	} else if ( kHz == 22050 ) {
+		if ( numChannels == 1 ) {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = ConvertPCM4( src + i );
+				_mm_storeu_ps( dest + i*2 + 0, _mm_unpacklo_ps( s, s ) );
+				_mm_storeu_ps( dest + i*2 + 4, _mm_unpackhi_ps( s, s ) );
+			}
+			for ( ; i < numSamples; i++ ) {
+				dest[i*2+0] = dest[i*2+1] = (float) src[i+0];
+			}
+		} else {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = ConvertPCM4( src + i );
+				_mm_storeu_ps( dest + i*2 + 0, _mm_movelh_ps( s, s ) );
+				_mm_storeu_ps( dest + i*2 + 4, _mm_movehl_ps( s, s ) );
+			}
+			for ( ; i < numSamples; i += 2 ) {
+				dest[i*2+0] = dest[i*2+2] = (float) src[i+0];
+				dest[i*2+1] = dest[i*2+3] = (float) src[i+1];
+			}
+		}
+	} else if ( kHz == 44100 ) {
+		for ( i = 0; i <= numSamples - 4; i += 4 ) {
+			_mm_storeu_ps( dest + i, ConvertPCM4( src + i ) );
+		}
+		for ( ; i < numSamples; i++ ) {
+			dest[i] = (float) src[i];
+		}
+	} else {
+		assert( 0 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::UpSampleOGGTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void idSIMD_SSE2Intrin::UpSampleOGGTo44kHz( float *dest, const float * const *ogg, const int numSamples, const int kHz, const int numChannels ) {
+	const __m128 scale = _mm_set1_ps( 32768.0f );
+	int i;
+
+	if ( kHz == 11025 ) {
+		if ( numChannels == 1 ) {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+				_mm_storeu_ps( dest + i*4 +  0, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 0, 0 ) ) );
+				_mm_storeu_ps( dest + i*4 +  4, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 1, 1, 1, 1 ) ) );
+				_mm_storeu_ps( dest + i*4 +  8, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 2, 2 ) ) );
+				_mm_storeu_ps( dest + i*4 + 12, _mm_shuffle_ps( s, s, R_SHUFFLEPS( 3, 3, 3, 3 ) ) );
+			}
+			for ( ; i < numSamples; i++ ) {
+				dest[i*4+0] = dest[i*4+1] = dest[i*4+2] = dest[i*4+3] = ogg[0][i] * 32768.0f;
+			}
+		} else {
+			const int numFrames = numSamples >> 1;
+			for ( i = 0; i <= numFrames - 4; i += 4 ) {
+				const __m128 l = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+				const __m128 r = _mm_mul_ps( _mm_loadu_ps( ogg[1] + i ), scale );
+				const __m128 lo = _mm_unpacklo_ps( l, r );
+				const __m128 hi = _mm_unpackhi_ps( l, r );
+				const __m128 f0 = _mm_movelh_ps( lo, lo );
+				const __m128 f1 = _mm_movehl_ps( lo, lo );
+				const __m128 f2 = _mm_movelh_ps( hi, hi );
+				const __m128 f3 = _mm_movehl_ps( hi, hi );
+				_mm_storeu_ps( dest + i*8 +  0, f0 );
+				_mm_storeu_ps( dest + i*8 +  4, f0 );
+				_mm_storeu_ps( dest + i*8 +  8, f1 );
+				_mm_storeu_ps( dest + i*8 + 12, f1 );
+				_mm_storeu_ps( dest + i*8 + 16, f2 );
+				_mm_storeu_ps( dest + i*8 + 20, f2 );
+				_mm_storeu_ps( dest + i*8 + 24, f3 );
+				_mm_storeu_ps( dest + i*8 + 28, f3 );
+			}
+			for ( ; i < numFrames; i++ ) {
+				dest[i*8+0] = dest[i*8+2] = dest[i*8+4] = dest[i*8+6] = ogg[0][i] * 32768.0f;
+				dest[i*8+1] = dest[i*8+3] = dest[i*8+5] = dest[i*8+7] = ogg[1][i] * 32768.0f;
+			}
+		}
+	} else if ( kHz == 22050 ) {
+		if ( numChannels == 1 ) {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				const __m128 s = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+				_mm_storeu_ps( dest + i*2 + 0, _mm_unpacklo_ps( s, s ) );
+				_mm_storeu_ps( dest + i*2 + 4, _mm_unpackhi_ps( s, s ) );
+			}
+			for ( ; i < numSamples; i++ ) {
+				dest[i*2+0] = dest[i*2+1] = ogg[0][i] * 32768.0f;
+			}
+		} else {
+			const int numFrames = numSamples >> 1;
+			for ( i = 0; i <= numFrames - 4; i += 4 ) {
+				const __m128 l = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+				const __m128 r = _mm_mul_ps( _mm_loadu_ps( ogg[1] + i ), scale );
+				const __m128 lo = _mm_unpacklo_ps( l, r );
+				const __m128 hi = _mm_unpackhi_ps( l, r );
+				_mm_storeu_ps( dest + i*4 +  0, _mm_movelh_ps( lo, lo ) );
+				_mm_storeu_ps( dest + i*4 +  4, _mm_movehl_ps( lo, lo ) );
+				_mm_storeu_ps( dest + i*4 +  8, _mm_movelh_ps( hi, hi ) );
+				_mm_storeu_ps( dest + i*4 + 12, _mm_movehl_ps( hi, hi ) );
+			}
+			for ( ; i < numFrames; i++ ) {
+				dest[i*4+0] = dest[i*4+2] = ogg[0][i] * 32768.0f;
+				dest[i*4+1] = dest[i*4+3] = ogg[1][i] * 32768.0f;
+			}
+		}
+	} else if ( kHz == 44100 ) {
+		if ( numChannels == 1 ) {
+			for ( i = 0; i <= numSamples - 4; i += 4 ) {
+				_mm_storeu_ps( dest + i, _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale ) );
+			}
+			for ( ; i < numSamples; i++ ) {
+				dest[i*1+0] = ogg[0][i] * 32768.0f;
+			}
+		} else {
+			const int numFrames = numSamples >> 1;
+			for ( i = 0; i <= numFrames - 4; i += 4 ) {
+				const __m128 l = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+				const __m128 r = _mm_mul_ps( _mm_loadu_ps( ogg[1] + i ), scale );
+				_mm_storeu_ps( dest + i*2 + 0, _mm_unpacklo_ps( l, r ) );
+				_mm_storeu_ps( dest + i*2 + 4, _mm_unpackhi_ps( l, r ) );
+			}
+			for ( ; i < numFrames; i++ ) {
+				dest[i*2+0] = ogg[0][i] * 32768.0f;
+				dest[i*2+1] = ogg[1][i] * 32768.0f;
+			}
+		}
+	} else {
+		assert( 0 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MixSoundTwoSpeakerMono
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	const float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	const float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m128 vol0 = _mm_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR );
+	__m128 vol1 = _mm_add_ps( vol0, _mm_setr_ps( 2.0f * incL, 2.0f * incR, 2.0f * incL, 2.0f * incR ) );
+	const __m128 inc = _mm_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m128 s = _mm_loadu_ps( samples + j );
+		_mm_storeu_ps( mixBuffer + j*2 + 0, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2 + 0 ), _mm_mul_ps( _mm_unpacklo_ps( s, s ), vol0 ) ) );
+		_mm_storeu_ps( mixBuffer + j*2 + 4, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2 + 4 ), _mm_mul_ps( _mm_unpackhi_ps( s, s ), vol1 ) ) );
+		vol0 = _mm_add_ps( vol0, inc );
+		vol1 = _mm_add_ps( vol1, inc );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MixSoundTwoSpeakerStereo
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	const float incL = ( currentV[0] - lastV[0] ) / MIXBUFFER_SAMPLES;
+	const float incR = ( currentV[1] - lastV[1] ) / MIXBUFFER_SAMPLES;
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m128 vol0 = _mm_setr_ps( lastV[0], lastV[1], lastV[0] + incL, lastV[1] + incR );
+	__m128 vol1 = _mm_add_ps( vol0, _mm_setr_ps( 2.0f * incL, 2.0f * incR, 2.0f * incL, 2.0f * incR ) );
+	const __m128 inc = _mm_setr_ps( 4.0f * incL, 4.0f * incR, 4.0f * incL, 4.0f * incR );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		_mm_storeu_ps( mixBuffer + j*2 + 0, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2 + 0 ), _mm_mul_ps( _mm_loadu_ps( samples + j*2 + 0 ), vol0 ) ) );
+		_mm_storeu_ps( mixBuffer + j*2 + 4, _mm_add_ps( _mm_loadu_ps( mixBuffer + j*2 + 4 ), _mm_mul_ps( _mm_loadu_ps( samples + j*2 + 4 ), vol1 ) ) );
+		vol0 = _mm_add_ps( vol0, inc );
+		vol1 = _mm_add_ps( vol1, inc );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MixSoundSixSpeakerMono
+
+  two samples are twelve floats, the volumes are spread over three vectors
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float inc[6];
+
+	for ( int k = 0; k < 6; k++ ) {
+		inc[k] = ( currentV[k] - lastV[k] ) / MIXBUFFER_SAMPLES;
+	}
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m128 vol0 = _mm_setr_ps( lastV[0], lastV[1], lastV[2], lastV[3] );
+	__m128 vol1 = _mm_setr_ps( lastV[4], lastV[5], lastV[0] + inc[0], lastV[1] + inc[1] );
+	__m128 vol2 = _mm_setr_ps( lastV[2] + inc[2], lastV[3] + inc[3], lastV[4] + inc[4], lastV[5] + inc[5] );
+	const __m128 inc0 = _mm_setr_ps( 2.0f * inc[0], 2.0f * inc[1], 2.0f * inc[2], 2.0f * inc[3] );
+	const __m128 inc1 = _mm_setr_ps( 2.0f * inc[4], 2.0f * inc[5], 2.0f * inc[0], 2.0f * inc[1] );
+	const __m128 inc2 = _mm_setr_ps( 2.0f * inc[2], 2.0f * inc[3], 2.0f * inc[4], 2.0f * inc[5] );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		const __m128 s = _mm_castpd_ps( _mm_load_sd( (const double *)( samples + i ) ) );
+		const __m128 s0 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 0, 0 ) );
+		const __m128 s1 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 0, 1, 1 ) );
+		const __m128 s2 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 1, 1, 1, 1 ) );
+		float *mix = mixBuffer + i * 6;
+		_mm_storeu_ps( mix + 0, _mm_add_ps( _mm_loadu_ps( mix + 0 ), _mm_mul_ps( s0, vol0 ) ) );
+		_mm_storeu_ps( mix + 4, _mm_add_ps( _mm_loadu_ps( mix + 4 ), _mm_mul_ps( s1, vol1 ) ) );
+		_mm_storeu_ps( mix + 8, _mm_add_ps( _mm_loadu_ps( mix + 8 ), _mm_mul_ps( s2, vol2 ) ) );
+		vol0 = _mm_add_ps( vol0, inc0 );
+		vol1 = _mm_add_ps( vol1, inc1 );
+		vol2 = _mm_add_ps( vol2, inc2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MixSoundSixSpeakerStereo
+
+  the left channel goes to speakers 0, 2, 3 and 4, the right channel to speakers 1 and 5
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	float inc[6];
+
+	for ( int k = 0; k < 6; k++ ) {
+		inc[k] = ( currentV[k] - lastV[k] ) / MIXBUFFER_SAMPLES;
+	}
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	__m128 vol0 = _mm_setr_ps( lastV[0], lastV[1], lastV[2], lastV[3] );
+	__m128 vol1 = _mm_setr_ps( lastV[4], lastV[5], lastV[0] + inc[0], lastV[1] + inc[1] );
+	__m128 vol2 = _mm_setr_ps( lastV[2] + inc[2], lastV[3] + inc[3], lastV[4] + inc[4], lastV[5] + inc[5] );
+	const __m128 inc0 = _mm_setr_ps( 2.0f * inc[0], 2.0f * inc[1], 2.0f * inc[2], 2.0f * inc[3] );
+	const __m128 inc1 = _mm_setr_ps( 2.0f * inc[4], 2.0f * inc[5], 2.0f * inc[0], 2.0f * inc[1] );
+	const __m128 inc2 = _mm_setr_ps( 2.0f * inc[2], 2.0f * inc[3], 2.0f * inc[4], 2.0f * inc[5] );
+
+	for ( int i = 0; i < MIXBUFFER_SAMPLES; i += 2 ) {
+		const __m128 s = _mm_loadu_ps( samples + i * 2 );
+		const __m128 s0 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 0, 1, 0, 0 ) );
+		const __m128 s2 = _mm_shuffle_ps( s, s, R_SHUFFLEPS( 2, 2, 2, 3 ) );
+		float *mix = mixBuffer + i * 6;
+		_mm_storeu_ps( mix + 0, _mm_add_ps( _mm_loadu_ps( mix + 0 ), _mm_mul_ps( s0, vol0 ) ) );
+		_mm_storeu_ps( mix + 4, _mm_add_ps( _mm_loadu_ps( mix + 4 ), _mm_mul_ps( s, vol1 ) ) );
+		_mm_storeu_ps( mix + 8, _mm_add_ps( _mm_loadu_ps( mix + 8 ), _mm_mul_ps( s2, vol2 ) ) );
+		vol0 = _mm_add_ps( vol0, inc0 );
+		vol1 = _mm_add_ps( vol1, inc1 );
+		vol2 = _mm_add_ps( vol2, inc2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2Intrin::MixedSoundToSamples
+============
+*/
+void VPCALL idSIMD_SSE2Intrin::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m128 min = _mm_set1_ps( -32768.0f );
+	const __m128 max = _mm_set1_ps( 32767.0f );
+	int i;
+
+	for ( i = 0; i <= numSamples - 8; i += 8 ) {
+		const __m128i s0 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 0 ), min ), max ) );
+		const __m128i s1 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 4 ), min ), max ) );
+		_mm_storeu_si128( (__m128i *)( samples + i ), _mm_packs_epi32( s0, s1 ) );
+	}
+	for ( ; i < numSamples; i++ ) {
+		if ( mixBuffer[i] <= -32768.0f ) {
+			samples[i] = -32768;
+		} else if ( mixBuffer[i] >= 32767.0f ) {
+			samples[i] = 32767;
+		} else {
+			samples[i] = (short) mixBuffer[i];
+		}
+	}
+}
+
+#endif /* ID_SIMD_SSE2_INTRINSICS */
@@ -133,6 +133,9 @@ const int MAX_EXPRESSION_REGISTERS = 4096;
 // MayaImport
 #include "MayaImport/maya_main.h"
 
+// server tick profiler
+#include "framework/TickProfiler.h"
+
 // game interface
 #include "framework/Game.h"
 
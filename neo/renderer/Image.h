@@ -120,6 +120,11 @@ typedef struct
 	unsigned int dwReserved2[3];
 } ddsFileHeader_t;
 
+// image cache files are regular dds files that store the key they were built
+// with in dwReserved1: id, version, ImageCacheKey, the source timestamp and the source key
+const unsigned int IMAGE_CACHE_ID		= DDS_MAKEFOURCC('I', 'D', 'I', 'C');
+const unsigned int IMAGE_CACHE_VERSION	= 2;
+
 
 // increasing numeric values imply more information is stored
 typedef enum {
@@ -148,6 +153,21 @@ typedef enum {
 
 #define	MAX_IMAGE_NAME	256
 
+const int MAX_IMAGE_LEVELS = 16;
+
+// the resampled first level and all mip levels of a 32 bit image, built without
+// touching OpenGL so the work can be done on a job thread and uploaded later
+typedef struct {
+	GLenum				internalFormat;
+	int					width;				// of the first level
+	int					height;
+	int					numLevels;
+	byte *				pics[MAX_IMAGE_LEVELS];
+	int					size;				// bytes held by pics, or by cacheFile
+	byte *				cacheFile;			// complete image cache file when it was built instead of the levels
+	int					cacheFileSize;
+} imageLevels_t;
+
 class idImage {
 public:
 				idImage();
@@ -161,6 +181,10 @@ public:
 	// for use with fragment programs, doesn't change any enable2D/3D/cube states
 	void		BindFragment();
 
+	// Does the file loading Bind() would do, on the main thread before the
+	// render thread gets the commands.  The render thread can't load images.
+	void		LoadForBind();
+
 	// deletes the texture object, but leaves the structure so it can be reloaded
 	void		PurgeImage();
 
@@ -209,12 +233,20 @@ public:
 	bool		CheckPrecompressedImage( bool fullLoad );
 	void		UploadPrecompressedImage( byte *data, int len );
 	void		ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd );
+	void		BuildImageLevels( const byte *pic, int width, int height, textureDepth_t minimumDepth, imageLevels_t &levels, bool uploadSize = true ) const;
+	void		UploadImageLevels( imageLevels_t &levels );
+	bool		DecodeImage( imageLevels_t &levels );
+	void		FinishDecodedImage( imageLevels_t &levels, bool decoded );
+	unsigned int ImageCacheKey( textureDepth_t minimumDepth ) const;
+	bool		CheckImageCache();
+	byte *		BuildImageCacheFile( int *fileSize ) const;
+	byte *		BuildImageCacheFile( const byte *pic, int width, int height, textureDepth_t minimumDepth, unsigned int key, ID_TIME_T sourceTimestamp, unsigned int sourceKey, int *fileSize ) const;
 	void		StartBackgroundImageLoad();
 	int			BitsForInternalFormat( int internalFormat ) const;
 	void		UploadCompressedNormalMap( int width, int height, const byte *rgba, int mipLevel );
 	GLenum		SelectInternalFormat( const byte **dataPtrs, int numDataPtrs, int width, int height,
 									 textureDepth_t minimumDepth ) const;
-	void		ImageProgramStringToCompressedFileName( const char *imageProg, char *fileName ) const;
+	void		ImageProgramStringToCompressedFileName( const char *imageProg, char *fileName, const char *dir = "dds" ) const;
 	int			NumLevelsForImageSize( int width, int height ) const;
 
 	// data commonly accessed is grouped here
@@ -238,6 +270,7 @@ public:
 	textureFilter_t		filter;
 	textureRepeat_t		repeat;
 	textureDepth_t		depth;
+	textureDepth_t		requestedDepth;			// depth as referenced, the image program may change depth, keys the image cache
 	cubeFiles_t			cubeFiles;				// determines the naming and flipping conventions for the six images
 
 	bool				referencedOutsideLevelLoad;
@@ -278,6 +311,7 @@ ID_INLINE idImage::idImage() {
 	filter = TF_DEFAULT;
 	repeat = TR_REPEAT;
 	depth = TD_DEFAULT;
+	requestedDepth = TD_DEFAULT;
 	cubeFiles = CF_2D;
 	referencedOutsideLevelLoad = false;
 	levelLoadReferenced = false;
@@ -384,6 +418,9 @@ public:
 	static idCVar		image_cacheMegs;			// maximum bytes set aside for temporary loading of full-sized precompressed images
 	static idCVar		image_useCache;				// 1 = do background load image caching
 	static idCVar		image_showBackgroundLoads;	// 1 = print number of outstanding background loads
+	static idCVar		image_jobDecode;			// decode images on the job threads during level load
+	static idCVar		image_jobDecodeMegs;		// maximum MB of decoded images waiting for upload
+	static idCVar		image_imageCache;			// 1 = load block compressed imagecache/ files, 2 = also build them
 	static idCVar		image_forceDownSize;		// allows the ability to force a downsize
 	static idCVar		image_downSizeSpecular;		// downsize specular
 	static idCVar		image_downSizeSpecularLimit;// downsize specular limit
@@ -423,6 +460,7 @@ public:
 	idImage *			AllocImage( const char *name );
 	void				SetNormalPalette();
 	void				ChangeTextureFilter();
+	void				LoadDecodeImages( const idList<idImage *> &decodeImages );
 
 	idList<idImage*>	images;
 	idStrList			ddsList;
@@ -447,6 +485,10 @@ public:
 
 	int	numActiveBackgroundImageLoads;
 	const static int MAX_BACKGROUND_IMAGE_LOADS = 8;
+
+	// progress of the image loads in EndLevelLoad
+	int					levelLoadImages;
+	int					levelLoadImagesDone;
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
@@ -481,12 +523,30 @@ void R_RotatePic( byte *data, int width );
 /*
 ====================================================================
 
+IMAGECOMPRESS
+
+====================================================================
+*/
+
+int R_CompressedImageSize( int width, int height, int blockBytes );
+// rgba is width * height texels, the blocks over the edges repeat the last row and column
+void R_CompressBC1( const byte *rgba, int width, int height, byte *out );
+void R_CompressBC3( const byte *rgba, int width, int height, byte *out );
+void R_TestImageCompression_f( const idCmdArgs &args );
+
+/*
+====================================================================
+
 IMAGEFILES
 
 ====================================================================
 */
 
-void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, bool makePowerOf2 );
+// images are decoded on the job threads during EndLevelLoad, the file system isn't
+// thread safe so every file access while the decode jobs run holds this lock
+const int CRITICAL_SECTION_IMAGE_FILES = CRITICAL_SECTION_THREE;
+
+void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, bool makePowerOf2, unsigned int *sourceKey = NULL );
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6], int *size, ID_TIME_T *timestamp );
 
@@ -498,7 +558,8 @@ IMAGEPROGRAM
 ====================================================================
 */
 
-void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, textureDepth_t *depth = NULL );
+// sourceKey gets a checksum of the length and zip crc of the source files, files in a pk4 have no timestamp
+void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, textureDepth_t *depth = NULL, unsigned int *sourceKey = NULL );
 const char *R_ParsePastImageProgram( idLexer &src );
 
 #endif
@@ -0,0 +1,497 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include <climits>
+
+#include "tr_local.h"
+
+/*
+====================================================================
+
+Block compression for the image cache.  BC1 color endpoints are fit along
+the principal axis of the block colors and refined with a least squares
+solve over the chosen indices, BC3 adds an 8 value alpha block.  This is
+plain C code that runs on the job threads and doesn't need a renderer.
+
+====================================================================
+*/
+
+/*
+================
+R_CompressedImageSize
+================
+*/
+int R_CompressedImageSize( int width, int height, int blockBytes ) {
+	return ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockBytes;
+}
+
+/*
+================
+R_ExtractBlock
+
+blocks that hang over the edge of a small mip level repeat the last row and column
+================
+*/
+static void R_ExtractBlock( const byte *rgba, int width, int height, int x, int y, byte block[16][4] ) {
+	for ( int j = 0; j < 4; j++ ) {
+		int sy = Min( y + j, height - 1 );
+		for ( int i = 0; i < 4; i++ ) {
+			int sx = Min( x + i, width - 1 );
+			const byte *in = rgba + ( sy * width + sx ) * 4;
+			block[j*4+i][0] = in[0];
+			block[j*4+i][1] = in[1];
+			block[j*4+i][2] = in[2];
+			block[j*4+i][3] = in[3];
+		}
+	}
+}
+
+/*
+================
+R_PackColor565
+================
+*/
+static unsigned short R_PackColor565( const float color[3] ) {
+	int r = idMath::ClampInt( 0, 31, idMath::FtoiFast( color[0] * ( 31.0f / 255.0f ) + 0.5f ) );
+	int g = idMath::ClampInt( 0, 63, idMath::FtoiFast( color[1] * ( 63.0f / 255.0f ) + 0.5f ) );
+	int b = idMath::ClampInt( 0, 31, idMath::FtoiFast( color[2] * ( 31.0f / 255.0f ) + 0.5f ) );
+	return (unsigned short)( ( r << 11 ) | ( g << 5 ) | b );
+}
+
+/*
+================
+R_UnpackColor565
+================
+*/
+static void R_UnpackColor565( unsigned short packed, int color[3] ) {
+	int r = ( packed >> 11 ) & 31;
+	int g = ( packed >> 5 ) & 63;
+	int b = packed & 31;
+	color[0] = ( r << 3 ) | ( r >> 2 );
+	color[1] = ( g << 2 ) | ( g >> 4 );
+	color[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+/*
+================
+R_ColorBlockIndices
+
+Picks the closest of the four colors for every texel, c0 must be greater than c1
+so the block decodes in four color mode.  Returns the squared error.
+================
+*/
+static int R_ColorBlockIndices( const byte block[16][4], unsigned short c0, unsigned short c1, unsigned int &indices ) {
+	int		palette[4][3];
+	int		error = 0;
+
+	R_UnpackColor565( c0, palette[0] );
+	R_UnpackColor565( c1, palette[1] );
+	for ( int i = 0; i < 3; i++ ) {
+		palette[2][i] = ( 2 * palette[0][i] + palette[1][i] ) / 3;
+		palette[3][i] = ( palette[0][i] + 2 * palette[1][i] ) / 3;
+	}
+
+	indices = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		int best = 0;
+		int bestDist = INT_MAX;
+		for ( int j = 0; j < 4; j++ ) {
+			int dr = block[i][0] - palette[j][0];
+			int dg = block[i][1] - palette[j][1];
+			int db = block[i][2] - palette[j][2];
+			int dist = dr * dr + dg * dg + db * db;
+			if ( dist < bestDist ) {
+				bestDist = dist;
+				best = j;
+			}
+		}
+		indices |= best << ( i * 2 );
+		error += bestDist;
+	}
+	return error;
+}
+
+/*
+================
+R_OrderColorEndpoints
+
+returns the squared error of the block with the endpoints in four color order
+================
+*/
+static int R_OrderColorEndpoints( const byte block[16][4], unsigned short &c0, unsigned short &c1, unsigned int &indices ) {
+	if ( c0 < c1 ) {
+		unsigned short swap = c0;
+		c0 = c1;
+		c1 = swap;
+	}
+	if ( c0 == c1 ) {
+		// equal endpoints decode in three color mode, index 0 is still the endpoint
+		int color[3];
+		int error = 0;
+		R_UnpackColor565( c0, color );
+		for ( int i = 0; i < 16; i++ ) {
+			for ( int j = 0; j < 3; j++ ) {
+				error += ( block[i][j] - color[j] ) * ( block[i][j] - color[j] );
+			}
+		}
+		indices = 0;
+		return error;
+	}
+	return R_ColorBlockIndices( block, c0, c1, indices );
+}
+
+/*
+================
+R_CompressColorBlock
+
+writes an 8 byte BC1 color block
+================
+*/
+static void R_CompressColorBlock( const byte block[16][4], byte *out ) {
+	float	mean[3];
+	float	cov[6];
+	float	axis[3];
+
+	mean[0] = mean[1] = mean[2] = 0.0f;
+	for ( int i = 0; i < 16; i++ ) {
+		mean[0] += block[i][0];
+		mean[1] += block[i][1];
+		mean[2] += block[i][2];
+	}
+	mean[0] *= ( 1.0f / 16.0f );
+	mean[1] *= ( 1.0f / 16.0f );
+	mean[2] *= ( 1.0f / 16.0f );
+
+	memset( cov, 0, sizeof( cov ) );
+	for ( int i = 0; i < 16; i++ ) {
+		float r = block[i][0] - mean[0];
+		float g = block[i][1] - mean[1];
+		float b = block[i][2] - mean[2];
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * b;
+		cov[3] += g * g;
+		cov[4] += g * b;
+		cov[5] += b * b;
+	}
+
+	// principal axis by power iteration, seeded with the covariance row of the largest
+	// variance, a fixed seed that is orthogonal to the axis would collapse to zero
+	float seed[3];
+	if ( cov[0] >= cov[3] && cov[0] >= cov[5] ) {
+		seed[0] = cov[0];
+		seed[1] = cov[1];
+		seed[2] = cov[2];
+	} else if ( cov[3] >= cov[5] ) {
+		seed[0] = cov[1];
+		seed[1] = cov[3];
+		seed[2] = cov[4];
+	} else {
+		seed[0] = cov[2];
+		seed[1] = cov[4];
+		seed[2] = cov[5];
+	}
+	if ( Max( cov[0], Max( cov[3], cov[5] ) ) < idMath::FLT_EPSILON ) {
+		// a flat block, any axis will do
+		seed[0] = seed[1] = seed[2] = 1.0f;
+	}
+	axis[0] = seed[0];
+	axis[1] = seed[1];
+	axis[2] = seed[2];
+	for ( int iter = 0; iter < 8; iter++ ) {
+		float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		float len = Max( idMath::Fabs( x ), Max( idMath::Fabs( y ), idMath::Fabs( z ) ) );
+		if ( len < idMath::FLT_EPSILON ) {
+			axis[0] = seed[0];
+			axis[1] = seed[1];
+			axis[2] = seed[2];
+			break;
+		}
+		axis[0] = x / len;
+		axis[1] = y / len;
+		axis[2] = z / len;
+	}
+	float lengthSqr = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	float invLength = idMath::InvSqrt( lengthSqr );
+	axis[0] *= invLength;
+	axis[1] *= invLength;
+	axis[2] *= invLength;
+
+	// the extent of the colors along the axis, inset a little to spend the
+	// endpoints on the bulk of the colors instead of the outliers
+	float minT = idMath::INFINITY;
+	float maxT = -idMath::INFINITY;
+	for ( int i = 0; i < 16; i++ ) {
+		float t = ( block[i][0] - mean[0] ) * axis[0] + ( block[i][1] - mean[1] ) * axis[1] + ( block[i][2] - mean[2] ) * axis[2];
+		minT = Min( minT, t );
+		maxT = Max( maxT, t );
+	}
+	float inset = ( maxT - minT ) * ( 1.0f / 16.0f );
+	minT += inset;
+	maxT -= inset;
+
+	float color0[3], color1[3];
+	for ( int i = 0; i < 3; i++ ) {
+		color0[i] = mean[i] + axis[i] * maxT;
+		color1[i] = mean[i] + axis[i] * minT;
+	}
+
+	unsigned short c0 = R_PackColor565( color0 );
+	unsigned short c1 = R_PackColor565( color1 );
+	unsigned int indices;
+	int error = R_OrderColorEndpoints( block, c0, c1, indices );
+
+	// refit the endpoints to the chosen indices with least squares
+	if ( error > 0 && c0 != c1 ) {
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[3] = { 0.0f, 0.0f, 0.0f };
+		float bx[3] = { 0.0f, 0.0f, 0.0f };
+
+		for ( int i = 0; i < 16; i++ ) {
+			float a = weights[( indices >> ( i * 2 ) ) & 3];
+			float b = 1.0f - a;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for ( int j = 0; j < 3; j++ ) {
+				ax[j] += a * block[i][j];
+				bx[j] += b * block[i][j];
+			}
+		}
+
+		float det = aa * bb - ab * ab;
+		if ( idMath::Fabs( det ) > idMath::FLT_EPSILON ) {
+			float invDet = 1.0f / det;
+			for ( int j = 0; j < 3; j++ ) {
+				color0[j] = ( ax[j] * bb - bx[j] * ab ) * invDet;
+				color1[j] = ( bx[j] * aa - ax[j] * ab ) * invDet;
+			}
+
+			unsigned short r0 = R_PackColor565( color0 );
+			unsigned short r1 = R_PackColor565( color1 );
+			unsigned int refitIndices;
+			int refitError = R_OrderColorEndpoints( block, r0, r1, refitIndices );
+			if ( refitError < error ) {
+				c0 = r0;
+				c1 = r1;
+				indices = refitIndices;
+			}
+		}
+	}
+
+	out[0] = c0 & 255;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 255;
+	out[3] = c1 >> 8;
+	out[4] = indices & 255;
+	out[5] = ( indices >> 8 ) & 255;
+	out[6] = ( indices >> 16 ) & 255;
+	out[7] = ( indices >> 24 ) & 255;
+}
+
+/*
+================
+R_CompressAlphaBlock
+
+writes an 8 byte block of a single channel in eight value mode, as used for the alpha of BC3
+================
+*/
+static void R_CompressAlphaBlock( const byte block[16][4], int channel, byte *out ) {
+	int		a0 = 0;
+	int		a1 = 255;
+	int		values[8];
+	uint64_t	indices = 0;
+
+	for ( int i = 0; i < 16; i++ ) {
+		a0 = Max( a0, (int)block[i][channel] );
+		a1 = Min( a1, (int)block[i][channel] );
+	}
+
+	out[0] = a0;
+	out[1] = a1;
+
+	if ( a0 != a1 ) {
+		values[0] = a0;
+		values[1] = a1;
+		for ( int i = 1; i < 7; i++ ) {
+			values[i + 1] = ( ( 7 - i ) * a0 + i * a1 ) / 7;
+		}
+
+		for ( int i = 0; i < 16; i++ ) {
+			int best = 0;
+			int bestDist = INT_MAX;
+			for ( int j = 0; j < 8; j++ ) {
+				int dist = abs( block[i][channel] - values[j] );
+				if ( dist < bestDist ) {
+					bestDist = dist;
+					best = j;
+				}
+			}
+			indices |= (uint64_t)best << ( i * 3 );
+		}
+	}
+
+	for ( int i = 0; i < 6; i++ ) {
+		out[2 + i] = ( indices >> ( i * 8 ) ) & 255;
+	}
+}
+
+/*
+================
+R_CompressBC1
+
+rgba is width * height texels, out gets R_CompressedImageSize( width, height, 8 ) bytes
+================
+*/
+void R_CompressBC1( const byte *rgba, int width, int height, byte *out ) {
+	byte	block[16][4];
+
+	for ( int y = 0; y < height; y += 4 ) {
+		for ( int x = 0; x < width; x += 4 ) {
+			R_ExtractBlock( rgba, width, height, x, y, block );
+			R_CompressColorBlock( block, out );
+			out += 8;
+		}
+	}
+}
+
+/*
+================
+R_CompressBC3
+
+rgba is width * height texels, out gets R_CompressedImageSize( width, height, 16 ) bytes
+================
+*/
+void R_CompressBC3( const byte *rgba, int width, int height, byte *out ) {
+	byte	block[16][4];
+
+	for ( int y = 0; y < height; y += 4 ) {
+		for ( int x = 0; x < width; x += 4 ) {
+			R_ExtractBlock( rgba, width, height, x, y, block );
+			R_CompressAlphaBlock( block, 3, out );
+			R_CompressColorBlock( block, out + 8 );
+			out += 16;
+		}
+	}
+}
+
+/*
+================
+R_DecodeColorBlock
+================
+*/
+static void R_DecodeColorBlock( const byte *in, byte block[16][4] ) {
+	int		palette[4][3];
+
+	unsigned short c0 = in[0] | ( in[1] << 8 );
+	unsigned short c1 = in[2] | ( in[3] << 8 );
+	unsigned int indices = in[4] | ( in[5] << 8 ) | ( in[6] << 16 ) | ( (unsigned int)in[7] << 24 );
+
+	R_UnpackColor565( c0, palette[0] );
+	R_UnpackColor565( c1, palette[1] );
+	for ( int i = 0; i < 3; i++ ) {
+		if ( c0 > c1 ) {
+			palette[2][i] = ( 2 * palette[0][i] + palette[1][i] ) / 3;
+			palette[3][i] = ( palette[0][i] + 2 * palette[1][i] ) / 3;
+		} else {
+			palette[2][i] = ( palette[0][i] + palette[1][i] ) / 2;
+			palette[3][i] = 0;
+		}
+	}
+
+	for ( int i = 0; i < 16; i++ ) {
+		const int *color = palette[( indices >> ( i * 2 ) ) & 3];
+		block[i][0] = color[0];
+		block[i][1] = color[1];
+		block[i][2] = color[2];
+		block[i][3] = 255;
+	}
+}
+
+/*
+================
+R_TestImageCompression_f
+
+compresses a few blocks that are known to be hard and checks the decoded colors
+================
+*/
+void R_TestImageCompression_f( const idCmdArgs &args ) {
+	static const char *names[] = { "flat", "gradient", "red/green", "black/white" };
+	// the 565 endpoints round to within a few steps, the gradient has 16 levels for 4 colors
+	static const int maxErrors[] = { 8, 32, 8, 8 };
+	byte	rgba[16][4];
+	byte	decoded[16][4];
+	byte	out[8];
+	int		failed = 0;
+
+	for ( int test = 0; test < 4; test++ ) {
+		for ( int i = 0; i < 16; i++ ) {
+			switch( test ) {
+				case 0:
+					rgba[i][0] = 90; rgba[i][1] = 140; rgba[i][2] = 200;
+					break;
+				case 1:
+					rgba[i][0] = i * 16; rgba[i][1] = 255 - i * 16; rgba[i][2] = 128;
+					break;
+				case 2:
+					// the principal axis is orthogonal to ( 1, 1, 1 )
+					rgba[i][0] = ( i & 1 ) ? 50 : 200; rgba[i][1] = ( i & 1 ) ? 200 : 50; rgba[i][2] = 50;
+					break;
+				case 3:
+					rgba[i][0] = rgba[i][1] = rgba[i][2] = ( ( i ^ ( i >> 2 ) ) & 1 ) ? 255 : 0;
+					break;
+			}
+			rgba[i][3] = 255;
+		}
+
+		R_CompressBC1( rgba[0], 4, 4, out );
+		R_DecodeColorBlock( out, decoded );
+
+		int maxError = 0;
+		for ( int i = 0; i < 16; i++ ) {
+			for ( int j = 0; j < 3; j++ ) {
+				maxError = Max( maxError, abs( rgba[i][j] - decoded[i][j] ) );
+			}
+		}
+
+		if ( maxError > maxErrors[test] ) {
+			common->Printf( "%s block: max error %d ^1failed^0\n", names[test], maxError );
+			failed++;
+		} else {
+			common->Printf( "%s block: max error %d ok\n", names[test], maxError );
+		}
+	}
+
+	common->Printf( "%d image compression tests failed\n", failed );
+}
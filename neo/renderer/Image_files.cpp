@@ -139,6 +139,56 @@ void R_WritePalTGA( const char *filename, const byte *data, const byte *palette,
 
 
 static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
+
+/*
+================
+R_ReadImageFile
+
+The image loaders also run on the job threads during level load,
+so their file system access is serialized
+================
+*/
+static int R_ReadImageFile( const char *name, void **buffer, ID_TIME_T *timestamp ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+	int length = fileSystem->ReadFile( name, buffer, timestamp );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+	return length;
+}
+
+/*
+================
+R_UpdateImageSourceKey
+
+Adds the length and the zip crc of an image file to the source key
+================
+*/
+static void R_UpdateImageSourceKey( const char *name, unsigned int *sourceKey ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+	idFile *f = fileSystem->OpenFileRead( name, false );
+	if ( f ) {
+		int length = f->Length();
+		unsigned int crc = 0;
+		idFile_InZip *zipFile = dynamic_cast<idFile_InZip *>( f );
+		if ( zipFile ) {
+			crc = zipFile->GetCRC();
+		}
+		CRC32_UpdateChecksum( *sourceKey, &length, sizeof( length ) );
+		CRC32_UpdateChecksum( *sourceKey, &crc, sizeof( crc ) );
+		fileSystem->CloseFile( f );
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+}
+
+/*
+================
+R_FreeImageFile
+================
+*/
+static void R_FreeImageFile( void *buffer ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+	fileSystem->FreeFile( buffer );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+}
 static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 static void LoadJPG( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 
@@ -230,7 +280,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*bmpRGBA;
 
 	if ( !pic ) {
-		fileSystem->ReadFile ( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -239,7 +289,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	length = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	length = R_ReadImageFile( name, (void **)&buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -368,7 +418,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 		}
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 
 }
 
@@ -398,7 +448,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	int		xmax, ymax;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -408,7 +458,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	//
 	// load the file
 	//
-	len = fileSystem->ReadFile( filename, (void **)&raw, timestamp );
+	len = R_ReadImageFile( filename, (void **)&raw, timestamp );
 	if (!raw) {
 		return;
 	}
@@ -478,7 +528,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 		*pic = NULL;
 	}
 
-	fileSystem->FreeFile( pcx );
+	R_FreeImageFile( pcx );
 }
 
 
@@ -494,7 +544,7 @@ static void LoadPCX32 ( const char *filename, byte **pic, int *width, int *heigh
 	byte	*pic32;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	LoadPCX (filename, &pic8, &palette, width, height, timestamp);
@@ -541,7 +591,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*targa_rgba;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -550,7 +600,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	fileSize = R_ReadImageFile( name, (void **)&buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -760,7 +810,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 		R_VerticalFlip( *pic, *width, *height );
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 }
 
 /*
@@ -770,30 +820,23 @@ LoadJPG
 */
 static void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height, ID_TIME_T *timestamp ) {
 
-	if ( pic ) {
-		*pic = NULL;		// until proven otherwise
+	if ( !pic ) {
+		R_ReadImageFile( filename, NULL, timestamp );
+		return;	// just getting timestamp
 	}
 
-	idFile *f = fileSystem->OpenFileRead( filename );
-	if ( !f ) {
+	*pic = NULL;		// until proven otherwise
+
+	byte *fbuffer;
+	int len = R_ReadImageFile( filename, (void **)&fbuffer, timestamp );
+	if ( !fbuffer ) {
 		return;
 	}
-	int len = f->Length();
-	if ( timestamp ) {
-		*timestamp = f->Timestamp();
-	}
-	if ( !pic ) {
-		fileSystem->CloseFile( f );
-		return;	// just getting timestamp
-	}
-	byte *fbuffer = (byte *)Mem_ClearedAlloc( len );
-	f->Read( fbuffer, len );
-	fileSystem->CloseFile( f );
 
 	int w=0, h=0, comp=0;
 	byte* decodedImageData = stbi_load_from_memory( fbuffer, len, &w, &h, &comp, 4 );
 
-	Mem_Free( fbuffer );
+	R_FreeImageFile( fbuffer );
 
 	if ( decodedImageData == NULL ) {
 		common->Warning( "stb_image was unable to load JPG %s : %s\n",
@@ -837,9 +880,11 @@ Timestamp may be NULL if the value is going to be ignored
 
 If pic is NULL, the image won't actually be loaded, it will just find the
 timestamp.
+
+If sourceKey isn't NULL, the length and zip crc of the file are added to it.
 =================
 */
-void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIME_T *timestamp, bool makePowerOf2 ) {
+void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIME_T *timestamp, bool makePowerOf2, unsigned int *sourceKey ) {
 	idStr name = cname;
 
 	if ( pic ) {
@@ -891,6 +936,11 @@ void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIM
 		LoadJPG( name.c_str(), pic, width, height, timestamp );
 	}
 
+	// name is the last file that was tried, which is the one that was found
+	if ( sourceKey && ( ( pic && *pic ) || ( timestamp && *timestamp != FILE_NOT_FOUND_TIMESTAMP ) ) ) {
+		R_UpdateImageSourceKey( name.c_str(), sourceKey );
+	}
+
 	if ( ( width && *width < 1 ) || ( height && *height < 1 ) ) {
 		if ( pic && *pic ) {
 			R_StaticFree( *pic );
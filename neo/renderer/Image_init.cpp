@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "precompiled.h"
 #pragma hdrstop
 
+#include <atomic>
+
 #include "tr_local.h"
 
 const char *imageFilter[] = {
@@ -62,6 +64,9 @@ idCVar idImageManager::image_cacheMinK( "image_cacheMinK", "200", CVAR_RENDERER
 idCVar idImageManager::image_cacheMegs( "image_cacheMegs", "20", CVAR_RENDERER | CVAR_ARCHIVE, "maximum MB set aside for temporary loading of full-sized precompressed images" );
 idCVar idImageManager::image_useCache( "image_useCache", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "1 = do background load image caching" );
 idCVar idImageManager::image_showBackgroundLoads( "image_showBackgroundLoads", "0", CVAR_RENDERER | CVAR_BOOL, "1 = print number of outstanding background loads" );
+idCVar idImageManager::image_jobDecode( "image_jobDecode", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "decode and mip map images on the job threads during level load" );
+idCVar idImageManager::image_jobDecodeMegs( "image_jobDecodeMegs", "64", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "maximum MB of decoded images waiting for upload during level load", 1, 1024 );
+idCVar idImageManager::image_imageCache( "image_imageCache", "2", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "0 = off, 1 = load block compressed imagecache files, 2 = also write them when images are loaded", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar idImageManager::image_downSizeSpecular( "image_downSizeSpecular", "0", CVAR_RENDERER | CVAR_ARCHIVE, "controls specular downsampling" );
 idCVar idImageManager::image_downSizeBump( "image_downSizeBump", "0", CVAR_RENDERER | CVAR_ARCHIVE, "controls normal map downsampling" );
 idCVar idImageManager::image_downSizeSpecularLimit( "image_downSizeSpecularLimit", "64", CVAR_RENDERER | CVAR_ARCHIVE, "controls specular downsampled limit" );
@@ -963,6 +968,8 @@ static const filterName_t textureFilters[] = {
 	{"GL_NEAREST_MIPMAP_LINEAR", GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST}
 };
 
+	R_SyncRenderThread();
+
 	// if these are changed dynamically, it will force another ChangeTextureFilter
 	image_filter.ClearModified();
 	image_anisotropy.ClearModified();
@@ -1574,6 +1581,7 @@ idImage	*idImageManager::ImageFromFile( const char *_name, textureFilter_t filte
 
 			image->allowDownSize = allowDownSize;
 			image->depth = depth;
+			image->requestedDepth = depth;
 			image->levelLoadReferenced = true;
 			if ( image->partialImage != NULL ) {
 				image->partialImage->levelLoadReferenced = true;
@@ -1601,6 +1609,7 @@ idImage	*idImageManager::ImageFromFile( const char *_name, textureFilter_t filte
 	image->allowDownSize = allowDownSize;
 	image->repeat = repeat;
 	image->depth = depth;
+	image->requestedDepth = depth;
 	image->type = TT_2D;
 	image->cubeFiles = cubeMap;
 	image->filter = filter;
@@ -1615,6 +1624,7 @@ idImage	*idImageManager::ImageFromFile( const char *_name, textureFilter_t filte
 		image->partialImage->allowDownSize = allowDownSize;
 		image->partialImage->repeat = repeat;
 		image->partialImage->depth = depth;
+		image->partialImage->requestedDepth = depth;
 		image->partialImage->type = TT_2D;
 		image->partialImage->cubeFiles = cubeMap;
 		image->partialImage->filter = filter;
@@ -1714,6 +1724,109 @@ void idImageManager::ReloadAllImages() {
 	R_ReloadImages_f( args );
 }
 
+typedef struct {
+	idImage *	image;
+	byte *		file;
+	int			fileSize;
+} imageCacheBuild_t;
+
+/*
+===============
+R_BuildImageCacheJob
+===============
+*/
+static void R_BuildImageCacheJob( void *data ) {
+	imageCacheBuild_t *build = (imageCacheBuild_t *)data;
+
+	build->file = build->image->BuildImageCacheFile( &build->fileSize );
+}
+
+/*
+===============
+R_BuildImageCache_f
+
+Writes the block compressed imagecache/ files of the loaded images, or with
+"all" of every image referenced by a material, compressing them on the job threads.
+
+buildImageCache [all]
+===============
+*/
+void R_BuildImageCache_f( const idCmdArgs &args ) {
+	bool	all = false;
+
+	if ( args.Argc() == 2 && !idStr::Icmp( args.Argv(1), "all" ) ) {
+		all = true;
+	} else if ( args.Argc() != 1 ) {
+		common->Printf( "USAGE: buildImageCache [all]\n" );
+		return;
+	}
+
+	// the internal formats depend on the renderer
+	if ( !glConfig.isInitialized || !glConfig.textureCompressionAvailable ) {
+		common->Printf( "buildImageCache needs a renderer with texture compression\n" );
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+
+	if ( all ) {
+		// create the images of every material without loading them
+		bool insideLevelLoad = globalImages->insideLevelLoad;
+		globalImages->insideLevelLoad = true;
+		for ( int i = 0; i < declManager->GetNumDecls( DECL_MATERIAL ); i++ ) {
+			declManager->MaterialByIndex( i );
+		}
+		globalImages->insideLevelLoad = insideLevelLoad;
+	}
+
+	idList<idImage *>	cacheImages;
+	for ( int i = 0; i < globalImages->images.Num(); i++ ) {
+		idImage	*image = globalImages->images[i];
+		if ( image->generatorFunction || image->cubeFiles != CF_2D || image->isPartialImage ) {
+			continue;
+		}
+		if ( !all && image->texnum == idImage::TEXTURE_NOT_LOADED ) {
+			continue;
+		}
+		cacheImages.Append( image );
+	}
+
+	// the files are written by the main thread between the batches
+	idParallelJobList *jobList = Sys_AllocJobList( "buildImageCache" );
+	int batchSize = Max( 8, Sys_NumJobThreads() * 4 );
+	imageCacheBuild_t *builds = new imageCacheBuild_t[batchSize];
+	int numWritten = 0;
+
+	for ( int first = 0; first < cacheImages.Num(); first += batchSize ) {
+		int num = Min( batchSize, cacheImages.Num() - first );
+		for ( int i = 0; i < num; i++ ) {
+			builds[i].image = cacheImages[first + i];
+			builds[i].file = NULL;
+			builds[i].fileSize = 0;
+			jobList->AddJob( R_BuildImageCacheJob, &builds[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+
+		for ( int i = 0; i < num; i++ ) {
+			if ( builds[i].file == NULL ) {
+				continue;
+			}
+			char filename[MAX_IMAGE_NAME];
+			builds[i].image->ImageProgramStringToCompressedFileName( builds[i].image->imgName, filename, "imagecache" );
+			fileSystem->WriteFile( filename, builds[i].file, builds[i].fileSize );
+			R_StaticFree( builds[i].file );
+			numWritten++;
+		}
+		session->PacifierUpdate();
+	}
+
+	Sys_FreeJobList( jobList );
+	delete[] builds;
+
+	common->Printf( "%i of %i images written to imagecache/ in %5.1f seconds\n", numWritten, cacheImages.Num(), ( Sys_Milliseconds() - start ) * 0.001f );
+}
+
 /*
 ===============
 R_CombineCubeImages_f
@@ -2009,6 +2122,8 @@ void idImageManager::Init() {
 
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
+	cmdSystem->AddCommand( "buildImageCache", R_BuildImageCache_f, CMD_FL_RENDERER, "writes block compressed imagecache files of the loaded images, or all material images" );
+	cmdSystem->AddCommand( "testImageCompression", R_TestImageCompression_f, CMD_FL_RENDERER, "tests the block compression of the image cache" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
 
 	// should forceLoadImages be here?
@@ -2052,6 +2167,97 @@ void idImageManager::BeginLevelLoad() {
 	}
 }
 
+typedef struct {
+	idImage *			image;
+	imageLevels_t		levels;
+	bool				decoded;
+	std::atomic<bool>	done;
+} imageDecode_t;
+
+/*
+====================
+R_DecodeImageJob
+====================
+*/
+static void R_DecodeImageJob( void *data ) {
+	imageDecode_t *decode = (imageDecode_t *)data;
+
+	decode->decoded = decode->image->DecodeImage( decode->levels );
+	decode->done = true;
+}
+
+/*
+====================
+LoadDecodeImages
+
+The images are decoded and mip mapped on the job threads, the main thread
+uploads them in order as they finish.  Only a few images are queued ahead of
+the uploads, and none while image_jobDecodeMegs of decoded images are waiting.
+====================
+*/
+void idImageManager::LoadDecodeImages( const idList<idImage *> &decodeImages ) {
+	if ( !decodeImages.Num() ) {
+		return;
+	}
+
+	idParallelJobList *jobList = Sys_AllocJobList( "imageDecode" );
+	imageDecode_t *decodes = new imageDecode_t[decodeImages.Num()];
+	int maxQueued = Max( 4, Sys_NumJobThreads() * 2 );
+	int maxStaged = image_jobDecodeMegs.GetInteger() * 1024 * 1024;
+	int numQueued = 0;
+
+	for ( int i = 0; i < decodeImages.Num(); i++ ) {
+		decodes[i].image = decodeImages[i];
+		decodes[i].decoded = false;
+		decodes[i].done = false;
+	}
+
+	for ( int numUploaded = 0; numUploaded < decodeImages.Num(); ) {
+		int staged = 0;
+		for ( int i = numUploaded; i < numQueued; i++ ) {
+			if ( decodes[i].done ) {
+				staged += decodes[i].levels.size;
+			}
+		}
+		// always keep one decode in flight, or the next upload would never finish
+		while ( numQueued < decodeImages.Num() && ( numQueued == numUploaded || ( numQueued - numUploaded < maxQueued && staged < maxStaged ) ) ) {
+			jobList->AddJob( R_DecodeImageJob, &decodes[numQueued++] );
+		}
+		jobList->Submit();
+
+		imageDecode_t &decode = decodes[numUploaded];
+		if ( !decode.done ) {
+			if ( Sys_NumJobThreads() == 0 ) {
+				// there are no job threads to run the queued jobs
+				jobList->Wait();
+			} else {
+				Sys_Sleep( 1 );
+			}
+			continue;
+		}
+
+		// the upload may write a precompressed or image cache file and the loading screen may read some
+		Sys_EnterCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+
+		decode.image->FinishDecodedImage( decode.levels, decode.decoded );
+		numUploaded++;
+
+		levelLoadImagesDone++;
+		if ( ( levelLoadImagesDone & 15 ) == 0 ) {
+			if ( image_showBackgroundLoads.GetBool() ) {
+				common->Printf( "%i of %i images loaded\n", levelLoadImagesDone, levelLoadImages );
+			}
+			session->PacifierUpdate();
+		}
+
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_IMAGE_FILES );
+	}
+
+	jobList->Wait();
+	Sys_FreeJobList( jobList );
+	delete[] decodes;
+}
+
 /*
 ====================
 EndLevelLoad
@@ -2097,6 +2303,23 @@ void idImageManager::EndLevelLoad() {
 		}
 	}
 
+	// the images that go through the job threads can't have a generator,
+	// be cube maps or partial images, and writing debug tgas uses the file
+	// system from BuildImageLevels
+	bool jobDecode = image_jobDecode.GetBool() && glConfig.isInitialized
+		&& !image_writeTGA.GetBool() && !image_writeNormalTGA.GetBool();
+
+	idList<idImage *>	decodeImages;
+
+	levelLoadImages = 0;
+	levelLoadImagesDone = 0;
+	for ( int i = 0 ; i < images.Num() ; i++ ) {
+		idImage	*image = images[ i ];
+		if ( !image->generatorFunction && image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage ) {
+			levelLoadImages++;
+		}
+	}
+
 	// load the ones we do need, if we are preloading
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
@@ -2107,7 +2330,17 @@ void idImageManager::EndLevelLoad() {
 		if ( image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage ) {
 //			common->Printf( "Loading %s\n", image->imgName.c_str() );
 			loadCount++;
-			image->ActuallyLoadImage( true, false );
+
+			if ( jobDecode && image->cubeFiles == CF_2D && !image->isPartialImage ) {
+				// precompressed and image cache files only need to be read and uploaded
+				if ( ( !image_usePrecompressedTextures.GetBool() || !image->CheckPrecompressedImage( true ) ) && !image->CheckImageCache() ) {
+					decodeImages.Append( image );
+					continue;
+				}
+			} else {
+				image->ActuallyLoadImage( true, false );
+			}
+			levelLoadImagesDone++;
 
 			if ( ( loadCount & 15 ) == 0 ) {
 				session->PacifierUpdate();
@@ -2115,10 +2348,13 @@ void idImageManager::EndLevelLoad() {
 		}
 	}
 
+	LoadDecodeImages( decodeImages );
+
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i purged from previous\n", purgeCount );
 	common->Printf( "%5i kept from previous\n", keepCount );
 	common->Printf( "%5i new loaded\n", loadCount );
+	common->Printf( "%5i decoded on the job threads\n", decodeImages.Num() );
 	common->Printf( "all images loaded in %5.1f seconds\n", (end-start) * 0.001 );
 }
 
@@ -497,10 +497,7 @@ There is no way to specify explicit mip map levels
 void idImage::GenerateImage( const byte *pic, int width, int height,
 					   textureFilter_t filterParm, bool allowDownSizeParm,
 					   textureRepeat_t repeatParm, textureDepth_t depthParm ) {
-	bool	preserveBorder;
-	byte		*scaledBuffer;
-	int			scaled_width, scaled_height;
-	byte		*shrunk;
+	imageLevels_t	levels;
 
 	PurgeImage();
 
@@ -517,6 +514,27 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		return;
 	}
 
+	BuildImageLevels( pic, width, height, depth, levels );
+	UploadImageLevels( levels );
+}
+
+/*
+================
+BuildImageLevels
+
+The OpenGL free part of GenerateImage, resamples the picture to the upload size
+and builds all mip levels.  Uses the filter and repeat already set on the image,
+if uploadSize is false the picture is kept at full size for the image cache.
+This runs on the job threads during level load, so it must not write the image
+or call anything that isn't thread safe.
+================
+*/
+void idImage::BuildImageLevels( const byte *pic, int width, int height, textureDepth_t minimumDepth, imageLevels_t &levels, bool uploadSize ) const {
+	bool	preserveBorder;
+	byte		*scaledBuffer;
+	int			scaled_width, scaled_height;
+	byte		*shrunk;
+
 	// don't let mip mapping smear the texture into the clamped border
 	if ( repeat == TR_CLAMP_TO_ZERO ) {
 		preserveBorder = true;
@@ -533,15 +551,14 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	}
 
 	// Optionally modify our width/height based on options/hardware
-	GetDownsize( scaled_width, scaled_height );
+	if ( uploadSize ) {
+		GetDownsize( scaled_width, scaled_height );
+	}
 
 	scaledBuffer = NULL;
 
-	// generate the texture number
-	glGenTextures( 1, &texnum );
-
 	// select proper internal format before we resample
-	internalFormat = SelectInternalFormat( &pic, 1, width, height, depth );
+	levels.internalFormat = SelectInternalFormat( &pic, 1, width, height, minimumDepth );
 
 	// copy or resample data as appropriate for first MIP level
 	if ( ( scaled_width == width ) && ( scaled_height == height ) ) {
@@ -582,9 +599,8 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		scaled_height = height;
 	}
 
-	uploadHeight = scaled_height;
-	uploadWidth = scaled_width;
-	type = TT_2D;
+	levels.width = scaled_width;
+	levels.height = scaled_height;
 
 	// zero the border if desired, allowing clamped projection textures
 	// even after picmip resampling or careless artists.
@@ -603,7 +619,8 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		R_SetBorderTexels( (byte *)scaledBuffer, width, height, rgba );
 	}
 
-	if ( generatorFunction == NULL && ( (depth == TD_BUMP && globalImages->image_writeNormalTGA.GetBool()) || (depth != TD_BUMP && globalImages->image_writeTGA.GetBool()) ) ) {
+	// EndLevelLoad doesn't decode on the job threads while these are set
+	if ( uploadSize && generatorFunction == NULL && ( (minimumDepth == TD_BUMP && globalImages->image_writeNormalTGA.GetBool()) || (minimumDepth != TD_BUMP && globalImages->image_writeTGA.GetBool()) ) ) {
 		// Optionally write out the texture to a .tga
 		char filename[MAX_IMAGE_NAME];
 		ImageProgramStringToCompressedFileName( imgName, filename );
@@ -638,38 +655,21 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	// one fragment program
 	// if the image is precompressed ( either in palletized mode or true rxgb mode )
 	// then it is loaded above and the swap never happens here
-	if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
+	if ( minimumDepth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
 		for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
 			scaledBuffer[ i + 3 ] = scaledBuffer[ i ];
 			scaledBuffer[ i ] = 0;
 		}
 	}
-	// upload the main image level
-	Bind();
 
+	levels.pics[0] = scaledBuffer;
+	levels.numLevels = 1;
+	levels.size = scaled_width * scaled_height * 4;
 
-	if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-		/*
-		if ( depth == TD_BUMP ) {
-			for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
-				scaledBuffer[ i ] = scaledBuffer[ i + 3 ];
-				scaledBuffer[ i + 3 ] = 0;
-			}
-		}
-		*/
-		UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, 0 );
-	} else {
-		glTexImage2D( GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
-	}
-
-	// create and upload the mip map levels, which we do in all cases, even if we don't think they are needed
-	int		miplevel;
-
-	miplevel = 0;
-	while ( scaled_width > 1 || scaled_height > 1 ) {
+	// create the mip map levels, which we do in all cases, even if we don't think they are needed
+	while ( ( scaled_width > 1 || scaled_height > 1 ) && levels.numLevels < MAX_IMAGE_LEVELS ) {
 		// preserve the border after mip map unless repeating
 		shrunk = R_MipMap( scaledBuffer, scaled_width, scaled_height, preserveBorder );
-		R_StaticFree( scaledBuffer );
 		scaledBuffer = shrunk;
 
 		scaled_width >>= 1;
@@ -680,28 +680,64 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		if ( scaled_height < 1 ) {
 			scaled_height = 1;
 		}
-		miplevel++;
 
 		// this is a visualization tool that shades each mip map
 		// level with a different color so you can see the
 		// rasterizer's texture level selection algorithm
 		// Changing the color doesn't help with lumminance/alpha/intensity formats...
-		if ( depth == TD_DIFFUSE && globalImages->image_colorMipLevels.GetBool() ) {
-			R_BlendOverTexture( (byte *)scaledBuffer, scaled_width * scaled_height, mipBlendColors[miplevel] );
+		if ( minimumDepth == TD_DIFFUSE && globalImages->image_colorMipLevels.GetBool() ) {
+			R_BlendOverTexture( (byte *)scaledBuffer, scaled_width * scaled_height, mipBlendColors[levels.numLevels] );
 		}
 
-		// upload the mip map
+		levels.pics[levels.numLevels++] = scaledBuffer;
+		levels.size += scaled_width * scaled_height * 4;
+	}
+}
+
+/*
+================
+UploadImageLevels
+
+The OpenGL part of GenerateImage, uploads and frees the levels
+================
+*/
+void idImage::UploadImageLevels( imageLevels_t &levels ) {
+	int		width, height;
+
+	// generate the texture number
+	glGenTextures( 1, &texnum );
+
+	internalFormat = levels.internalFormat;
+	uploadWidth = levels.width;
+	uploadHeight = levels.height;
+	type = TT_2D;
+
+	// upload the main image level
+	Bind();
+
+	width = levels.width;
+	height = levels.height;
+	for ( int i = 0; i < levels.numLevels; i++ ) {
 		if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-			UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, miplevel );
+			UploadCompressedNormalMap( width, height, levels.pics[i], i );
 		} else {
-			glTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height,
-				0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
+			glTexImage2D( GL_TEXTURE_2D, i, internalFormat, width, height,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, levels.pics[i] );
 		}
-	}
+		R_StaticFree( levels.pics[i] );
+		levels.pics[i] = NULL;
 
-	if ( scaledBuffer != 0 ) {
-		R_StaticFree( scaledBuffer );
+		width >>= 1;
+		height >>= 1;
+		if ( width < 1 ) {
+			width = 1;
+		}
+		if ( height < 1 ) {
+			height = 1;
+		}
 	}
+	levels.numLevels = 0;
+	levels.size = 0;
 
 	SetImageFilterAndRepeat();
 
@@ -967,11 +1003,12 @@ void idImage::GenerateCubeImage( const byte *pic[6], int size,
 ImageProgramStringToFileCompressedFileName
 ================
 */
-void idImage::ImageProgramStringToCompressedFileName( const char *imageProg, char *fileName ) const {
+void idImage::ImageProgramStringToCompressedFileName( const char *imageProg, char *fileName, const char *dir ) const {
 	const char	*s;
 	char	*f;
 
-	strcpy( fileName, "dds/" );
+	strcpy( fileName, dir );
+	strcat( fileName, "/" );
 	f = fileName + strlen( fileName );
 
 	int depth = 0;
@@ -1549,6 +1586,221 @@ void idImage::UploadPrecompressedImage( byte *data, int len ) {
 	SetImageFilterAndRepeat();
 }
 
+/*
+===============
+ImageCacheKey
+
+Everything besides the source files that changes the contents of an image cache file
+===============
+*/
+unsigned int idImage::ImageCacheKey( textureDepth_t minimumDepth ) const {
+	int				parms[4];
+	unsigned int	key;
+
+	parms[0] = minimumDepth;
+	parms[1] = repeat;
+	parms[2] = globalImages->image_roundDown.GetBool();
+	parms[3] = globalImages->image_useNormalCompression.GetInteger();
+
+	CRC32_InitChecksum( key );
+	CRC32_UpdateChecksum( key, imgName.c_str(), imgName.Length() );
+	CRC32_UpdateChecksum( key, parms, sizeof( parms ) );
+	CRC32_FinishChecksum( key );
+
+	return key;
+}
+
+/*
+===============
+BuildImageCacheFile
+
+Block compresses the full mip chain of a loaded image program into a complete
+dds file for imagecache/.  Returns NULL if the image doesn't select a DXT format.
+Uses the filter and repeat already set on the image, so it can run on a job thread.
+===============
+*/
+byte *idImage::BuildImageCacheFile( const byte *pic, int width, int height, textureDepth_t minimumDepth,
+									unsigned int key, ID_TIME_T sourceTimestamp, unsigned int sourceKey, int *fileSize ) const {
+	imageLevels_t	levels;
+	int				blockBytes;
+
+	*fileSize = 0;
+
+	// the mip colors are only a development aid, and the normal path reports bad sizes
+	if ( globalImages->image_colorMipLevels.GetBool() || MakePowerOfTwo( width ) != width || MakePowerOfTwo( height ) != height ) {
+		return NULL;
+	}
+
+	// DXT3 images are stored as BC3, palettized normal maps and uncompressed formats aren't cached
+	switch ( SelectInternalFormat( &pic, 1, width, height, minimumDepth ) ) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+			blockBytes = 8;
+			break;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			blockBytes = 16;
+			break;
+		default:
+			return NULL;
+	}
+
+	// the upload skips mip levels for downsizing, so the cache always holds the full size
+	BuildImageLevels( pic, width, height, minimumDepth, levels, false );
+
+	int len = 4 + sizeof( ddsFileHeader_t );
+	int w = levels.width;
+	int h = levels.height;
+	for ( int i = 0; i < levels.numLevels; i++ ) {
+		len += R_CompressedImageSize( w, h, blockBytes );
+		w = Max( w >> 1, 1 );
+		h = Max( h >> 1, 1 );
+	}
+
+	byte *data = (byte *)R_StaticAlloc( len );
+
+	ddsFileHeader_t	*header = (ddsFileHeader_t *)( data + 4 );
+	memset( header, 0, sizeof( *header ) );
+	header->dwSize = sizeof( *header );
+	header->dwFlags = DDSF_CAPS | DDSF_PIXELFORMAT | DDSF_WIDTH | DDSF_HEIGHT | DDSF_LINEARSIZE | DDSF_MIPMAPCOUNT;
+	header->dwHeight = levels.height;
+	header->dwWidth = levels.width;
+	header->dwPitchOrLinearSize = R_CompressedImageSize( levels.width, levels.height, blockBytes );
+	header->dwMipMapCount = levels.numLevels;
+	header->dwReserved1[0] = IMAGE_CACHE_ID;
+	header->dwReserved1[1] = IMAGE_CACHE_VERSION;
+	header->dwReserved1[2] = key;
+	header->dwReserved1[3] = (unsigned int)sourceTimestamp;
+	header->dwReserved1[4] = sourceKey;
+	header->ddspf.dwSize = sizeof( header->ddspf );
+	header->ddspf.dwFlags = DDSF_FOURCC;
+	header->ddspf.dwFourCC = ( blockBytes == 8 ) ? DDS_MAKEFOURCC( 'D', 'X', 'T', '1' ) : DDS_MAKEFOURCC( 'D', 'X', 'T', '5' );
+	header->dwCaps1 = DDSF_TEXTURE | DDSF_MIPMAP | DDSF_COMPLEX;
+
+	*(unsigned int *)data = LittleInt( DDS_MAKEFOURCC( 'D', 'D', 'S', ' ' ) );
+	for ( int i = 0; i < sizeof( *header ) / 4; i++ ) {
+		( (unsigned int *)header )[i] = LittleInt( ( (unsigned int *)header )[i] );
+	}
+
+	byte *out = data + 4 + sizeof( ddsFileHeader_t );
+	w = levels.width;
+	h = levels.height;
+	for ( int i = 0; i < levels.numLevels; i++ ) {
+		if ( blockBytes == 8 ) {
+			R_CompressBC1( levels.pics[i], w, h, out );
+		} else {
+			R_CompressBC3( levels.pics[i], w, h, out );
+		}
+		out += R_CompressedImageSize( w, h, blockBytes );
+		R_StaticFree( levels.pics[i] );
+		w = Max( w >> 1, 1 );
+		h = Max( h >> 1, 1 );
+	}
+
+	*fileSize = len;
+	return data;
+}
+
+/*
+===============
+BuildImageCacheFile
+
+Loads the image program and builds its cache file, for the buildImageCache command
+===============
+*/
+byte *idImage::BuildImageCacheFile( int *fileSize ) const {
+	int				width, height;
+	byte			*pic;
+	ID_TIME_T		sourceTimestamp;
+	unsigned int	sourceKey;
+	textureDepth_t	loadDepth = requestedDepth;
+
+	*fileSize = 0;
+
+	R_LoadImageProgram( imgName, &pic, &width, &height, &sourceTimestamp, &loadDepth, &sourceKey );
+	if ( pic == NULL ) {
+		return NULL;
+	}
+
+	byte *data = BuildImageCacheFile( pic, width, height, loadDepth, ImageCacheKey( requestedDepth ), sourceTimestamp, sourceKey, fileSize );
+
+	R_StaticFree( pic );
+
+	return data;
+}
+
+/*
+===============
+CheckImageCache
+
+Uploads the imagecache/ file of a 2D image program if it was built from the
+current source files with the current settings.
+===============
+*/
+bool idImage::CheckImageCache() {
+	if ( !glConfig.isInitialized || !glConfig.textureCompressionAvailable ) {
+		return false;
+	}
+	if ( globalImages->image_imageCache.GetInteger() <= 0 || !globalImages->image_useCompression.GetBool() ) {
+		return false;
+	}
+
+	// if we are doing a copyFiles, make sure the original images are referenced
+	if ( fileSystem->PerformingCopyFiles() ) {
+		return false;
+	}
+
+	// the timestamps of all the files the image program reads, without loading them,
+	// files in a pk4 have no timestamp so their length and crc are checked as well
+	ID_TIME_T sourceTimestamp;
+	unsigned int sourceKey;
+	R_LoadImageProgram( imgName, NULL, NULL, NULL, &sourceTimestamp, NULL, &sourceKey );
+	if ( sourceTimestamp == FILE_NOT_FOUND_TIMESTAMP ) {
+		return false;
+	}
+
+	char filename[MAX_IMAGE_NAME];
+	ImageProgramStringToCompressedFileName( imgName, filename, "imagecache" );
+
+	byte *data;
+	int len = fileSystem->ReadFile( filename, (void **)&data, NULL );
+	if ( len <= 0 ) {
+		return false;
+	}
+
+	const ddsFileHeader_t *header = (const ddsFileHeader_t *)( data + 4 );
+	bool valid = false;
+
+	if ( len >= 4 + sizeof( ddsFileHeader_t ) && LittleInt( *(unsigned int *)data ) == DDS_MAKEFOURCC( 'D', 'D', 'S', ' ' )
+		&& LittleInt( header->dwReserved1[0] ) == IMAGE_CACHE_ID && LittleInt( header->dwReserved1[1] ) == IMAGE_CACHE_VERSION
+		&& LittleInt( header->dwReserved1[2] ) == ImageCacheKey( requestedDepth ) && LittleInt( header->dwReserved1[3] ) == (unsigned int)sourceTimestamp
+		&& LittleInt( header->dwReserved1[4] ) == sourceKey ) {
+
+		int blockBytes = ( LittleInt( header->ddspf.dwFourCC ) == DDS_MAKEFOURCC( 'D', 'X', 'T', '1' ) ) ? 8 : 16;
+		int numLevels = LittleInt( header->dwMipMapCount );
+		int w = LittleInt( header->dwWidth );
+		int h = LittleInt( header->dwHeight );
+		int expected = 4 + sizeof( ddsFileHeader_t );
+		for ( int i = 0; i < numLevels; i++ ) {
+			expected += R_CompressedImageSize( w, h, blockBytes );
+			w = Max( w >> 1, 1 );
+			h = Max( h >> 1, 1 );
+		}
+		valid = ( numLevels > 0 && numLevels <= MAX_IMAGE_LEVELS && len == expected );
+	}
+
+	if ( !valid ) {
+		fileSystem->FreeFile( data );
+		return false;
+	}
+
+	timestamp = sourceTimestamp;
+	UploadPrecompressedImage( data, len );
+
+	fileSystem->FreeFile( data );
+
+	return true;
+}
+
 /*
 ===============
 ActuallyLoadImage
@@ -1558,8 +1810,10 @@ On exit, the idImage will have a valid OpenGL texture number that can be bound
 ===============
 */
 void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd ) {
-	int		width, height;
-	byte	*pic;
+	int		width;
+
+	// a load from the front end must not issue GL while the render thread owns the context
+	R_SyncRenderThread();
 
 	// this is the ONLY place generatorFunction will ever be called
 	if ( generatorFunction ) {
@@ -1611,40 +1865,106 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 			// fall through to load the normal image
 		}
 
-		R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
-
-		if ( pic == NULL ) {
-			common->Warning( "Couldn't load image: " S_COLOR_GREEN "%s", imgName.c_str() );
-			MakeDefault();
+		// or a block compressed image cache file
+		if ( checkForPrecompressed && CheckImageCache() ) {
 			return;
 		}
+
+		imageLevels_t	levels;
+
+		FinishDecodedImage( levels, DecodeImage( levels ) );
+	}
+}
+
 /*
-		// swap the red and alpha for rxgb support
-		// do this even on tga normal maps so we only have to use
-		// one fragment program
-		// if the image is precompressed ( either in palletized mode or true rxgb mode )
-		// then it is loaded above and the swap never happens here
-		if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
-			for ( int i = 0; i < width * height * 4; i += 4 ) {
-				pic[ i + 3 ] = pic[ i ];
-				pic[ i ] = 0;
-			}
+===============
+DecodeImage
+
+The part of ActuallyLoadImage for 2D image files that can run on a job thread,
+loads the file or image program and builds the upload levels.
+Returns false if the image couldn't be loaded.
+===============
+*/
+bool idImage::DecodeImage( imageLevels_t &levels ) {
+	int		width, height;
+	byte	*pic;
+
+	levels.numLevels = 0;
+	levels.size = 0;
+	levels.cacheFile = NULL;
+	levels.cacheFileSize = 0;
+
+	// build the image cache file instead of the levels when the format allows it
+	bool buildCacheFile = glConfig.isInitialized && globalImages->image_imageCache.GetInteger() >= 2 && glConfig.textureCompressionAvailable;
+	unsigned int sourceKey = 0;
+
+	R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth, buildCacheFile ? &sourceKey : NULL );
+
+	if ( pic == NULL ) {
+		return false;
+	}
+
+	// build a hash for checking duplicate image files
+	// NOTE: takes about 10% of image load times (SD)
+	// may not be strictly necessary, but some code uses it, so let's leave it in
+	imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+
+	if ( glConfig.isInitialized ) {
+		if ( buildCacheFile ) {
+			levels.cacheFile = BuildImageCacheFile( pic, width, height, depth, ImageCacheKey( requestedDepth ), timestamp, sourceKey, &levels.cacheFileSize );
 		}
+		if ( levels.cacheFile ) {
+			levels.size = levels.cacheFileSize;
+		} else {
+			BuildImageLevels( pic, width, height, depth, levels );
+		}
+	}
+
+	R_StaticFree( pic );
+
+	return true;
+}
+
+/*
+===============
+FinishDecodedImage
+
+Uploads an image that went through DecodeImage, on the main thread
+===============
 */
-		// build a hash for checking duplicate image files
-		// NOTE: takes about 10% of image load times (SD)
-		// may not be strictly necessary, but some code uses it, so let's leave it in
-		imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+void idImage::FinishDecodedImage( imageLevels_t &levels, bool decoded ) {
+	if ( !decoded ) {
+		common->Warning( "Couldn't load image: " S_COLOR_GREEN "%s", imgName.c_str() );
+		MakeDefault();
+		return;
+	}
 
-		GenerateImage( pic, width, height, filter, allowDownSize, repeat, depth );
-		timestamp = timestamp;
-		precompressedFile = false;
+	// without a rendering context only the parms and timestamp are needed
+	if ( !glConfig.isInitialized ) {
+		return;
+	}
 
-		R_StaticFree( pic );
+	PurgeImage();
 
-		// write out the precompressed version of this file if needed
-		WritePrecompressedImage();
+	if ( levels.cacheFile ) {
+		char filename[MAX_IMAGE_NAME];
+		ImageProgramStringToCompressedFileName( imgName, filename, "imagecache" );
+
+		// the upload byte swaps the header in place, so write it out first
+		fileSystem->WriteFile( filename, levels.cacheFile, levels.cacheFileSize );
+		UploadPrecompressedImage( levels.cacheFile, levels.cacheFileSize );
+
+		R_StaticFree( levels.cacheFile );
+		levels.cacheFile = NULL;
+		levels.size = 0;
+		return;
 	}
+
+	UploadImageLevels( levels );
+	precompressedFile = false;
+
+	// write out the precompressed version of this file if needed
+	WritePrecompressedImage();
 }
 
 //=========================================================================================================
@@ -1655,6 +1975,8 @@ PurgeImage
 ===============
 */
 void idImage::PurgeImage() {
+	R_SyncRenderThread();
+
 	if ( texnum != TEXTURE_NOT_LOADED ) {
 		glDeleteTextures( 1, &texnum );	// this should be the ONLY place it is ever called!
 		texnum = TEXTURE_NOT_LOADED;
@@ -1691,19 +2013,27 @@ void idImage::Bind() {
 		cacheUsagePrev->cacheUsageNext = this;
 	}
 
-	// load the image if necessary (FIXME: not SMP safe!)
+	// load the image if necessary
 	if ( texnum == TEXTURE_NOT_LOADED ) {
 		if ( partialImage ) {
 			// if we have a partial image, go ahead and use that
 			this->partialImage->Bind();
 
-			// start a background load of the full thing if it isn't already in the queue
-			if ( !backgroundLoadInProgress ) {
+			// start a background load of the full thing if it isn't already in the queue,
+			// the render thread leaves that to LoadForBind on the main thread
+			if ( !backgroundLoadInProgress && Sys_IsMainThread() ) {
 				StartBackgroundImageLoad();
 			}
 			return;
 		}
 
+		// the file system and the decl manager aren't thread safe, LoadForBind loads
+		// everything the commands use before the render thread gets them
+		if ( !Sys_IsMainThread() ) {
+			globalImages->defaultImage->Bind();
+			return;
+		}
+
 		// load the image on demand here, which isn't our normal game operating mode
 		ActuallyLoadImage( true, true );	// check for precompressed, load is from back end
 	}
@@ -1783,19 +2113,27 @@ void idImage::BindFragment() {
 		cacheUsagePrev->cacheUsageNext = this;
 	}
 
-	// load the image if necessary (FIXME: not SMP safe!)
+	// load the image if necessary
 	if ( texnum == TEXTURE_NOT_LOADED ) {
 		if ( partialImage ) {
 			// if we have a partial image, go ahead and use that
 			this->partialImage->BindFragment();
 
-			// start a background load of the full thing if it isn't already in the queue
-			if ( !backgroundLoadInProgress ) {
+			// start a background load of the full thing if it isn't already in the queue,
+			// the render thread leaves that to LoadForBind on the main thread
+			if ( !backgroundLoadInProgress && Sys_IsMainThread() ) {
 				StartBackgroundImageLoad();
 			}
 			return;
 		}
 
+		// the file system and the decl manager aren't thread safe, LoadForBind loads
+		// everything the commands use before the render thread gets them
+		if ( !Sys_IsMainThread() ) {
+			globalImages->defaultImage->BindFragment();
+			return;
+		}
+
 		// load the image on demand here, which isn't our normal game operating mode
 		ActuallyLoadImage( true, true );	// check for precompressed, load is from back end
 	}
@@ -1818,6 +2156,27 @@ void idImage::BindFragment() {
 }
 
 
+/*
+==============
+LoadForBind
+==============
+*/
+void idImage::LoadForBind() {
+	if ( texnum != TEXTURE_NOT_LOADED ) {
+		return;
+	}
+
+	if ( partialImage ) {
+		partialImage->LoadForBind();
+		if ( !backgroundLoadInProgress ) {
+			StartBackgroundImageLoad();
+		}
+		return;
+	}
+
+	ActuallyLoadImage( true, true );	// check for precompressed, load is for the back end
+}
+
 /*
 ====================
 CopyFramebuffer
@@ -1944,6 +2303,8 @@ if rows = cols * 6, assume it is a cube map animation
 void idImage::UploadScratch( const byte *data, int cols, int rows ) {
 	int			i;
 
+	R_SyncRenderThread();
+
 	// if rows = cols * 6, assume it is a cube map animation
 	if ( rows == cols * 6 ) {
 		if ( type != TT_CUBIC ) {
@@ -330,8 +330,9 @@ static void R_ImageAdd( byte *data1, int width1, int height1, byte *data2, int w
 }
 
 
-// we build a canonical token form of the image program here
-static char parseBuffer[MAX_IMAGE_NAME];
+// we build a canonical token form of the image program here,
+// one per thread because images are also loaded on the job threads
+static thread_local char parseBuffer[MAX_IMAGE_NAME];
 
 /*
 ===================
@@ -369,7 +370,7 @@ used to parse an image program from a text stream.
 ===================
 */
 static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *height,
-								  ID_TIME_T *timestamps, textureDepth_t *depth ) {
+								  ID_TIME_T *timestamps, textureDepth_t *depth, unsigned int *sourceKey ) {
 	idToken		token;
 	float		scale;
 	ID_TIME_T		timestamp;
@@ -380,7 +381,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 	if ( !token.Icmp( "heightmap" ) ) {
 		MatchAndAppendToken( src, "(" );
 
-		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey ) ) {
 			return false;
 		}
 
@@ -408,13 +409,13 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 
 		MatchAndAppendToken( src, "(" );
 
-		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey ) ) {
 			return false;
 		}
 
 		MatchAndAppendToken( src, "," );
 
-		if ( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth, sourceKey ) ) {
 			if ( pic ) {
 				R_StaticFree( *pic );
 				*pic = NULL;
@@ -438,7 +439,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 	if ( !token.Icmp( "smoothnormals" ) ) {
 		MatchAndAppendToken( src, "(" );
 
-		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey ) ) {
 			return false;
 		}
 
@@ -459,13 +460,13 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 
 		MatchAndAppendToken( src, "(" );
 
-		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey ) ) {
 			return false;
 		}
 
 		MatchAndAppendToken( src, "," );
 
-		if ( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth ) ) {
+		if ( !R_ParseImageProgram_r( src, pic ? &pic2 : NULL, &width2, &height2, timestamps, depth, sourceKey ) ) {
 			if ( pic ) {
 				R_StaticFree( *pic );
 				*pic = NULL;
@@ -489,7 +490,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
 		for ( i = 0 ; i < 4 ; i++ ) {
 			MatchAndAppendToken( src, "," );
@@ -510,7 +511,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 	if ( !token.Icmp( "invertAlpha" ) ) {
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
 		// process it
 		if ( pic ) {
@@ -524,7 +525,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 	if ( !token.Icmp( "invertColor" ) ) {
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
 		// process it
 		if ( pic ) {
@@ -540,7 +541,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
 		// copy red to green, blue, and alpha
 		if ( pic ) {
@@ -562,7 +563,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 
 		MatchAndAppendToken( src, "(" );
 
-		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+		R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
 		// average RGB into alpha, then set RGB to white
 		if ( pic ) {
@@ -587,7 +588,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 	}
 
 	// load it as an image
-	R_LoadImage( token.c_str(), pic, width, height, &timestamp, true );
+	R_LoadImage( token.c_str(), pic, width, height, &timestamp, true, sourceKey );
 
 	if ( timestamp == FILE_NOT_FOUND_TIMESTAMP ) {
 		return false;
@@ -609,7 +610,7 @@ static bool R_ParseImageProgram_r( idLexer &src, byte **pic, int *width, int *he
 R_LoadImageProgram
 ===================
 */
-void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamps, textureDepth_t *depth ) {
+void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamps, textureDepth_t *depth, unsigned int *sourceKey ) {
 	idLexer src;
 
 	src.LoadMemory( name, strlen(name), name );
@@ -619,8 +620,15 @@ void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height,
 	if ( timestamps ) {
 		*timestamps = 0;
 	}
+	if ( sourceKey ) {
+		CRC32_InitChecksum( *sourceKey );
+	}
+
+	R_ParseImageProgram_r( src, pic, width, height, timestamps, depth, sourceKey );
 
-	R_ParseImageProgram_r( src, pic, width, height, timestamps, depth );
+	if ( sourceKey ) {
+		CRC32_FinishChecksum( *sourceKey );
+	}
 
 	src.FreeSource();
 }
@@ -632,6 +640,6 @@ R_ParsePastImageProgram
 */
 const char *R_ParsePastImageProgram( idLexer &src ) {
 	parseBuffer[0] = 0;
-	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL );
+	R_ParseImageProgram_r( src, NULL, NULL, NULL, NULL, NULL, NULL );
 	return parseBuffer;
 }
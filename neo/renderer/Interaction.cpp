@@ -51,7 +51,7 @@ at the border we throw things out on the border, because if any one
 vertex is clearly inside, the entire triangle will be accepted.
 =====================
 */
-void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo ) {
+void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo, byte *cullBits ) {
 	int i, frontBits;
 
 	if ( cullInfo.cullBits != NULL ) {
@@ -77,7 +77,10 @@ void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangl
 		return;
 	}
 
-	cullInfo.cullBits = (byte *) R_StaticAlloc( tri->numVerts * sizeof( cullInfo.cullBits[0] ) );
+	if ( cullBits == NULL ) {
+		cullBits = (byte *) R_StaticAlloc( tri->numVerts * sizeof( cullInfo.cullBits[0] ) );
+	}
+	cullInfo.cullBits = cullBits;
 	SIMDProcessor->Memset( cullInfo.cullBits, 0, tri->numVerts * sizeof( cullInfo.cullBits[0] ) );
 
 	float *planeSide = (float *) _alloca16( tri->numVerts * sizeof( float ) );
@@ -245,6 +248,8 @@ idInteraction::idInteraction( void ) {
 	lightPrev				= NULL;
 	entityNext				= NULL;
 	entityPrev				= NULL;
+	shadowJobsPending		= false;
+	shadowSettings			= -1;
 	dynamicModelFrameCount	= 0;
 	frustumState			= FRUSTUM_UNINITIALIZED;
 	frustumAreas			= NULL;
@@ -266,6 +271,8 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 
 	// link and initialize
 	interaction->dynamicModelFrameCount = 0;
+	interaction->shadowJobsPending = false;
+	interaction->shadowSettings = -1;
 
 	interaction->lightDef = ldef;
 	interaction->entityDef = edef;
@@ -317,6 +324,11 @@ will be regenerated automatically
 ===============
 */
 void idInteraction::FreeSurfaces( void ) {
+	// the shadow jobs write into the surfaces
+	if ( this->shadowJobsPending ) {
+		R_FlushShadowJobs();
+	}
+
 	if ( this->surfaces ) {
 		for ( int i = 0 ; i < this->numSurfaces ; i++ ) {
 			surfaceInteraction_t *sint = &this->surfaces[i];
@@ -643,9 +655,13 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 	//
 	numSurfaces = model->NumSurfaces();
 	surfaces = (surfaceInteraction_t *)R_ClearedStaticAlloc( sizeof( *surfaces ) * numSurfaces );
+	shadowSettings = idInteractionCache::CurrentSettings();
 
 	interactionGenerated = false;
 
+	// the shadow volumes of static interactions may be cached from an earlier load of the map
+	const cachedInteraction_t *cached = entityDef->world->interactionCache.FindInteraction( entityDef, lightDef, model );
+
 	// check each surface in the model
 	for ( int c = 0 ; c < model->NumSurfaces() ; c++ ) {
 		const modelSurface_t	*surf;
@@ -700,13 +716,19 @@ void idInteraction::CreateInteraction( const idRenderModel *model ) {
 			// if the light has an optimized shadow volume, don't create shadows for any models that are part of the base areas
 			if ( lightDef->parms.prelightModel == NULL || !model->IsStaticWorldModel() || !r_useOptimizedShadows.GetBool() ) {
 
-				// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
-				sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
-				if ( sint->shadowTris ) {
-					if ( shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID ) ) {
-						// if any surface is a shadow-casting perforated or translucent surface, or the
-						// base surface is suppressed in the view (world weapon shadows) we can't use
-						// the external shadow optimizations because we can see through some of the faces
+				// if any surface is a shadow-casting perforated or translucent surface, or the
+				// base surface is suppressed in the view (world weapon shadows) we can't use
+				// the external shadow optimizations because we can see through some of the faces
+				const bool seeThrough = shader->Coverage() != MC_OPAQUE || ( !r_skipSuppress.GetBool() && entityDef->parms.suppressSurfaceInViewID );
+
+				if ( cached != NULL ) {
+					sint->shadowTris = entityDef->world->interactionCache.CopyShadowVolume( cached, c );
+
+				// the turbo shadows may be generated on the job threads while the view is set up
+				} else if ( !R_QueueShadowVolume( entityDef, tri, lightDef, shadowGen, seeThrough, this, c ) ) {
+					// this is the only place during gameplay (outside the utilities) that R_CreateShadowVolume() is called
+					sint->shadowTris = R_CreateShadowVolume( entityDef, tri, lightDef, shadowGen, sint->cullInfo );
+					if ( sint->shadowTris && seeThrough ) {
 						sint->shadowTris->numShadowIndexesNoCaps = sint->shadowTris->numIndexes;
 						sint->shadowTris->numShadowIndexesNoFrontCaps = sint->shadowTris->numIndexes;
 					}
@@ -800,22 +822,16 @@ static bool R_PotentiallyInsideInfiniteShadow( const srfTriangles_t *occluder,
 
 /*
 ==================
-idInteraction::AddActiveInteraction
-
-Create and add any necessary light and shadow triangles
+idInteraction::PrepareActiveInteraction
 
 If the model doesn't have any surfaces that need interactions
 with this type of light, it can be skipped, but we might need to
 instantiate the dynamic model to find out
 ==================
 */
-void idInteraction::AddActiveInteraction( void ) {
+const idRenderModel *idInteraction::PrepareActiveInteraction( idScreenRect &shadowScissor ) {
 	viewLight_t *	vLight;
 	viewEntity_t *	vEntity;
-	idScreenRect	shadowScissor;
-	idScreenRect	lightScissor;
-	idVec3			localLightOrigin;
-	idVec3			localViewOrigin;
 
 	vLight = lightDef->viewLight;
 	vEntity = entityDef->viewEntity;
@@ -838,7 +854,7 @@ void idInteraction::AddActiveInteraction( void ) {
 		// this will also cull the case where the light origin is inside the
 		// view frustum and the entity bounds are outside the view frustum
 		if ( CullInteractionByViewFrustum( tr.viewDef->viewFrustum ) ) {
-			return;
+			return NULL;
 		}
 
 		// calculate the shadow scissor rectangle
@@ -847,7 +863,7 @@ void idInteraction::AddActiveInteraction( void ) {
 
 	// get out before making the dynamic model if the shadow scissor rectangle is empty
 	if ( shadowScissor.IsEmpty() ) {
-		return;
+		return NULL;
 	}
 
 	// We will need the dynamic surface created to make interactions, even if the
@@ -855,7 +871,7 @@ void idInteraction::AddActiveInteraction( void ) {
 	// has been generated once in the view.
 	idRenderModel *model = R_EntityDefDynamicModel( entityDef );
 	if ( model == NULL || model->NumSurfaces() <= 0 ) {
-		return;
+		return NULL;
 	}
 
 	// the dynamic model may have changed since we built the surface list
@@ -869,6 +885,31 @@ void idInteraction::AddActiveInteraction( void ) {
 		CreateInteraction( model );
 	}
 
+	return model;
+}
+
+/*
+==================
+idInteraction::AddActiveInteraction
+
+Create and add any necessary light and shadow triangles
+==================
+*/
+void idInteraction::AddActiveInteraction( void ) {
+	viewLight_t *	vLight;
+	viewEntity_t *	vEntity;
+	idScreenRect	shadowScissor;
+	idScreenRect	lightScissor;
+	idVec3			localLightOrigin;
+	idVec3			localViewOrigin;
+
+	vLight = lightDef->viewLight;
+	vEntity = entityDef->viewEntity;
+
+	if ( PrepareActiveInteraction( shadowScissor ) == NULL ) {
+		return;
+	}
+
 	R_GlobalPointToLocal( vEntity->modelMatrix, lightDef->globalLightOrigin, localLightOrigin );
 	R_GlobalPointToLocal( vEntity->modelMatrix, tr.viewDef->renderView.vieworg, localViewOrigin );
 
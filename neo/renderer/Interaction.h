@@ -106,6 +106,12 @@ public:
 	idInteraction *			entityNext;				// for entityDef chains
 	idInteraction *			entityPrev;
 
+	// shadow volumes of the surfaces are still being generated on the job threads
+	bool					shadowJobsPending;
+
+	// idInteractionCache::CurrentSettings() when the surfaces were created, -1 before
+	int						shadowSettings;
+
 public:
 							idInteraction( void );
 
@@ -138,6 +144,12 @@ public:
 	// will be used to determine when we need to start purging old interactions
 	int						MemoryUsed( void );
 
+	// culls the interaction against the view and creates the surfaces if needed,
+	// returns NULL if there is nothing to add
+	// R_AddModelSurfaces calls this for the whole view ahead of AddActiveInteraction,
+	// so the shadow volumes can be generated on the job threads
+	const idRenderModel *	PrepareActiveInteraction( idScreenRect &shadowScissor );
+
 	// makes sure all necessary light surfaces and shadow surfaces are created, and
 	// calls R_LinkLightSurf() for each one
 	void					AddActiveInteraction( void );
@@ -171,8 +183,9 @@ private:
 };
 
 
-void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
-void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
+// the arrays are allocated unless a buffer is given to write into
+void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo, byte *facing = NULL );
+void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo, byte *cullBits = NULL );
 void R_FreeInteractionCullInfo( srfCullInfo_t &cullInfo );
 
 void R_ShowInteractionMemory_f( const idCmdArgs &args );
@@ -0,0 +1,657 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "tr_local.h"
+
+/*
+
+  The .binter holds the map checksum and shadow settings it was built with,
+  followed by the cached interactions.  Each interaction has its light and
+  entity keys, the number of model surfaces and the shadow volumes of the
+  surfaces that have one.
+
+  All values are little endian.  A cache that can't be read is thrown away
+  and built again, it is never an error.
+
+*/
+
+/*
+================
+ReadCacheCount
+================
+*/
+static bool ReadCacheCount( idFile *f, int &count ) {
+	count = -1;
+	f->ReadInt( count );
+	return count >= 0;
+}
+
+/*
+================
+ReadCacheFloats
+================
+*/
+static bool ReadCacheFloats( idFile *f, float *values, int num ) {
+	if ( f->Read( values, num * sizeof( float ) ) != num * (int)sizeof( float ) ) {
+		return false;
+	}
+	LittleRevBytes( values, sizeof( float ), num );
+	return true;
+}
+
+/*
+================
+ReadCacheIndexes
+================
+*/
+static bool ReadCacheIndexes( idFile *f, glIndex_t *indexes, int num, int numVerts ) {
+	for ( int j = 0 ; j < num ; j++ ) {
+		int index = -1;
+		f->ReadInt( index );
+		if ( index < 0 || index >= numVerts ) {
+			return false;
+		}
+		indexes[j] = index;
+	}
+	return true;
+}
+
+/*
+================
+R_DuplicateShadowVolume
+================
+*/
+static srfTriangles_t *R_DuplicateShadowVolume( const srfTriangles_t *tri ) {
+	srfTriangles_t *newTri = R_AllocStaticTriSurf();
+
+	newTri->numVerts = tri->numVerts;
+	if ( tri->shadowVertexes ) {
+		R_AllocStaticTriSurfShadowVerts( newTri, tri->numVerts );
+		SIMDProcessor->Memcpy( newTri->shadowVertexes, tri->shadowVertexes, tri->numVerts * sizeof( tri->shadowVertexes[0] ) );
+	}
+
+	newTri->numIndexes = tri->numIndexes;
+	R_AllocStaticTriSurfIndexes( newTri, tri->numIndexes );
+	SIMDProcessor->Memcpy( newTri->indexes, tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+
+	newTri->numShadowIndexesNoCaps = tri->numShadowIndexesNoCaps;
+	newTri->numShadowIndexesNoFrontCaps = tri->numShadowIndexesNoFrontCaps;
+	newTri->shadowCapPlaneBits = tri->shadowCapPlaneBits;
+
+	// these have no effect, because they extend to infinity
+	newTri->bounds.Clear();
+
+	return newTri;
+}
+
+/*
+================
+idInteractionCache::idInteractionCache
+================
+*/
+idInteractionCache::idInteractionCache( void ) {
+	mapChecksum = 0;
+	settings = 0;
+	modified = false;
+}
+
+/*
+================
+idInteractionCache::~idInteractionCache
+================
+*/
+idInteractionCache::~idInteractionCache( void ) {
+	Clear();
+}
+
+/*
+================
+idInteractionCache::FreeInteraction
+================
+*/
+void idInteractionCache::FreeInteraction( cachedInteraction_t &cached ) {
+	if ( cached.shadowTris == NULL ) {
+		return;
+	}
+	for ( int i = 0 ; i < cached.numSurfaces ; i++ ) {
+		if ( cached.shadowTris[i] ) {
+			R_FreeStaticTriSurf( cached.shadowTris[i] );
+		}
+	}
+	R_StaticFree( cached.shadowTris );
+	cached.shadowTris = NULL;
+}
+
+/*
+================
+idInteractionCache::Clear
+================
+*/
+void idInteractionCache::Clear( void ) {
+	for ( int i = 0 ; i < interactions.Num() ; i++ ) {
+		FreeInteraction( interactions[i] );
+	}
+	interactions.Clear();
+	interactionHash.Free();
+
+	fileName.Clear();
+	modified = false;
+}
+
+/*
+================
+idInteractionCache::IsCacheable
+
+Only the interactions between lights and static models that
+have stayed where they were added can be cached
+================
+*/
+bool idInteractionCache::IsCacheable( const idRenderEntityLocal *entityDef, const idRenderLightLocal *lightDef, const idRenderModel *model ) {
+	if ( lightDef->lightHasMoved || entityDef->entityHasMoved ) {
+		return false;
+	}
+	if ( entityDef->parms.callback != NULL || model != entityDef->parms.hModel || model->IsDynamicModel() != DM_STATIC ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idInteractionCache::LightKey
+
+Checksum of everything that shapes the shadows of the light
+================
+*/
+unsigned int idInteractionCache::LightKey( const idRenderLightLocal *lightDef ) {
+	const renderLight_t &parms = lightDef->parms;
+	unsigned int crc;
+
+	CRC32_InitChecksum( crc );
+	CRC32_UpdateChecksum( crc, parms.axis.ToFloatPtr(), sizeof( parms.axis ) );
+	CRC32_UpdateChecksum( crc, parms.origin.ToFloatPtr(), sizeof( parms.origin ) );
+	CRC32_UpdateChecksum( crc, parms.lightCenter.ToFloatPtr(), sizeof( parms.lightCenter ) );
+	CRC32_UpdateChecksum( crc, parms.lightRadius.ToFloatPtr(), sizeof( parms.lightRadius ) );
+	CRC32_UpdateChecksum( crc, parms.target.ToFloatPtr(), sizeof( parms.target ) );
+	CRC32_UpdateChecksum( crc, parms.right.ToFloatPtr(), sizeof( parms.right ) );
+	CRC32_UpdateChecksum( crc, parms.up.ToFloatPtr(), sizeof( parms.up ) );
+	CRC32_UpdateChecksum( crc, parms.start.ToFloatPtr(), sizeof( parms.start ) );
+	CRC32_UpdateChecksum( crc, parms.end.ToFloatPtr(), sizeof( parms.end ) );
+
+	int flags = ( parms.pointLight ? 1 : 0 ) | ( parms.parallel ? 2 : 0 ) | ( parms.noShadows ? 4 : 0 );
+	CRC32_UpdateChecksum( crc, &flags, sizeof( flags ) );
+
+	const char *name = lightDef->lightShader->GetName();
+	CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+	if ( parms.prelightModel ) {
+		name = parms.prelightModel->Name();
+		CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+	}
+
+	CRC32_FinishChecksum( crc );
+
+	return crc;
+}
+
+/*
+================
+idInteractionCache::EntityKey
+
+Checksum of the entity placement and the model surfaces
+================
+*/
+unsigned int idInteractionCache::EntityKey( const idRenderEntityLocal *entityDef, const idRenderModel *model ) {
+	const renderEntity_t &parms = entityDef->parms;
+	unsigned int crc;
+
+	CRC32_InitChecksum( crc );
+
+	const char *name = model->Name();
+	CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+	int timeStamp = (int)model->Timestamp();
+	CRC32_UpdateChecksum( crc, &timeStamp, sizeof( timeStamp ) );
+
+	for ( int i = 0 ; i < model->NumSurfaces() ; i++ ) {
+		const modelSurface_t *surf = model->Surface( i );
+		int counts[2] = { 0, 0 };
+		if ( surf->geometry ) {
+			counts[0] = surf->geometry->numVerts;
+			counts[1] = surf->geometry->numIndexes;
+		}
+		CRC32_UpdateChecksum( crc, counts, sizeof( counts ) );
+		if ( surf->shader ) {
+			name = surf->shader->GetName();
+			CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+		}
+	}
+
+	CRC32_UpdateChecksum( crc, parms.origin.ToFloatPtr(), sizeof( parms.origin ) );
+	CRC32_UpdateChecksum( crc, parms.axis.ToFloatPtr(), sizeof( parms.axis ) );
+
+	if ( parms.customShader ) {
+		name = parms.customShader->GetName();
+		CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+	}
+	if ( parms.customSkin ) {
+		name = parms.customSkin->GetName();
+		CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+	}
+
+	int flags = ( parms.noShadow ? 1 : 0 ) | ( parms.noSelfShadow ? 2 : 0 ) | ( parms.suppressSurfaceInViewID ? 4 : 0 );
+	CRC32_UpdateChecksum( crc, &flags, sizeof( flags ) );
+
+	CRC32_FinishChecksum( crc );
+
+	return crc;
+}
+
+/*
+================
+idInteractionCache::WorldChecksum
+
+Checksum of the map geometry, which is the same whether it was read from the .proc or the .bproc
+================
+*/
+unsigned int idInteractionCache::WorldChecksum( const idList<idRenderModel *> &worldModels ) {
+	unsigned int crc;
+
+	CRC32_InitChecksum( crc );
+
+	for ( int i = 0 ; i < worldModels.Num() ; i++ ) {
+		const idRenderModel *model = worldModels[i];
+
+		const char *name = model->Name();
+		CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+
+		for ( int j = 0 ; j < model->NumSurfaces() ; j++ ) {
+			const srfTriangles_t *tri = model->Surface( j )->geometry;
+			if ( !tri ) {
+				continue;
+			}
+
+			name = model->Surface( j )->shader->GetName();
+			CRC32_UpdateChecksum( crc, name, idStr::Length( name ) + 1 );
+			CRC32_UpdateChecksum( crc, &tri->numVerts, sizeof( tri->numVerts ) );
+			CRC32_UpdateChecksum( crc, &tri->numIndexes, sizeof( tri->numIndexes ) );
+
+			if ( tri->verts ) {
+				for ( int k = 0 ; k < tri->numVerts ; k++ ) {
+					CRC32_UpdateChecksum( crc, tri->verts[k].xyz.ToFloatPtr(), sizeof( idVec3 ) );
+				}
+			} else if ( tri->shadowVertexes ) {
+				CRC32_UpdateChecksum( crc, tri->shadowVertexes, tri->numVerts * sizeof( tri->shadowVertexes[0] ) );
+			}
+			CRC32_UpdateChecksum( crc, tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+		}
+	}
+
+	CRC32_FinishChecksum( crc );
+
+	return crc;
+}
+
+/*
+================
+idInteractionCache::CurrentSettings
+================
+*/
+int idInteractionCache::CurrentSettings( void ) {
+	int bits = 0;
+
+	bits |= r_shadows.GetBool() ? 1 : 0;
+	bits |= r_useTurboShadow.GetBool() ? 2 : 0;
+	bits |= r_useShadowVertexProgram.GetBool() ? 4 : 0;
+	bits |= r_useShadowProjectedCull.GetBool() ? 8 : 0;
+	bits |= r_skipSuppress.GetBool() ? 16 : 0;
+	bits |= r_useOptimizedShadows.GetBool() ? 32 : 0;
+
+	return bits;
+}
+
+/*
+================
+idInteractionCache::Find
+================
+*/
+int idInteractionCache::Find( unsigned int lightKey, unsigned int entityKey ) const {
+	for ( int i = interactionHash.First( lightKey ^ entityKey ) ; i != -1 ; i = interactionHash.Next( i ) ) {
+		if ( interactions[i].lightKey == lightKey && interactions[i].entityKey == entityKey ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+idInteractionCache::Init
+================
+*/
+void idInteractionCache::Init( const char *mapName, const idList<idRenderModel *> &worldModels ) {
+	Clear();
+
+	if ( !r_interactionCache.GetBool() || !mapName || !mapName[0] ) {
+		return;
+	}
+
+	mapChecksum = WorldChecksum( worldModels );
+	settings = CurrentSettings();
+
+	fileName = mapName;
+	fileName.SetFileExtension( BINTER_FILE_EXT );
+
+	if ( !Read( fileName ) ) {
+		// start over, it will be written again when the map is freed
+		for ( int i = 0 ; i < interactions.Num() ; i++ ) {
+			FreeInteraction( interactions[i] );
+		}
+		interactions.Clear();
+		interactionHash.Free();
+	}
+}
+
+/*
+================
+idInteractionCache::Read
+
+Returns false if the cache is missing, out of date or broken
+================
+*/
+bool idInteractionCache::Read( const char *filename ) {
+	void *	buffer;
+	int		i, j, k;
+
+	int length = fileSystem->ReadFile( filename, &buffer, NULL );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	idFile_Memory f( filename, (const char *)buffer, length );
+
+	int ident = 0, version = 0, checksum = 0, fileSettings = 0;
+	f.ReadInt( ident );
+	f.ReadInt( version );
+	f.ReadInt( checksum );
+	f.ReadInt( fileSettings );
+	if ( ident != BINTER_FILE_ID || version != BINTER_FILE_VERSION || (unsigned int)checksum != mapChecksum || fileSettings != settings ) {
+		common->Printf( "idInteractionCache: %s is out of date, rebuilding\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	int numInteractions;
+	if ( !ReadCacheCount( &f, numInteractions ) || numInteractions > length ) {
+		common->Printf( "idInteractionCache: %s is broken, rebuilding\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	bool ok = true;
+
+	interactionHash.Clear( 1024, Max( numInteractions, 1024 ) );
+	interactions.Resize( numInteractions );
+
+	for ( i = 0 ; ok && i < numInteractions ; i++ ) {
+		cachedInteraction_t &cached = interactions.Alloc();
+		int lightKey = 0, entityKey = 0, numShadows = 0;
+
+		f.ReadInt( lightKey );
+		f.ReadInt( entityKey );
+		cached.lightKey = lightKey;
+		cached.entityKey = entityKey;
+		cached.shadowTris = NULL;
+		ok = ReadCacheCount( &f, cached.numSurfaces ) && ReadCacheCount( &f, numShadows );
+		ok = ok && cached.numSurfaces > 0 && cached.numSurfaces <= length && numShadows <= cached.numSurfaces;
+		if ( !ok ) {
+			cached.numSurfaces = 0;
+			break;
+		}
+
+		cached.shadowTris = (srfTriangles_t **)R_ClearedStaticAlloc( cached.numSurfaces * sizeof( cached.shadowTris[0] ) );
+
+		for ( j = 0 ; ok && j < numShadows ; j++ ) {
+			int surfaceNum, hasShadowVerts = 0;
+
+			ok = ReadCacheCount( &f, surfaceNum ) && surfaceNum < cached.numSurfaces && cached.shadowTris[surfaceNum] == NULL;
+			if ( !ok ) {
+				break;
+			}
+
+			srfTriangles_t *tri = R_AllocStaticTriSurf();
+			cached.shadowTris[surfaceNum] = tri;
+
+			ok = ReadCacheCount( &f, tri->numVerts ) && ReadCacheCount( &f, tri->numIndexes ) &&
+					ReadCacheCount( &f, tri->numShadowIndexesNoCaps ) && ReadCacheCount( &f, tri->numShadowIndexesNoFrontCaps ) &&
+					ReadCacheCount( &f, tri->shadowCapPlaneBits ) && ReadCacheCount( &f, hasShadowVerts );
+			// every vertex and index takes at least four bytes
+			ok = ok && tri->numVerts <= length && tri->numIndexes <= length;
+			ok = ok && tri->numShadowIndexesNoCaps <= tri->numShadowIndexesNoFrontCaps && tri->numShadowIndexesNoFrontCaps <= tri->numIndexes;
+			if ( !ok ) {
+				tri->numVerts = tri->numIndexes = 0;
+				break;
+			}
+
+			if ( hasShadowVerts ) {
+				R_AllocStaticTriSurfShadowVerts( tri, tri->numVerts );
+				for ( k = 0 ; ok && k < tri->numVerts ; k++ ) {
+					ok = ReadCacheFloats( &f, tri->shadowVertexes[k].xyz.ToFloatPtr(), 4 );
+				}
+			}
+
+			R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+			ok = ok && ReadCacheIndexes( &f, tri->indexes, tri->numIndexes, tri->numVerts );
+
+			tri->bounds.Clear();
+		}
+
+		interactionHash.Add( cached.lightKey ^ cached.entityKey, i );
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !ok ) {
+		common->Printf( "idInteractionCache: %s is broken, rebuilding\n", filename );
+		return false;
+	}
+
+	common->Printf( "idInteractionCache: %i cached interactions\n", interactions.Num() );
+
+	return true;
+}
+
+/*
+================
+idInteractionCache::Write
+================
+*/
+void idInteractionCache::Write( void ) {
+	int i, j, k;
+
+	if ( fileName.IsEmpty() || !modified ) {
+		return;
+	}
+
+	idFile_Memory f( fileName );
+
+	f.WriteInt( BINTER_FILE_ID );
+	f.WriteInt( BINTER_FILE_VERSION );
+	f.WriteInt( mapChecksum );
+	f.WriteInt( settings );
+	f.WriteInt( interactions.Num() );
+
+	for ( i = 0 ; i < interactions.Num() ; i++ ) {
+		const cachedInteraction_t &cached = interactions[i];
+
+		int numShadows = 0;
+		for ( j = 0 ; j < cached.numSurfaces ; j++ ) {
+			if ( cached.shadowTris[j] ) {
+				numShadows++;
+			}
+		}
+
+		f.WriteInt( cached.lightKey );
+		f.WriteInt( cached.entityKey );
+		f.WriteInt( cached.numSurfaces );
+		f.WriteInt( numShadows );
+
+		for ( j = 0 ; j < cached.numSurfaces ; j++ ) {
+			const srfTriangles_t *tri = cached.shadowTris[j];
+			if ( !tri ) {
+				continue;
+			}
+
+			f.WriteInt( j );
+			f.WriteInt( tri->numVerts );
+			f.WriteInt( tri->numIndexes );
+			f.WriteInt( tri->numShadowIndexesNoCaps );
+			f.WriteInt( tri->numShadowIndexesNoFrontCaps );
+			f.WriteInt( tri->shadowCapPlaneBits );
+			f.WriteInt( tri->shadowVertexes != NULL );
+			if ( tri->shadowVertexes ) {
+				for ( k = 0 ; k < tri->numVerts ; k++ ) {
+					f.WriteVec4( tri->shadowVertexes[k].xyz );
+				}
+			}
+			for ( k = 0 ; k < tri->numIndexes ; k++ ) {
+				f.WriteInt( tri->indexes[k] );
+			}
+		}
+	}
+
+	fileSystem->WriteFile( fileName, f.GetDataPtr(), f.Length(), "fs_devpath" );
+
+	common->Printf( "idInteractionCache: wrote %s with %i interactions\n", fileName.c_str(), interactions.Num() );
+
+	modified = false;
+}
+
+/*
+================
+idInteractionCache::FindInteraction
+================
+*/
+const cachedInteraction_t *idInteractionCache::FindInteraction( const idRenderEntityLocal *entityDef, const idRenderLightLocal *lightDef, const idRenderModel *model ) {
+	if ( fileName.IsEmpty() || interactions.Num() == 0 || !r_interactionCache.GetBool() ) {
+		return NULL;
+	}
+
+	// the shadow volumes depend on these
+	if ( settings != CurrentSettings() ) {
+		return NULL;
+	}
+
+	if ( !IsCacheable( entityDef, lightDef, model ) ) {
+		return NULL;
+	}
+
+	int index = Find( LightKey( lightDef ), EntityKey( entityDef, model ) );
+	if ( index == -1 || interactions[index].numSurfaces != model->NumSurfaces() ) {
+		return NULL;
+	}
+
+	tr.pc.c_cachedInteractions++;
+
+	return &interactions[index];
+}
+
+/*
+================
+idInteractionCache::CopyShadowVolume
+================
+*/
+srfTriangles_t *idInteractionCache::CopyShadowVolume( const cachedInteraction_t *cached, int surfaceNum ) const {
+	if ( cached->shadowTris[surfaceNum] == NULL ) {
+		return NULL;
+	}
+	return R_DuplicateShadowVolume( cached->shadowTris[surfaceNum] );
+}
+
+/*
+================
+idInteractionCache::StoreInteractions
+
+Called before the defs are freed
+================
+*/
+void idInteractionCache::StoreInteractions( const idList<idRenderLightLocal *> &lightDefs ) {
+	if ( fileName.IsEmpty() || !r_interactionCache.GetBool() || settings != CurrentSettings() ) {
+		return;
+	}
+
+	for ( int i = 0 ; i < lightDefs.Num() ; i++ ) {
+		const idRenderLightLocal *lightDef = lightDefs[i];
+		if ( !lightDef ) {
+			continue;
+		}
+
+		unsigned int lightKey = 0;
+
+		// all empty interactions are at the end of the list
+		for ( idInteraction *inter = lightDef->firstInteraction ; inter != NULL && !inter->IsEmpty() ; inter = inter->lightNext ) {
+			if ( inter->IsDeferred() || inter->shadowJobsPending ) {
+				continue;
+			}
+
+			// the cvars may have changed since the surfaces were created
+			if ( inter->shadowSettings != settings ) {
+				continue;
+			}
+
+			const idRenderModel *model = inter->entityDef->parms.hModel;
+			if ( model == NULL || !IsCacheable( inter->entityDef, lightDef, model ) || inter->numSurfaces != model->NumSurfaces() ) {
+				continue;
+			}
+
+			if ( lightKey == 0 ) {
+				lightKey = LightKey( lightDef );
+			}
+			unsigned int entityKey = EntityKey( inter->entityDef, model );
+			if ( Find( lightKey, entityKey ) != -1 ) {
+				continue;
+			}
+
+			cachedInteraction_t &cached = interactions.Alloc();
+			cached.lightKey = lightKey;
+			cached.entityKey = entityKey;
+			cached.numSurfaces = inter->numSurfaces;
+			cached.shadowTris = (srfTriangles_t **)R_ClearedStaticAlloc( cached.numSurfaces * sizeof( cached.shadowTris[0] ) );
+			for ( int j = 0 ; j < cached.numSurfaces ; j++ ) {
+				if ( inter->surfaces[j].shadowTris ) {
+					cached.shadowTris[j] = R_DuplicateShadowVolume( inter->surfaces[j].shadowTris );
+				}
+			}
+
+			interactionHash.Add( lightKey ^ entityKey, interactions.Num() - 1 );
+			modified = true;
+		}
+	}
+}
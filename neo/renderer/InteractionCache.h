@@ -0,0 +1,107 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __INTERACTIONCACHE_H__
+#define __INTERACTIONCACHE_H__
+
+/*
+===============================================================================
+
+	Interaction cache.
+
+	Keeps the shadow volumes of the interactions between lights and
+	entities that never move, so reloading the same map doesn't have to
+	generate them again.  The cache is stored in a .binter next to the
+	.proc, and is only used with the map geometry it was built from.
+
+	An interaction is looked up by a checksum of the light parms and one
+	of the entity parms and model, and only the shadow volumes are kept.
+	The rest of the interaction is cheap to create again.
+
+===============================================================================
+*/
+
+#define BINTER_FILE_EXT				"binter"
+#define BINTER_FILE_ID				( ( 'R' << 24 ) | ( 'T' << 16 ) | ( 'N' << 8 ) | 'B' )
+#define BINTER_FILE_VERSION			1
+
+typedef struct {
+	unsigned int			lightKey;
+	unsigned int			entityKey;
+	int						numSurfaces;
+	srfTriangles_t **		shadowTris;				// numSurfaces pointers, NULL if the surface has no shadow volume
+} cachedInteraction_t;
+
+class idInteractionCache {
+public:
+							idInteractionCache( void );
+							~idInteractionCache( void );
+
+	// frees all the cached shadow volumes
+	void					Clear( void );
+
+	// starts caching for a map, reading the existing cache if it was built from
+	// the same geometry and with the same shadow settings
+	void					Init( const char *mapName, const idList<idRenderModel *> &worldModels );
+
+	// writes the cache if any new interactions were stored
+	void					Write( void );
+
+	// returns the cached interaction for the light and entity, or NULL
+	const cachedInteraction_t *	FindInteraction( const idRenderEntityLocal *entityDef, const idRenderLightLocal *lightDef, const idRenderModel *model );
+
+	// returns a copy of a cached shadow volume, or NULL if the surface doesn't have one
+	srfTriangles_t *		CopyShadowVolume( const cachedInteraction_t *cached, int surfaceNum ) const;
+
+	// adds all the created interactions of the lights that aren't cached yet
+	void					StoreInteractions( const idList<idRenderLightLocal *> &lightDefs );
+
+	// the cvars that change which shadow volumes are generated and how
+	static int				CurrentSettings( void );
+
+private:
+	idStr					fileName;				// empty if the world doesn't have a map
+	unsigned int			mapChecksum;
+	int						settings;				// the cvars the shadow volumes were generated with
+	bool					modified;
+
+	idList<cachedInteraction_t>	interactions;
+	idHashIndex				interactionHash;
+
+	static bool				IsCacheable( const idRenderEntityLocal *entityDef, const idRenderLightLocal *lightDef, const idRenderModel *model );
+	static unsigned int		LightKey( const idRenderLightLocal *lightDef );
+	static unsigned int		EntityKey( const idRenderEntityLocal *entityDef, const idRenderModel *model );
+	static unsigned int		WorldChecksum( const idList<idRenderModel *> &worldModels );
+
+	int						Find( unsigned int lightKey, unsigned int entityKey ) const;
+	bool					Read( const char *filename );
+	void					FreeInteraction( cachedInteraction_t &cached );
+};
+
+#endif /* !__INTERACTIONCACHE_H__ */
@@ -130,6 +130,13 @@ int idRenderModelStatic::Memory() const {
 		totalBytes += R_TriSurfMemory( surf->geometry );
 	}
 
+	totalBytes += inactiveSurfaces.MemoryUsed();
+	for ( int j = 0 ; j < inactiveSurfaces.Num() ; j++ ) {
+		if ( inactiveSurfaces[j].geometry ) {
+			totalBytes += R_TriSurfMemory( inactiveSurfaces[j].geometry );
+		}
+	}
+
 	return totalBytes;
 }
 
@@ -2182,6 +2189,15 @@ void idRenderModelStatic::PurgeModel() {
 	}
 	surfaces.Clear();
 
+	for ( i = 0 ; i < inactiveSurfaces.Num() ; i++ ) {
+		surf = &inactiveSurfaces[i];
+
+		if ( surf->geometry ) {
+			R_FreeStaticTriSurf( surf->geometry );
+		}
+	}
+	inactiveSurfaces.Clear();
+
 	purged = true;
 }
 
@@ -2355,6 +2371,58 @@ bool idRenderModelStatic::DeleteSurfaceWithId( int id ) {
 			return true;
 		}
 	}
+	for ( i = 0; i < inactiveSurfaces.Num(); i++ ) {
+		if ( inactiveSurfaces[i].id == id ) {
+			R_FreeStaticTriSurf( inactiveSurfaces[i].geometry );
+			inactiveSurfaces.RemoveIndex( i );
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+=================
+idRenderModelStatic::DeactivateSurfaceWithId
+
+Moves the surface out of the drawn surfaces but keeps its geometry, so a dynamic
+model can bring it back without reallocating when it is selected again.
+=================
+*/
+bool idRenderModelStatic::DeactivateSurfaceWithId( int id ) {
+	int i;
+
+	for ( i = 0; i < surfaces.Num(); i++ ) {
+		if ( surfaces[i].id == id ) {
+			// the vertex cache may be restarted while the surface is inactive
+			if ( surfaces[i].geometry ) {
+				R_FreeStaticTriSurfVertexCaches( surfaces[i].geometry );
+			}
+			inactiveSurfaces.Append( surfaces[i] );
+			surfaces.RemoveIndex( i );
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+=================
+idRenderModelStatic::ReactivateSurfaceWithId
+
+Appends a surface deactivated by DeactivateSurfaceWithId to the drawn surfaces.
+=================
+*/
+bool idRenderModelStatic::ReactivateSurfaceWithId( int id, int &surfaceNum ) {
+	int i;
+
+	for ( i = 0; i < inactiveSurfaces.Num(); i++ ) {
+		if ( inactiveSurfaces[i].id == id ) {
+			surfaceNum = surfaces.Append( inactiveSurfaces[i] );
+			inactiveSurfaces.RemoveIndex( i );
+			return true;
+		}
+	}
 	return false;
 }
 
@@ -280,7 +280,9 @@ void idRenderModelOverlay::AddOverlaySurfacesToModel( idRenderModel *baseModel )
 			newSurf->id = -1 - k;
 		}
 
-		if ( newSurf->geometry == NULL || newSurf->geometry->numVerts < numVerts || newSurf->geometry->numIndexes < numIndexes ) {
+		// the render thread may still be drawing the previous frame from the old indexes,
+		// so the geometry is replaced and the old one goes through the deferred free
+		if ( newSurf->geometry == NULL || newSurf->geometry->numVerts < numVerts || newSurf->geometry->numIndexes < numIndexes || R_RenderThreadActive() ) {
 			R_FreeStaticTriSurf( newSurf->geometry );
 			newSurf->geometry = R_AllocStaticTriSurf();
 			R_AllocStaticTriSurfVerts( newSurf->geometry, numVerts );
@@ -107,9 +107,12 @@ public:
 	bool						DeleteSurfaceWithId( int id );
 	void						DeleteSurfacesWithNegativeId( void );
 	bool						FindSurfaceWithId( int id, int &surfaceNum );
+	bool						DeactivateSurfaceWithId( int id );
+	bool						ReactivateSurfaceWithId( int id, int &surfaceNum );
 
 public:
 	idList<modelSurface_t>		surfaces;
+	idList<modelSurface_t>		inactiveSurfaces;		// dynamic surfaces that are not drawn right now but kept for reuse
 	idBounds					bounds;
 	int							overlaysAdded;
 
@@ -167,7 +170,8 @@ public:
 	void						ParseMesh(idLexer& parser, int numJoints, const idJointMat* joints);
 	#endif
 
-	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf );
+	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf, idRenderModelStatic *staticModel );
+	void						DeformSurface( const struct renderEntity_s *ent, const idJointMat *joints, srfTriangles_t *tri, bool jobThread );
 	idBounds					CalcBounds( const idJointMat *joints );
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
@@ -218,6 +222,11 @@ public:
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
 	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
 
+								// while deforms are deferred, InstantiateDynamicModel only sets up the surfaces
+								// and the skinning is queued up for RunDeferredDeforms to run on the job threads
+	static void					BeginDeferredDeforms( void );
+	static void					RunDeferredDeforms( idParallelJobList *jobList );
+
 private:
 	idList<idMD5Joint>			joints;
 	idList<idJointQuat>			defaultPose;
@@ -571,13 +571,86 @@ void idMD5Mesh::TransformScaledVerts( idDrawVert *verts, const idJointMat *entJo
 	SIMDProcessor->TransformVerts( verts, texCoords.Num(), entJoints, scaledWeights, weightIndex, numWeights );
 }
 
+/*
+===============================================================================
+
+	Deferred deforms
+
+	While deforms are deferred UpdateSurface only sets up the triangle surfaces,
+	which takes the allocators, and queues the skinning of the vertexes.
+	RunDeferredDeforms then runs all the queued skinning on the job threads.
+
+===============================================================================
+*/
+
+typedef struct {
+	idMD5Mesh *					mesh;
+	const renderEntity_t *		ent;
+	srfTriangles_t *			tri;
+	idRenderModelStatic *		staticModel;
+} md5DeformJob_t;
+
+static bool						deferDeforms = false;
+static idList<md5DeformJob_t>	deformJobs;
+
+/*
+====================
+R_MD5DeformJob
+====================
+*/
+static void R_MD5DeformJob( void *data ) {
+	md5DeformJob_t *job = (md5DeformJob_t *)data;
+
+	job->mesh->DeformSurface( job->ent, job->ent->joints, job->tri, true );
+}
+
+/*
+====================
+idRenderModelMD5::BeginDeferredDeforms
+====================
+*/
+void idRenderModelMD5::BeginDeferredDeforms( void ) {
+	assert( !deferDeforms );
+	deferDeforms = true;
+	deformJobs.SetNum( 0, false );
+}
+
+/*
+====================
+idRenderModelMD5::RunDeferredDeforms
+====================
+*/
+void idRenderModelMD5::RunDeferredDeforms( idParallelJobList *jobList ) {
+	int i;
+
+	deferDeforms = false;
+
+	if ( deformJobs.Num() == 0 ) {
+		return;
+	}
+
+	for ( i = 0; i < deformJobs.Num(); i++ ) {
+		jobList->AddJob( R_MD5DeformJob, &deformJobs[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+
+	// add the surface bounds to the snapshots in the order the surfaces were queued
+	for ( i = 0; i < deformJobs.Num(); i++ ) {
+		deformJobs[i].staticModel->bounds.AddPoint( deformJobs[i].tri->bounds[0] );
+		deformJobs[i].staticModel->bounds.AddPoint( deformJobs[i].tri->bounds[1] );
+	}
+
+	deformJobs.SetNum( 0, false );
+}
+
 /*
 ====================
 idMD5Mesh::UpdateSurface
 ====================
 */
-void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
-	int i, base;
+void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf, idRenderModelStatic *staticModel ) {
+	int i;
 	srfTriangles_t *tri;
 
 	tr.pc.c_deformedSurfaces++;
@@ -626,6 +699,40 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 		}
 	}
 
+	if ( deferDeforms ) {
+		// the job threads can't allocate, so the face planes for the smoothed tangents are allocated here
+		if ( !r_useDeferredTangents.GetBool() && tri->dominantTris == NULL ) {
+			tr.pc.c_tangentIndexes += tri->numIndexes;
+			if ( !tri->facePlanes ) {
+				R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+			}
+		}
+
+		md5DeformJob_t &job = deformJobs.Alloc();
+		job.mesh = this;
+		job.ent = ent;
+		job.tri = tri;
+		job.staticModel = staticModel;
+		return;
+	}
+
+	DeformSurface( ent, entJoints, tri, false );
+
+	staticModel->bounds.AddPoint( tri->bounds[0] );
+	staticModel->bounds.AddPoint( tri->bounds[1] );
+}
+
+/*
+====================
+idMD5Mesh::DeformSurface
+
+Skins the vertexes of a surface set up by UpdateSurface.  On a job thread
+nothing may be allocated and the performance counters may not be touched.
+====================
+*/
+void idMD5Mesh::DeformSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, srfTriangles_t *tri, bool jobThread ) {
+	int i, base;
+
 	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
 		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
 	} else {
@@ -646,7 +753,13 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 	// has ambient drawing, or is culled, no additional work will be necessary
 	if ( !r_useDeferredTangents.GetBool() ) {
 		// set face planes, vertex normals, tangents
-		R_DeriveTangents( tri );
+		if ( !jobThread ) {
+			R_DeriveTangents( tri );
+		} else if ( tri->dominantTris != NULL ) {
+			R_DeriveUnsmoothedTangents( tri );
+		} else {
+			R_DeriveSmoothedTangents( tri );
+		}
 	}
 
 	#if MD5_ENABLE_GIBS > 0 // HINTS
@@ -1177,57 +1290,68 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		}
 	}
 
-	// create all the surfaces
+	// select the meshes up front so the skin, gib and LOD tests are done once per entity and view
+	// and nothing is deformed for meshes that won't be drawn
+	typedef enum {
+		MESH_DRAW,
+		MESH_DELETE,	// nodraw, skinned away or gibbed, the surface is freed
+		MESH_INACTIVE	// other LOD level, the surface is kept for when the range changes again
+	} meshSelect_t;
+
+	meshSelect_t *select = (meshSelect_t *)_alloca( meshes.Num() * sizeof( meshSelect_t ) );
+
+	#if MD5_ENABLE_LODS > 0
+	float lodRange = ( view ? ( ent->origin - view->renderView.vieworg ).LengthSqr() : 0.00f );
+	#if MD5_ENABLE_LODS > 1 // DEBUG
+	float lodSquare = r_lodRangeIncrements.GetFloat() * r_lodRangeIncrements.GetFloat();
+	lodRange = fminf(lodRange, lodSquare * r_lodLevelMaximum.GetFloat() * r_lodLevelMaximum.GetFloat());
+	lodRange = fmaxf(lodRange, lodSquare * r_lodLevelMinimum.GetFloat() * r_lodLevelMinimum.GetFloat());
+	#endif
+	#endif
+
 	for( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
+		select[i] = MESH_DELETE;
+
 		// avoid deforming the surface if it will be a nodraw due to a skin remapping
 		// FIXME: may have to still deform clipping hulls
 		#if MD5_ENABLE_GIBS > 0
 		const idMaterial* shader = R_RemapShaderBySkin(mesh->shader, ent->customSkin, ent->customShader);
 		if /*el*/ (shader == NULL) {
-			staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+			continue;
 		} else if (mesh->gibZones) {
 			if (gibParts == MD5_GIBBED_BITS && ent->gibbedZones < MD5_GIBBED_HEAD) { // We have a 'whole' mesh and no zones are gibbed (we may set gibbedZones|0x1 on death).
 				if /*el*/ (mesh->gibZones != MD5_GIBBED_BITS || mesh->gibShown != MD5_GIBBED_HIDE) {
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				} else if (shader->IsDrawn() != true && shader->SurfaceCastsShadow() != true) {
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				}
 			} else if (mesh->gibZones & ent->gibbedZones) { // A qualifying zone is gibbed.
 				if /*el*/ (mesh->gibShown == MD5_GIBBED_HIDE || (mesh->gibShown & ent->gibbedZones) > 1) { // Always hide or ancestor gibbed (we may set gibbedZones|0x1 on death).
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				} else if (mesh->gibZones == MD5_GIBBED_BITS && shader->IsDrawn() != true && shader->SurfaceCastsShadow() != true) { // Suppress nodraw (to use the gib skeleton).
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				}
 			} else { // No qualifying zones are gibbed.
 				if /*el*/ (mesh->gibShown != MD5_GIBBED_HIDE) {
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				} else if (shader->IsDrawn() != true && shader->SurfaceCastsShadow() != true) {
-					staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+					continue;
 				}
 			}
 		} else if (shader->IsDrawn() != true && shader->SurfaceCastsShadow() != true) {
-			staticModel->DeleteSurfaceWithId(i); mesh->surfaceNum = -1; continue;
+			continue;
 		}
 		#else
 		const idMaterial *shader = mesh->shader;
 		shader = R_RemapShaderBySkin(shader, ent->customSkin, ent->customShader);
 		if (!shader || (!shader->IsDrawn() && !shader->SurfaceCastsShadow())) {
-			staticModel->DeleteSurfaceWithId(i);
-			mesh->surfaceNum = -1;
 			continue;
 		}
 		#endif
 		#if MD5_ENABLE_LODS > 0
 		if (mesh->lodUpper > 0.00f) {
-			float lodRange = (view ? (ent->origin - view->renderView.vieworg).LengthSqr() : 0.00f);
-			#if MD5_ENABLE_LODS > 1 // DEBUG
-			float lodSquare = r_lodRangeIncrements.GetFloat() * r_lodRangeIncrements.GetFloat();
-			lodRange = fminf(lodRange, lodSquare * r_lodLevelMaximum.GetFloat() * r_lodLevelMaximum.GetFloat());
-			lodRange = fmaxf(lodRange, lodSquare * r_lodLevelMinimum.GetFloat() * r_lodLevelMinimum.GetFloat());
-			#endif
 			if (lodRange < mesh->lodLower || lodRange >= mesh->lodUpper) {
-				staticModel->DeleteSurfaceWithId(i);
-				mesh->surfaceNum = -1;
+				select[i] = MESH_INACTIVE;
 				continue;
 			}
 			#if MD5_ENABLE_LODS > 1 // DEBUG
@@ -1264,6 +1388,26 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		}
 		#endif
 
+		select[i] = MESH_DRAW;
+	}
+
+	// remove the surfaces that are not drawn before looking up the others, so their surface numbers stay valid
+	for( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
+		if ( select[i] == MESH_DELETE ) {
+			staticModel->DeleteSurfaceWithId( i );
+			mesh->surfaceNum = -1;
+		} else if ( select[i] == MESH_INACTIVE ) {
+			staticModel->DeactivateSurfaceWithId( i );
+			mesh->surfaceNum = -1;
+		}
+	}
+
+	// create or update the selected surfaces
+	for( mesh = meshes.Ptr(), i = 0; i < meshes.Num(); i++, mesh++ ) {
+		if ( select[i] != MESH_DRAW ) {
+			continue;
+		}
+
 		modelSurface_t *surf;
 
 		if ( staticModel->FindSurfaceWithId( i, surfaceNum ) ) {
@@ -1272,17 +1416,19 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		} else {
 			// Remove Overlays before adding new surfaces
 			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( staticModel );
-			mesh->surfaceNum = staticModel->NumSurfaces();
-			surf = &staticModel->surfaces.Alloc();
-			surf->geometry = NULL;
-			surf->shader = NULL;
-			surf->id = i;
+			if ( staticModel->ReactivateSurfaceWithId( i, surfaceNum ) ) {
+				mesh->surfaceNum = surfaceNum;
+				surf = &staticModel->surfaces[surfaceNum];
+			} else {
+				mesh->surfaceNum = staticModel->NumSurfaces();
+				surf = &staticModel->surfaces.Alloc();
+				surf->geometry = NULL;
+				surf->shader = NULL;
+				surf->id = i;
+			}
 		}
 
-		mesh->UpdateSurface( ent, ent->joints, surf );
-
-		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
-		staticModel->bounds.AddPoint( surf->geometry->bounds[1] );
+		mesh->UpdateSurface( ent, ent->joints, surf, staticModel );
 	}
 
 	return staticModel;
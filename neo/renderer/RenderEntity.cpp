@@ -39,6 +39,7 @@ idRenderEntityLocal::idRenderEntityLocal() {
 	index					= 0;
 	lastModifiedFrameNum	= 0;
 	archived				= false;
+	entityHasMoved			= false;
 	dynamicModel			= NULL;
 	dynamicModelFrameCount	= 0;
 	cachedDynamicModel		= NULL;
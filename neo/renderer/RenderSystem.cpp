@@ -93,8 +93,12 @@ static void R_PerformanceCounters( void ) {
 	}
 
 	if ( r_showInteractions.GetBool() ) {
-		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i\n",
-			tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes );
+		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i cachedInteractions:%i\n",
+			tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes, tr.pc.c_cachedInteractions );
+	}
+	if ( r_showShadowJobs.GetBool() ) {
+		common->Printf( "shadowJobs:%i flushes:%i shdwTris:%i msec:%.2f\n",
+			tr.pc.c_shadowJobs, tr.pc.c_shadowJobFlushes, tr.pc.c_shadowJobIndexes / 3, tr.pc.shadowJobMsec );
 	}
 	if ( r_showDefs.GetBool() ) {
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", tr.pc.c_visibleViewEntities,
@@ -119,6 +123,168 @@ static void R_PerformanceCounters( void ) {
 
 
 
+/*
+==============================================================================
+
+RENDER THREAD
+
+With r_smp the back end commands of a frame are executed by a separate thread
+while the main thread builds the next frame.  The OpenGL context belongs to
+the render thread while it is busy, so anything on the main thread that
+touches GL outside of the back end has to R_SyncRenderThread first.
+
+==============================================================================
+*/
+
+static xthreadInfo				renderThread;
+static bool						renderThreadActive;		// the thread is running
+static bool						renderThreadBusy;		// the thread owns the context and is executing a frame
+static bool						renderThreadShutdown;
+static const emptyCommand_t *	renderThreadCmds;
+static idStr					renderThreadError;
+
+/*
+====================
+R_RenderThread
+====================
+*/
+static int R_RenderThread( void *parms ) {
+	while ( true ) {
+		Sys_WaitForEvent( TRIGGER_EVENT_RENDER_ISSUE );
+		if ( renderThreadShutdown ) {
+			break;
+		}
+
+		GLimp_ActivateContext();
+
+		// errors are raised again on the main thread
+		try {
+			RB_ExecuteBackEndCommands( renderThreadCmds );
+		} catch ( idException &ex ) {
+			renderThreadError = ex.error;
+		}
+
+		GLimp_DeactivateContext();
+
+		Sys_TriggerEvent( TRIGGER_EVENT_RENDER_DONE );
+	}
+
+	return 0;
+}
+
+/*
+====================
+R_StartRenderThread
+
+Called after the OpenGL context and the vertex cache are up
+====================
+*/
+void R_StartRenderThread( void ) {
+	if ( renderThreadActive || !r_smp.GetBool() ) {
+		return;
+	}
+
+	renderThreadShutdown = false;
+	renderThreadBusy = false;
+	renderThreadError.Clear();
+
+	Sys_CreateThread( R_RenderThread, NULL, renderThread, "render" );
+	renderThreadActive = true;
+
+	// the front end can't touch buffer objects while the render thread owns the context
+	vertexCache.SetDeferredUploads( true );
+
+	common->Printf( "back end running on a separate render thread\n" );
+}
+
+/*
+====================
+R_ShutdownRenderThread
+====================
+*/
+void R_ShutdownRenderThread( void ) {
+	if ( !renderThreadActive ) {
+		return;
+	}
+
+	R_SyncRenderThread();
+
+	renderThreadShutdown = true;
+	Sys_TriggerEvent( TRIGGER_EVENT_RENDER_ISSUE );
+	Sys_DestroyThread( renderThread );
+	renderThreadActive = false;
+
+	vertexCache.SetDeferredUploads( false );
+}
+
+/*
+====================
+R_RenderThreadActive
+====================
+*/
+bool R_RenderThreadActive( void ) {
+	return renderThreadActive;
+}
+
+/*
+====================
+R_SyncRenderThread
+
+Waits for the render thread to finish the commands it was given and makes
+the context current on the main thread again.  Does nothing when called
+from any other thread, or when the render thread is idle.
+====================
+*/
+void R_SyncRenderThread( void ) {
+	if ( !renderThreadBusy || !Sys_IsMainThread() ) {
+		return;
+	}
+
+	double start = Sys_MillisecondsPrecise();
+
+	Sys_WaitForEvent( TRIGGER_EVENT_RENDER_DONE );
+	renderThreadBusy = false;
+
+	GLimp_ActivateContext();
+
+	if ( r_showSmp.GetBool() ) {
+		// B if the front end had to wait for the back end, F if the back end was already idle
+		common->Printf( "%c", ( Sys_MillisecondsPrecise() - start > 0.1 ) ? 'B' : 'F' );
+	}
+
+	if ( renderThreadError.Length() ) {
+		idStr error = renderThreadError;
+		renderThreadError.Clear();
+		common->Error( "%s", error.c_str() );
+	}
+}
+
+/*
+====================
+R_BackEndNeedsMainThread
+
+Some frames have to be executed on the main thread even with r_smp
+====================
+*/
+static bool R_BackEndNeedsMainThread( void ) {
+	// the screenshot code reads the frame back right after EndFrame
+	if ( tr.takingScreenshot ) {
+		return true;
+	}
+
+	// ImGui isn't thread safe and draws from the back end
+	if ( D3::ImGuiHooks::GetOpenWindowsMask() != 0 ) {
+		return true;
+	}
+
+	// several debug tools look at entity and light defs
+	if ( RB_DebugToolsNeedFrontEnd() ) {
+		return true;
+	}
+
+	return false;
+}
+
 /*
 ====================
 R_IssueRenderCommands
@@ -127,12 +293,18 @@ Called by R_EndFrame each frame
 ====================
 */
 static void R_IssueRenderCommands( void ) {
+	// the render thread must be done with the previous
+	// frame before we can execute anything here
+	R_SyncRenderThread();
+
 	if ( frameData->cmdHead->commandId == RC_NOP
 		&& !frameData->cmdHead->next ) {
 		// nothing to issue
 		return;
 	}
 
+	vertexCache.SubmitUploads();
+
 	// r_skipBackEnd allows the entire time of the back end
 	// to be removed from performance measurements, although
 	// nothing will be drawn to the screen.  If the prints
@@ -143,11 +315,101 @@ static void R_IssueRenderCommands( void ) {
 	// draw 2D graphics
 	if ( !r_skipBackEnd.GetBool() ) {
 		RB_ExecuteBackEndCommands( frameData->cmdHead );
+	} else {
+		vertexCache.FlushUploads();
 	}
 
 	R_ClearCommandChain();
 }
 
+/*
+====================
+R_LoadMaterialImages
+====================
+*/
+static void R_LoadMaterialImages( const idMaterial *material ) {
+	if ( !material ) {
+		return;
+	}
+	for ( int i = 0 ; i < material->GetNumStages() ; i++ ) {
+		const shaderStage_t *stage = material->GetStage( i );
+		if ( stage->newStage ) {
+			for ( int j = 0 ; j < stage->newStage->numFragmentProgramImages ; j++ ) {
+				if ( stage->newStage->fragmentProgramImages[j] ) {
+					stage->newStage->fragmentProgramImages[j]->LoadForBind();
+				}
+			}
+		} else if ( stage->texture.image ) {
+			stage->texture.image->LoadForBind();
+		}
+	}
+}
+
+/*
+====================
+R_LoadCommandImages
+
+The render thread can't load images, the file system and the decl manager
+aren't thread safe.  Everything the commands will bind is loaded here first.
+====================
+*/
+static void R_LoadCommandImages( const emptyCommand_t *cmds ) {
+	for ( ; cmds ; cmds = (const emptyCommand_t *)cmds->next ) {
+		if ( cmds->commandId != RC_DRAW_VIEW ) {
+			continue;
+		}
+		const viewDef_t *viewDef = ( (const drawSurfsCommand_t *)cmds )->viewDef;
+
+		for ( int i = 0 ; i < viewDef->numDrawSurfs ; i++ ) {
+			R_LoadMaterialImages( viewDef->drawSurfs[i]->material );
+		}
+
+		for ( const viewLight_t *vLight = viewDef->viewLights ; vLight ; vLight = vLight->next ) {
+			R_LoadMaterialImages( vLight->lightShader );
+			if ( vLight->falloffImage ) {
+				vLight->falloffImage->LoadForBind();
+			}
+
+			const drawSurf_t *lists[] = { vLight->localInteractions, vLight->globalInteractions, vLight->translucentInteractions };
+			for ( int i = 0 ; i < 3 ; i++ ) {
+				for ( const drawSurf_t *surf = lists[i] ; surf ; surf = surf->nextOnLight ) {
+					R_LoadMaterialImages( surf->material );
+				}
+			}
+		}
+	}
+
+	// the back end leaves the uploads of finished background loads to the main thread
+	globalImages->CompleteBackgroundImageLoads();
+}
+
+/*
+====================
+R_IssueRenderThreadCommands
+
+Hands the current command chain to the render thread and returns
+immediately.  The caller must switch to the other frameData
+before adding any more commands.
+====================
+*/
+static void R_IssueRenderThreadCommands( void ) {
+	if ( renderThreadBusy || r_skipBackEnd.GetBool()
+		|| ( frameData->cmdHead->commandId == RC_NOP && !frameData->cmdHead->next ) ) {
+		R_IssueRenderCommands();
+		return;
+	}
+
+	R_LoadCommandImages( frameData->cmdHead );
+
+	vertexCache.SubmitUploads();
+
+	renderThreadCmds = frameData->cmdHead;
+
+	GLimp_DeactivateContext();
+	renderThreadBusy = true;
+	Sys_TriggerEvent( TRIGGER_EVENT_RENDER_ISSUE );
+}
+
 /*
 ============
 R_GetCommandBuffer
@@ -197,6 +459,61 @@ static void R_ViewStatistics( viewDef_t *parms ) {
 	common->Printf( "view:%p surfs:%i\n", parms, parms->numDrawSurfs );
 }
 
+/*
+=============
+R_SnapshotTriSurf
+
+The front end may free and recreate the vertex caches of a surface, or
+reuse the surface for the next frame, while the render thread is still
+drawing it.  The back end gets a copy of the header in frame memory; the
+vertexes, indexes and caches it points to are only freed after the deferred
+frees have run, which is after the back end is done with them.  Geometry that
+is rewritten in place, like the overlays, must be reallocated instead while
+the render thread runs.
+=============
+*/
+static const srfTriangles_t *R_SnapshotTriSurf( const srfTriangles_t *tri ) {
+	if ( !tri ) {
+		return NULL;
+	}
+
+	srfTriangles_t *copy = (srfTriangles_t *)R_FrameAlloc( sizeof( *copy ) );
+	*copy = *tri;
+	return copy;
+}
+
+/*
+=============
+R_SnapshotDrawSurfChain
+=============
+*/
+static void R_SnapshotDrawSurfChain( const drawSurf_t *surfs ) {
+	for ( const drawSurf_t *surf = surfs ; surf ; surf = surf->nextOnLight ) {
+		// the chains are const for the back end, but they are ours until the command is issued
+		const_cast<drawSurf_t *>( surf )->geo = R_SnapshotTriSurf( surf->geo );
+	}
+}
+
+/*
+=============
+R_SnapshotViewGeometry
+=============
+*/
+static void R_SnapshotViewGeometry( viewDef_t *parms ) {
+	for ( int i = 0 ; i < parms->numDrawSurfs ; i++ ) {
+		parms->drawSurfs[i]->geo = R_SnapshotTriSurf( parms->drawSurfs[i]->geo );
+	}
+
+	for ( viewLight_t *vLight = parms->viewLights ; vLight ; vLight = vLight->next ) {
+		vLight->frustumTris = R_SnapshotTriSurf( vLight->frustumTris );
+		R_SnapshotDrawSurfChain( vLight->globalShadows );
+		R_SnapshotDrawSurfChain( vLight->localInteractions );
+		R_SnapshotDrawSurfChain( vLight->localShadows );
+		R_SnapshotDrawSurfChain( vLight->globalInteractions );
+		R_SnapshotDrawSurfChain( vLight->translucentInteractions );
+	}
+}
+
 /*
 =============
 R_AddDrawViewCmd
@@ -213,6 +530,10 @@ void	R_AddDrawViewCmd( viewDef_t *parms ) {
 
 	cmd->viewDef = parms;
 
+	if ( R_RenderThreadActive() ) {
+		R_SnapshotViewGeometry( parms );
+	}
+
 	tr.pc.c_numViews++;
 
 	R_ViewStatistics( parms );
@@ -645,6 +966,10 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 	guiModel->EmitFullScreen();
 	guiModel->Clear();
 
+	// wait for the render thread to finish the last frame, the counters
+	// and cvar checks below need the back end to be idle
+	R_SyncRenderThread();
+
 	// save out timing information
 	if ( frontEndMsec ) {
 		*frontEndMsec = pc.frontEndMsec;
@@ -667,7 +992,11 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 	cmd->commandId = RC_SWAP_BUFFERS;
 
 	// start the back end up again with the new command list
-	R_IssueRenderCommands();
+	if ( R_RenderThreadActive() && !R_BackEndNeedsMainThread() ) {
+		R_IssueRenderThreadCommands();
+	} else {
+		R_IssueRenderCommands();
+	}
 
 	// use the other buffers next frame, because another CPU
 	// may still be rendering into the current buffers
@@ -971,6 +1300,7 @@ bool idRenderSystemLocal::UploadImage( const char *imageName, const byte *data,
 	if ( !image ) {
 		return false;
 	}
+	R_SyncRenderThread();
 	image->UploadScratch( data, width, height );
 	image->SetImageFilterAndRepeat();
 	return true;
@@ -89,6 +89,9 @@ idCVar r_useCachedDynamicModels( "r_useCachedDynamicModels", "1", CVAR_RENDERER
 
 idCVar r_useVertexBuffers( "r_useVertexBuffers", "1", CVAR_RENDERER | CVAR_INTEGER, "use ARB_vertex_buffer_object for vertexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
 idCVar r_useIndexBuffers( "r_useIndexBuffers", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "use ARB_vertex_buffer_object for indexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
+idCVar r_smp( "r_smp", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "run the back end on a separate render thread, requires vid_restart" );
+idCVar r_parallelDynamicModels( "r_parallelDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "skin the MD5 models of a view on the job threads" );
+idCVar r_parallelShadows( "r_parallelShadows", "1", CVAR_RENDERER | CVAR_BOOL, "generate the dynamic shadow volumes of a view on the job threads" );
 
 idCVar r_useStateCaching( "r_useStateCaching", "1", CVAR_RENDERER | CVAR_BOOL, "avoid redundant state changes in GL_*() calls" );
 idCVar r_useInfiniteFarZ( "r_useInfiniteFarZ", "1", CVAR_RENDERER | CVAR_BOOL, "use the no-far-clip-plane trick" );
@@ -136,6 +139,7 @@ idCVar r_useLightCulling( "r_useLightCulling", "3", CVAR_RENDERER | CVAR_INTEGER
 idCVar r_useLightScissors( "r_useLightScissors", "1", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each light" );
 idCVar r_useClippedLightScissors( "r_useClippedLightScissors", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar r_useEntityCulling( "r_useEntityCulling", "1", CVAR_RENDERER | CVAR_BOOL, "0 = none, 1 = box" );
+idCVar r_useBatchCulling( "r_useBatchCulling", "1", CVAR_RENDERER | CVAR_BOOL, "cull the world bounds of all the entity and light refs of an area with one SIMD call before the exact tests" );
 idCVar r_useEntityScissors( "r_useEntityScissors", "0", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each entity" );
 idCVar r_useInteractionCulling( "r_useInteractionCulling", "1", CVAR_RENDERER | CVAR_BOOL, "1 = cull interactions" );
 idCVar r_useInteractionScissors( "r_useInteractionScissors", "2", CVAR_RENDERER | CVAR_INTEGER, "1 = use a custom scissor rectangle for each shadow interaction, 2 = also crop using portal scissors", -2, 2, idCmdSystem::ArgCompletion_Integer<-2,2> );
@@ -217,6 +221,7 @@ idCVar r_showNormals( "r_showNormals", "0", CVAR_RENDERER | CVAR_FLOAT, "draws w
 idCVar r_showMemory( "r_showMemory", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization" );
 idCVar r_showCull( "r_showCull", "0", CVAR_RENDERER | CVAR_BOOL, "report sphere and box culling stats" );
 idCVar r_showInteractions( "r_showInteractions", "0", CVAR_RENDERER | CVAR_BOOL, "report interaction generation activity" );
+idCVar r_showShadowJobs( "r_showShadowJobs", "0", CVAR_RENDERER | CVAR_BOOL, "report the shadow volumes generated on the job threads" );
 idCVar r_showDepth( "r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range" );
 idCVar r_showSurfaces( "r_showSurfaces", "0", CVAR_RENDERER | CVAR_BOOL, "report surface/light/shadow counts" );
 idCVar r_showPrimitives( "r_showPrimitives", "0", CVAR_RENDERER | CVAR_INTEGER, "report drawsurf/index/vertex counts" );
@@ -263,6 +268,9 @@ idCVar r_useSoftParticles( "r_useSoftParticles", "1", CVAR_RENDERER | CVAR_ARCHI
 
 idCVar r_glDebugContext( "r_glDebugContext", "0", CVAR_RENDERER | CVAR_BOOL, "Enable OpenGL Debug context - requires vid_restart, needs SDL2" );
 
+idCVar r_binaryProc( "r_binaryProc", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "load maps from the binary .bproc when it is up to date, and write it after parsing the text .proc" );
+idCVar r_interactionCache( "r_interactionCache", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "keep the shadow volumes of the interactions between static lights and entities in a .binter file next to the map" );
+
 // eez: This is a slight hack for letting us select the desired screenshot format in other functions
 //  This is a hack to avoid adding another function parameter to idRenderSystem::TakeScreenshot(),
 //  which would break the API of the dhewm3 SDK for mods.
@@ -792,6 +800,9 @@ void R_InitOpenGL( void ) {
 	// allocate the frame data, which may be more if smp is enabled
 	R_InitFrameData();
 
+	// everything the back end needs is up, r_smp moves it to its own thread
+	R_StartRenderThread();
+
 	// Reset our gamma
 	r_gammaInShader.ClearModified();
 	if ( r_gammaInShader.GetBool() ) {
@@ -1996,6 +2007,9 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 		return;
 	}
 
+	// even a partial restart needs the context back on the main thread
+	R_SyncRenderThread();
+
 	bool full = true;
 	bool forceWindow = false;
 	for ( int i = 1 ; i < args.Argc() ; i++ ) {
@@ -2052,6 +2066,9 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 	// this could take a while, so give them the cursor back ASAP
 	Sys_GrabMouseCursor( false );
 
+	// the render thread is started again with the new context, if r_smp is still set
+	R_ShutdownRenderThread();
+
 	// dump ambient caches
 	renderModelManager->FreeModelVertexCaches();
 
@@ -2249,6 +2266,7 @@ void idRenderSystemLocal::Clear( void ) {
 	guiRecursionLevel = 0;
 	guiModel = NULL;
 	demoGuiModel = NULL;
+	frontEndJobs = NULL;
 	takingScreenshot = false;
 }
 
@@ -2282,6 +2300,8 @@ void idRenderSystemLocal::Init( void ) {
 
 	R_InitTriSurfData();
 
+	frontEndJobs = Sys_AllocJobList( "frontEnd" );
+
 #ifdef ID_BUILD_FREETYPE
 	R_InitFreeType();
 #endif // ID_BUILD_FREETYPE
@@ -2316,6 +2336,8 @@ void idRenderSystemLocal::Shutdown( void ) {
 	R_DoneFreeType( );
 #endif // ID_BUILD_FREETYPE
 
+	R_ShutdownRenderThread();
+
 	if ( glConfig.isInitialized ) {
 		globalImages->PurgeAllImages();
 	}
@@ -2334,6 +2356,8 @@ void idRenderSystemLocal::Shutdown( void ) {
 
 	R_ShutdownTriSurfData();
 
+	Sys_FreeJobList( frontEndJobs );
+
 	RB_ShutdownDebugTools();
 
 	delete guiModel;
@@ -2350,6 +2374,9 @@ idRenderSystemLocal::BeginLevelLoad
 ========================
 */
 void idRenderSystemLocal::BeginLevelLoad( void ) {
+	// models and images are purged, and the deferred frees run
+	R_SyncRenderThread();
+
 	renderModelManager->BeginLevelLoad();
 	globalImages->BeginLevelLoad();
 }
@@ -2360,6 +2387,8 @@ idRenderSystemLocal::EndLevelLoad
 ========================
 */
 void idRenderSystemLocal::EndLevelLoad( void ) {
+	R_SyncRenderThread();
+
 	renderModelManager->EndLevelLoad();
 	globalImages->EndLevelLoad();
 	if ( r_forceLoadImages.GetBool() ) {
@@ -2395,6 +2424,8 @@ idRenderSystemLocal::ShutdownOpenGL
 */
 void idRenderSystemLocal::ShutdownOpenGL( void ) {
 
+	R_ShutdownRenderThread();
+
 	R_ShutdownFrameData();
 
 	// as the input is tied to the window, it should be shut down when the window
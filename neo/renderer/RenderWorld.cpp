@@ -253,6 +253,11 @@ void idRenderWorldLocal::UpdateEntityDef( qhandle_t entityHandle, const renderEn
 			}
 		}
 
+		// the cached interactions of the entity are no longer valid
+		if ( re->origin != def->parms.origin || re->axis != def->parms.axis || re->hModel != def->parms.hModel ) {
+			def->entityHasMoved = true;
+		}
+
 		// save any decals if the model is the same, allowing marks to move with entities
 		if ( def->parms.hModel == re->hModel ) {
 			R_FreeEntityDefDerivedData( def, true, true );
@@ -1423,6 +1428,99 @@ CREATE MODEL REFS
 =================================================================================
 */
 
+/*
+=================
+R_AddAreaCullBounds
+=================
+*/
+void R_AddAreaCullBounds( areaCullBounds_t *cull, areaReference_t *ref, const idBounds &bounds ) {
+	int i, j;
+
+	if ( cull->num >= cull->size ) {
+		// the bounds are six rows of size floats, so everything has to be moved over
+		int newSize = cull->size ? cull->size * 2 : 16;
+		areaReference_t **newRefs = (areaReference_t **)R_StaticAlloc( newSize * sizeof( newRefs[0] ) );
+		float *newBounds = (float *)R_StaticAlloc( newSize * 6 * sizeof( newBounds[0] ) );
+		byte *newCulled = (byte *)R_StaticAlloc( newSize * sizeof( newCulled[0] ) );
+
+		for ( i = 0; i < cull->num; i++ ) {
+			newRefs[i] = cull->refs[i];
+		}
+		for ( j = 0; j < 6; j++ ) {
+			for ( i = 0; i < cull->num; i++ ) {
+				newBounds[j * newSize + i] = cull->bounds[j * cull->size + i];
+			}
+		}
+
+		R_FreeAreaCullBounds( cull );
+		cull->refs = newRefs;
+		cull->bounds = newBounds;
+		cull->culled = newCulled;
+		cull->size = newSize;
+	}
+
+	i = cull->num++;
+	cull->refs[i] = ref;
+	for ( j = 0; j < 3; j++ ) {
+		cull->bounds[j * cull->size + i] = bounds[0][j];
+		cull->bounds[( j + 3 ) * cull->size + i] = bounds[1][j];
+	}
+	ref->cullIndex = i;
+}
+
+/*
+=================
+R_RemoveAreaCullBounds
+
+Moves the last bounds into the removed slot.
+=================
+*/
+void R_RemoveAreaCullBounds( areaCullBounds_t *cull, areaReference_t *ref ) {
+	int i = ref->cullIndex;
+	int last = --cull->num;
+
+	assert( i >= 0 && i <= last && cull->refs[i] == ref );
+
+	if ( i != last ) {
+		cull->refs[i] = cull->refs[last];
+		cull->refs[i]->cullIndex = i;
+		for ( int j = 0; j < 6; j++ ) {
+			cull->bounds[j * cull->size + i] = cull->bounds[j * cull->size + last];
+		}
+	}
+	ref->cullIndex = -1;
+}
+
+/*
+=================
+R_FreeAreaCullBounds
+=================
+*/
+void R_FreeAreaCullBounds( areaCullBounds_t *cull ) {
+	if ( cull->refs ) {
+		R_StaticFree( cull->refs );
+		R_StaticFree( cull->bounds );
+		R_StaticFree( cull->culled );
+	}
+	memset( cull, 0, sizeof( *cull ) );
+}
+
+/*
+=================
+R_CullAreaBounds
+
+Returns a byte for every bounds in the area, indexed by areaReference_t::cullIndex,
+that is set if the bounds are completely on the positive side of one of the planes.
+=================
+*/
+const byte *R_CullAreaBounds( areaCullBounds_t *cull, int numPlanes, const idPlane *planes ) {
+	if ( cull->num == 0 ) {
+		return NULL;
+	}
+	SIMDProcessor->CullBounds( cull->culled, planes, numPlanes, cull->bounds, cull->size, cull->num );
+	return cull->culled;
+}
+
 /*
 =================
 AddEntityRefToArea
@@ -1438,6 +1536,20 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal *def, portalAre
 		common->Error( "idRenderWorldLocal::AddEntityRefToArea: NULL def" );
 	}
 
+	// the first reference of the def gets the world bounds that all of them share
+	if ( def->entityRefs == NULL ) {
+		idVec3 v, transformed;
+
+		def->globalReferenceBounds.Clear();
+		for ( int i = 0; i < 8; i++ ) {
+			v[0] = def->referenceBounds[i&1][0];
+			v[1] = def->referenceBounds[(i>>1)&1][1];
+			v[2] = def->referenceBounds[(i>>2)&1][2];
+			R_LocalPointToGlobal( def->modelMatrix, v, transformed );
+			def->globalReferenceBounds.AddPoint( transformed );
+		}
+	}
+
 	ref = areaReferenceAllocator.Alloc();
 
 	tr.pc.c_entityReferences++;
@@ -1454,6 +1566,8 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal *def, portalAre
 	ref->areaPrev = area->entityRefs.areaPrev;
 	ref->areaNext->areaPrev = ref;
 	ref->areaPrev->areaNext = ref;
+
+	R_AddAreaCullBounds( &area->entityCull, ref, def->globalReferenceBounds );
 }
 
 /*
@@ -1478,6 +1592,8 @@ void idRenderWorldLocal::AddLightRefToArea( idRenderLightLocal *light, portalAre
 	lref->areaNext = area->lightRefs.areaNext;
 	lref->areaPrev = &area->lightRefs;
 	area->lightRefs.areaNext = lref;
+
+	R_AddAreaCullBounds( &area->lightCull, lref, light->frustumTris->bounds );
 }
 
 /*
@@ -40,6 +40,11 @@ If you have questions concerning this license or the applicable additional terms
 #define PROC_FILE_EXT				"proc"
 #define	PROC_FILE_ID				"mapProcFile003"
 
+// binary version of the .proc, written on demand, see RenderWorld_load.cpp
+#define BPROC_FILE_EXT				"bproc"
+#define BPROC_FILE_ID				( ( 'C' << 24 ) | ( 'R' << 16 ) | ( 'P' << 8 ) | 'B' )
+#define BPROC_FILE_VERSION			1
+
 // shader parms
 const int MAX_GLOBAL_SHADER_PARMS	= 12;
 
@@ -31,6 +31,128 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+/*
+
+  The .bproc is a binary copy of the .proc, so big maps can be loaded
+  with a single file read instead of lexing the text.  It holds the same
+  sections in the same order, with the values the text parser produced,
+  so both paths build the exact same world.  It is written whenever the
+  text has to be parsed, which dmap forces after writing a new .proc.
+
+  All values are little endian.
+
+*/
+
+typedef enum {
+	BPROC_END,
+	BPROC_MODEL,
+	BPROC_SHADOW_MODEL,
+	BPROC_INTER_AREA_PORTALS,
+	BPROC_NODES
+} bprocSection_t;
+
+/*
+================
+WriteBinarySurface
+================
+*/
+static void WriteBinarySurface( idFile *f, const char *material, const srfTriangles_t *tri ) {
+	int j;
+
+	f->WriteString( material );
+	f->WriteInt( tri->numVerts );
+	f->WriteInt( tri->numIndexes );
+	for ( j = 0 ; j < tri->numVerts ; j++ ) {
+		f->WriteVec3( tri->verts[j].xyz );
+		f->WriteVec2( tri->verts[j].st );
+		f->WriteVec3( tri->verts[j].normal );
+	}
+	for ( j = 0 ; j < tri->numIndexes ; j++ ) {
+		f->WriteInt( tri->indexes[j] );
+	}
+}
+
+/*
+================
+ReadBinaryCount
+
+A corrupt or truncated .bproc makes the readers return false, the
+text .proc is parsed instead.  A count can't be larger than the rest
+of the file.
+================
+*/
+static bool ReadBinaryCount( idFile *f, int &count ) {
+	count = -1;
+	if ( f->ReadInt( count ) != sizeof( count ) || count < 0 || count > f->Length() - f->Tell() ) {
+		common->Warning( "%s: bad count", f->GetName() );
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+ReadBinaryString
+================
+*/
+static bool ReadBinaryString( idFile *f, idStr &string ) {
+	int len;
+
+	if ( !ReadBinaryCount( f, len ) ) {
+		return false;
+	}
+	string.Fill( ' ', len );
+	f->Read( &string[0], len );
+	return true;
+}
+
+/*
+================
+ReadBinaryFloats
+================
+*/
+static bool ReadBinaryFloats( idFile *f, float *values, int num ) {
+	if ( f->Read( values, num * sizeof( float ) ) != num * (int)sizeof( float ) ) {
+		common->Warning( "%s: unexpected end of file", f->GetName() );
+		return false;
+	}
+	LittleRevBytes( values, sizeof( float ), num );
+	return true;
+}
+
+/*
+================
+ReadBinaryIndexes
+================
+*/
+static bool ReadBinaryIndexes( idFile *f, glIndex_t *indexes, int num, int numVerts ) {
+	int j;
+
+	if ( sizeof( glIndex_t ) == sizeof( int ) ) {
+		if ( f->Read( indexes, num * sizeof( int ) ) != num * (int)sizeof( int ) ) {
+			common->Warning( "%s: unexpected end of file", f->GetName() );
+			return false;
+		}
+		LittleRevBytes( indexes, sizeof( int ), num );
+	} else {
+		for ( j = 0 ; j < num ; j++ ) {
+			int index = 0;
+			if ( f->ReadInt( index ) != sizeof( index ) ) {
+				common->Warning( "%s: unexpected end of file", f->GetName() );
+				return false;
+			}
+			indexes[j] = index;
+		}
+	}
+
+	for ( j = 0 ; j < num ; j++ ) {
+		if ( (unsigned int)indexes[j] >= (unsigned int)numVerts ) {
+			common->Warning( "%s: bad index", f->GetName() );
+			return false;
+		}
+	}
+	return true;
+}
 
 /*
 ================
@@ -43,6 +165,9 @@ void idRenderWorldLocal::FreeWorld() {
 	// this will free all the lightDefs and entityDefs
 	FreeDefs();
 
+	interactionCache.Write();
+	interactionCache.Clear();
+
 	// free all the portals and check light/model references
 	for ( i = 0 ; i < numPortalAreas ; i++ ) {
 		portalArea_t	*area;
@@ -62,6 +187,9 @@ void idRenderWorldLocal::FreeWorld() {
 		if ( area->entityRefs.areaNext != &area->entityRefs ) {
 			common->Error( "FreeWorld: unexpected remaining entityRefs" );
 		}
+
+		R_FreeAreaCullBounds( &area->entityCull );
+		R_FreeAreaCullBounds( &area->lightCull );
 	}
 
 	if ( portalAreas ) {
@@ -115,7 +243,7 @@ void idRenderWorldLocal::TouchWorldModels( void ) {
 idRenderWorldLocal::ParseModel
 ================
 */
-idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
+idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src, idFile *binary ) {
 	idRenderModel	*model;
 	idToken			token;
 	int				i, j;
@@ -135,6 +263,12 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		src->Error( "R_ParseModel: bad numSurfaces" );
 	}
 
+	if ( binary ) {
+		binary->WriteInt( BPROC_MODEL );
+		binary->WriteString( token );
+		binary->WriteInt( numSurfaces );
+	}
+
 	for ( i = 0 ; i < numSurfaces ; i++ ) {
 		src->ExpectTokenString( "{" );
 
@@ -172,6 +306,10 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		}
 		src->ExpectTokenString( "}" );
 
+		if ( binary ) {
+			WriteBinarySurface( binary, surf.shader->GetName(), tri );
+		}
+
 		// add the completed surface to the model
 		model->AddSurface( surf );
 	}
@@ -188,7 +326,7 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 idRenderWorldLocal::ParseShadowModel
 ================
 */
-idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src ) {
+idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src, idFile *binary ) {
 	idRenderModel	*model;
 	idToken			token;
 	int				j;
@@ -233,6 +371,22 @@ idRenderModel *idRenderWorldLocal::ParseShadowModel( idLexer *src ) {
 		tri->indexes[j] = src->ParseInt();
 	}
 
+	if ( binary ) {
+		binary->WriteInt( BPROC_SHADOW_MODEL );
+		binary->WriteString( model->Name() );
+		binary->WriteInt( tri->numVerts );
+		binary->WriteInt( tri->numShadowIndexesNoCaps );
+		binary->WriteInt( tri->numShadowIndexesNoFrontCaps );
+		binary->WriteInt( tri->numIndexes );
+		binary->WriteInt( tri->shadowCapPlaneBits );
+		for ( j = 0 ; j < tri->numVerts ; j++ ) {
+			binary->WriteVec3( tri->shadowVertexes[j].xyz.ToVec3() );
+		}
+		for ( j = 0 ; j < tri->numIndexes ; j++ ) {
+			binary->WriteInt( tri->indexes[j] );
+		}
+	}
+
 	// add the completed surface to the model
 	model->AddSurface( surf );
 
@@ -264,40 +418,92 @@ void idRenderWorldLocal::SetupAreaRefs() {
 	}
 }
 
+/*
+================
+idRenderWorldLocal::AllocInterAreaPortals
+================
+*/
+void idRenderWorldLocal::AllocInterAreaPortals( int numAreas, int numPortals ) {
+	numPortalAreas = numAreas;
+	portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
+	areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
+
+	// set the doubly linked lists
+	SetupAreaRefs();
+
+	numInterAreaPortals = numPortals;
+	doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals *
+		sizeof( doublePortals [0] ) );
+}
+
+/*
+================
+idRenderWorldLocal::SetupInterAreaPortal
+
+Links the winding into a1 and its reverse into a2
+================
+*/
+void idRenderWorldLocal::SetupInterAreaPortal( int portalNum, idWinding *w, int a1, int a2 ) {
+	portal_t	*p;
+
+	// add the portal to a1
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a2;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w;
+	p->w->GetPlane( p->plane );
+
+	p->next = portalAreas[a1].portals;
+	portalAreas[a1].portals = p;
+
+	doublePortals[portalNum].portals[0] = p;
+
+	// reverse it for a2
+	p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
+	p->intoArea = a1;
+	p->doublePortal = &doublePortals[portalNum];
+	p->w = w->Reverse();
+	p->w->GetPlane( p->plane );
+
+	p->next = portalAreas[a2].portals;
+	portalAreas[a2].portals = p;
+
+	doublePortals[portalNum].portals[1] = p;
+}
+
 /*
 ================
 idRenderWorldLocal::ParseInterAreaPortals
 ================
 */
-void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
+void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src, idFile *binary ) {
 	int i, j;
 
 	src->ExpectTokenString( "{" );
 
-	numPortalAreas = src->ParseInt();
-	if ( numPortalAreas < 0 ) {
+	int numAreas = src->ParseInt();
+	if ( numAreas < 0 ) {
 		src->Error( "R_ParseInterAreaPortals: bad numPortalAreas" );
 		return;
 	}
-	portalAreas = (portalArea_t *)R_ClearedStaticAlloc( numPortalAreas * sizeof( portalAreas[0] ) );
-	areaScreenRect = (idScreenRect *) R_ClearedStaticAlloc( numPortalAreas * sizeof( idScreenRect ) );
 
-	// set the doubly linked lists
-	SetupAreaRefs();
-
-	numInterAreaPortals = src->ParseInt();
-	if ( numInterAreaPortals < 0 ) {
+	int numPortals = src->ParseInt();
+	if ( numPortals < 0 ) {
 		src->Error(  "R_ParseInterAreaPortals: bad numInterAreaPortals" );
 		return;
 	}
 
-	doublePortals = (doublePortal_t *)R_ClearedStaticAlloc( numInterAreaPortals *
-		sizeof( doublePortals [0] ) );
+	AllocInterAreaPortals( numAreas, numPortals );
+
+	if ( binary ) {
+		binary->WriteInt( BPROC_INTER_AREA_PORTALS );
+		binary->WriteInt( numAreas );
+		binary->WriteInt( numPortals );
+	}
 
 	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
 		int		numPoints, a1, a2;
 		idWinding	*w;
-		portal_t	*p;
 
 		numPoints = src->ParseInt();
 		a1 = src->ParseInt();
@@ -312,29 +518,16 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 			(*w)[j][4] = 0;
 		}
 
-		// add the portal to a1
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a2;
-		p->doublePortal = &doublePortals[i];
-		p->w = w;
-		p->w->GetPlane( p->plane );
-
-		p->next = portalAreas[a1].portals;
-		portalAreas[a1].portals = p;
-
-		doublePortals[i].portals[0] = p;
-
-		// reverse it for a2
-		p = (portal_t *)R_ClearedStaticAlloc( sizeof( *p ) );
-		p->intoArea = a1;
-		p->doublePortal = &doublePortals[i];
-		p->w = w->Reverse();
-		p->w->GetPlane( p->plane );
-
-		p->next = portalAreas[a2].portals;
-		portalAreas[a2].portals = p;
+		if ( binary ) {
+			binary->WriteInt( numPoints );
+			binary->WriteInt( a1 );
+			binary->WriteInt( a2 );
+			for ( j = 0 ; j < numPoints ; j++ ) {
+				binary->WriteVec3( (*w)[j].ToVec3() );
+			}
+		}
 
-		doublePortals[i].portals[1] = p;
+		SetupInterAreaPortal( i, w, a1, a2 );
 	}
 
 	src->ExpectTokenString( "}" );
@@ -345,7 +538,7 @@ void idRenderWorldLocal::ParseInterAreaPortals( idLexer *src ) {
 idRenderWorldLocal::ParseNodes
 ================
 */
-void idRenderWorldLocal::ParseNodes( idLexer *src ) {
+void idRenderWorldLocal::ParseNodes( idLexer *src, idFile *binary ) {
 	int			i;
 
 	src->ExpectTokenString( "{" );
@@ -356,6 +549,11 @@ void idRenderWorldLocal::ParseNodes( idLexer *src ) {
 	}
 	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
 
+	if ( binary ) {
+		binary->WriteInt( BPROC_NODES );
+		binary->WriteInt( numAreaNodes );
+	}
+
 	for ( i = 0 ; i < numAreaNodes ; i++ ) {
 		areaNode_t	*node;
 
@@ -364,11 +562,389 @@ void idRenderWorldLocal::ParseNodes( idLexer *src ) {
 		src->Parse1DMatrix( 4, node->plane.ToFloatPtr() );
 		node->children[0] = src->ParseInt();
 		node->children[1] = src->ParseInt();
+
+		if ( binary ) {
+			binary->WriteVec4( node->plane.ToVec4() );
+			binary->WriteInt( node->children[0] );
+			binary->WriteInt( node->children[1] );
+		}
 	}
 
 	src->ExpectTokenString( "}" );
 }
 
+/*
+================
+idRenderWorldLocal::ReadBinaryModel
+
+Returns NULL if the file is corrupt
+================
+*/
+idRenderModel *idRenderWorldLocal::ReadBinaryModel( idFile *f ) {
+	idRenderModel	*model;
+	idStr			name;
+	int				i, j, numSurfaces;
+	srfTriangles_t	*tri;
+	modelSurface_t	surf;
+
+	if ( !ReadBinaryString( f, name ) || !ReadBinaryCount( f, numSurfaces ) ) {
+		return NULL;
+	}
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( name );
+
+	for ( i = 0 ; i < numSurfaces ; i++ ) {
+		if ( !ReadBinaryString( f, name ) ) {
+			delete model;
+			return NULL;
+		}
+
+		surf.shader = declManager->FindMaterial( name );
+
+		((idMaterial*)surf.shader)->AddReference();
+
+		tri = R_AllocStaticTriSurf();
+		surf.geometry = tri;
+
+		// the surface is added to the model as soon as it is allocated, so deleting the model frees it
+		model->AddSurface( surf );
+
+		if ( !ReadBinaryCount( f, tri->numVerts ) || !ReadBinaryCount( f, tri->numIndexes ) ) {
+			delete model;
+			return NULL;
+		}
+
+		R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+		for ( j = 0 ; j < tri->numVerts ; j++ ) {
+			if ( !ReadBinaryFloats( f, tri->verts[j].xyz.ToFloatPtr(), 3 )
+				|| !ReadBinaryFloats( f, tri->verts[j].st.ToFloatPtr(), 2 )
+				|| !ReadBinaryFloats( f, tri->verts[j].normal.ToFloatPtr(), 3 ) ) {
+				delete model;
+				return NULL;
+			}
+		}
+
+		R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+		if ( !ReadBinaryIndexes( f, tri->indexes, tri->numIndexes, tri->numVerts ) ) {
+			delete model;
+			return NULL;
+		}
+	}
+
+	model->FinishSurfaces();
+
+	return model;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryShadowModel
+
+Returns NULL if the file is corrupt
+================
+*/
+idRenderModel *idRenderWorldLocal::ReadBinaryShadowModel( idFile *f ) {
+	idRenderModel	*model;
+	idStr			name;
+	int				j;
+	srfTriangles_t	*tri;
+	modelSurface_t	surf;
+
+	if ( !ReadBinaryString( f, name ) ) {
+		return NULL;
+	}
+
+	model = renderModelManager->AllocModel();
+	model->InitEmpty( name );
+
+	surf.shader = tr.defaultMaterial;
+
+	tri = R_AllocStaticTriSurf();
+	surf.geometry = tri;
+
+	// add the surface right away, so deleting the model frees it
+	model->AddSurface( surf );
+
+	if ( !ReadBinaryCount( f, tri->numVerts ) || !ReadBinaryCount( f, tri->numShadowIndexesNoCaps )
+		|| !ReadBinaryCount( f, tri->numShadowIndexesNoFrontCaps ) || !ReadBinaryCount( f, tri->numIndexes )
+		|| f->ReadInt( tri->shadowCapPlaneBits ) != sizeof( tri->shadowCapPlaneBits )
+		|| tri->numShadowIndexesNoCaps > tri->numIndexes || tri->numShadowIndexesNoFrontCaps > tri->numIndexes ) {
+		common->Warning( "%s: bad shadow model", f->GetName() );
+		delete model;
+		return NULL;
+	}
+
+	R_AllocStaticTriSurfShadowVerts( tri, tri->numVerts );
+	tri->bounds.Clear();
+	for ( j = 0 ; j < tri->numVerts ; j++ ) {
+		if ( !ReadBinaryFloats( f, tri->shadowVertexes[j].xyz.ToFloatPtr(), 3 ) ) {
+			delete model;
+			return NULL;
+		}
+		tri->shadowVertexes[j].xyz[3] = 1;		// no homogenous value
+
+		tri->bounds.AddPoint( tri->shadowVertexes[j].xyz.ToVec3() );
+	}
+
+	R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+	if ( !ReadBinaryIndexes( f, tri->indexes, tri->numIndexes, tri->numVerts ) ) {
+		delete model;
+		return NULL;
+	}
+
+	// like ParseShadowModel, no FinishSurfaces
+	return model;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryInterAreaPortals
+
+Returns false if the file is corrupt, FreeWorld releases what was read
+================
+*/
+bool idRenderWorldLocal::ReadBinaryInterAreaPortals( idFile *f ) {
+	int i, j, numAreas, numPortals;
+
+	if ( portalAreas || !ReadBinaryCount( f, numAreas ) || !ReadBinaryCount( f, numPortals ) ) {
+		return false;
+	}
+
+	AllocInterAreaPortals( numAreas, numPortals );
+
+	for ( i = 0 ; i < numInterAreaPortals ; i++ ) {
+		int		numPoints, a1 = 0, a2 = 0;
+		idWinding	*w;
+
+		if ( !ReadBinaryCount( f, numPoints ) ) {
+			return false;
+		}
+		f->ReadInt( a1 );
+		f->ReadInt( a2 );
+		if ( numPoints < 3 || a1 < 0 || a1 >= numPortalAreas || a2 < 0 || a2 >= numPortalAreas ) {
+			common->Warning( "%s: bad portal", f->GetName() );
+			return false;
+		}
+
+		w = new idWinding( numPoints );
+		w->SetNumPoints( numPoints );
+		for ( j = 0 ; j < numPoints ; j++ ) {
+			if ( !ReadBinaryFloats( f, (*w)[j].ToFloatPtr(), 3 ) ) {
+				delete w;
+				return false;
+			}
+			// no texture coordinates
+			(*w)[j][3] = 0;
+			(*w)[j][4] = 0;
+		}
+
+		SetupInterAreaPortal( i, w, a1, a2 );
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::ReadBinaryNodes
+
+Returns false if the file is corrupt, FreeWorld releases what was read
+================
+*/
+bool idRenderWorldLocal::ReadBinaryNodes( idFile *f ) {
+	int			i, j;
+
+	if ( areaNodes || !ReadBinaryCount( f, numAreaNodes ) || numAreaNodes == 0 ) {
+		return false;
+	}
+	areaNodes = (areaNode_t *)R_ClearedStaticAlloc( numAreaNodes * sizeof( areaNodes[0] ) );
+
+	for ( i = 0 ; i < numAreaNodes ; i++ ) {
+		areaNode_t	*node;
+
+		node = &areaNodes[i];
+
+		if ( !ReadBinaryFloats( f, node->plane.ToFloatPtr(), 4 ) ) {
+			return false;
+		}
+		for ( j = 0 ; j < 2 ; j++ ) {
+			// children are either later nodes or areas, so CommonChildrenArea_r can't loop
+			if ( f->ReadInt( node->children[j] ) != sizeof( node->children[j] )
+				|| ( node->children[j] > 0 && ( node->children[j] <= i || node->children[j] >= numAreaNodes ) ) ) {
+				common->Warning( "%s: bad node", f->GetName() );
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::ParseProcFile
+
+Optionally writes everything it parses to the binary file
+================
+*/
+bool idRenderWorldLocal::ParseProcFile( const char *filename, idFile *binary ) {
+	idLexer *		src;
+	idToken			token;
+	idRenderModel *	lastModel;
+
+	src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
+	if ( !src->IsLoaded() ) {
+		common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename );
+		delete src;
+		return false;
+	}
+
+	if ( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) ) {
+		common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
+		delete src;
+		return false;
+	}
+
+	// parse the file
+	while ( 1 ) {
+		if ( !src->ReadToken( &token ) ) {
+			break;
+		}
+
+		if ( token == "model" ) {
+			lastModel = ParseModel( src, binary );
+
+			// add it to the model manager list
+			renderModelManager->AddModel( lastModel );
+
+			// save it in the list to free when clearing this map
+			localModels.Append( lastModel );
+			continue;
+		}
+
+		if ( token == "shadowModel" ) {
+			lastModel = ParseShadowModel( src, binary );
+
+			// add it to the model manager list
+			renderModelManager->AddModel( lastModel );
+
+			// save it in the list to free when clearing this map
+			localModels.Append( lastModel );
+			continue;
+		}
+
+		if ( token == "interAreaPortals" ) {
+			ParseInterAreaPortals( src, binary );
+			continue;
+		}
+
+		if ( token == "nodes" ) {
+			ParseNodes( src, binary );
+			continue;
+		}
+
+		src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
+	}
+
+	delete src;
+
+	if ( binary ) {
+		binary->WriteInt( BPROC_END );
+	}
+
+	return true;
+}
+
+/*
+================
+idRenderWorldLocal::LoadBinaryProc
+
+Returns false if there is no usable .bproc, so the text has to be parsed.
+A corrupt file is freed again, the world is empty on failure.
+================
+*/
+bool idRenderWorldLocal::LoadBinaryProc( const char *filename, ID_TIME_T procTimeStamp ) {
+	void *			buffer;
+	ID_TIME_T		timeStamp;
+	idRenderModel *	lastModel;
+
+	int length = fileSystem->ReadFile( filename, &buffer, &timeStamp );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	// the text is the source, an older binary is stale
+	if ( procTimeStamp != FILE_NOT_FOUND_TIMESTAMP && procTimeStamp > timeStamp ) {
+		common->Printf( "idRenderWorldLocal::InitFromMap: %s is older than the .proc, rebuilding\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	idFile_Memory f( filename, (const char *)buffer, length );
+
+	int ident = 0, version = 0;
+	f.ReadInt( ident );
+	f.ReadInt( version );
+	if ( ident != BPROC_FILE_ID || version != BPROC_FILE_VERSION ) {
+		common->Printf( "idRenderWorldLocal::InitFromMap: %s has wrong version, rebuilding\n", filename );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	bool valid = true;
+	while ( valid ) {
+		int section = -1;
+		if ( f.ReadInt( section ) != sizeof( section ) ) {
+			common->Warning( "%s: unexpected end of file", filename );
+			valid = false;
+			break;
+		}
+
+		if ( section == BPROC_END ) {
+			break;
+		}
+
+		switch ( section ) {
+			case BPROC_MODEL:
+			case BPROC_SHADOW_MODEL:
+				lastModel = ( section == BPROC_MODEL ) ? ReadBinaryModel( &f ) : ReadBinaryShadowModel( &f );
+				if ( !lastModel ) {
+					valid = false;
+					break;
+				}
+
+				// add it to the model manager list
+				renderModelManager->AddModel( lastModel );
+
+				// save it in the list to free when clearing this map
+				localModels.Append( lastModel );
+				break;
+			case BPROC_INTER_AREA_PORTALS:
+				valid = ReadBinaryInterAreaPortals( &f );
+				break;
+			case BPROC_NODES:
+				valid = ReadBinaryNodes( &f );
+				break;
+			default:
+				common->Warning( "%s: bad section %d", filename, section );
+				valid = false;
+				break;
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !valid ) {
+		// throw away whatever was read, the text will be parsed from scratch
+		common->Printf( "idRenderWorldLocal::InitFromMap: %s is corrupt, rebuilding\n", filename );
+		FreeWorld();
+		return false;
+	}
+
+	return true;
+}
+
 /*
 ================
 idRenderWorldLocal::CommonChildrenArea_r
@@ -440,6 +1016,9 @@ void idRenderWorldLocal::FreeDefs() {
 
 	generateAllInteractionsCalled = false;
 
+	// keep the shadow volumes of the static interactions for the next load
+	interactionCache.StoreInteractions( lightDefs );
+
 	if ( interactionTable ) {
 		R_StaticFree( interactionTable );
 		interactionTable = NULL;
@@ -477,10 +1056,8 @@ is still useful for displaying a bare model
 =================
 */
 bool idRenderWorldLocal::InitFromMap( const char *name ) {
-	idLexer *		src;
-	idToken			token;
 	idStr			filename;
-	idRenderModel *	lastModel;
+	idStr			binaryName;
 
 	// if this is an empty world, initialize manually
 	if ( !name || !name[0] ) {
@@ -494,6 +1071,8 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	// load it
 	filename = name;
 	filename.SetFileExtension( PROC_FILE_EXT );
+	binaryName = name;
+	binaryName.SetFileExtension( BPROC_FILE_EXT );
 
 	// if we are reloading the same map, check the timestamp
 	// and try to skip all the work
@@ -504,6 +1083,7 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		if ( currentTimeStamp != FILE_NOT_FOUND_TIMESTAMP && currentTimeStamp == mapTimeStamp ) {
 			common->Printf( "idRenderWorldLocal::InitFromMap: retaining existing map\n" );
 			FreeDefs();
+			interactionCache.Write();
 			TouchWorldModels();
 			AddWorldModelEntities();
 			ClearPortalStates();
@@ -514,13 +1094,27 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	FreeWorld();
 
-	src = new idLexer( filename, LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
-	if ( !src->IsLoaded() ) {
-		common->Printf( "idRenderWorldLocal::InitFromMap: %s not found\n", filename.c_str() );
-		ClearWorld();
-		return false;
-	}
+	if ( !r_binaryProc.GetBool() || !LoadBinaryProc( binaryName, currentTimeStamp ) ) {
+		// parse the text, keeping a binary copy for the next load
+		idFile_Memory *binary = NULL;
+		if ( r_binaryProc.GetBool() ) {
+			binary = new idFile_Memory( binaryName );
+			binary->WriteInt( BPROC_FILE_ID );
+			binary->WriteInt( BPROC_FILE_VERSION );
+		}
 
+		if ( !ParseProcFile( filename, binary ) ) {
+			delete binary;
+			FreeWorld();
+			ClearWorld();
+			return false;
+		}
+
+		if ( binary ) {
+			fileSystem->WriteFile( binaryName, binary->GetDataPtr(), binary->Length(), "fs_devpath" );
+			delete binary;
+		}
+	}
 
 	mapName = name;
 	mapTimeStamp = currentTimeStamp;
@@ -530,55 +1124,6 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		WriteLoadMap();
 	}
 
-	if ( !src->ReadToken( &token ) || token.Icmp( PROC_FILE_ID ) ) {
-		common->Printf( "idRenderWorldLocal::InitFromMap: bad id '%s' instead of '%s'\n", token.c_str(), PROC_FILE_ID );
-		delete src;
-		return false;
-	}
-
-	// parse the file
-	while ( 1 ) {
-		if ( !src->ReadToken( &token ) ) {
-			break;
-		}
-
-		if ( token == "model" ) {
-			lastModel = ParseModel( src );
-
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
-
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
-		}
-
-		if ( token == "shadowModel" ) {
-			lastModel = ParseShadowModel( src );
-
-			// add it to the model manager list
-			renderModelManager->AddModel( lastModel );
-
-			// save it in the list to free when clearing this map
-			localModels.Append( lastModel );
-			continue;
-		}
-
-		if ( token == "interAreaPortals" ) {
-			ParseInterAreaPortals( src );
-			continue;
-		}
-
-		if ( token == "nodes" ) {
-			ParseNodes( src );
-			continue;
-		}
-
-		src->Error( "idRenderWorldLocal::InitFromMap: bad token \"%s\"", token.c_str() );
-	}
-
-	delete src;
-
 	// if it was a trivial map without any areas, create a single area
 	if ( !numPortalAreas ) {
 		ClearWorld();
@@ -587,6 +1132,9 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	// find the points where we can early-our of reference pushing into the BSP tree
 	CommonChildrenArea_r( &areaNodes[0] );
 
+	// the interactions are keyed on the map geometry, so the cache can't outlive a change to it
+	interactionCache.Init( name, localModels );
+
 	AddWorldModelEntities();
 	ClearPortalStates();
 
@@ -53,6 +53,22 @@ typedef struct doublePortal_s {
 } doublePortal_t;
 
 
+// the world space bounds of the entity or light references in an area, stored as
+// six arrays of size floats (mins x, y, z then maxs x, y, z) so all of them can be
+// culled against the portal planes with a single SIMD call before the exact tests
+typedef struct {
+	int				num;
+	int				size;			// always a multiple of 8
+	areaReference_t **	refs;		// refs[i]->cullIndex == i
+	float *			bounds;
+	byte *			culled;			// set by R_CullAreaBounds
+} areaCullBounds_t;
+
+void			R_AddAreaCullBounds( areaCullBounds_t *cull, areaReference_t *ref, const idBounds &bounds );
+void			R_RemoveAreaCullBounds( areaCullBounds_t *cull, areaReference_t *ref );
+void			R_FreeAreaCullBounds( areaCullBounds_t *cull );
+const byte *	R_CullAreaBounds( areaCullBounds_t *cull, int numPlanes, const idPlane *planes );
+
 typedef struct portalArea_s {
 	int				areaNum;
 	int				connectedAreaNum[NUM_PORTAL_ATTRIBUTES];	// if two areas have matching connectedAreaNum, they are
@@ -61,6 +77,8 @@ typedef struct portalArea_s {
 	portal_t *		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	areaCullBounds_t	entityCull;	// world bounds of the entityRefs
+	areaCullBounds_t	lightCull;	// world bounds of the lightRefs
 } portalArea_t;
 
 
@@ -169,14 +187,25 @@ public:
 
 	bool					generateAllInteractionsCalled;
 
+	// shadow volumes of the static interactions from earlier loads of the map
+	idInteractionCache		interactionCache;
+
 	//-----------------------
 	// RenderWorld_load.cpp
 
-	idRenderModel *			ParseModel( idLexer *src );
-	idRenderModel *			ParseShadowModel( idLexer *src );
+	idRenderModel *			ParseModel( idLexer *src, idFile *binary );
+	idRenderModel *			ParseShadowModel( idLexer *src, idFile *binary );
 	void					SetupAreaRefs();
-	void					ParseInterAreaPortals( idLexer *src );
-	void					ParseNodes( idLexer *src );
+	void					AllocInterAreaPortals( int numAreas, int numPortals );
+	void					SetupInterAreaPortal( int portalNum, idWinding *w, int a1, int a2 );
+	void					ParseInterAreaPortals( idLexer *src, idFile *binary );
+	void					ParseNodes( idLexer *src, idFile *binary );
+	bool					ParseProcFile( const char *filename, idFile *binary );
+	idRenderModel *			ReadBinaryModel( idFile *f );
+	idRenderModel *			ReadBinaryShadowModel( idFile *f );
+	bool					ReadBinaryInterAreaPortals( idFile *f );
+	bool					ReadBinaryNodes( idFile *f );
+	bool					LoadBinaryProc( const char *filename, ID_TIME_T procTimeStamp );
 	int						CommonChildrenArea_r( areaNode_t *node );
 	void					FreeWorld();
 	void					ClearWorld();
@@ -596,6 +596,12 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t *ps
 
 	area = &portalAreas[ areaNum ];
 
+	// cull the world bounds of all the refs at once, the survivors still get the exact test
+	const byte *culled = NULL;
+	if ( r_useBatchCulling.GetBool() && r_useEntityCulling.GetBool() && r_useCulling.GetInteger() >= 2 ) {
+		culled = R_CullAreaBounds( &area->entityCull, ps->numPortalPlanes, ps->portalPlanes );
+	}
+
 	for ( ref = area->entityRefs.areaNext ; ref != &area->entityRefs ; ref = ref->areaNext ) {
 		entity = ref->entity;
 
@@ -620,7 +626,7 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t *ps
 		}
 
 		// cull reference bounds
-		if ( CullEntityByPortals( entity, ps ) ) {
+		if ( ( culled && culled[ref->cullIndex] ) || CullEntityByPortals( entity, ps ) ) {
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
 			continue;
@@ -727,6 +733,12 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t *ps
 
 	area = &portalAreas[ areaNum ];
 
+	// the last stack plane is not used, as in CullLightByPortals
+	const byte *culled = NULL;
+	if ( r_useBatchCulling.GetBool() && r_useLightCulling.GetInteger() != 0 ) {
+		culled = R_CullAreaBounds( &area->lightCull, ps->numPortalPlanes - 1, ps->portalPlanes );
+	}
+
 	for ( lref = area->lightRefs.areaNext ; lref != &area->lightRefs ; lref = lref->areaNext ) {
 		light = lref->light;
 
@@ -744,7 +756,7 @@ void idRenderWorldLocal::AddAreaLightRefs( int areaNum, const portalStack_t *ps
 		}
 
 		// cull frustum
-		if ( CullLightByPortals( light, ps ) ) {
+		if ( ( culled && culled[lref->cullIndex] ) || CullLightByPortals( light, ps ) ) {
 			// we are culled out through this portal chain, but it might
 			// still be visible through others
 			continue;
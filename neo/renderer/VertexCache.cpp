@@ -171,8 +171,18 @@ void idVertexCache::Init() {
 	freeStaticHeaders.next = freeStaticHeaders.prev = &freeStaticHeaders;
 	staticHeaders.next = staticHeaders.prev = &staticHeaders;
 	freeDynamicHeaders.next = freeDynamicHeaders.prev = &freeDynamicHeaders;
-	dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
-	deferredFreeList.next = deferredFreeList.prev = &deferredFreeList;
+	for ( int i = 0 ; i < NUM_VERTEX_FRAMES ; i++ ) {
+		dynamicHeaders[i].next = dynamicHeaders[i].prev = &dynamicHeaders[i];
+		deferredFreeList[i].next = deferredFreeList[i].prev = &deferredFreeList[i];
+		tempStaging[i] = NULL;
+	}
+
+	deferUploads = false;
+	tempSubmitted = 0;
+	backEndTemp = NULL;
+	backEndTempStaging = NULL;
+	backEndTempStart = 0;
+	backEndTempEnd = 0;
 
 	// set up the dynamic frame memory
 	frameBytes = FRAME_MEMORY_BYTES;
@@ -202,6 +212,8 @@ the cached data isn't valid
 ===========
 */
 void idVertexCache::PurgeAll() {
+	R_SyncRenderThread();
+
 	while( staticHeaders.next != &staticHeaders ) {
 		ActuallyFree( staticHeaders.next );
 	}
@@ -243,7 +255,8 @@ void idVertexCache::Alloc( void *data, int size, vertCache_t **buffer, bool inde
 			block->next->prev = block;
 			block->prev->next = block;
 
-			if( !virtualMemory ) {
+			// with deferred uploads the back end generates the buffer on first use
+			if( !virtualMemory && !deferUploads ) {
 				glGenBuffersARB( 1, & block->vbo );
 			}
 		}
@@ -280,7 +293,17 @@ void idVertexCache::Alloc( void *data, int size, vertCache_t **buffer, bool inde
 	block->indexBuffer = indexBuffer;
 
 	// copy the data
-	if ( block->vbo ) {
+	if ( !virtualMemory && deferUploads ) {
+		vertUpload_t &upload = frontEndUploads.Alloc();
+		upload.block = block;
+		upload.data = Mem_Alloc( size );
+		upload.size = size;
+		upload.stream = allocatingTempBuffer;
+		SIMDProcessor->Memcpy( upload.data, data, size );
+	} else if ( !virtualMemory ) {
+		if ( !block->vbo ) {
+			glGenBuffersARB( 1, & block->vbo );
+		}
 		if ( indexBuffer ) {
 			glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, block->vbo );
 			glBufferDataARB( GL_ELEMENT_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, data, GL_STATIC_DRAW_ARB );
@@ -351,10 +374,10 @@ void idVertexCache::Free( vertCache_t *block ) {
 	block->next->prev = block->prev;
 	block->prev->next = block->next;
 
-	block->next = deferredFreeList.next;
-	block->prev = &deferredFreeList;
-	deferredFreeList.next->prev = block;
-	deferredFreeList.next = block;
+	block->next = deferredFreeList[listNum].next;
+	block->prev = &deferredFreeList[listNum];
+	deferredFreeList[listNum].next->prev = block;
+	deferredFreeList[listNum].next = block;
 }
 
 /*
@@ -400,8 +423,8 @@ vertCache_t	*idVertexCache::AllocFrameTemp( void *data, int size ) {
 	block = freeDynamicHeaders.next;
 	block->next->prev = block->prev;
 	block->prev->next = block->next;
-	block->next = dynamicHeaders.next;
-	block->prev = &dynamicHeaders;
+	block->next = dynamicHeaders[listNum].next;
+	block->prev = &dynamicHeaders[listNum];
 	block->next->prev = block;
 	block->prev->next = block;
 
@@ -418,7 +441,9 @@ vertCache_t	*idVertexCache::AllocFrameTemp( void *data, int size ) {
 	block->virtMem = tempBuffers[listNum]->virtMem;
 	block->vbo = tempBuffers[listNum]->vbo;
 
-	if ( block->vbo ) {
+	if ( block->vbo && deferUploads ) {
+		SIMDProcessor->Memcpy( tempStaging[listNum] + block->offset, data, size );
+	} else if ( block->vbo ) {
 		glBindBufferARB( GL_ARRAY_BUFFER_ARB, block->vbo );
 		glBufferSubDataARB( GL_ARRAY_BUFFER_ARB, block->offset, (GLsizeiptrARB)size, data );
 	} else {
@@ -463,9 +488,10 @@ void idVertexCache::EndFrame() {
 	}
 #endif
 
-	if( !virtualMemory ) {
+	if( !virtualMemory && !deferUploads ) {
 		// unbind vertex buffers so normal virtual memory will be used in case
 		// r_useVertexBuffers / r_useIndexBuffers
+		// with deferred uploads the back end does this in FlushUploads
 		glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
 	}
@@ -477,25 +503,121 @@ void idVertexCache::EndFrame() {
 	staticCountThisFrame = 0;
 	dynamicAllocThisFrame = 0;
 	dynamicCountThisFrame = 0;
+	tempSubmitted = 0;
 	tempOverflow = false;
 
+	// the frame that last used this list has been through the back end,
+	// which may have been running on the render thread until now
+
 	// free all the deferred free headers
-	while( deferredFreeList.next != &deferredFreeList ) {
-		ActuallyFree( deferredFreeList.next );
+	while( deferredFreeList[listNum].next != &deferredFreeList[listNum] ) {
+		ActuallyFree( deferredFreeList[listNum].next );
 	}
 
 	// free all the frame temp headers
-	vertCache_t	*block = dynamicHeaders.next;
-	if ( block != &dynamicHeaders ) {
+	vertCache_t	*block = dynamicHeaders[listNum].next;
+	if ( block != &dynamicHeaders[listNum] ) {
 		block->prev = &freeDynamicHeaders;
-		dynamicHeaders.prev->next = freeDynamicHeaders.next;
-		freeDynamicHeaders.next->prev = dynamicHeaders.prev;
+		dynamicHeaders[listNum].prev->next = freeDynamicHeaders.next;
+		freeDynamicHeaders.next->prev = dynamicHeaders[listNum].prev;
 		freeDynamicHeaders.next = block;
 
-		dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
+		dynamicHeaders[listNum].next = dynamicHeaders[listNum].prev = &dynamicHeaders[listNum];
 	}
 }
 
+/*
+===========
+idVertexCache::SetDeferredUploads
+===========
+*/
+void idVertexCache::SetDeferredUploads( bool enable ) {
+	// virtual memory copies never touch GL
+	if ( virtualMemory || enable == deferUploads ) {
+		return;
+	}
+
+	if ( enable ) {
+		for ( int i = 0 ; i < NUM_VERTEX_FRAMES ; i++ ) {
+			tempStaging[i] = (byte *)Mem_Alloc( frameBytes );
+		}
+		// what was allocated so far this frame already went to the buffer object
+		tempSubmitted = dynamicAllocThisFrame;
+		deferUploads = true;
+	} else {
+		// the render thread is gone, upload what is still queued on this thread
+		SubmitUploads();
+		FlushUploads();
+
+		for ( int i = 0 ; i < NUM_VERTEX_FRAMES ; i++ ) {
+			Mem_Free( tempStaging[i] );
+			tempStaging[i] = NULL;
+		}
+		deferUploads = false;
+	}
+}
+
+/*
+===========
+idVertexCache::SubmitUploads
+
+Hands the queued uploads and the frame temp data written since the
+last submit to the back end.  The back end must not be running.
+===========
+*/
+void idVertexCache::SubmitUploads() {
+	if ( !deferUploads ) {
+		return;
+	}
+
+	assert( backEndUploads.Num() == 0 );
+	backEndUploads.Swap( frontEndUploads );
+
+	backEndTemp = tempBuffers[listNum];
+	backEndTempStaging = tempStaging[listNum];
+	backEndTempStart = tempSubmitted;
+	backEndTempEnd = dynamicAllocThisFrame;
+	tempSubmitted = dynamicAllocThisFrame;
+}
+
+/*
+===========
+idVertexCache::FlushUploads
+===========
+*/
+void idVertexCache::FlushUploads() {
+	if ( virtualMemory ) {
+		return;
+	}
+
+	for ( int i = 0 ; i < backEndUploads.Num() ; i++ ) {
+		vertUpload_t &upload = backEndUploads[i];
+		vertCache_t *block = upload.block;
+
+		if ( !block->vbo ) {
+			glGenBuffersARB( 1, & block->vbo );
+		}
+		GLenum target = block->indexBuffer ? GL_ELEMENT_ARRAY_BUFFER_ARB : GL_ARRAY_BUFFER_ARB;
+		glBindBufferARB( target, block->vbo );
+		glBufferDataARB( target, (GLsizeiptrARB)upload.size, upload.data, upload.stream ? GL_STREAM_DRAW_ARB : GL_STATIC_DRAW_ARB );
+
+		Mem_Free( upload.data );
+	}
+	backEndUploads.SetNum( 0, false );
+
+	if ( backEndTempEnd > backEndTempStart ) {
+		glBindBufferARB( GL_ARRAY_BUFFER_ARB, backEndTemp->vbo );
+		glBufferSubDataARB( GL_ARRAY_BUFFER_ARB, backEndTempStart, (GLsizeiptrARB)( backEndTempEnd - backEndTempStart ),
+			backEndTempStaging + backEndTempStart );
+	}
+	backEndTempStart = backEndTempEnd = 0;
+
+	// unbind vertex buffers so normal virtual memory will be used in case
+	// r_useVertexBuffers / r_useIndexBuffers
+	glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
+	glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
+}
+
 /*
 =============
 idVertexCache::List
@@ -55,6 +55,14 @@ typedef struct vertCache_s {
 	int				frameUsed;			// it can't be purged if near the current frame
 } vertCache_t;
 
+// a buffer object upload the front end queued for the render thread
+typedef struct vertUpload_s {
+	vertCache_t *	block;
+	void *			data;				// Mem_Alloc'd copy, freed after the upload
+	int				size;
+	bool			stream;				// GL_STREAM_DRAW_ARB instead of GL_STATIC_DRAW_ARB
+} vertUpload_t;
+
 
 class idVertexCache {
 public:
@@ -107,6 +115,17 @@ public:
 	// listVertexCache calls this
 	void			List();
 
+	// With r_smp the front end can't issue GL while the render thread owns
+	// the context, so buffer object uploads are queued and the frame temp
+	// data goes to a staging copy until the back end flushes them.
+	void			SetDeferredUploads( bool enable );
+
+	// called on the main thread when a command list is handed to the back end
+	void			SubmitUploads();
+
+	// called by the back end before it draws anything
+	void			FlushUploads();
+
 private:
 	void			InitMemoryBlocks( int size );
 	void			ActuallyFree( vertCache_t *block );
@@ -136,12 +155,23 @@ private:
 
 	vertCache_t		freeStaticHeaders;		// head of doubly linked list
 	vertCache_t		freeDynamicHeaders;		// head of doubly linked list
-	vertCache_t		dynamicHeaders;			// head of doubly linked list
-	vertCache_t		deferredFreeList;		// head of doubly linked list
+	vertCache_t		dynamicHeaders[NUM_VERTEX_FRAMES];		// head of doubly linked list
+	vertCache_t		deferredFreeList[NUM_VERTEX_FRAMES];	// head of doubly linked list
 	vertCache_t		staticHeaders;			// head of doubly linked list in MRU order,
 											// staticHeaders.next is most recently used
 
 	int				frameBytes;				// for each of NUM_VERTEX_FRAMES frames
+
+	bool			deferUploads;
+	idList<vertUpload_t>	frontEndUploads;
+	idList<vertUpload_t>	backEndUploads;
+	byte *			tempStaging[NUM_VERTEX_FRAMES];	// copies of the tempBuffers when uploads are deferred
+	int				tempSubmitted;			// bytes of this frame's temp data already handed to the back end
+
+	vertCache_t *	backEndTemp;			// temp buffer range the back end uploads at the next flush
+	byte *			backEndTempStaging;
+	int				backEndTempStart;
+	int				backEndTempEnd;
 };
 
 extern	idVertexCache	vertexCache;
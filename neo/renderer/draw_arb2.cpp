@@ -498,6 +498,9 @@ void R_LoadARBProgram( int progIndex ) {
 	char	*buffer;
 	char	*start = NULL, *end;
 
+	// materials can load programs from the front end
+	R_SyncRenderThread();
+
 #if D3_INTEGRATE_SOFTPART_SHADERS
 	if ( progs[progIndex].ident == VPROG_SOFT_PARTICLE || progs[progIndex].ident == FPROG_SOFT_PARTICLE ) {
 		// these shaders are loaded directly from a string
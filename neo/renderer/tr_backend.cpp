@@ -654,8 +654,14 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 	// needed for editor rendering
 	RB_SetDefaultGLState();
 
-	// upload any image loads that have completed
-	globalImages->CompleteBackgroundImageLoads();
+	// upload the vertex cache data the front end queued for this frame
+	vertexCache.FlushUploads();
+
+	// upload any image loads that have completed, R_LoadCommandImages
+	// does it on the main thread when this runs on the render thread
+	if ( Sys_IsMainThread() ) {
+		globalImages->CompleteBackgroundImageLoads();
+	}
 
 	for ( ; cmds ; cmds = (const emptyCommand_t *)cmds->next ) {
 		switch ( cmds->commandId ) {
@@ -345,6 +345,7 @@ viewEntity_t *R_SetEntityDefViewEntity( idRenderEntityLocal *def ) {
 	// copy the model and weapon depth hack for back-end use
 	vModel->modelDepthHack = def->parms.modelDepthHack;
 	vModel->weaponDepthHack = def->parms.weaponDepthHack;
+	vModel->xrayIndex = def->parms.xrayIndex;
 
 	R_AxisToModelMatrix( def->parms.axis, def->parms.origin, vModel->modelMatrix );
 
@@ -418,6 +419,7 @@ viewLight_t *R_SetLightDefViewLight( idRenderLightLocal *light ) {
 	// add to the view light chain
 	vLight = (viewLight_t *)R_ClearedFrameAlloc( sizeof( *vLight ) );
 	vLight->lightDef = light;
+	vLight->noSpecular = light->parms.noSpecular;
 
 	// the scissorRect will be expanded as the light bounds is accepted into visible portal chains
 	vLight->scissorRect.Clear();
@@ -1037,6 +1039,38 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 	return update;
 }
 
+/*
+===================
+R_FinishEntityDefDynamicModel
+
+Adds the overlays to a freshly instantiated snapshot of a dynamic model
+===================
+*/
+void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( !def->cachedDynamicModel ) {
+		return;
+	}
+
+	// add any overlays to the snapshot of the dynamic model
+	if ( def->overlay && !r_skipOverlays.GetBool() ) {
+		def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+	} else {
+		idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+	}
+
+	if ( r_checkBounds.GetBool() ) {
+		idBounds b = def->cachedDynamicModel->Bounds();
+		if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+				b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+				b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+				b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+				b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+				b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+			common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+		}
+	}
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -1045,11 +1079,19 @@ Issues a deferred entity callback if necessary.
 If the model isn't dynamic, it returns the original.
 Returns the cached dynamic model if present, otherwise creates
 it and any necessary overlays
+
+If needsFinish is given the overlays of a new snapshot are left out and
+needsFinish is set, the caller has to call R_FinishEntityDefDynamicModel
+once the deferred deforms have run
 ===================
 */
-idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
+idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def, bool *needsFinish ) {
 	bool callbackUpdate;
 
+	if ( needsFinish ) {
+		*needsFinish = false;
+	}
+
 	// allow deferred entities to construct themselves
 	if ( def->parms.callback ) {
 		callbackUpdate = R_IssueEntityDefCallback( def );
@@ -1079,26 +1121,11 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 
 		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
 		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
-		if ( def->cachedDynamicModel ) {
 
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
-
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
+		if ( needsFinish ) {
+			*needsFinish = true;
+		} else {
+			R_FinishEntityDefDynamicModel( def );
 		}
 
 		def->dynamicModel = def->cachedDynamicModel;
@@ -1420,6 +1447,141 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+/*
+===================
+R_SkipViewEntity
+
+Entities that are left out of the current view
+===================
+*/
+static bool R_SkipViewEntity( const viewEntity_t *vEntity ) {
+	if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 1 ) {
+		return true;
+	} else if ( !tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 2 ) {
+		return true;
+	}
+
+	// Don't let particle entities re-instantiate their dynamic model during non-visible 
+	// views (in TDM, the light gem render) -- SteveL #3970
+	if ( tr.viewDef->renderView.viewID < 0
+		&& dynamic_cast<const idRenderModelPrt*>( vEntity->entityDef->parms.hModel ) != NULL ) // yuck.
+	{
+		return true;
+	}
+
+	return false;
+}
+
+/*
+===================
+R_InstantiateViewEntityModels
+
+Instantiates the dynamic models of all the visible entities before any surfaces
+are added, with the MD5 skinning deferred so it can run on the job threads for
+the whole view at once.  The entities that are only in the view for their shadows
+still get their models instantiated on demand by their interactions.
+
+The overlays are added right after the deforms, before any interaction can be
+created for the new snapshots.
+===================
+*/
+static void R_InstantiateViewEntityModels( void ) {
+	viewEntity_t		*vEntity;
+
+	idRenderModelMD5::BeginDeferredDeforms();
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		if ( vEntity->scissorRect.IsEmpty() || R_SkipViewEntity( vEntity ) ) {
+			continue;
+		}
+
+		const float oldFloatTime = tr.viewDef->floatTime;
+		const int oldTime = tr.viewDef->renderView.time;
+
+		game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+
+		if ( vEntity->entityDef->parms.timeGroup ) {
+			tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
+			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+		}
+
+		vEntity->instantiatedModel = R_EntityDefDynamicModel( vEntity->entityDef, &vEntity->finishDynamicModel );
+
+		tr.viewDef->floatTime = oldFloatTime;
+		tr.viewDef->renderView.time = oldTime;
+	}
+
+	idRenderModelMD5::RunDeferredDeforms( tr.frontEndJobs );
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		if ( vEntity->scissorRect.IsEmpty() || R_SkipViewEntity( vEntity ) ) {
+			continue;
+		}
+		if ( vEntity->finishDynamicModel ) {
+			R_FinishEntityDefDynamicModel( vEntity->entityDef );
+			vEntity->finishDynamicModel = false;
+		}
+	}
+}
+
+/*
+===================
+R_CreateViewInteractions
+
+Creates the interactions the view will need before any of them are added, with
+the dynamic shadow volumes queued up so they are generated on the job threads.
+This walks the entities and interactions in the same order as R_AddModelSurfaces,
+which then finds all the interactions already created.
+===================
+*/
+static void R_CreateViewInteractions( bool instantiateAhead ) {
+	viewEntity_t		*vEntity;
+	idInteraction		*inter, *next;
+	idScreenRect		shadowScissor;
+
+	R_BeginShadowJobs();
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		if ( R_SkipViewEntity( vEntity ) ) {
+			continue;
+		}
+		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex != 2 ) {
+			continue;
+		}
+
+		float oldFloatTime = tr.viewDef->floatTime;
+		int oldTime = tr.viewDef->renderView.time;
+
+		game->SelectTimeGroup( vEntity->entityDef->parms.timeGroup );
+
+		if ( vEntity->entityDef->parms.timeGroup ) {
+			tr.viewDef->floatTime = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup ) * 0.001;
+			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
+		}
+
+		// the visible entities without any surfaces don't get their interactions added
+		const idRenderModel *model = NULL;
+		if ( !vEntity->scissorRect.IsEmpty() ) {
+			model = instantiateAhead ? vEntity->instantiatedModel : R_EntityDefDynamicModel( vEntity->entityDef );
+		}
+
+		if ( vEntity->scissorRect.IsEmpty() || ( model != NULL && model->NumSurfaces() > 0 ) ) {
+			for ( inter = vEntity->entityDef->firstInteraction; inter != NULL && !inter->IsEmpty(); inter = next ) {
+				next = inter->entityNext;
+				if ( inter->lightDef->viewCount != tr.viewCount ) {
+					continue;
+				}
+				inter->PrepareActiveInteraction( shadowScissor );
+			}
+		}
+
+		tr.viewDef->floatTime = oldFloatTime;
+		tr.viewDef->renderView.time = oldTime;
+	}
+
+	R_EndShadowJobs();
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1440,11 +1602,8 @@ void R_AddModelSurfaces( void ) {
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
-	// go through each entity that is either visible to the view, or to
-	// any light that intersects the view (for shadows)
-	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
-
-		if ( r_useEntityScissors.GetBool() ) {
+	if ( r_useEntityScissors.GetBool() ) {
+		for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 			// calculate the screen area covered by the entity
 			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
 			// intersect with the portal crossing scissor rectangle
@@ -1454,6 +1613,20 @@ void R_AddModelSurfaces( void ) {
 				R_ShowColoredScreenRect( vEntity->scissorRect, vEntity->entityDef->index );
 			}
 		}
+	}
+
+	const bool instantiateAhead = r_parallelDynamicModels.GetBool() && Sys_NumJobThreads() > 0;
+	if ( instantiateAhead ) {
+		R_InstantiateViewEntityModels();
+	}
+
+	if ( r_parallelShadows.GetBool() && Sys_NumJobThreads() > 0 ) {
+		R_CreateViewInteractions( instantiateAhead );
+	}
+
+	// go through each entity that is either visible to the view, or to
+	// any light that intersects the view (for shadows)
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 
 		float oldFloatTime = 0.0f;
 		int oldTime = 0;
@@ -1468,31 +1641,21 @@ void R_AddModelSurfaces( void ) {
 			tr.viewDef->renderView.time = game->GetTimeGroupTime( vEntity->entityDef->parms.timeGroup );
 		}
 
-		if ( tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 1 ) {
+		if ( R_SkipViewEntity( vEntity ) ) {
 			if ( vEntity->entityDef->parms.timeGroup ) {
 				tr.viewDef->floatTime = oldFloatTime;
 				tr.viewDef->renderView.time = oldTime;
 			}
 			continue;
-		} else if ( !tr.viewDef->isXraySubview && vEntity->entityDef->parms.xrayIndex == 2 ) {
-			if ( vEntity->entityDef->parms.timeGroup ) {
-				tr.viewDef->floatTime = oldFloatTime;
-				tr.viewDef->renderView.time = oldTime;
-			}
-			continue;
-		}
-
-		// Don't let particle entities re-instantiate their dynamic model during non-visible 
-		// views (in TDM, the light gem render) -- SteveL #3970
-		if ( tr.viewDef->renderView.viewID < 0
-			&& dynamic_cast<const idRenderModelPrt*>( vEntity->entityDef->parms.hModel ) != NULL ) // yuck.
-		{
-			continue;
 		}
 
 		// add the ambient surface if it has a visible rectangle
 		if ( !vEntity->scissorRect.IsEmpty() ) {
-			model = R_EntityDefDynamicModel( vEntity->entityDef );
+			if ( instantiateAhead ) {
+				model = vEntity->instantiatedModel;
+			} else {
+				model = R_EntityDefDynamicModel( vEntity->entityDef );
+			}
 			if ( model == NULL || model->NumSurfaces() <= 0 ) {
 				if ( vEntity->entityDef->parms.timeGroup ) {
 					tr.viewDef->floatTime = oldFloatTime;
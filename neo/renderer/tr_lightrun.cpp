@@ -612,6 +612,7 @@ void R_FreeLightDefDerivedData( idRenderLightLocal *ldef ) {
 		// unlink from the area
 		lref->areaNext->areaPrev = lref->areaPrev;
 		lref->areaPrev->areaNext = lref->areaNext;
+		R_RemoveAreaCullBounds( &lref->area->lightCull, lref );
 
 		// put it back on the free list for reuse
 		ldef->world->areaReferenceAllocator.Free( lref );
@@ -679,6 +680,7 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal *def, bool keepDecals, bool
 		// unlink from the area
 		ref->areaNext->areaPrev = ref->areaPrev;
 		ref->areaPrev->areaNext = ref->areaNext;
+		R_RemoveAreaCullBounds( &ref->area->entityCull, ref );
 
 		// put it back on the free list for reuse
 		def->world->areaReferenceAllocator.Free( ref );
@@ -37,7 +37,7 @@ class idRenderWorldLocal;
 // everything that is needed by the backend needs
 // to be double buffered to allow it to run in
 // parallel on a dual cpu machine
-const int SMP_FRAMES = 1;
+const int SMP_FRAMES = 2;
 
 const int FALLOFF_TEXTURE_SIZE =	64;
 
@@ -102,6 +102,7 @@ SURFACES
 #include "ModelDecal.h"
 #include "ModelOverlay.h"
 #include "Interaction.h"
+#include "InteractionCache.h"
 
 
 // drawSurf_t structures command the back end to render surfaces
@@ -153,6 +154,7 @@ typedef struct areaReference_s {
 	idRenderEntityLocal *	entity;					// only one of entity / light will be non-NULL
 	idRenderLightLocal *	light;					// only one of entity / light will be non-NULL
 	struct portalArea_s	*	area;					// so owners can find all the areas they are in
+	int						cullIndex;				// in area->entityCull or area->lightCull
 } areaReference_t;
 
 
@@ -268,12 +270,16 @@ public:
 													// in the cached memory
 	bool					archived;				// for demo writing
 
+	bool					entityHasMoved;			// the origin, axis or model has changed since it was
+													// first added, so the interaction cache is not valid
+
 	idRenderModel *			dynamicModel;			// if parms.model->IsDynamicModel(), this is the generated data
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 													// dynamicModel if this doesn't == tr.viewCount
 	idRenderModel *			cachedDynamicModel;
 
 	idBounds				referenceBounds;		// the local bounds used to place entityRefs, either from parms or a model
+	idBounds				globalReferenceBounds;	// world space bounds of referenceBounds, set when the entityRefs are created
 
 	// a viewEntity_t is created whenever a idRenderEntityLocal is considered for inclusion
 	// in a given view, even if it turns out to not be visible
@@ -334,6 +340,7 @@ typedef struct viewLight_s {
 	const idMaterial *		lightShader;				// light shader used by backend
 	const float	*			shaderRegisters;			// shader registers used by backend
 	idImage *				falloffImage;				// falloff image used by backend
+	bool					noSpecular;					// copied from lightDef->parms for the backend
 
 	const struct drawSurf_s	*globalShadows;				// shadow everything
 	const struct drawSurf_s	*localInteractions;			// don't get local shadows
@@ -365,6 +372,12 @@ typedef struct viewEntity_s {
 	bool				weaponDepthHack;
 	float				modelDepthHack;
 
+	int					xrayIndex;				// copied from entityDef->parms for the backend
+
+	// front end only, set when R_AddModelSurfaces instantiates the models ahead of adding the surfaces
+	idRenderModel *		instantiatedModel;
+	bool				finishDynamicModel;		// overlays and bounds check wait for the deferred deforms
+
 	float				modelMatrix[16];		// local coords to global coords
 	float				modelViewMatrix[16];	// local coords to eye coords
 } viewEntity_t;
@@ -529,8 +542,8 @@ typedef struct frameMemoryBlock_s {
 
 // all of the information needed by the back end must be
 // contained in a frameData_t.  This entire structure is
-// duplicated so the front and back end can run in parallel
-// on an SMP machine (OBSOLETE: this capability has been removed)
+// duplicated SMP_FRAMES times so the front and back end can
+// run in parallel when r_smp is enabled
 typedef struct {
 	// one or more blocks of memory for all frame
 	// temporary allocations
@@ -557,6 +570,20 @@ extern	frameData_t	*frameData;
 void R_ClearCommandChain( void );
 void R_AddDrawViewCmd( viewDef_t *parms );
 
+// the render thread executes the back end commands of one frame while the
+// front end builds the next one, it only runs when r_smp is set
+const int TRIGGER_EVENT_RENDER_ISSUE = TRIGGER_EVENT_ONE;
+const int TRIGGER_EVENT_RENDER_DONE = TRIGGER_EVENT_TWO;
+
+void R_StartRenderThread( void );
+void R_ShutdownRenderThread( void );
+bool R_RenderThreadActive( void );
+
+// anything on the main thread that issues OpenGL calls outside of the back
+// end must call this first, it waits for the render thread to finish the
+// frame it is working on and takes the context back
+void R_SyncRenderThread( void );
+
 void R_ReloadGuis_f( const idCmdArgs &args );
 void R_ListGuis_f( const idCmdArgs &args );
 
@@ -585,6 +612,7 @@ typedef struct {
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createLightTris;
 	int		c_createShadowVolumes;
+	int		c_cachedInteractions;	// interactions with the shadow volumes from the interaction cache
 	int		c_generateMd5;
 	int		c_entityDefCallbacks;
 	int		c_alloc, c_free;	// counts for R_StaticAllc/R_StaticFree
@@ -598,6 +626,10 @@ typedef struct {
 	int		c_tangentIndexes;	// R_DeriveTangents()
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs;
+	int		c_shadowJobs;		// R_QueueShadowVolume
+	int		c_shadowJobFlushes;
+	int		c_shadowJobIndexes;
+	float	shadowJobMsec;		// time spent waiting on the shadow jobs
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
 } performanceCounters_t;
 
@@ -803,6 +835,8 @@ public:
 	class idGuiModel *		guiModel;
 	class idGuiModel *		demoGuiModel;
 
+	idParallelJobList *		frontEndJobs;			// per view front end work spread over the job threads
+
 	// DG: remember the original glConfig.vidWidth/Height values that get overwritten in BeginFrame()
 	//     so they can be reset in EndFrame() (Editors tend to mess up the viewport by using BeginFrame())
 	int						origWidth;
@@ -857,6 +891,7 @@ extern idCVar r_useLightCulling;		// 0 = none, 1 = box, 2 = exact clip of polyhe
 extern idCVar r_useLightScissors;		// 1 = use custom scissor rectangle for each light
 extern idCVar r_useClippedLightScissors;// 0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always
 extern idCVar r_useEntityCulling;		// 0 = none, 1 = box
+extern idCVar r_useBatchCulling;		// cull all the refs of an area against the portal planes at once
 extern idCVar r_useEntityScissors;		// 1 = use custom scissor rectangle for each entity
 extern idCVar r_useInteractionCulling;	// 1 = cull interactions
 extern idCVar r_useInteractionScissors;	// 1 = use a custom scissor rectangle for each interaction
@@ -936,6 +971,9 @@ extern idCVar r_showIntensity;			// draw the screen colors based on intensity, r
 extern idCVar r_showDefs;				// report the number of modeDefs and lightDefs in view
 extern idCVar r_showTrace;				// show the intersection of an eye trace with the world
 extern idCVar r_showSmp;				// show which end (front or back) is blocking
+extern idCVar r_smp;					// run the back end on a separate render thread
+extern idCVar r_parallelDynamicModels;	// skin the MD5 models of a view on the job threads
+extern idCVar r_parallelShadows;		// generate the dynamic shadow volumes of a view on the job threads
 extern idCVar r_showDepth;				// display the contents of the depth buffer and the depth range
 extern idCVar r_showImages;				// draw all images to screen instead of rendering
 extern idCVar r_showTris;				// enables wireframe rendering of the world
@@ -958,6 +996,7 @@ extern idCVar r_showInteractionScissors;// show screen rectangle which contains
 extern idCVar r_showMemory;				// print frame memory utilization
 extern idCVar r_showCull;				// report sphere and box culling stats
 extern idCVar r_showInteractions;		// report interaction generation activity
+extern idCVar r_showShadowJobs;			// report the shadow volumes generated on the job threads
 extern idCVar r_showSurfaces;			// report surface/light/shadow counts
 extern idCVar r_showPrimitives;			// report vertex/index/draw counts
 extern idCVar r_showPortals;			// draw portal outlines in color based on passed / not passed
@@ -998,6 +1037,9 @@ extern idCVar r_glDebugContext; // DG: use debug context to call logging callbac
 extern idCVar r_enableDepthCapture; // DG: disable capturing depth buffer, used for soft particles
 extern idCVar r_useSoftParticles;
 
+extern idCVar r_binaryProc;				// load and write precompiled .bproc files
+extern idCVar r_interactionCache;		// keep the shadow volumes of static interactions in a .binter file
+
 /*
 ====================================================================
 
@@ -1190,7 +1232,8 @@ void R_ListRenderLightDefs_f( const idCmdArgs &args );
 void R_ListRenderEntityDefs_f( const idCmdArgs &args );
 
 bool R_IssueEntityDefCallback( idRenderEntityLocal *def );
-idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def );
+idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def, bool *needsFinish = NULL );
+void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def );
 
 viewEntity_t *R_SetEntityDefViewEntity( idRenderEntityLocal *def );
 viewLight_t *R_SetLightDefViewLight( idRenderLightLocal *def );
@@ -1445,6 +1488,14 @@ srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 									 const srfTriangles_t *tri, const idRenderLightLocal *light,
 									 srfCullInfo_t &cullInfo );
 
+// while the interactions of a view are created the dynamic shadow volumes can be
+// queued up and generated on the job threads, R_FlushShadowJobs fills them in
+void R_BeginShadowJobs( void );
+bool R_QueueShadowVolume( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light,
+						 shadowGen_t optimize, bool seeThrough, idInteraction *interaction, int surfaceNum );
+void R_FlushShadowJobs( void );
+void R_EndShadowJobs( void );
+
 /*
 ============================================================
 
@@ -1526,6 +1577,9 @@ srfTriangles_t *	R_MergeTriangles( const srfTriangles_t *tri1, const srfTriangle
 // if the deformed verts have significant enough texture coordinate changes to reverse the texture
 // polarity of a triangle, the tangents will be incorrect
 void				R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes = true );
+void				R_DeriveUnsmoothedTangents( srfTriangles_t *tri );
+// job thread safe, the face planes have to be allocated up front if they are wanted
+void				R_DeriveSmoothedTangents( srfTriangles_t *tri );
 
 // deformable meshes precalculate as much as possible from a base frame, then generate
 // complete srfTriangles_t from just a new set of vertexes
@@ -1646,6 +1700,7 @@ void RB_ShowDestinationAlpha( void );
 void RB_ShowOverdraw( void );
 void RB_RenderDebugTools( drawSurf_t **drawSurfs, int numDrawSurfs );
 void RB_ShutdownDebugTools( void );
+bool RB_DebugToolsNeedFrontEnd( void );
 
 /*
 =============================================================
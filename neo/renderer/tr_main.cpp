@@ -177,14 +177,19 @@ void R_ShowColoredScreenRect( const idScreenRect &rect, int colorIndex ) {
 	}
 }
 
+// the front end builds into one of these while the render
+// thread may still be executing the commands of the other
+static frameData_t	*smpFrameData[SMP_FRAMES];
+static int			smpFrame;
+
 /*
 ====================
 R_ToggleSmpFrame
+
+The back end must be done with the frameData we switch to
 ====================
 */
 void R_ToggleSmpFrame( void ) {
-	R_FreeDeferredTriSurfs( frameData );
-
 	// clear frame-temporary data
 	frameData_t		*frame;
 	frameMemoryBlock_t	*block;
@@ -192,6 +197,11 @@ void R_ToggleSmpFrame( void ) {
 	// update the highwater mark
 	R_CountFrameData();
 
+	smpFrame = ( smpFrame + 1 ) % SMP_FRAMES;
+	frameData = smpFrameData[smpFrame];
+
+	R_FreeDeferredTriSurfs( frameData );
+
 	frame = frameData;
 
 	// reset the memory allocation to the first block
@@ -220,19 +230,22 @@ void R_ShutdownFrameData( void ) {
 	frameMemoryBlock_t *block;
 
 	// free any current data
-	frame = frameData;
-	if ( !frame ) {
-		return;
-	}
+	for ( int i = 0 ; i < SMP_FRAMES ; i++ ) {
+		frame = smpFrameData[i];
+		if ( !frame ) {
+			continue;
+		}
 
-	R_FreeDeferredTriSurfs( frame );
+		R_FreeDeferredTriSurfs( frame );
 
-	frameMemoryBlock_t *nextBlock;
-	for ( block = frame->memory ; block ; block = nextBlock ) {
-		nextBlock = block->next;
-		Mem_Free( block );
+		frameMemoryBlock_t *nextBlock;
+		for ( block = frame->memory ; block ; block = nextBlock ) {
+			nextBlock = block->next;
+			Mem_Free( block );
+		}
+		Mem_Free( frame );
+		smpFrameData[i] = NULL;
 	}
-	Mem_Free( frame );
 	frameData = NULL;
 }
 
@@ -248,18 +261,22 @@ void R_InitFrameData( void ) {
 
 	R_ShutdownFrameData();
 
-	frameData = (frameData_t *)Mem_ClearedAlloc( sizeof( *frameData ));
-	frame = frameData;
-	size = MEMORY_BLOCK_SIZE;
-	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-	if ( !block ) {
-		common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
+	for ( int i = 0 ; i < SMP_FRAMES ; i++ ) {
+		frame = (frameData_t *)Mem_ClearedAlloc( sizeof( *frame ));
+		size = MEMORY_BLOCK_SIZE;
+		block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
+		if ( !block ) {
+			common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
+		}
+		block->size = size;
+		block->used = 0;
+		block->next = NULL;
+		frame->memory = block;
+		frame->memoryHighwater = 0;
+		smpFrameData[i] = frame;
 	}
-	block->size = size;
-	block->used = 0;
-	block->next = NULL;
-	frame->memory = block;
-	frame->memoryHighwater = 0;
+	smpFrame = 0;
+	frameData = smpFrameData[0];
 
 	R_ToggleSmpFrame();
 }
@@ -828,7 +828,7 @@ void RB_CreateSingleDrawInteractions( const drawSurf_t *surf, void (*DrawInterac
 						RB_SubmittInteraction( &inter, DrawInteraction );
 					}
 
-					if ( !vLight->lightDef->parms.noSpecular )
+					if ( !vLight->noSpecular )
 					{
 						R_SetDrawInteraction( surfaceStage, surfaceRegs, &inter.specularImage,
 											inter.specularMatrix, inter.specularColor.ToFloatPtr() );
@@ -2437,3 +2437,26 @@ void RB_ShutdownDebugTools( void ) {
 		rb_debugPolygons[i].winding.Clear();
 	}
 }
+
+/*
+=================
+RB_DebugToolsNeedFrontEnd
+
+Many of the debug tools look at entity and light defs, the world or the
+debug line lists, which the front end changes while building the next frame.
+With r_smp the back end runs these frames on the main thread.
+=================
+*/
+bool RB_DebugToolsNeedFrontEnd( void ) {
+	if ( rb_numDebugLines || rb_numDebugText || rb_numDebugPolygons ) {
+		return true;
+	}
+	if ( r_showViewEntitys.GetBool() || r_showLights.GetInteger() || r_showPortals.GetBool()
+		|| r_showSurfaceInfo.GetBool() || r_showTrace.GetInteger() || r_showOverDraw.GetInteger() ) {
+		return true;
+	}
+	if ( tr.testImage ) {
+		return true;
+	}
+	return false;
+}
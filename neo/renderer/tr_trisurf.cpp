@@ -1729,35 +1729,16 @@ void R_DeriveUnsmoothedTangents( srfTriangles_t *tri ) {
 
 /*
 ==================
-R_DeriveTangents
-
-This is called once for static surfaces, and every frame for deforming surfaces
+R_DeriveSmoothedTangents
 
-Builds tangents, normals, and face planes
+Builds smoothed tangents, normals, and face planes if they are allocated.
+Doesn't allocate or update the performance counters, so it can be run on a job thread.
 ==================
 */
-void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
+void R_DeriveSmoothedTangents( srfTriangles_t *tri ) {
 	int				i;
 	idPlane			*planes;
 
-	#if MD5_ENABLE_LODS > 2 // DEBUG+
-	if (tri->dominantTris != NULL && r_testUnsmoothedTangents.GetInteger() != 1) {
-	#else
-	if (tri->dominantTris != NULL) {
-	#endif
-		R_DeriveUnsmoothedTangents( tri );
-		return;
-	}
-
-	if ( tri->tangentsCalculated ) {
-		return;
-	}
-
-	tr.pc.c_tangentIndexes += tri->numIndexes;
-
-	if ( !tri->facePlanes && allocFacePlanes ) {
-		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
-	}
 	planes = tri->facePlanes;
 
 #if 1
@@ -1925,6 +1906,38 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 	tri->facePlanesCalculated = true;
 }
 
+/*
+==================
+R_DeriveTangents
+
+This is called once for static surfaces, and every frame for deforming surfaces
+
+Builds tangents, normals, and face planes
+==================
+*/
+void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
+	#if MD5_ENABLE_LODS > 2 // DEBUG+
+	if (tri->dominantTris != NULL && r_testUnsmoothedTangents.GetInteger() != 1) {
+	#else
+	if (tri->dominantTris != NULL) {
+	#endif
+		R_DeriveUnsmoothedTangents( tri );
+		return;
+	}
+
+	if ( tri->tangentsCalculated ) {
+		return;
+	}
+
+	tr.pc.c_tangentIndexes += tri->numIndexes;
+
+	if ( !tri->facePlanes && allocFacePlanes ) {
+		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+	}
+
+	R_DeriveSmoothedTangents( tri );
+}
+
 /*
 =================
 R_RemoveDuplicatedTriangles
@@ -42,10 +42,10 @@ Determines which triangles of the surface are facing towards the light origin.
 
 The facing array should be allocated with one extra index than
 the number of surface triangles, which will be used to handle dangling
-edge silhouettes.
+edge silhouettes.  If no facing array is given, it is allocated here.
 ================
 */
-void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo ) {
+void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo, byte *facing ) {
 	if ( cullInfo.facing != NULL ) {
 		return;
 	}
@@ -54,7 +54,10 @@ void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles
 	R_GlobalPointToLocal( ent->modelMatrix, light->globalLightOrigin, localLightOrigin );
 
 	const int numFaces = tri->numIndexes / 3;
-	cullInfo.facing = (byte *) R_StaticAlloc( ( numFaces + 1 ) * sizeof( cullInfo.facing[0] ) );
+	if ( facing == NULL ) {
+		facing = (byte *) R_StaticAlloc( ( numFaces + 1 ) * sizeof( cullInfo.facing[0] ) );
+	}
+	cullInfo.facing = facing;
 
 	// exact geometric cull against face
 	for ( int i = 0, face = 0; i < tri->numIndexes; i += 3, face++ ) {
@@ -72,31 +75,20 @@ void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles
 
 /*
 =====================
-R_CreateVertexProgramTurboShadowVolume
+R_CountShadowingFaces
 
-are dangling edges that are outside the light frustum still making planes?
+Turns the triangles that are completely outside the light frustum away
+from the light and returns the number of triangles that cast a shadow
 =====================
 */
-srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
-														const srfTriangles_t *tri, const idRenderLightLocal *light,
-														srfCullInfo_t &cullInfo ) {
+static int R_CountShadowingFaces( const srfTriangles_t *tri, srfCullInfo_t &cullInfo, bool projectedCull ) {
 	int		i, j;
-	srfTriangles_t	*newTri;
-	silEdge_t	*sil;
-	const glIndex_t *indexes;
-	const byte *facing;
-
-	R_CalcInteractionFacing( ent, tri, light, cullInfo );
-	if ( r_useShadowProjectedCull.GetBool() ) {
-		R_CalcInteractionCullBits( ent, tri, light, cullInfo );
-	}
-
-	int numFaces = tri->numIndexes / 3;
-	int	numShadowingFaces = 0;
-	facing = cullInfo.facing;
+	int		numFaces = tri->numIndexes / 3;
+	int		numShadowingFaces = 0;
+	const byte *facing = cullInfo.facing;
 
 	// if all the triangles are inside the light frustum
-	if ( cullInfo.cullBits == LIGHT_CULL_ALL_FRONT || !r_useShadowProjectedCull.GetBool() ) {
+	if ( cullInfo.cullBits == LIGHT_CULL_ALL_FRONT || !projectedCull ) {
 
 		// count the number of shadowing faces
 		for ( i = 0; i < numFaces; i++ ) {
@@ -107,7 +99,7 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 	} else {
 
 		// make all triangles that are outside the light frustum "facing", so they won't cast shadows
-		indexes = tri->indexes;
+		const glIndex_t *indexes = tri->indexes;
 		byte *modifyFacing = cullInfo.facing;
 		const byte *cullBits = cullInfo.cullBits;
 		for ( j = i = 0; i < tri->numIndexes; i += 3, j++ ) {
@@ -124,25 +116,20 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 		}
 	}
 
-	if ( !numShadowingFaces ) {
-		// no faces are inside the light frustum and still facing the right way
-		return NULL;
-	}
-
-	// shadowVerts will be NULL on these surfaces, so the shadowVerts will be taken from the ambient surface
-	newTri = R_AllocStaticTriSurf();
+	return numShadowingFaces;
+}
 
-	newTri->numVerts = tri->numVerts * 2;
+/*
+=====================
+R_TurboShadowSilIndexes
 
-	// alloc the max possible size
-#ifdef USE_TRI_DATA_ALLOCATOR
-	R_AllocStaticTriSurfIndexes( newTri, ( numShadowingFaces + tri->numSilEdges ) * 6 );
-	glIndex_t *tempIndexes = newTri->indexes;
-	glIndex_t *shadowIndexes = newTri->indexes;
-#else
-	glIndex_t *tempIndexes = (glIndex_t *)_alloca16( tri->numSilEdges * 6 * sizeof( tempIndexes[0] ) );
-	glIndex_t *shadowIndexes = tempIndexes;
-#endif
+Adds a quad for each silhouette edge, vertRemap is NULL for the vertex program
+shadows, which use the doubled vertexes of the surface itself
+=====================
+*/
+static glIndex_t *R_TurboShadowSilIndexes( const srfTriangles_t *tri, const byte *facing, const int *vertRemap, glIndex_t *shadowIndexes ) {
+	int			i;
+	silEdge_t	*sil;
 
 	// create new triangles along sil planes
 	for ( sil = tri->silEdges, i = tri->numSilEdges; i > 0; i--, sil++ ) {
@@ -154,8 +141,8 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 			continue;
 		}
 
-		int v1 = sil->v1 << 1;
-		int v2 = sil->v2 << 1;
+		int v1 = vertRemap ? vertRemap[sil->v1] : sil->v1 << 1;
+		int v2 = vertRemap ? vertRemap[sil->v2] : sil->v2 << 1;
 
 		// set the two triangle winding orders based on facing
 		// without using a poorly-predictable branch
@@ -170,7 +157,131 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 		shadowIndexes += 6;
 	}
 
-	int	numShadowIndexes = shadowIndexes - tempIndexes;
+	return shadowIndexes;
+}
+
+/*
+=====================
+R_TurboShadowCapIndexes
+
+Adds the front and rear caps of the triangles that face away from the light
+=====================
+*/
+static glIndex_t *R_TurboShadowCapIndexes( const srfTriangles_t *tri, const byte *facing, const int *vertRemap, glIndex_t *shadowIndexes ) {
+	int i, j;
+
+	// put some faces on the model and some on the distant projection
+	if ( vertRemap == NULL ) {
+		const glIndex_t *indexes = tri->indexes;
+		for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
+			if ( facing[j] ) {
+				continue;
+			}
+
+			int i0 = indexes[i+0] << 1;
+			shadowIndexes[2] = i0;
+			shadowIndexes[3] = i0 ^ 1;
+			int i1 = indexes[i+1] << 1;
+			shadowIndexes[1] = i1;
+			shadowIndexes[4] = i1 ^ 1;
+			int i2 = indexes[i+2] << 1;
+			shadowIndexes[0] = i2;
+			shadowIndexes[5] = i2 ^ 1;
+
+			shadowIndexes += 6;
+		}
+	} else {
+		const glIndex_t *indexes = tri->silIndexes;
+		for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
+			if ( facing[j] ) {
+				continue;
+			}
+
+			int i0 = vertRemap[indexes[i+0]];
+			shadowIndexes[2] = i0;
+			shadowIndexes[3] = i0 ^ 1;
+			int i1 = vertRemap[indexes[i+1]];
+			shadowIndexes[1] = i1;
+			shadowIndexes[4] = i1 ^ 1;
+			int i2 = vertRemap[indexes[i+2]];
+			shadowIndexes[0] = i2;
+			shadowIndexes[5] = i2 ^ 1;
+
+			shadowIndexes += 6;
+		}
+	}
+
+	return shadowIndexes;
+}
+
+/*
+=====================
+R_TurboShadowVertexRemap
+
+Creates the projected shadow vertexes for the triangles that face away from the light
+=====================
+*/
+static int R_TurboShadowVertexRemap( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light,
+									const byte *facing, int *vertRemap, shadowCache_t *shadowVerts ) {
+	int		i, j;
+	idVec3	localLightOrigin;
+
+	R_GlobalPointToLocal( ent->modelMatrix, light->globalLightOrigin, localLightOrigin );
+
+	SIMDProcessor->Memset( vertRemap, -1, tri->numVerts * sizeof( vertRemap[0] ) );
+
+	for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
+		if ( facing[j] ) {
+			continue;
+		}
+		// this may pull in some vertexes that are outside
+		// the frustum, because they connect to vertexes inside
+		vertRemap[tri->silIndexes[i+0]] = 0;
+		vertRemap[tri->silIndexes[i+1]] = 0;
+		vertRemap[tri->silIndexes[i+2]] = 0;
+	}
+
+	return SIMDProcessor->CreateShadowCache( &shadowVerts->xyz, vertRemap, localLightOrigin, tri->verts, tri->numVerts );
+}
+
+/*
+=====================
+R_CreateVertexProgramTurboShadowVolume
+
+are dangling edges that are outside the light frustum still making planes?
+=====================
+*/
+srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLocal *ent,
+														const srfTriangles_t *tri, const idRenderLightLocal *light,
+														srfCullInfo_t &cullInfo ) {
+	srfTriangles_t	*newTri;
+
+	R_CalcInteractionFacing( ent, tri, light, cullInfo );
+	if ( r_useShadowProjectedCull.GetBool() ) {
+		R_CalcInteractionCullBits( ent, tri, light, cullInfo );
+	}
+
+	int numShadowingFaces = R_CountShadowingFaces( tri, cullInfo, r_useShadowProjectedCull.GetBool() );
+
+	if ( !numShadowingFaces ) {
+		// no faces are inside the light frustum and still facing the right way
+		return NULL;
+	}
+
+	// shadowVerts will be NULL on these surfaces, so the shadowVerts will be taken from the ambient surface
+	newTri = R_AllocStaticTriSurf();
+
+	newTri->numVerts = tri->numVerts * 2;
+
+	// alloc the max possible size
+#ifdef USE_TRI_DATA_ALLOCATOR
+	R_AllocStaticTriSurfIndexes( newTri, ( numShadowingFaces + tri->numSilEdges ) * 6 );
+	glIndex_t *tempIndexes = newTri->indexes;
+#else
+	glIndex_t *tempIndexes = (glIndex_t *)_alloca16( tri->numSilEdges * 6 * sizeof( tempIndexes[0] ) );
+#endif
+
+	int	numShadowIndexes = R_TurboShadowSilIndexes( tri, cullInfo.facing, NULL, tempIndexes ) - tempIndexes;
 
 	// we aren't bothering to separate front and back caps on these
 	newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps = numShadowIndexes + numShadowingFaces * 6;
@@ -190,26 +301,7 @@ srfTriangles_t *R_CreateVertexProgramTurboShadowVolume( const idRenderEntityLoca
 	// these have no effect, because they extend to infinity
 	newTri->bounds.Clear();
 
-	// put some faces on the model and some on the distant projection
-	indexes = tri->indexes;
-	shadowIndexes = newTri->indexes + numShadowIndexes;
-	for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
-		if ( facing[j] ) {
-			continue;
-		}
-
-		int i0 = indexes[i+0] << 1;
-		shadowIndexes[2] = i0;
-		shadowIndexes[3] = i0 ^ 1;
-		int i1 = indexes[i+1] << 1;
-		shadowIndexes[1] = i1;
-		shadowIndexes[4] = i1 ^ 1;
-		int i2 = indexes[i+2] << 1;
-		shadowIndexes[0] = i2;
-		shadowIndexes[5] = i2 ^ 1;
-
-		shadowIndexes += 6;
-	}
+	R_TurboShadowCapIndexes( tri, cullInfo.facing, NULL, newTri->indexes + numShadowIndexes );
 
 	return newTri;
 }
@@ -222,50 +314,14 @@ R_CreateTurboShadowVolume
 srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 											const srfTriangles_t *tri, const idRenderLightLocal *light,
 											srfCullInfo_t &cullInfo ) {
-	int		i, j;
-	idVec3	localLightOrigin;
 	srfTriangles_t	*newTri;
-	silEdge_t	*sil;
-	const glIndex_t *indexes;
-	const byte *facing;
 
 	R_CalcInteractionFacing( ent, tri, light, cullInfo );
 	if ( r_useShadowProjectedCull.GetBool() ) {
 		R_CalcInteractionCullBits( ent, tri, light, cullInfo );
 	}
 
-	int numFaces = tri->numIndexes / 3;
-	int	numShadowingFaces = 0;
-	facing = cullInfo.facing;
-
-	// if all the triangles are inside the light frustum
-	if ( cullInfo.cullBits == LIGHT_CULL_ALL_FRONT || !r_useShadowProjectedCull.GetBool() ) {
-
-		// count the number of shadowing faces
-		for ( i = 0; i < numFaces; i++ ) {
-			numShadowingFaces += facing[i];
-		}
-		numShadowingFaces = numFaces - numShadowingFaces;
-
-	} else {
-
-		// make all triangles that are outside the light frustum "facing", so they won't cast shadows
-		indexes = tri->indexes;
-		byte *modifyFacing = cullInfo.facing;
-		const byte *cullBits = cullInfo.cullBits;
-		for ( j = i = 0; i < tri->numIndexes; i += 3, j++ ) {
-			if ( !modifyFacing[j] ) {
-				int	i1 = indexes[i+0];
-				int	i2 = indexes[i+1];
-				int	i3 = indexes[i+2];
-				if ( cullBits[i1] & cullBits[i2] & cullBits[i3] ) {
-					modifyFacing[j] = 1;
-				} else {
-					numShadowingFaces++;
-				}
-			}
-		}
-	}
+	int numShadowingFaces = R_CountShadowingFaces( tri, cullInfo, r_useShadowProjectedCull.GetBool() );
 
 	if ( !numShadowingFaces ) {
 		// no faces are inside the light frustum and still facing the right way
@@ -281,24 +337,9 @@ srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 	shadowCache_t *shadowVerts = (shadowCache_t *)_alloca16( tri->numVerts * 2 * sizeof( shadowVerts[0] ) );
 #endif
 
-	R_GlobalPointToLocal( ent->modelMatrix, light->globalLightOrigin, localLightOrigin );
-
 	int	*vertRemap = (int *)_alloca16( tri->numVerts * sizeof( vertRemap[0] ) );
 
-	SIMDProcessor->Memset( vertRemap, -1, tri->numVerts * sizeof( vertRemap[0] ) );
-
-	for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
-		if ( facing[j] ) {
-			continue;
-		}
-		// this may pull in some vertexes that are outside
-		// the frustum, because they connect to vertexes inside
-		vertRemap[tri->silIndexes[i+0]] = 0;
-		vertRemap[tri->silIndexes[i+1]] = 0;
-		vertRemap[tri->silIndexes[i+2]] = 0;
-	}
-
-	newTri->numVerts = SIMDProcessor->CreateShadowCache( &shadowVerts->xyz, vertRemap, localLightOrigin, tri->verts, tri->numVerts );
+	newTri->numVerts = R_TurboShadowVertexRemap( ent, tri, light, cullInfo.facing, vertRemap, shadowVerts );
 
 	c_turboUsedVerts += newTri->numVerts;
 	c_turboUnusedVerts += tri->numVerts * 2 - newTri->numVerts;
@@ -314,39 +355,11 @@ srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 #ifdef USE_TRI_DATA_ALLOCATOR
 	R_AllocStaticTriSurfIndexes( newTri, ( numShadowingFaces + tri->numSilEdges ) * 6 );
 	glIndex_t *tempIndexes = newTri->indexes;
-	glIndex_t *shadowIndexes = newTri->indexes;
 #else
 	glIndex_t *tempIndexes = (glIndex_t *)_alloca16( tri->numSilEdges * 6 * sizeof( tempIndexes[0] ) );
-	glIndex_t *shadowIndexes = tempIndexes;
 #endif
 
-	// create new triangles along sil planes
-	for ( sil = tri->silEdges, i = tri->numSilEdges; i > 0; i--, sil++ ) {
-
-		int f1 = facing[sil->p1];
-		int f2 = facing[sil->p2];
-
-		if ( !( f1 ^ f2 ) ) {
-			continue;
-		}
-
-		int v1 = vertRemap[sil->v1];
-		int v2 = vertRemap[sil->v2];
-
-		// set the two triangle winding orders based on facing
-		// without using a poorly-predictable branch
-
-		shadowIndexes[0] = v1;
-		shadowIndexes[1] = v2 ^ f1;
-		shadowIndexes[2] = v2 ^ f2;
-		shadowIndexes[3] = v1 ^ f2;
-		shadowIndexes[4] = v1 ^ f1;
-		shadowIndexes[5] = v2 ^ 1;
-
-		shadowIndexes += 6;
-	}
-
-	int numShadowIndexes = shadowIndexes - tempIndexes;
+	int numShadowIndexes = R_TurboShadowSilIndexes( tri, cullInfo.facing, vertRemap, tempIndexes ) - tempIndexes;
 
 	// we aren't bothering to separate front and back caps on these
 	newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps = numShadowIndexes + numShadowingFaces * 6;
@@ -366,26 +379,224 @@ srfTriangles_t *R_CreateTurboShadowVolume( const idRenderEntityLocal *ent,
 	// these have no effect, because they extend to infinity
 	newTri->bounds.Clear();
 
-	// put some faces on the model and some on the distant projection
-	indexes = tri->silIndexes;
-	shadowIndexes = newTri->indexes + numShadowIndexes;
-	for ( i = 0, j = 0; i < tri->numIndexes; i += 3, j++ ) {
-		if ( facing[j] ) {
+	R_TurboShadowCapIndexes( tri, cullInfo.facing, vertRemap, newTri->indexes + numShadowIndexes );
+
+	return newTri;
+}
+
+/*
+===============================================================================
+
+	Turbo shadow jobs
+
+	While the interactions of a view are created, the turbo shadow volumes can be
+	queued up instead of generated right away.  The jobs only write into frame
+	memory that is allocated when they are queued, the shadow surfaces are only
+	allocated once all the jobs have finished.
+
+===============================================================================
+*/
+
+typedef struct {
+	const idRenderEntityLocal *	ent;
+	const srfTriangles_t *		tri;
+	const idRenderLightLocal *	light;
+	idInteraction *				interaction;
+	int							surfaceNum;
+	bool						vertexProgram;		// the shadow vertexes are taken from the ambient surface
+	bool						projectedCull;
+	bool						seeThrough;			// the external shadow optimizations can't be used
+
+	// frame memory the job writes into
+	byte *						facing;
+	byte *						cullBits;
+	int *						vertRemap;
+	shadowCache_t *				shadowVerts;
+	glIndex_t *					shadowIndexes;
+
+	int							numVerts;
+	int							numIndexes;			// 0 if the surface doesn't cast a shadow
+	int							numSilIndexes;
+} shadowJob_t;
+
+static bool					deferShadows = false;
+static idList<shadowJob_t>	shadowJobs;
+
+/*
+=====================
+R_TurboShadowJob
+=====================
+*/
+static void R_TurboShadowJob( void *data ) {
+	shadowJob_t *	job = (shadowJob_t *)data;
+	srfCullInfo_t	cullInfo;
+
+	memset( &cullInfo, 0, sizeof( cullInfo ) );
+
+	R_CalcInteractionFacing( job->ent, job->tri, job->light, cullInfo, job->facing );
+	if ( job->projectedCull ) {
+		R_CalcInteractionCullBits( job->ent, job->tri, job->light, cullInfo, job->cullBits );
+	}
+
+	if ( !R_CountShadowingFaces( job->tri, cullInfo, job->projectedCull ) ) {
+		job->numIndexes = 0;
+		return;
+	}
+
+	if ( job->vertexProgram ) {
+		job->numVerts = job->tri->numVerts * 2;
+	} else {
+		job->numVerts = R_TurboShadowVertexRemap( job->ent, job->tri, job->light, cullInfo.facing, job->vertRemap, job->shadowVerts );
+	}
+
+	glIndex_t *shadowIndexes = R_TurboShadowSilIndexes( job->tri, cullInfo.facing, job->vertRemap, job->shadowIndexes );
+	job->numSilIndexes = shadowIndexes - job->shadowIndexes;
+
+	shadowIndexes = R_TurboShadowCapIndexes( job->tri, cullInfo.facing, job->vertRemap, shadowIndexes );
+	job->numIndexes = shadowIndexes - job->shadowIndexes;
+}
+
+/*
+=====================
+R_BeginShadowJobs
+=====================
+*/
+void R_BeginShadowJobs( void ) {
+	assert( shadowJobs.Num() == 0 );
+	deferShadows = true;
+}
+
+/*
+=====================
+R_QueueShadowVolume
+
+Queues up a turbo shadow volume for the surface of an interaction, returns false
+if the shadow volume has to be created right away with R_CreateShadowVolume
+=====================
+*/
+bool R_QueueShadowVolume( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light,
+						 shadowGen_t optimize, bool seeThrough, idInteraction *interaction, int surfaceNum ) {
+	if ( !deferShadows || optimize != SG_DYNAMIC || !r_useTurboShadow.GetBool() || !r_shadows.GetBool() ) {
+		return false;
+	}
+
+	// let R_CreateShadowVolume deal with the empty and broken surfaces
+	if ( tri->numSilEdges <= 0 || tri->numIndexes <= 0 || tri->numVerts <= 0 ) {
+		return false;
+	}
+
+	tr.pc.c_createShadowVolumes++;
+
+	const int numFaces = tri->numIndexes / 3;
+
+	shadowJob_t &job = shadowJobs.Alloc();
+	job.ent = ent;
+	job.tri = tri;
+	job.light = light;
+	job.interaction = interaction;
+	job.surfaceNum = surfaceNum;
+	job.vertexProgram = r_useShadowVertexProgram.GetBool();
+	job.projectedCull = r_useShadowProjectedCull.GetBool();
+	job.seeThrough = seeThrough;
+
+	job.facing = (byte *)R_FrameAlloc( ( numFaces + 1 ) * sizeof( job.facing[0] ) );
+	job.cullBits = job.projectedCull ? (byte *)R_FrameAlloc( tri->numVerts * sizeof( job.cullBits[0] ) ) : NULL;
+	if ( job.vertexProgram ) {
+		job.vertRemap = NULL;
+		job.shadowVerts = NULL;
+	} else {
+		job.vertRemap = (int *)R_FrameAlloc( tri->numVerts * sizeof( job.vertRemap[0] ) );
+		job.shadowVerts = (shadowCache_t *)R_FrameAlloc( tri->numVerts * 2 * sizeof( job.shadowVerts[0] ) );
+	}
+	// the max possible size
+	job.shadowIndexes = (glIndex_t *)R_FrameAlloc( ( numFaces + tri->numSilEdges ) * 6 * sizeof( job.shadowIndexes[0] ) );
+
+	job.numVerts = 0;
+	job.numIndexes = 0;
+	job.numSilIndexes = 0;
+
+	interaction->shadowJobsPending = true;
+
+	return true;
+}
+
+/*
+=====================
+R_FlushShadowJobs
+
+Runs the queued shadow jobs on the job threads and creates the
+shadow surfaces for them, in the order they were queued
+=====================
+*/
+void R_FlushShadowJobs( void ) {
+	int i;
+
+	if ( shadowJobs.Num() == 0 ) {
+		return;
+	}
+
+	const double startTime = Sys_MillisecondsPrecise();
+
+	for ( i = 0; i < shadowJobs.Num(); i++ ) {
+		tr.frontEndJobs->AddJob( R_TurboShadowJob, &shadowJobs[i] );
+	}
+	tr.frontEndJobs->Submit();
+	tr.frontEndJobs->Wait();
+
+	tr.pc.shadowJobMsec += Sys_MillisecondsPrecise() - startTime;
+	tr.pc.c_shadowJobs += shadowJobs.Num();
+	tr.pc.c_shadowJobFlushes++;
+
+	for ( i = 0; i < shadowJobs.Num(); i++ ) {
+		const shadowJob_t &job = shadowJobs[i];
+
+		job.interaction->shadowJobsPending = false;
+
+		if ( job.numIndexes == 0 ) {
 			continue;
 		}
 
-		int i0 = vertRemap[indexes[i+0]];
-		shadowIndexes[2] = i0;
-		shadowIndexes[3] = i0 ^ 1;
-		int i1 = vertRemap[indexes[i+1]];
-		shadowIndexes[1] = i1;
-		shadowIndexes[4] = i1 ^ 1;
-		int i2 = vertRemap[indexes[i+2]];
-		shadowIndexes[0] = i2;
-		shadowIndexes[5] = i2 ^ 1;
+		srfTriangles_t *newTri = R_AllocStaticTriSurf();
 
-		shadowIndexes += 6;
+		newTri->numVerts = job.numVerts;
+		if ( !job.vertexProgram ) {
+			R_AllocStaticTriSurfShadowVerts( newTri, job.numVerts );
+			SIMDProcessor->Memcpy( newTri->shadowVertexes, job.shadowVerts, job.numVerts * sizeof( job.shadowVerts[0] ) );
+
+			c_turboUsedVerts += job.numVerts;
+			c_turboUnusedVerts += job.tri->numVerts * 2 - job.numVerts;
+		}
+
+		R_AllocStaticTriSurfIndexes( newTri, job.numIndexes );
+		SIMDProcessor->Memcpy( newTri->indexes, job.shadowIndexes, job.numIndexes * sizeof( job.shadowIndexes[0] ) );
+
+		// we aren't bothering to separate front and back caps on these
+		newTri->numIndexes = newTri->numShadowIndexesNoFrontCaps = job.numIndexes;
+		newTri->numShadowIndexesNoCaps = job.numSilIndexes;
+		newTri->shadowCapPlaneBits = SHADOW_CAP_INFINITE;
+
+		// these have no effect, because they extend to infinity
+		newTri->bounds.Clear();
+
+		if ( job.seeThrough ) {
+			newTri->numShadowIndexesNoCaps = newTri->numIndexes;
+			newTri->numShadowIndexesNoFrontCaps = newTri->numIndexes;
+		}
+
+		tr.pc.c_shadowJobIndexes += job.numIndexes;
+
+		job.interaction->surfaces[job.surfaceNum].shadowTris = newTri;
 	}
 
-	return newTri;
+	shadowJobs.SetNum( 0, false );
+}
+
+/*
+=====================
+R_EndShadowJobs
+=====================
+*/
+void R_EndShadowJobs( void ) {
+	R_FlushShadowJobs();
+	deferShadows = false;
 }
@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include <float.h>
 
 #include <SDL_cpuinfo.h>
+#include <SDL_version.h>
 
 // MSVC header intrin.h uses strcmp and errors out when not set
 #define IDSTR_NO_REDIRECT
@@ -213,6 +214,12 @@ int Sys_GetProcessorId( void ) {
 		flags |= CPUID_SSE3;
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+	// SDL also checks that the OS saves the ymm registers
+	if (SDL_HasAVX2())
+		flags |= CPUID_AVX2;
+#endif
+
 	return flags;
 }
 
@@ -618,6 +618,12 @@ try_again:
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	// SDL1.2 has no context, and is not supported by ImGui anyway
 	D3::ImGuiHooks::Init(window, context);
+#else
+	// without a context we can't hand it over to the render thread
+	if ( r_smp.GetBool() ) {
+		common->Warning( "r_smp requires SDL2, disabling it" );
+		r_smp.SetBool( false );
+	}
 #endif
 
 	return true;
@@ -863,7 +869,11 @@ GLimp_ActivateContext
 =================
 */
 void GLimp_ActivateContext() {
-	common->DPrintf("TODO: GLimp_ActivateContext\n");
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	if ( SDL_GL_MakeCurrent( window, context ) != 0 ) {
+		common->Warning( "GLimp_ActivateContext: %s", SDL_GetError() );
+	}
+#endif
 }
 
 /*
@@ -872,7 +882,9 @@ GLimp_DeactivateContext
 =================
 */
 void GLimp_DeactivateContext() {
-	common->DPrintf("TODO: GLimp_DeactivateContext\n");
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_GL_MakeCurrent( window, NULL );
+#endif
 }
 
 /*
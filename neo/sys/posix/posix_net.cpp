@@ -48,6 +48,36 @@ idPort clientPort, serverPort;
 
 idCVar net_ip( "net_ip", "localhost", CVAR_SYSTEM, "local IP address" );
 idCVar net_port( "net_port", "", CVAR_SYSTEM | CVAR_INTEGER, "local IP port number" );
+idCVar net_batchPackets( "net_batchPackets", "1", CVAR_SYSTEM | CVAR_BOOL, "receive and send several packets with one system call where the platform supports it" );
+
+// recvmmsg and sendmmsg receive and send several packets with one system call
+#if defined( __linux__ )
+	#define ID_NET_MMSG 1
+#else
+	#define ID_NET_MMSG 0
+#endif
+
+const int PORT_BATCH_PACKETS		= 16;		// the most packets received or sent with one system call
+const int PORT_BATCH_PACKET_SIZE	= 16384;	// as large as the largest network message
+const int PORT_BATCH_SEND_SIZE		= 65536;
+
+struct portBatch_s {
+	// received packets not yet returned by GetPacket
+	int					numReceived;
+	int					nextReceived;
+	int					receivedSize[PORT_BATCH_PACKETS];
+	struct sockaddr_in	receivedFrom[PORT_BATCH_PACKETS];
+	byte				receiveBuf[PORT_BATCH_PACKETS][PORT_BATCH_PACKET_SIZE];
+
+	// packets queued by SendPacket between BeginSendBatch and FlushSendBatch
+	bool				sending;
+	int					numSends;
+	int					sendBufUsed;
+	int					sendOffset[PORT_BATCH_PACKETS];
+	int					sendSize[PORT_BATCH_PACKETS];
+	struct sockaddr_in	sendTo[PORT_BATCH_PACKETS];
+	byte				sendBuf[PORT_BATCH_SEND_SIZE];
+};
 
 typedef struct {
 	unsigned int ip;
@@ -382,6 +412,93 @@ static int IPSocket( const char *net_interface, int port, netadr_t *bound_to = N
 	return newsocket;
 }
 
+#if ID_NET_MMSG
+
+/*
+==================
+ReceivePacketBatch
+
+Fills the receive ring with the packets waiting on the socket.
+==================
+*/
+static void ReceivePacketBatch( int netSocket, portBatch_t *batch ) {
+	struct mmsghdr	msgs[PORT_BATCH_PACKETS];
+	struct iovec	iovs[PORT_BATCH_PACKETS];
+	int				i, ret;
+
+	memset( msgs, 0, sizeof( msgs ) );
+	for ( i = 0; i < PORT_BATCH_PACKETS; i++ ) {
+		iovs[i].iov_base = batch->receiveBuf[i];
+		iovs[i].iov_len = PORT_BATCH_PACKET_SIZE;
+		msgs[i].msg_hdr.msg_name = &batch->receivedFrom[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof( batch->receivedFrom[i] );
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	batch->numReceived = 0;
+	batch->nextReceived = 0;
+
+	ret = recvmmsg( netSocket, msgs, PORT_BATCH_PACKETS, MSG_DONTWAIT, NULL );
+	if ( ret == -1 ) {
+		if ( errno != EWOULDBLOCK && errno != ECONNREFUSED ) {
+			common->DPrintf( "ReceivePacketBatch recvmmsg(): %s\n", strerror( errno ) );
+		}
+		return;
+	}
+
+	for ( i = 0; i < ret; i++ ) {
+		// a truncated packet is dropped like recvfrom would drop it into a too small buffer
+		batch->receivedSize[i] = ( msgs[i].msg_hdr.msg_flags & MSG_TRUNC ) ? -1 : msgs[i].msg_len;
+	}
+	batch->numReceived = ret;
+}
+
+/*
+==================
+SendPacketBatch
+
+Sends the queued packets, returns the number of system calls made.
+==================
+*/
+static int SendPacketBatch( int netSocket, portBatch_t *batch ) {
+	struct mmsghdr	msgs[PORT_BATCH_PACKETS];
+	struct iovec	iovs[PORT_BATCH_PACKETS];
+	int				i, ret, numSent, numCalls;
+
+	memset( msgs, 0, sizeof( msgs ) );
+	for ( i = 0; i < batch->numSends; i++ ) {
+		iovs[i].iov_base = batch->sendBuf + batch->sendOffset[i];
+		iovs[i].iov_len = batch->sendSize[i];
+		msgs[i].msg_hdr.msg_name = &batch->sendTo[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof( batch->sendTo[i] );
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	numCalls = 0;
+	for ( numSent = 0; numSent < batch->numSends; ) {
+		ret = sendmmsg( netSocket, msgs + numSent, batch->numSends - numSent, 0 );
+		numCalls++;
+		if ( ret == -1 ) {
+			// skip the packet that failed
+			netadr_t to;
+			SockadrToNetadr( &batch->sendTo[numSent], &to );
+			common->Printf( "idPort::SendPacket ERROR: to %s: %s\n", Sys_NetAdrToString( to ), strerror( errno ) );
+			numSent++;
+		} else {
+			numSent += ret;
+		}
+	}
+
+	batch->numSends = 0;
+	batch->sendBufUsed = 0;
+
+	return numCalls;
+}
+
+#endif
+
 /*
 ==================
 idPort::idPort
@@ -390,6 +507,8 @@ idPort::idPort
 idPort::idPort() {
 	netSocket = 0;
 	memset( &bound_to, 0, sizeof( bound_to ) );
+	batch = NULL;
+	ResetStats();
 }
 
 /*
@@ -408,10 +527,13 @@ idPort::Close
 */
 void idPort::Close() {
 	if ( netSocket ) {
+		FlushSendBatch();
 		close(netSocket);
 		netSocket = 0;
 		memset( &bound_to, 0, sizeof( bound_to ) );
 	}
+	delete batch;
+	batch = NULL;
 }
 
 /*
@@ -428,8 +550,32 @@ bool idPort::GetPacket( netadr_t &net_from, void *data, int &size, int maxSize )
 		return false;
 	}
 
+#if ID_NET_MMSG
+	if ( batch && net_batchPackets.GetBool() ) {
+		if ( batch->nextReceived >= batch->numReceived ) {
+			ReceivePacketBatch( netSocket, batch );
+			receiveCalls++;
+		}
+		while ( batch->nextReceived < batch->numReceived ) {
+			int i = batch->nextReceived++;
+			if ( batch->receivedSize[i] < 0 || batch->receivedSize[i] >= maxSize ) {
+				common->DPrintf( "idPort::GetPacket: dropped packet larger than %d bytes\n", maxSize );
+				continue;
+			}
+			memcpy( data, batch->receiveBuf[i], batch->receivedSize[i] );
+			SockadrToNetadr( &batch->receivedFrom[i], &net_from );
+			size = batch->receivedSize[i];
+			packetsRead++;
+			bytesRead += size;
+			return true;
+		}
+		return false;
+	}
+#endif
+
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *) &from, (socklen_t *) &fromlen );
+	receiveCalls++;
 
 	if ( ret == -1 ) {
 		if (errno == EWOULDBLOCK || errno == ECONNREFUSED) {
@@ -444,6 +590,8 @@ bool idPort::GetPacket( netadr_t &net_from, void *data, int &size, int maxSize )
 
 	SockadrToNetadr( &from, &net_from );
 	size = ret;
+	packetsRead++;
+	bytesRead += size;
 	return true;
 }
 
@@ -465,6 +613,13 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 		return GetPacket( net_from, data, size, maxSize );
 	}
 
+#if ID_NET_MMSG
+	// don't wait while received packets are left
+	if ( batch && net_batchPackets.GetBool() && batch->nextReceived < batch->numReceived ) {
+		return GetPacket( net_from, data, size, maxSize );
+	}
+#endif
+
 	FD_ZERO( &set );
 	FD_SET( netSocket, &set );
 
@@ -484,10 +639,18 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 		// timed out
 		return false;
 	}
+
+#if ID_NET_MMSG
+	if ( batch && net_batchPackets.GetBool() ) {
+		return GetPacket( net_from, data, size, maxSize );
+	}
+#endif
+
 	struct sockaddr_in from;
 	int fromlen;
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *)&from, (socklen_t *)&fromlen );
+	receiveCalls++;
 	if ( ret == -1 ) {
 		// there should be no blocking errors once select declares things are good
 		common->DPrintf( "idPort::GetPacketBlocking: %s\n", strerror( errno ) );
@@ -496,6 +659,8 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 	assert( ret < maxSize );
 	SockadrToNetadr( &from, &net_from );
 	size = ret;
+	packetsRead++;
+	bytesRead += size;
 	return true;
 }
 
@@ -519,12 +684,58 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 
 	NetadrToSockadr( &to, &addr );
 
+	packetsWritten++;
+	bytesWritten += size;
+
+#if ID_NET_MMSG
+	if ( batch && batch->sending && size <= PORT_BATCH_SEND_SIZE ) {
+		if ( batch->numSends >= PORT_BATCH_PACKETS || batch->sendBufUsed + size > PORT_BATCH_SEND_SIZE ) {
+			sendCalls += SendPacketBatch( netSocket, batch );
+		}
+		batch->sendOffset[batch->numSends] = batch->sendBufUsed;
+		batch->sendSize[batch->numSends] = size;
+		batch->sendTo[batch->numSends] = addr;
+		memcpy( batch->sendBuf + batch->sendBufUsed, data, size );
+		batch->sendBufUsed += size;
+		batch->numSends++;
+		return;
+	}
+#endif
+
 	ret = sendto( netSocket, data, size, 0, (struct sockaddr *) &addr, sizeof(addr) );
+	sendCalls++;
 	if ( ret == -1 ) {
 		common->Printf( "idPort::SendPacket ERROR: to %s: %s\n", Sys_NetAdrToString( to ), strerror( errno ) );
 	}
 }
 
+/*
+==================
+idPort::BeginSendBatch
+==================
+*/
+void idPort::BeginSendBatch( void ) {
+	if ( batch && net_batchPackets.GetBool() ) {
+		batch->sending = true;
+	}
+}
+
+/*
+==================
+idPort::FlushSendBatch
+==================
+*/
+void idPort::FlushSendBatch( void ) {
+#if ID_NET_MMSG
+	if ( batch ) {
+		if ( batch->numSends ) {
+			sendCalls += SendPacketBatch( netSocket, batch );
+		}
+		batch->sending = false;
+	}
+#endif
+}
+
 /*
 ==================
 idPort::InitForPort
@@ -537,6 +748,16 @@ bool idPort::InitForPort( int portNumber ) {
 		memset( &bound_to, 0, sizeof( bound_to ) );
 		return false;
 	}
+#if ID_NET_MMSG
+	if ( !batch ) {
+		batch = new portBatch_t;
+	}
+	batch->numReceived = 0;
+	batch->nextReceived = 0;
+	batch->sending = false;
+	batch->numSends = 0;
+	batch->sendBufUsed = 0;
+#endif
 	return true;
 }
 
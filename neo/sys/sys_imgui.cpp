@@ -320,6 +320,10 @@ void NewFrame()
 		framesAfterAllWindowsClosed = 0;
 	}
 
+	// ImGui state and its font texture are also used by the back end,
+	// which may still be running the last frame on the render thread (r_smp)
+	R_SyncRenderThread();
+
 	if( imgui_scale.IsModified() ) {
 		imgui_scale.ClearModified();
 		ImGuiIO& io = ImGui::GetIO();
@@ -60,10 +60,26 @@ void idSysLocal::DebugVPrintf( const char *fmt, va_list arg ) {
 	Sys_DebugVPrintf( fmt, arg );
 }
 
+idParallelJobList *idSysLocal::AllocJobList( const char *name ) {
+	return Sys_AllocJobList( name );
+}
+
+void idSysLocal::FreeJobList( idParallelJobList *jobList ) {
+	Sys_FreeJobList( jobList );
+}
+
+int idSysLocal::NumJobThreads( void ) {
+	return Sys_NumJobThreads();
+}
+
 unsigned int idSysLocal::GetMilliseconds( void ) {
 	return Sys_Milliseconds();
 }
 
+double idSysLocal::GetMillisecondsPrecise( void ) {
+	return Sys_MillisecondsPrecise();
+}
+
 int idSysLocal::GetProcessorId( void ) {
 	return Sys_GetProcessorId();
 }
@@ -62,6 +62,12 @@ public:
 	virtual void			StartProcess( const char *exeName, bool quit );
 
 	virtual bool			IsGameWindowVisible( void );
+
+	virtual idParallelJobList *	AllocJobList( const char *name );
+	virtual void			FreeJobList( idParallelJobList *jobList );
+	virtual int				NumJobThreads( void );
+
+	virtual double			GetMillisecondsPrecise( void );
 };
 
 #endif /* !__SYS_LOCAL__ */
@@ -39,6 +39,7 @@ typedef enum {
 	CPUID_SSE							= 0x00040,	// Streaming SIMD Extensions
 	CPUID_SSE2							= 0x00080,	// Streaming SIMD Extensions 2
 	CPUID_SSE3							= 0x00100,	// Streaming SIMD Extentions 3 aka Prescott's New Instructions
+	CPUID_AVX2							= 0x00200,	// Advanced Vector Extensions 2, includes OS support for the ymm registers
 } cpuidSimd_t;
 
 typedef enum {
@@ -160,6 +161,8 @@ void			Sys_Sleep( int msec );
 // Sys_Milliseconds should only be used for profiling purposes,
 // any game related timing information should come from event timestamps
 unsigned int	Sys_Milliseconds( void );
+// like Sys_Milliseconds but with sub millisecond precision, for profiling only
+double			Sys_MillisecondsPrecise( void );
 
 // returns a selection of the CPUID_* flags
 int				Sys_GetProcessorId( void );
@@ -297,6 +300,8 @@ typedef struct {
 
 #define	PORT_ANY			-1
 
+typedef struct portBatch_s portBatch_t;
+
 class idPort {
 public:
 				idPort();				// this just zeros netSocket and port
@@ -312,15 +317,25 @@ public:
 	bool		GetPacketBlocking( netadr_t &from, void *data, int &size, int maxSize, int timeout );
 	void		SendPacket( const netadr_t to, const void *data, int size );
 
+				// packets sent in between are queued and sent with as few system calls as the platform allows
+	void		BeginSendBatch( void );
+	void		FlushSendBatch( void );
+
+	void		ResetStats( void ) { packetsRead = bytesRead = packetsWritten = bytesWritten = receiveCalls = sendCalls = 0; }
+
 	int			packetsRead;
 	int			bytesRead;
 
 	int			packetsWritten;
 	int			bytesWritten;
 
+	int			receiveCalls;	// system calls made to receive packets
+	int			sendCalls;		// system calls made to send packets
+
 private:
 	netadr_t	bound_to;		// interface and port
 	int			netSocket;		// OS specific socket
+	portBatch_t *batch;			// packets received and queued for sending in batches, NULL if the platform has no batched I/O
 };
 
 class idTCP {
@@ -412,6 +427,49 @@ enum {
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+/*
+==============================================================
+
+	Parallel jobs
+
+	Jobs are added to a job list and start running on the job threads once the
+	list is submitted. Wait() returns when every submitted job has finished, the
+	waiting thread runs queued jobs itself in the meantime. Each job thread owns
+	a queue of jobs and steals from the other queues once its own runs dry.
+
+==============================================================
+*/
+
+const int MAX_JOB_THREADS			= 16;
+
+typedef void (*jobRun_t)( void * );
+
+class idParallelJobList {
+public:
+	virtual					~idParallelJobList( void ) {}
+
+							// adds a job, it won't start before the next Submit
+	virtual void			AddJob( jobRun_t function, void *data ) = 0;
+							// hands all jobs added since the last Submit to the job threads
+	virtual void			Submit( void ) = 0;
+							// runs jobs until all submitted jobs have finished
+	virtual void			Wait( void ) = 0;
+							// returns true if all submitted jobs have finished
+	virtual bool			IsDone( void ) = 0;
+	virtual const char *	GetName( void ) const = 0;
+};
+
+// numThreads <= 0 uses one thread per core minus the main thread
+void				Sys_InitJobs( int numThreads );
+void				Sys_ShutdownJobs( void );
+int					Sys_NumJobThreads( void );
+
+idParallelJobList *	Sys_AllocJobList( const char *name );
+void				Sys_FreeJobList( idParallelJobList *jobList );
+
+// prints job thread and job list statistics
+void				Sys_ListJobs( void );
+
 /*
 ==============================================================
 
@@ -445,6 +503,12 @@ public:
 	virtual void			StartProcess( const char *exePath, bool quit ) = 0;
 
 	virtual bool			IsGameWindowVisible( void ) = 0;
+
+	virtual idParallelJobList *	AllocJobList( const char *name ) = 0;
+	virtual void			FreeJobList( idParallelJobList *jobList ) = 0;
+	virtual int				NumJobThreads( void ) = 0;
+
+	virtual double			GetMillisecondsPrecise( void ) = 0;
 };
 
 extern idSys *				sys;
@@ -75,6 +75,23 @@ unsigned int Sys_Milliseconds() {
 	return SDL_GetTicks();
 }
 
+/*
+================
+Sys_MillisecondsPrecise
+================
+*/
+double Sys_MillisecondsPrecise() {
+#if SDL_MAJOR_VERSION < 2
+	return SDL_GetTicks();
+#else
+	static double ticksPerMsec = 0.0;
+	if ( ticksPerMsec == 0.0 ) {
+		ticksPerMsec = SDL_GetPerformanceFrequency() / 1000.0;
+	}
+	return SDL_GetPerformanceCounter() / ticksPerMsec;
+#endif
+}
+
 /*
 ==================
 Sys_InitThreads
@@ -179,6 +196,7 @@ wait and trigger events
 we use a single lock to manipulate the conditions, CRITICAL_SECTION_SYS
 
 the semantics match the win32 version. signals raised while no one is waiting stay raised until a wait happens (which then does a simple pass-through)
+a wait only returns once the event was signaled, cond_wait may also wake up spuriously
 
 NOTE: we use the same mutex for all the events. I don't think this would become much of a problem
 cond_wait unlocks atomically with setting the wait condition, and locks it back before exiting the function
@@ -197,15 +215,14 @@ void Sys_WaitForEvent(int index) {
 	Sys_EnterCriticalSection(CRITICAL_SECTION_SYS);
 
 	assert(!waiting[index]);	// WaitForEvent from multiple threads? that wouldn't be good
-	if (signaled[index]) {
-		// emulate windows behaviour: signal has been raised already. clear and keep going
-		signaled[index] = false;
-	} else {
-		waiting[index] = true;
+	// emulate windows behaviour: if the signal has been raised already, clear and keep going
+	waiting[index] = true;
+	while (!signaled[index]) {
 		if (SDL_CondWait(cond[index], mutex[CRITICAL_SECTION_SYS]) != 0)
 			common->Error("ERROR: SDL_CondWait failed\n");
-		waiting[index] = false;
 	}
+	waiting[index] = false;
+	signaled[index] = false;
 
 	Sys_LeaveCriticalSection(CRITICAL_SECTION_SYS);
 }
@@ -220,12 +237,11 @@ void Sys_TriggerEvent(int index) {
 
 	Sys_EnterCriticalSection(CRITICAL_SECTION_SYS);
 
+	// emulate windows behaviour: if no thread is waiting, the signal stays on so next wait keeps going
+	signaled[index] = true;
 	if (waiting[index]) {
 		if (SDL_CondSignal(cond[index]) != 0)
 			common->Error("ERROR: SDL_CondSignal failed\n");
-	} else {
-		// emulate windows behaviour: if no thread is waiting, leave the signal on so next wait keeps going
-		signaled[index] = true;
 	}
 
 	Sys_LeaveCriticalSection(CRITICAL_SECTION_SYS);
@@ -345,3 +361,449 @@ bool Sys_IsMainThread() {
 	// any threads yet so it should be the main thread
 	return true;
 }
+
+/*
+======================================================
+parallel jobs
+
+every job thread owns a queue, Submit deals the jobs of a list out over the queues.
+a thread pops jobs from the back of its own queue and steals from the front of the
+others once it runs dry, the thread waiting on a list steals as well. idle threads
+sleep on jobSemaphore which Submit raises once per thread it wants to wake up.
+======================================================
+*/
+
+class idParallelJobListLocal;
+
+typedef struct {
+	jobRun_t					function;
+	void *						data;
+	idParallelJobListLocal *	list;
+} job_t;
+
+typedef struct {
+	SDL_mutex *		mutex;
+	idList<job_t>	jobs;
+	int				first;			// jobs before first have been taken from the front
+	int				numExecuted;
+	int				numStolen;
+} jobQueue_t;
+
+static xthreadInfo			jobThreads[MAX_JOB_THREADS];
+static char					jobThreadNames[MAX_JOB_THREADS][16];
+static jobQueue_t			jobQueues[MAX_JOB_THREADS + 1];	// the last queue is used when there are no job threads
+static int					numJobThreads = 0;
+static int					numJobQueues = 0;
+static int					nextJobQueue = 0;
+static SDL_sem *			jobSemaphore = NULL;
+static bool					jobsShutdown = false;
+static SDL_mutex *			jobListsMutex = NULL;
+static idList<idParallelJobListLocal *>	jobLists;
+
+/*
+==================
+Sys_JobMicroseconds
+==================
+*/
+static unsigned int Sys_JobMicroseconds( void ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	static Uint64 frequency = SDL_GetPerformanceFrequency();
+	return (unsigned int)( SDL_GetPerformanceCounter() * 1000000 / frequency );
+#else
+	return SDL_GetTicks() * 1000;
+#endif
+}
+
+/*
+==================
+Sys_FetchJob
+
+takes a job from the back of the queue owned by the thread, or steals one from the front of another queue.
+queueNum -1 only steals.
+==================
+*/
+static bool Sys_FetchJob( int queueNum, job_t &job ) {
+	if ( queueNum >= 0 ) {
+		jobQueue_t &queue = jobQueues[queueNum];
+		SDL_LockMutex( queue.mutex );
+		if ( queue.jobs.Num() > queue.first ) {
+			job = queue.jobs[queue.jobs.Num() - 1];
+			queue.jobs.SetNum( queue.jobs.Num() - 1, false );
+			if ( queue.jobs.Num() == queue.first ) {
+				queue.jobs.SetNum( 0, false );
+				queue.first = 0;
+			}
+			queue.numExecuted++;
+			SDL_UnlockMutex( queue.mutex );
+			return true;
+		}
+		SDL_UnlockMutex( queue.mutex );
+	}
+
+	for ( int i = 1; i <= numJobQueues; i++ ) {
+		jobQueue_t &queue = jobQueues[( queueNum + i + numJobQueues ) % numJobQueues];
+		SDL_LockMutex( queue.mutex );
+		if ( queue.jobs.Num() > queue.first ) {
+			job = queue.jobs[queue.first++];
+			if ( queue.jobs.Num() == queue.first ) {
+				queue.jobs.SetNum( 0, false );
+				queue.first = 0;
+			}
+			queue.numStolen++;
+			SDL_UnlockMutex( queue.mutex );
+			return true;
+		}
+		SDL_UnlockMutex( queue.mutex );
+	}
+
+	return false;
+}
+
+/*
+======================================================
+idParallelJobListLocal
+======================================================
+*/
+
+class idParallelJobListLocal : public idParallelJobList {
+public:
+							idParallelJobListLocal( const char *name );
+	virtual					~idParallelJobListLocal( void );
+
+	virtual void			AddJob( jobRun_t function, void *data );
+	virtual void			Submit( void );
+	virtual void			Wait( void );
+	virtual bool			IsDone( void );
+	virtual const char *	GetName( void ) const { return name.c_str(); }
+
+	void					JobDone( void );
+	void					Print( void ) const;
+
+private:
+	idStr					name;
+	idList<job_t>			pending;
+	SDL_mutex *				mutex;
+	SDL_cond *				done;
+	int						numRunning;			// submitted jobs that haven't finished yet
+
+	int						numSubmits;
+	int						numJobs;
+	unsigned int			submitTime;
+	unsigned int			lastTime;			// microseconds from Submit until Wait returned
+	unsigned int			peakTime;
+	double					totalTime;
+};
+
+/*
+==================
+idParallelJobListLocal::idParallelJobListLocal
+==================
+*/
+idParallelJobListLocal::idParallelJobListLocal( const char *name ) {
+	this->name = name;
+	pending.SetGranularity( 64 );
+	mutex = SDL_CreateMutex();
+	done = SDL_CreateCond();
+	numRunning = 0;
+	numSubmits = 0;
+	numJobs = 0;
+	submitTime = 0;
+	lastTime = 0;
+	peakTime = 0;
+	totalTime = 0.0;
+}
+
+/*
+==================
+idParallelJobListLocal::~idParallelJobListLocal
+==================
+*/
+idParallelJobListLocal::~idParallelJobListLocal( void ) {
+	Wait();
+	SDL_DestroyCond( done );
+	SDL_DestroyMutex( mutex );
+}
+
+/*
+==================
+idParallelJobListLocal::AddJob
+==================
+*/
+void idParallelJobListLocal::AddJob( jobRun_t function, void *data ) {
+	job_t &job = pending.Alloc();
+	job.function = function;
+	job.data = data;
+	job.list = this;
+}
+
+/*
+==================
+idParallelJobListLocal::Submit
+==================
+*/
+void idParallelJobListLocal::Submit( void ) {
+	if ( !pending.Num() ) {
+		return;
+	}
+
+	numSubmits++;
+	numJobs += pending.Num();
+
+	if ( !numJobQueues ) {
+		// the job system isn't running (yet), so just run everything right here
+		for ( int i = 0; i < pending.Num(); i++ ) {
+			pending[i].function( pending[i].data );
+		}
+		pending.SetNum( 0, false );
+		return;
+	}
+
+	SDL_LockMutex( mutex );
+	if ( !numRunning ) {
+		submitTime = Sys_JobMicroseconds();
+	}
+	numRunning += pending.Num();
+	SDL_UnlockMutex( mutex );
+
+	// deal the jobs out in contiguous runs so neighbouring jobs tend to run on the same thread
+	int queueNum = nextJobQueue;
+	int perQueue = ( pending.Num() + numJobQueues - 1 ) / numJobQueues;
+	for ( int i = 0; i < pending.Num(); i += perQueue ) {
+		jobQueue_t &queue = jobQueues[queueNum];
+		int num = Min( perQueue, pending.Num() - i );
+		SDL_LockMutex( queue.mutex );
+		for ( int j = 0; j < num; j++ ) {
+			queue.jobs.Append( pending[i + j] );
+		}
+		SDL_UnlockMutex( queue.mutex );
+		queueNum = ( queueNum + 1 ) % numJobQueues;
+	}
+	nextJobQueue = queueNum;
+
+	for ( int i = Min( pending.Num(), numJobThreads ); i > 0; i-- ) {
+		SDL_SemPost( jobSemaphore );
+	}
+
+	pending.SetNum( 0, false );
+}
+
+/*
+==================
+idParallelJobListLocal::Wait
+==================
+*/
+void idParallelJobListLocal::Wait( void ) {
+	job_t job;
+
+	// help out until there is nothing left to take, then sleep until the running jobs are done
+	while ( !IsDone() && Sys_FetchJob( -1, job ) ) {
+		job.function( job.data );
+		job.list->JobDone();
+	}
+
+	SDL_LockMutex( mutex );
+	while ( numRunning > 0 ) {
+		SDL_CondWait( done, mutex );
+	}
+	SDL_UnlockMutex( mutex );
+}
+
+/*
+==================
+idParallelJobListLocal::IsDone
+==================
+*/
+bool idParallelJobListLocal::IsDone( void ) {
+	SDL_LockMutex( mutex );
+	bool isDone = ( numRunning == 0 );
+	SDL_UnlockMutex( mutex );
+	return isDone;
+}
+
+/*
+==================
+idParallelJobListLocal::JobDone
+==================
+*/
+void idParallelJobListLocal::JobDone( void ) {
+	SDL_LockMutex( mutex );
+	if ( --numRunning == 0 ) {
+		lastTime = Sys_JobMicroseconds() - submitTime;
+		peakTime = Max( peakTime, lastTime );
+		totalTime += lastTime;
+		SDL_CondBroadcast( done );
+	}
+	SDL_UnlockMutex( mutex );
+}
+
+/*
+==================
+idParallelJobListLocal::Print
+==================
+*/
+void idParallelJobListLocal::Print( void ) const {
+	common->Printf( "%-24s %8d %10d %10u %10u %10.0f\n", name.c_str(), numSubmits, numJobs, lastTime, peakTime, numSubmits ? totalTime / numSubmits : 0.0 );
+}
+
+/*
+==================
+Sys_JobThread
+==================
+*/
+static int Sys_JobThread( void *parms ) {
+	int queueNum = (int)(intptr_t)parms;
+	job_t job;
+
+	while ( true ) {
+		SDL_SemWait( jobSemaphore );
+		SDL_LockMutex( jobListsMutex );
+		bool shutdown = jobsShutdown;
+		SDL_UnlockMutex( jobListsMutex );
+		if ( shutdown ) {
+			break;
+		}
+		while ( Sys_FetchJob( queueNum, job ) ) {
+			job.function( job.data );
+			job.list->JobDone();
+		}
+	}
+
+	return 0;
+}
+
+/*
+==================
+Sys_InitJobs
+==================
+*/
+void Sys_InitJobs( int numThreads ) {
+	if ( numThreads <= 0 ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		numThreads = SDL_GetCPUCount() - 1;
+#else
+		numThreads = 0;
+#endif
+	}
+	numThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, numThreads );
+
+	if ( !jobListsMutex ) {
+		jobListsMutex = SDL_CreateMutex();
+	}
+	jobSemaphore = SDL_CreateSemaphore( 0 );
+	jobsShutdown = false;
+
+	numJobThreads = numThreads;
+	numJobQueues = Max( numThreads, 1 );
+	nextJobQueue = 0;
+	for ( int i = 0; i < numJobQueues; i++ ) {
+		jobQueues[i].mutex = SDL_CreateMutex();
+		jobQueues[i].jobs.SetGranularity( 256 );
+		jobQueues[i].first = 0;
+		jobQueues[i].numExecuted = 0;
+		jobQueues[i].numStolen = 0;
+	}
+
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		idStr::snPrintf( jobThreadNames[i], sizeof( jobThreadNames[i] ), "job%d", i );
+		Sys_CreateThread( Sys_JobThread, (void *)(intptr_t)i, jobThreads[i], jobThreadNames[i] );
+	}
+
+	common->Printf( "%d job threads\n", numJobThreads );
+}
+
+/*
+==================
+Sys_ShutdownJobs
+
+all job lists must have been waited on
+==================
+*/
+void Sys_ShutdownJobs( void ) {
+	if ( !jobSemaphore ) {
+		return;
+	}
+
+	SDL_LockMutex( jobListsMutex );
+	jobsShutdown = true;
+	SDL_UnlockMutex( jobListsMutex );
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		SDL_SemPost( jobSemaphore );
+	}
+	for ( int i = 0; i < numJobThreads; i++ ) {
+		Sys_DestroyThread( jobThreads[i] );
+	}
+
+	for ( int i = 0; i < numJobQueues; i++ ) {
+		assert( jobQueues[i].jobs.Num() == jobQueues[i].first );
+		jobQueues[i].jobs.Clear();
+		SDL_DestroyMutex( jobQueues[i].mutex );
+		jobQueues[i].mutex = NULL;
+	}
+
+	SDL_DestroySemaphore( jobSemaphore );
+	jobSemaphore = NULL;
+	numJobThreads = 0;
+	numJobQueues = 0;
+}
+
+/*
+==================
+Sys_NumJobThreads
+==================
+*/
+int Sys_NumJobThreads( void ) {
+	return numJobThreads;
+}
+
+/*
+==================
+Sys_AllocJobList
+==================
+*/
+idParallelJobList *Sys_AllocJobList( const char *name ) {
+	idParallelJobListLocal *jobList = new idParallelJobListLocal( name );
+
+	SDL_LockMutex( jobListsMutex );
+	jobLists.Append( jobList );
+	SDL_UnlockMutex( jobListsMutex );
+
+	return jobList;
+}
+
+/*
+==================
+Sys_FreeJobList
+==================
+*/
+void Sys_FreeJobList( idParallelJobList *jobList ) {
+	if ( !jobList ) {
+		return;
+	}
+
+	SDL_LockMutex( jobListsMutex );
+	jobLists.Remove( static_cast<idParallelJobListLocal *>( jobList ) );
+	SDL_UnlockMutex( jobListsMutex );
+
+	delete jobList;
+}
+
+/*
+==================
+Sys_ListJobs
+==================
+*/
+void Sys_ListJobs( void ) {
+	common->Printf( "%d job threads\n", numJobThreads );
+	common->Printf( "queue      own   stolen\n" );
+	for ( int i = 0; i < numJobQueues; i++ ) {
+		common->Printf( "%5d %8d %8d\n", i, jobQueues[i].numExecuted, jobQueues[i].numStolen );
+	}
+
+	common->Printf( "\n%-24s %8s %10s %10s %10s %10s\n", "job list", "submits", "jobs", "last usec", "peak usec", "avg usec" );
+	SDL_LockMutex( jobListsMutex );
+	for ( int i = 0; i < jobLists.Num(); i++ ) {
+		jobLists[i]->Print();
+	}
+	SDL_UnlockMutex( jobListsMutex );
+	common->Printf( "%d job lists\n", jobLists.Num() );
+}
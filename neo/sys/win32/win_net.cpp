@@ -660,6 +660,8 @@ idPort::idPort
 idPort::idPort() {
 	netSocket = 0;
 	memset( &bound_to, 0, sizeof( bound_to ) );
+	batch = NULL;
+	ResetStats();
 }
 
 /*
@@ -718,6 +720,7 @@ bool idPort::GetPacket( netadr_t &from, void *data, int &size, int maxSize ) {
 	while( 1 ) {
 
 		ret = Net_GetUDPPacket( netSocket, from, (char *)data, size, maxSize );
+		receiveCalls++;
 		if ( !ret ) {
 			break;
 		}
@@ -828,6 +831,7 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 
 		for ( msg = udpPorts[ bound_to.port ]->sendFirst; msg && msg->time <= Sys_Milliseconds() - net_forceLatency.GetInteger(); msg = udpPorts[ bound_to.port ]->sendFirst ) {
 			Net_SendUDPPacket( netSocket, msg->size, msg->data, msg->address );
+			sendCalls++;
 			udpPorts[ bound_to.port ]->sendFirst = udpPorts[ bound_to.port ]->sendFirst->next;
 			if ( !udpPorts[ bound_to.port ]->sendFirst ) {
 				udpPorts[ bound_to.port ]->sendLast = NULL;
@@ -837,9 +841,28 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 
 	} else {
 		Net_SendUDPPacket( netSocket, size, data, to );
+		sendCalls++;
 	}
 }
 
+/*
+==================
+idPort::BeginSendBatch
+
+Winsock has no call to send several datagrams at once, packets are sent as they come.
+==================
+*/
+void idPort::BeginSendBatch( void ) {
+}
+
+/*
+==================
+idPort::FlushSendBatch
+==================
+*/
+void idPort::FlushSendBatch( void ) {
+}
+
 
 //=============================================================================
 
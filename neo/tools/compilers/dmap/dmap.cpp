@@ -31,8 +31,69 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "dmap.h"
 
+#include <atomic>
+
 dmapGlobals_t	dmapGlobals;
 
+typedef struct {
+	uEntity_t			*entity;
+	areaJob_t			func;
+	void				*data;
+	std::atomic<int>	nextArea;
+} areaJobs_t;
+
+/*
+============
+AreaJobRunner
+
+Every area is handed out once, and each area only writes its own
+triangle lists, so the output doesn't depend on which thread ran it
+============
+*/
+static void AreaJobRunner( void *data ) {
+	areaJobs_t *jobs = (areaJobs_t *)data;
+
+	for ( int areaNum = jobs->nextArea++ ; areaNum < jobs->entity->numAreas ; areaNum = jobs->nextArea++ ) {
+		jobs->func( jobs->entity, areaNum, jobs->data );
+	}
+}
+
+/*
+============
+RunAreaJobs
+============
+*/
+void RunAreaJobs( uEntity_t *e, areaJob_t func, void *data ) {
+	int numRunners = Min( dmapGlobals.numThreads, e->numAreas );
+
+	if ( numRunners <= 1 ) {
+		for ( int i = 0 ; i < e->numAreas ; i++ ) {
+			func( e, i, data );
+		}
+		return;
+	}
+
+	// the verbose prints would interleave between threads
+	bool oldVerbose = dmapGlobals.verbose;
+	dmapGlobals.verbose = false;
+
+	areaJobs_t jobs;
+	jobs.entity = e;
+	jobs.func = func;
+	jobs.data = data;
+	jobs.nextArea = 0;
+
+	idParallelJobList *jobList = Sys_AllocJobList( "dmap" );
+	for ( int i = 0 ; i < numRunners ; i++ ) {
+		jobList->AddJob( AreaJobRunner, &jobs );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	Sys_FreeJobList( jobList );
+
+	dmapGlobals.verbose = oldVerbose;
+}
+
 /*
 ============
 ProcessModel
@@ -177,6 +238,7 @@ void DmapHelp( void ) {
 	"noCurves          = don't process curves\n"
 	"noCM              = don't create collision map\n"
 	"noAAS             = don't create AAS files\n"
+	"threads <n>       = optimize areas on n threads, 0 uses all job threads\n"
 
 	);
 }
@@ -209,6 +271,7 @@ void ResetDmapGlobals( void ) {
 	dmapGlobals.noStats = false;
 	dmapGlobals.noCM = false;
 	dmapGlobals.noAAS = false;
+	dmapGlobals.numThreads = 1;
 	dmapGlobals.shadowOptLevel = SO_NONE;
 	dmapGlobals.drawBounds.Clear();
 	dmapGlobals.drawflag = false;
@@ -308,6 +371,14 @@ void Dmap( const idCmdArgs &args ) {
 		} else if ( !idStr::Icmp( s, "noStats" ) ) {
 			dmapGlobals.noStats = true;
 			common->Printf( "noStats = true\n" );
+		} else if ( !idStr::Icmp( s, "threads" ) ) {
+			dmapGlobals.numThreads = atoi( args.Argv( i+1 ) );
+			if ( dmapGlobals.numThreads <= 0 ) {
+				dmapGlobals.numThreads = Sys_NumJobThreads() + 1;
+			}
+			dmapGlobals.numThreads = Min( dmapGlobals.numThreads, MAX_JOB_THREADS + 1 );
+			common->Printf( "threads = %i\n", dmapGlobals.numThreads );
+			i += 1;
 		} else if ( !idStr::Icmp( s, "editorOutput" ) ) {
 #ifdef _WIN32
 			com_outputMsg = true;
@@ -321,6 +392,12 @@ void Dmap( const idCmdArgs &args ) {
 		common->Error( "usage: dmap [options] mapfile" );
 	}
 
+	if ( dmapGlobals.drawflag && dmapGlobals.numThreads > 1 ) {
+		// the optimizer debug drawing isn't thread safe
+		common->Printf( "forcing threads = 1 for draw\n" );
+		dmapGlobals.numThreads = 1;
+	}
+
 	passedName = args.Argv(i);		// may have an extension
 	passedName.BackSlashesToSlashes();
 	if ( passedName.Icmpn( "maps/", 4 ) != 0 ) {
@@ -374,6 +451,22 @@ void Dmap( const idCmdArgs &args ) {
 
 	if ( !leaked ) {
 
+		// the old .bproc may carry the same timestamp as the new .proc,
+		// so remove it and let the renderer parse the text into a new one
+		idStr::snPrintf( path, sizeof( path ), "%s." BPROC_FILE_EXT, dmapGlobals.mapFileBase );
+		fileSystem->RemoveFile( path );
+		if ( r_binaryProc.GetBool() ) {
+			start = Sys_Milliseconds();
+
+			idRenderWorld *world = renderSystem->AllocRenderWorld();
+			world->InitFromMap( dmapGlobals.mapFileBase );
+			renderSystem->FreeRenderWorld( world );
+
+			end = Sys_Milliseconds();
+			common->Printf( "-------------------------------------\n" );
+			common->Printf( "%5.0f seconds to create %s\n", ( end - start ) * 0.001f, path );
+		}
+
 		if ( !dmapGlobals.noCM ) {
 
 			// make sure the collision model manager is not used by the game
@@ -325,6 +325,7 @@ typedef struct {
 	bool	noStats;			// don't print timing stats
 	bool	noCM;				// don't create collision map
 	bool	noAAS;				// don't create AAS files
+	int		numThreads;			// areas optimized and t junction fixed at once
 
 	idBounds	drawBounds;
 	bool	drawflag;
@@ -347,6 +348,11 @@ typedef struct {
 
 extern dmapGlobals_t dmapGlobals;
 
+// calls func( e, areaNum, data ) once for every area of the entity, spread over
+// dmapGlobals.numThreads job threads; areas must not touch each other's data
+typedef void (*areaJob_t)( uEntity_t *e, int areaNum, void *data );
+void	RunAreaJobs( uEntity_t *e, areaJob_t func, void *data );
+
 int FindFloatPlane( const idPlane &plane, bool *fixedDegeneracies = NULL );
 
 
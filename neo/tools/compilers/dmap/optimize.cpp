@@ -41,15 +41,17 @@ If you have questions concerning this license or the applicable additional terms
 
 */
 
-idBounds	optBounds;
+// the optimizer working set is per thread, so dmap -threads can
+// optimize several areas at once
+static	thread_local idBounds	optBounds;
 
 #define	MAX_OPT_VERTEXES	0x10000
-int			numOptVerts;
-optVertex_t optVerts[MAX_OPT_VERTEXES];
+static	thread_local int			numOptVerts;
+static	thread_local optVertex_t	*optVerts;
 
 #define	MAX_OPT_EDGES		0x40000
-static	int		numOptEdges;
-static	optEdge_t	optEdges[MAX_OPT_EDGES];
+static	thread_local int			numOptEdges;
+static	thread_local optEdge_t		*optEdges;
 
 static bool IsTriangleValid( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
 static bool IsTriangleDegenerate( const optVertex_t *v1, const optVertex_t *v2, const optVertex_t *v3 );
@@ -1156,8 +1158,8 @@ typedef struct edgeCrossing_s {
 	optVertex_t		*ov;
 } edgeCrossing_t;
 
-static	originalEdges_t	*originalEdges;
-static	int				numOriginalEdges;
+static	thread_local originalEdges_t	*originalEdges;
+static	thread_local int				numOriginalEdges;
 
 /*
 =================
@@ -1249,13 +1251,15 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t *opt ) {
 	// now split any crossing edges and create optEdges
 	// linked to the vertexes
 
-	// debug drawing bounds
-	dmapGlobals.drawBounds = optBounds;
+	// debug drawing bounds, draw forces a single thread
+	if ( dmapGlobals.drawflag ) {
+		dmapGlobals.drawBounds = optBounds;
 
-	dmapGlobals.drawBounds[0][0] -= 2;
-	dmapGlobals.drawBounds[0][1] -= 2;
-	dmapGlobals.drawBounds[1][0] += 2;
-	dmapGlobals.drawBounds[1][1] += 2;
+		dmapGlobals.drawBounds[0][0] -= 2;
+		dmapGlobals.drawBounds[0][1] -= 2;
+		dmapGlobals.drawBounds[1][0] += 2;
+		dmapGlobals.drawBounds[1][1] += 2;
+	}
 
 	// generate crossing points between all the original edges
 	crossings = (edgeCrossing_t **)Mem_ClearedAlloc( numOriginalEdges * sizeof( *crossings ) );
@@ -1679,9 +1683,15 @@ void	OptimizeGroupList( optimizeGroup_t *groupList ) {
 
 	// optimize and remove colinear edges, which will
 	// re-introduce some t junctions
+	optVerts = (optVertex_t *)Mem_Alloc( MAX_OPT_VERTEXES * sizeof( *optVerts ) );
+	optEdges = (optEdge_t *)Mem_Alloc( MAX_OPT_EDGES * sizeof( *optEdges ) );
 	for ( group = groupList ; group ; group = group->nextGroup ) {
 		OptimizeOptList( group );
 	}
+	Mem_Free( optVerts );
+	Mem_Free( optEdges );
+	optVerts = NULL;
+	optEdges = NULL;
 	c_edge = CountGroupListTris( groupList );
 
 	// fix t junctions again
@@ -1703,11 +1713,13 @@ void	OptimizeGroupList( optimizeGroup_t *groupList ) {
 OptimizeEntity
 ==================
 */
-void	OptimizeEntity( uEntity_t *e ) {
-	int		i;
+static void OptimizeArea( uEntity_t *e, int areaNum, void *data ) {
+	OptimizeGroupList( e->areas[areaNum].groups );
+}
 
+void	OptimizeEntity( uEntity_t *e ) {
 	common->VerbosePrintf( "----- OptimizeEntity -----\n" );
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		OptimizeGroupList( e->areas[i].groups );
-	}
+
+	// areas never share triangles, so they can be optimized independently
+	RunAreaJobs( e, OptimizeArea, NULL );
 }
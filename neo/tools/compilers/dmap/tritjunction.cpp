@@ -93,11 +93,23 @@ typedef struct hashVert_s {
 	int					iv[3];
 } hashVert_t;
 
-static idBounds	hashBounds;
-static idVec3	hashScale;
-static hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
-static int		numHashVerts, numTotalVerts;
-static int		hashIntMins[3], hashIntScale[3];
+typedef struct tjunctionHash_s {
+	idBounds	hashBounds;
+	idVec3		hashScale;
+	hashVert_t	*hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
+	int			numHashVerts, numTotalVerts;
+	int			hashIntMins[3], hashIntScale[3];
+} tjunctionHash_t;
+
+// every thread builds its own hash, so dmap -threads can fix several
+// areas at once, while FixGlobalTjunctions lets its area jobs read the
+// hash of the thread that built it
+static thread_local tjunctionHash_t	threadHash;
+static thread_local tjunctionHash_t	*sharedHash;
+
+static tjunctionHash_t &CurrentHash( void ) {
+	return sharedHash ? *sharedHash : threadHash;
+}
 
 /*
 ===============
@@ -107,17 +119,18 @@ Also modifies the original vert to the snapped value
 ===============
 */
 struct hashVert_s	*GetHashVert( idVec3 &v ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	int		iv[3];
 	int		block[3];
 	int		i;
 	hashVert_t	*hv;
 
-	numTotalVerts++;
+	hash.numTotalVerts++;
 
 	// snap the vert to integral values
 	for ( i = 0 ; i < 3 ; i++ ) {
 		iv[i] = floor( ( v[i] + 0.5/SNAP_FRACTIONS ) * SNAP_FRACTIONS );
-		block[i] = ( iv[i] - hashIntMins[i] ) / hashIntScale[i];
+		block[i] = ( iv[i] - hash.hashIntMins[i] ) / hash.hashIntScale[i];
 		if ( block[i] < 0 ) {
 			block[i] = 0;
 		} else if ( block[i] >= HASH_BINS ) {
@@ -127,7 +140,7 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 
 	// see if a vertex near enough already exists
 	// this could still fail to find a near neighbor right at the hash block boundary
-	for ( hv = hashVerts[block[0]][block[1]][block[2]] ; hv ; hv = hv->next ) {
+	for ( hv = hash.hashVerts[block[0]][block[1]][block[2]] ; hv ; hv = hv->next ) {
 #if 0
 		if ( hv->iv[0] == iv[0] && hv->iv[1] == iv[1] && hv->iv[2] == iv[2] ) {
 			VectorCopy( hv->v, v );
@@ -151,8 +164,8 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 	// create a new one
 	hv = (hashVert_t *)Mem_Alloc( sizeof( *hv ) );
 
-	hv->next = hashVerts[block[0]][block[1]][block[2]];
-	hashVerts[block[0]][block[1]][block[2]] = hv;
+	hv->next = hash.hashVerts[block[0]][block[1]][block[2]];
+	hash.hashVerts[block[0]][block[1]][block[2]] = hv;
 
 	hv->iv[0] = iv[0];
 	hv->iv[1] = iv[1];
@@ -164,7 +177,7 @@ struct hashVert_s	*GetHashVert( idVec3 &v ) {
 
 	VectorCopy( hv->v, v );
 
-	numHashVerts++;
+	hash.numHashVerts++;
 
 	return hv;
 }
@@ -179,6 +192,7 @@ bins that should hold the triangle
 ==================
 */
 static void HashBlocksForTri( const mapTri_t *tri, int blocks[2][3] ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	idBounds	bounds;
 	int			i;
 
@@ -189,14 +203,14 @@ static void HashBlocksForTri( const mapTri_t *tri, int blocks[2][3] ) {
 
 	// add a 1.0 slop margin on each side
 	for ( i = 0 ; i < 3 ; i++ ) {
-		blocks[0][i] = ( bounds[0][i] - 1.0 - hashBounds[0][i] ) / hashScale[i];
+		blocks[0][i] = ( bounds[0][i] - 1.0 - hash.hashBounds[0][i] ) / hash.hashScale[i];
 		if ( blocks[0][i] < 0 ) {
 			blocks[0][i] = 0;
 		} else if ( blocks[0][i] >= HASH_BINS ) {
 			blocks[0][i] = HASH_BINS - 1;
 		}
 
-		blocks[1][i] = ( bounds[1][i] + 1.0 - hashBounds[0][i] ) / hashScale[i];
+		blocks[1][i] = ( bounds[1][i] + 1.0 - hash.hashBounds[0][i] ) / hash.hashScale[i];
 		if ( blocks[1][i] < 0 ) {
 			blocks[1][i] = 0;
 		} else if ( blocks[1][i] >= HASH_BINS ) {
@@ -214,37 +228,38 @@ Removes triangles that are degenerated or flipped backwards
 =================
 */
 void HashTriangles( optimizeGroup_t *groupList ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	mapTri_t	*a;
 	int			vert;
 	int			i;
 	optimizeGroup_t	*group;
 
 	// clear the hash tables
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash.hashVerts, 0, sizeof( hash.hashVerts ) );
 
-	numHashVerts = 0;
-	numTotalVerts = 0;
+	hash.numHashVerts = 0;
+	hash.numTotalVerts = 0;
 
 	// bound all the triangles to determine the bucket size
-	hashBounds.Clear();
+	hash.hashBounds.Clear();
 	for ( group = groupList ; group ; group = group->nextGroup ) {
 		for ( a = group->triList ; a ; a = a->next ) {
-			hashBounds.AddPoint( a->v[0].xyz );
-			hashBounds.AddPoint( a->v[1].xyz );
-			hashBounds.AddPoint( a->v[2].xyz );
+			hash.hashBounds.AddPoint( a->v[0].xyz );
+			hash.hashBounds.AddPoint( a->v[1].xyz );
+			hash.hashBounds.AddPoint( a->v[2].xyz );
 		}
 	}
 
 	// spread the bounds so it will never have a zero size
 	for ( i = 0 ; i < 3 ; i++ ) {
-		hashBounds[0][i] = floor( hashBounds[0][i] - 1 );
-		hashBounds[1][i] = ceil( hashBounds[1][i] + 1 );
-		hashIntMins[i] = hashBounds[0][i] * SNAP_FRACTIONS;
-
-		hashScale[i] = ( hashBounds[1][i] - hashBounds[0][i] ) / HASH_BINS;
-		hashIntScale[i] = hashScale[i] * SNAP_FRACTIONS;
-		if ( hashIntScale[i] < 1 ) {
-			hashIntScale[i] = 1;
+		hash.hashBounds[0][i] = floor( hash.hashBounds[0][i] - 1 );
+		hash.hashBounds[1][i] = ceil( hash.hashBounds[1][i] + 1 );
+		hash.hashIntMins[i] = hash.hashBounds[0][i] * SNAP_FRACTIONS;
+
+		hash.hashScale[i] = ( hash.hashBounds[1][i] - hash.hashBounds[0][i] ) / HASH_BINS;
+		hash.hashIntScale[i] = hash.hashScale[i] * SNAP_FRACTIONS;
+		if ( hash.hashIntScale[i] < 1 ) {
+			hash.hashIntScale[i] = 1;
 		}
 	}
 
@@ -271,20 +286,21 @@ after t junction processing
 =================
 */
 void FreeTJunctionHash( void ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	int			i, j, k;
 	hashVert_t	*hv, *next;
 
 	for ( i = 0 ; i < HASH_BINS ; i++ ) {
 		for ( j = 0 ; j < HASH_BINS ; j++ ) {
 			for ( k = 0 ; k < HASH_BINS ; k++ ) {
-				for ( hv = hashVerts[i][j][k] ; hv ; hv = next ) {
+				for ( hv = hash.hashVerts[i][j][k] ; hv ; hv = next ) {
 					next = hv->next;
 					Mem_Free( hv );
 				}
 			}
 		}
 	}
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash.hashVerts, 0, sizeof( hash.hashVerts ) );
 }
 
 
@@ -394,6 +410,7 @@ Potentially splits a triangle into a list of triangles based on tjunctions
 ==================
 */
 static mapTri_t	*FixTriangleAgainstHash( const mapTri_t *tri ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	mapTri_t		*fixed;
 	mapTri_t		*a;
 	mapTri_t		*test, *next;
@@ -417,7 +434,7 @@ static mapTri_t	*FixTriangleAgainstHash( const mapTri_t *tri ) {
 	for ( i = blocks[0][0] ; i <= blocks[1][0] ; i++ ) {
 		for ( j = blocks[0][1] ; j <= blocks[1][1] ; j++ ) {
 			for ( k = blocks[0][2] ; k <= blocks[1][2] ; k++ ) {
-				for ( hv = hashVerts[i][j][k] ; hv ; hv = hv->next ) {
+				for ( hv = hash.hashVerts[i][j][k] ; hv ; hv = hv->next ) {
 					// fix all triangles in the list against this point
 					test = fixed;
 					fixed = NULL;
@@ -511,13 +528,43 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t *groupList ) {
 FixEntityTjunctions
 ==================
 */
+static void FixAreaTjunctions( uEntity_t *e, int areaNum, void *data ) {
+	FixAreaGroupsTjunctions( e->areas[areaNum].groups );
+	FreeTJunctionHash();
+}
+
 void	FixEntityTjunctions( uEntity_t *e ) {
-	int		i;
+	RunAreaJobs( e, FixAreaTjunctions, NULL );
+}
+
+/*
+==================
+FixAreaAgainstHash
+
+Fixes one area against the global hash, which is only read
+==================
+*/
+static void FixAreaAgainstHash( uEntity_t *e, int areaNum, void *data ) {
+	optimizeGroup_t	*group;
+
+	sharedHash = (tjunctionHash_t *)data;
+
+	for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
+		// don't touch discrete surfaces
+		if ( group->material != NULL && group->material->IsDiscrete() ) {
+			continue;
+		}
 
-	for ( i = 0 ; i < e->numAreas ; i++ ) {
-		FixAreaGroupsTjunctions( e->areas[i].groups );
-		FreeTJunctionHash();
+		mapTri_t *newList = NULL;
+		for ( mapTri_t *tri = group->triList ; tri ; tri = tri->next ) {
+			mapTri_t *fixed = FixTriangleAgainstHash( tri );
+			newList = MergeTriLists( newList, fixed );
+		}
+		FreeTriList( group->triList );
+		group->triList = newList;
 	}
+
+	sharedHash = NULL;
 }
 
 /*
@@ -526,6 +573,7 @@ FixGlobalTjunctions
 ==================
 */
 void	FixGlobalTjunctions( uEntity_t *e ) {
+	tjunctionHash_t	&hash = CurrentHash();
 	mapTri_t	*a;
 	int			vert;
 	int			i;
@@ -535,33 +583,33 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 	common->VerbosePrintf( "----- FixGlobalTjunctions -----\n" );
 
 	// clear the hash tables
-	memset( hashVerts, 0, sizeof( hashVerts ) );
+	memset( hash.hashVerts, 0, sizeof( hash.hashVerts ) );
 
-	numHashVerts = 0;
-	numTotalVerts = 0;
+	hash.numHashVerts = 0;
+	hash.numTotalVerts = 0;
 
 	// bound all the triangles to determine the bucket size
-	hashBounds.Clear();
+	hash.hashBounds.Clear();
 	for ( areaNum = 0 ; areaNum < e->numAreas ; areaNum++ ) {
 		for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
 			for ( a = group->triList ; a ; a = a->next ) {
-				hashBounds.AddPoint( a->v[0].xyz );
-				hashBounds.AddPoint( a->v[1].xyz );
-				hashBounds.AddPoint( a->v[2].xyz );
+				hash.hashBounds.AddPoint( a->v[0].xyz );
+				hash.hashBounds.AddPoint( a->v[1].xyz );
+				hash.hashBounds.AddPoint( a->v[2].xyz );
 			}
 		}
 	}
 
 	// spread the bounds so it will never have a zero size
 	for ( i = 0 ; i < 3 ; i++ ) {
-		hashBounds[0][i] = floor( hashBounds[0][i] - 1 );
-		hashBounds[1][i] = ceil( hashBounds[1][i] + 1 );
-		hashIntMins[i] = hashBounds[0][i] * SNAP_FRACTIONS;
-
-		hashScale[i] = ( hashBounds[1][i] - hashBounds[0][i] ) / HASH_BINS;
-		hashIntScale[i] = hashScale[i] * SNAP_FRACTIONS;
-		if ( hashIntScale[i] < 1 ) {
-			hashIntScale[i] = 1;
+		hash.hashBounds[0][i] = floor( hash.hashBounds[0][i] - 1 );
+		hash.hashBounds[1][i] = ceil( hash.hashBounds[1][i] + 1 );
+		hash.hashIntMins[i] = hash.hashBounds[0][i] * SNAP_FRACTIONS;
+
+		hash.hashScale[i] = ( hash.hashBounds[1][i] - hash.hashBounds[0][i] ) / HASH_BINS;
+		hash.hashIntScale[i] = hash.hashScale[i] * SNAP_FRACTIONS;
+		if ( hash.hashIntScale[i] < 1 ) {
+			hash.hashIntScale[i] = 1;
 		}
 	}
 
@@ -637,22 +685,7 @@ void	FixGlobalTjunctions( uEntity_t *e ) {
 
 
 	// now fix each area
-	for ( areaNum = 0 ; areaNum < e->numAreas ; areaNum++ ) {
-		for ( group = e->areas[areaNum].groups ; group ; group = group->nextGroup ) {
-			// don't touch discrete surfaces
-			if ( group->material != NULL && group->material->IsDiscrete() ) {
-				continue;
-			}
-
-			mapTri_t *newList = NULL;
-			for ( mapTri_t *tri = group->triList ; tri ; tri = tri->next ) {
-				mapTri_t *fixed = FixTriangleAgainstHash( tri );
-				newList = MergeTriLists( newList, fixed );
-			}
-			FreeTriList( group->triList );
-			group->triList = newList;
-		}
-	}
+	RunAreaJobs( e, FixAreaAgainstHash, &hash );
 
 
 	// done
@@ -0,0 +1,1499 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "idlib/precompiled.h"
+
+#include <limits.h>
+
+#include "idlib/math/Simd_Generic.h"
+#include "idlib/math/Simd_MMX.h"
+#include "idlib/math/Simd_SSE.h"
+#include "idlib/math/Simd_SSE2.h"
+#include "idlib/math/Simd_SSE3.h"
+#include "idlib/math/Simd_SSE2Intrin.h"
+#include "idlib/math/Simd_AVX2.h"
+
+#if defined(_MSC_VER) && ( defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64) )
+	#include <intrin.h>
+#endif
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+	#include <xmmintrin.h>
+	#define SIMDBENCH_HAS_MXCSR
+#endif
+
+/*
+===============================================================================
+
+	simdbench
+
+	Headless micro-benchmark for the idSIMDProcessor implementations. Only
+	links against idlib. Every processor entry is run with the generic
+	processor as reference and the selected processor under test over a
+	sweep of element counts. Results are checked against a per-kernel error
+	tolerance and written as JSON so they can be tracked per commit.
+
+	usage: simdbench [options]
+		-processor <name>	auto, generic, mmx, sse, sse2, sse3, sse2intrin or avx2
+		-min <count>		smallest element count, default 16
+		-max <count>		largest element count, default 1048576
+		-step <factor>		element count multiplier, default 4
+		-iterations <n>		timing samples per kernel and count, best one is kept
+		-tolerance <scale>	scales all error tolerances
+		-filter <string>	only run kernels whose name contains string
+		-json <file>		write results to file, - for stdout
+		-list				list the kernel groups and exit
+
+	The exit code is 0 when all kernels are within tolerance, 1 on a
+	mismatch and 2 on a usage error.
+
+===============================================================================
+*/
+
+#define RANDOM_SEED				1013904223L
+
+const int	BENCH_DEFAULT_MIN		= 16;
+const int	BENCH_DEFAULT_MAX		= 1 << 20;
+const int	BENCH_MIN_SAMPLE_NS		= 200000;	// keep repeating a kernel until a sample takes at least this long
+const int	BENCH_MAX_REPEATS		= 1 << 16;
+
+// the generic normalizations use idMath::RSqrt, a single newton step with a relative error up to 1.75e-3
+const float	BENCH_RSQRT_EPSILON		= 4e-3f;
+
+// kernel flags
+const int	BENCH_INPLACE			= BIT( 0 );	// kernel modifies its input, reset before every call
+
+/*
+===============================================================================
+
+	Engine stubs, idlib only needs a console and the processor id.
+
+===============================================================================
+*/
+
+idCVar *		idCVar::staticVars = NULL;
+idCVarSystem *	cvarSystem = NULL;
+
+// console output, stderr when the json goes to stdout
+static FILE *	benchOutput = stdout;
+
+/*
+================
+Bench_GetProcessorId
+================
+*/
+static int Bench_GetProcessorId( void ) {
+	int flags = CPUID_GENERIC;
+
+#if defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports( "mmx" ) ) {
+		flags |= CPUID_MMX;
+	}
+	if ( __builtin_cpu_supports( "sse" ) ) {
+		flags |= CPUID_SSE;
+	}
+	if ( __builtin_cpu_supports( "sse2" ) ) {
+		flags |= CPUID_SSE2;
+	}
+	if ( __builtin_cpu_supports( "sse3" ) ) {
+		flags |= CPUID_SSE3;
+	}
+	// also checks that the OS saves the ymm registers
+	if ( __builtin_cpu_supports( "avx2" ) ) {
+		flags |= CPUID_AVX2;
+	}
+#elif defined(_MSC_VER) && ( defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64) )
+	int regs[4];
+
+	__cpuid( regs, 0 );
+	const int maxLevel = regs[0];
+
+	__cpuid( regs, 1 );
+	if ( regs[3] & BIT( 23 ) ) {
+		flags |= CPUID_MMX;
+	}
+	if ( regs[3] & BIT( 25 ) ) {
+		flags |= CPUID_SSE;
+	}
+	if ( regs[3] & BIT( 26 ) ) {
+		flags |= CPUID_SSE2;
+	}
+	if ( regs[2] & BIT( 0 ) ) {
+		flags |= CPUID_SSE3;
+	}
+	const bool osSavesYMM = ( regs[2] & BIT( 27 ) ) && ( regs[2] & BIT( 28 ) ) && ( _xgetbv( 0 ) & 6 ) == 6;
+	if ( maxLevel >= 7 && osSavesYMM ) {
+		__cpuidex( regs, 7, 0 );
+		if ( regs[1] & BIT( 5 ) ) {
+			flags |= CPUID_AVX2;
+		}
+	}
+#endif
+
+	return flags;
+}
+
+/*
+================
+Bench_SetMXCSRFlag
+================
+*/
+static void Bench_SetMXCSRFlag( unsigned int flag, bool enable ) {
+#ifdef SIMDBENCH_HAS_MXCSR
+	unsigned int csr = _mm_getcsr();
+	_mm_setcsr( enable ? ( csr | flag ) : ( csr & ~flag ) );
+#endif
+}
+
+class idSysBench : public idSys {
+public:
+	virtual void			DebugPrintf( const char *fmt, ... ) {}
+	virtual void			DebugVPrintf( const char *fmt, va_list arg ) {}
+
+	virtual unsigned int	GetMilliseconds( void ) { return (unsigned int)( std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() ); }
+	virtual int				GetProcessorId( void ) { return Bench_GetProcessorId(); }
+	virtual void			FPU_SetFTZ( bool enable ) { Bench_SetMXCSRFlag( 1 << 15, enable ); }
+	virtual void			FPU_SetDAZ( bool enable ) { Bench_SetMXCSRFlag( 1 << 6, enable ); }
+
+	virtual bool			LockMemory( void *ptr, int bytes ) { return false; }
+	virtual bool			UnlockMemory( void *ptr, int bytes ) { return false; }
+
+	virtual uintptr_t		DLL_Load( const char *dllName ) { return 0; }
+	virtual void *			DLL_GetProcAddress( uintptr_t dllHandle, const char *procName ) { return NULL; }
+	virtual void			DLL_Unload( uintptr_t dllHandle ) {}
+	virtual void			DLL_GetFileName( const char *baseName, char *dllName, int maxLength ) {}
+
+	virtual sysEvent_t		GenerateMouseButtonEvent( int button, bool down ) { sysEvent_t ev; memset( &ev, 0, sizeof( ev ) ); return ev; }
+	virtual sysEvent_t		GenerateMouseMoveEvent( int deltax, int deltay ) { sysEvent_t ev; memset( &ev, 0, sizeof( ev ) ); return ev; }
+
+	virtual void			OpenURL( const char *url, bool quit ) {}
+	virtual void			StartProcess( const char *exePath, bool quit ) {}
+
+	virtual bool			IsGameWindowVisible( void ) { return false; }
+
+	virtual idParallelJobList *	AllocJobList( const char *name ) { return NULL; }
+	virtual void			FreeJobList( idParallelJobList *jobList ) {}
+	virtual int				NumJobThreads( void ) { return 0; }
+
+	virtual double			GetMillisecondsPrecise( void ) { return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+};
+
+class idCommonBench : public idCommon {
+public:
+	virtual void				Init( int argc, char **argv ) {}
+	virtual void				Shutdown( void ) {}
+	virtual void				Quit( void ) { exit( 0 ); }
+	virtual bool				IsInitialized( void ) const { return true; }
+	virtual void				Frame( void ) {}
+	virtual void				GUIFrame( bool execCmd, bool network ) {}
+	virtual void				StartupVariable( const char *match, bool once ) {}
+	virtual void				InitTool( const toolFlag_t tool, const idDict *dict ) {}
+	virtual void				ActivateTool( bool active ) {}
+	virtual void				WriteConfigToFile( const char *filename ) {}
+	virtual void				WriteFlaggedCVarsToFile( const char *filename, int flags, const char *setCmd ) {}
+	virtual void				BeginRedirect( char *buffer, int buffersize, void (*flush)( const char * ) ) {}
+	virtual void				EndRedirect( void ) {}
+	virtual void				SetRefreshOnPrint( bool set ) {}
+	virtual void				Printf( const char *fmt, ... ) { va_list argptr; va_start( argptr, fmt ); VPrintf( fmt, argptr ); va_end( argptr ); }
+	virtual void				VPrintf( const char *fmt, va_list arg ) { char msg[4096]; idStr::vsnPrintf( msg, sizeof( msg ), fmt, arg ); idStr::RemoveColors( msg ); fputs( msg, benchOutput ); }
+	virtual void				DPrintf( const char *fmt, ... ) {}
+	virtual void				VerbosePrintf( const char *fmt, ... ) {}
+	virtual void				Warning( const char *fmt, ... ) { va_list argptr; va_start( argptr, fmt ); fputs( "WARNING: ", benchOutput ); VPrintf( fmt, argptr ); va_end( argptr ); fputs( "\n", benchOutput ); }
+	virtual void				DWarning( const char *fmt, ... ) {}
+	virtual void				PrintWarnings( void ) {}
+	virtual void				ClearWarnings( const char *reason ) {}
+	virtual void				Error( const char *fmt, ... ) { va_list argptr; va_start( argptr, fmt ); fputs( "ERROR: ", stderr ); vfprintf( stderr, fmt, argptr ); va_end( argptr ); fputs( "\n", stderr ); exit( 1 ); }
+	virtual void				FatalError( const char *fmt, ... ) { va_list argptr; va_start( argptr, fmt ); fputs( "FATAL ERROR: ", stderr ); vfprintf( stderr, fmt, argptr ); va_end( argptr ); fputs( "\n", stderr ); exit( 1 ); }
+	virtual const idLangDict *	GetLanguageDict( void ) { return NULL; }
+	virtual float				Get_com_engineHz_latched( void ) { return 60.0f; }
+	virtual int64_t				Get_com_engineHz_numerator( void ) { return 60; }
+	virtual int64_t				Get_com_engineHz_denominator( void ) { return 1; }
+	virtual const char *		KeysFromBinding( const char *bind ) { return ""; }
+	virtual const char *		BindingFromKey( const char *key ) { return ""; }
+	virtual int					ButtonState( int key ) { return 0; }
+	virtual int					KeyState( int key ) { return 0; }
+	virtual bool				SetCallback( CallbackType cbt, FunctionPointer cb, void *userArg ) { return false; }
+	virtual bool				GetAdditionalFunction( FunctionType ft, FunctionPointer *out_fnptr, void **out_userArg ) { return false; }
+};
+
+idSysBench		sysLocal;
+idSys *			sys = &sysLocal;
+idCommonBench	commonLocal;
+idCommon *		common = &commonLocal;
+
+/*
+===============================================================================
+
+	idBenchCompare
+
+	Accumulates the difference between the reference and tested outputs.
+
+===============================================================================
+*/
+
+class idBenchCompare {
+public:
+					idBenchCompare( float epsilon, float magnitude );
+
+					// floats match if the difference is within epsilon * max( |reference|, magnitude )
+	void			Floats( const float *ref, const float *tst, int num );
+	void			Ints( const int *ref, const int *tst, int num );
+	void			Shorts( const short *ref, const short *tst, int num, int tolerance );
+	void			Bytes( const byte *ref, const byte *tst, int num );
+
+	float			epsilon;
+	float			magnitude;
+	float			maxError;		// largest relative error
+	int				maxUlps;		// largest distance in units in the last place
+	int				mismatches;
+	int				firstMismatch;
+};
+
+/*
+================
+idBenchCompare::idBenchCompare
+================
+*/
+idBenchCompare::idBenchCompare( float epsilon, float magnitude ) {
+	this->epsilon = epsilon;
+	this->magnitude = magnitude;
+	maxError = 0.0f;
+	maxUlps = 0;
+	mismatches = 0;
+	firstMismatch = -1;
+}
+
+/*
+================
+FloatToOrderedInt
+
+  Maps the float bit patterns onto a monotonic integer range so the
+  difference between two floats is their distance in ulps.
+================
+*/
+static ID_INLINE int FloatToOrderedInt( float f ) {
+	int i;
+	memcpy( &i, &f, sizeof( i ) );
+	return ( i < 0 ) ? ( (int)0x80000000 - i ) : i;
+}
+
+/*
+================
+idBenchCompare::Floats
+================
+*/
+void idBenchCompare::Floats( const float *ref, const float *tst, int num ) {
+	for ( int i = 0; i < num; i++ ) {
+		if ( memcmp( &ref[i], &tst[i], sizeof( float ) ) == 0 ) {
+			continue;
+		}
+		// NaN or infinite
+		if ( FLOAT_IS_NAN( ref[i] ) || FLOAT_IS_NAN( tst[i] ) ) {
+			if ( !FLOAT_IS_NAN( ref[i] ) || !FLOAT_IS_NAN( tst[i] ) ) {
+				if ( firstMismatch < 0 ) {
+					firstMismatch = i;
+				}
+				mismatches++;
+				maxError = idMath::INFINITY;
+			}
+			continue;
+		}
+		int64_t ulps = (int64_t)FloatToOrderedInt( ref[i] ) - (int64_t)FloatToOrderedInt( tst[i] );
+		ulps = ( ulps < 0 ) ? -ulps : ulps;
+		maxUlps = (int)Max( (int64_t)maxUlps, Min( ulps, (int64_t)INT_MAX ) );
+
+		const float error = idMath::Fabs( ref[i] - tst[i] ) / Max( idMath::Fabs( ref[i] ), magnitude );
+		maxError = Max( maxError, error );
+		if ( error > epsilon ) {
+			if ( firstMismatch < 0 ) {
+				firstMismatch = i;
+			}
+			mismatches++;
+		}
+	}
+}
+
+/*
+================
+idBenchCompare::Ints
+================
+*/
+void idBenchCompare::Ints( const int *ref, const int *tst, int num ) {
+	for ( int i = 0; i < num; i++ ) {
+		if ( ref[i] != tst[i] ) {
+			if ( firstMismatch < 0 ) {
+				firstMismatch = i;
+			}
+			mismatches++;
+		}
+	}
+}
+
+/*
+================
+idBenchCompare::Shorts
+================
+*/
+void idBenchCompare::Shorts( const short *ref, const short *tst, int num, int tolerance ) {
+	for ( int i = 0; i < num; i++ ) {
+		const int delta = idMath::Abs( ref[i] - tst[i] );
+		maxUlps = Max( maxUlps, delta );
+		if ( delta > tolerance ) {
+			if ( firstMismatch < 0 ) {
+				firstMismatch = i;
+			}
+			mismatches++;
+		}
+	}
+}
+
+/*
+================
+idBenchCompare::Bytes
+================
+*/
+void idBenchCompare::Bytes( const byte *ref, const byte *tst, int num ) {
+	for ( int i = 0; i < num; i++ ) {
+		if ( ref[i] != tst[i] ) {
+			if ( firstMismatch < 0 ) {
+				firstMismatch = i;
+			}
+			mismatches++;
+		}
+	}
+}
+
+/*
+===============================================================================
+
+	idSIMDBench
+
+===============================================================================
+*/
+
+typedef struct benchResult_s {
+	idStr			name;
+	int				count;
+	double			genericNs;		// best time of one call
+	double			simdNs;
+	float			maxError;
+	int				maxUlps;
+	int				mismatches;
+	int				firstMismatch;
+} benchResult_t;
+
+class idSIMDBench;
+typedef void (*benchFunc_t)( idSIMDBench &bench, int count );
+
+typedef struct {
+	const char *	name;			// prefix of the result names
+	benchFunc_t		func;
+	int				maxCount;		// larger counts are clamped, 0 = no limit
+	int				minCount;
+} benchKernel_t;
+
+class idSIMDBench {
+public:
+					idSIMDBench( void );
+					~idSIMDBench( void );
+
+	idSIMDProcessor *generic;
+	idSIMDProcessor *simd;
+	int				iterations;
+	float			toleranceScale;
+	idStr			filter;
+	idRandom		random;
+	idList<benchResult_t> results;
+
+					// scratch memory, freed after every kernel and count
+	void *			Alloc( int bytes );
+	float *			Floats( int num );
+	float *			RandomFloats( int num, float scale );
+	void			FreeAll( void );
+
+	bool			Filtered( const char *name ) const;
+
+					// runs the kernel on both processors, compares the outputs and times it
+					// kernel( processor, slot ) writes to the outputs of slot 0 or 1
+					// reset( slot ) restores inputs that the kernel modifies
+					// compare( cmp ) compares the slot 0 and 1 outputs
+	template< typename KERNEL, typename RESET, typename COMPARE >
+	void			Run( const char *name, int count, int flags, float epsilon, float magnitude, KERNEL kernel, RESET reset, COMPARE compare );
+
+private:
+	idList<void *>	allocs;
+
+	template< typename KERNEL, typename RESET >
+	double			Time( idSIMDProcessor *processor, int flags, KERNEL &kernel, RESET &reset );
+};
+
+struct benchNoReset {
+	void operator()( int slot ) const {}
+};
+
+/*
+================
+idSIMDBench::idSIMDBench
+================
+*/
+idSIMDBench::idSIMDBench( void ) {
+	generic = NULL;
+	simd = NULL;
+	iterations = 5;
+	toleranceScale = 1.0f;
+}
+
+/*
+================
+idSIMDBench::~idSIMDBench
+================
+*/
+idSIMDBench::~idSIMDBench( void ) {
+	FreeAll();
+}
+
+/*
+================
+idSIMDBench::Alloc
+
+  Padded so the 16 byte operations can round the count up.
+================
+*/
+void *idSIMDBench::Alloc( int bytes ) {
+	void *ptr = Mem_Alloc16( bytes + 64 );
+	memset( ptr, 0, bytes + 64 );
+	allocs.Append( ptr );
+	return ptr;
+}
+
+/*
+================
+idSIMDBench::Floats
+================
+*/
+float *idSIMDBench::Floats( int num ) {
+	return (float *)Alloc( num * sizeof( float ) );
+}
+
+/*
+================
+idSIMDBench::RandomFloats
+================
+*/
+float *idSIMDBench::RandomFloats( int num, float scale ) {
+	float *f = Floats( num );
+	for ( int i = 0; i < num; i++ ) {
+		f[i] = random.CRandomFloat() * scale;
+	}
+	return f;
+}
+
+/*
+================
+idSIMDBench::FreeAll
+================
+*/
+void idSIMDBench::FreeAll( void ) {
+	for ( int i = 0; i < allocs.Num(); i++ ) {
+		Mem_Free16( allocs[i] );
+	}
+	allocs.Clear();
+}
+
+/*
+================
+idSIMDBench::Filtered
+================
+*/
+bool idSIMDBench::Filtered( const char *name ) const {
+	return filter.Length() != 0 && idStr::FindText( name, filter, false ) == -1;
+}
+
+/*
+================
+idSIMDBench::Time
+
+  Returns the best time of a single call in nanoseconds. Kernels that
+  modify their input are timed one call at a time, others are repeated
+  until a sample is long enough for the clock resolution.
+================
+*/
+template< typename KERNEL, typename RESET >
+double idSIMDBench::Time( idSIMDProcessor *processor, int flags, KERNEL &kernel, RESET &reset ) {
+	typedef std::chrono::steady_clock clock;
+
+	int repeats = 1;
+	if ( !( flags & BENCH_INPLACE ) ) {
+		while ( repeats < BENCH_MAX_REPEATS ) {
+			clock::time_point start = clock::now();
+			for ( int i = 0; i < repeats; i++ ) {
+				kernel( processor, 1 );
+			}
+			const double ns = std::chrono::duration<double, std::nano>( clock::now() - start ).count();
+			if ( ns >= BENCH_MIN_SAMPLE_NS ) {
+				break;
+			}
+			repeats *= 2;
+		}
+	}
+
+	double best = idMath::INFINITY;
+	for ( int i = 0; i < iterations; i++ ) {
+		if ( flags & BENCH_INPLACE ) {
+			reset( 1 );
+		}
+		clock::time_point start = clock::now();
+		for ( int j = 0; j < repeats; j++ ) {
+			kernel( processor, 1 );
+		}
+		const double ns = std::chrono::duration<double, std::nano>( clock::now() - start ).count() / repeats;
+		best = Min( best, ns );
+	}
+	return best;
+}
+
+/*
+================
+idSIMDBench::Run
+================
+*/
+template< typename KERNEL, typename RESET, typename COMPARE >
+void idSIMDBench::Run( const char *name, int count, int flags, float epsilon, float magnitude, KERNEL kernel, RESET reset, COMPARE compare ) {
+	if ( Filtered( name ) ) {
+		return;
+	}
+
+	benchResult_t &r = results.Alloc();
+	r.name = name;
+	r.count = count;
+
+	// correctness, both processors start from the same inputs
+	reset( 0 );
+	reset( 1 );
+	kernel( generic, 0 );
+	kernel( simd, 1 );
+
+	idBenchCompare cmp( epsilon * toleranceScale, magnitude );
+	compare( cmp );
+	r.maxError = cmp.maxError;
+	r.maxUlps = cmp.maxUlps;
+	r.mismatches = cmp.mismatches;
+	r.firstMismatch = cmp.firstMismatch;
+
+	// timing, slot 1 is reused for both processors
+	r.genericNs = Time( generic, flags, kernel, reset );
+	r.simdNs = Time( simd, flags, kernel, reset );
+
+	common->Printf( "%-44s %8d %12.1f %12.1f %6.2fx %10.3g %s\n", name, count, r.genericNs, r.simdNs,
+					r.simdNs > 0.0 ? r.genericNs / r.simdNs : 0.0, r.maxError, r.mismatches ? S_COLOR_RED "X" : "ok" );
+}
+
+/*
+===============================================================================
+
+	Kernels
+
+===============================================================================
+*/
+
+/*
+================
+Bench_Arithmetic
+================
+*/
+static void Bench_Arithmetic( idSIMDBench &b, int count ) {
+	const float *src0 = b.RandomFloats( count, 10.0f );
+	const float *src1 = b.RandomFloats( count, 10.0f );
+	float *orig = b.RandomFloats( count, 10.0f );
+	float *dst[2] = { b.Floats( count ), b.Floats( count ) };
+	float *nonZero = b.Floats( count );
+	for ( int i = 0; i < count; i++ ) {
+		nonZero[i] = ( src1[i] >= 0.0f ? 1.0f : -1.0f ) + src1[i];
+	}
+
+	benchNoReset noReset;
+	auto reset = [&]( int slot ) { memcpy( dst[slot], orig, count * sizeof( float ) ); };
+	auto compare = [&]( idBenchCompare &c ) { c.Floats( dst[0], dst[1], count ); };
+	const float eps = 1e-6f;
+
+	b.Run( "Add( c, src )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Add( dst[s], 4.0f, src0, count ); }, noReset, compare );
+	b.Run( "Add( src0, src1 )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Add( dst[s], src0, src1, count ); }, noReset, compare );
+	b.Run( "Sub( c, src )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Sub( dst[s], 4.0f, src0, count ); }, noReset, compare );
+	b.Run( "Sub( src0, src1 )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Sub( dst[s], src0, src1, count ); }, noReset, compare );
+	b.Run( "Mul( c, src )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Mul( dst[s], 4.0f, src0, count ); }, noReset, compare );
+	b.Run( "Mul( src0, src1 )", count, 0, eps, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Mul( dst[s], src0, src1, count ); }, noReset, compare );
+	b.Run( "Div( c, src )", count, 0, 1e-5f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Div( dst[s], 4.0f, nonZero, count ); }, noReset, compare );
+	b.Run( "Div( src0, src1 )", count, 0, 1e-5f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Div( dst[s], src0, nonZero, count ); }, noReset, compare );
+	b.Run( "MulAdd( c, src )", count, BENCH_INPLACE, eps, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->MulAdd( dst[s], 0.123f, src0, count ); }, reset, compare );
+	b.Run( "MulAdd( src0, src1 )", count, BENCH_INPLACE, eps, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->MulAdd( dst[s], src0, src1, count ); }, reset, compare );
+	b.Run( "MulSub( c, src )", count, BENCH_INPLACE, eps, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->MulSub( dst[s], 0.123f, src0, count ); }, reset, compare );
+	b.Run( "MulSub( src0, src1 )", count, BENCH_INPLACE, eps, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->MulSub( dst[s], src0, src1, count ); }, reset, compare );
+}
+
+/*
+================
+Bench_Dot
+================
+*/
+static void Bench_Dot( idSIMDBench &b, int count ) {
+	idVec3 *v0 = (idVec3 *)b.RandomFloats( count * 3, 10.0f );
+	idVec3 *v1 = (idVec3 *)b.RandomFloats( count * 3, 10.0f );
+	idPlane *planes = (idPlane *)b.RandomFloats( count * 4, 10.0f );
+	idDrawVert *verts = (idDrawVert *)b.Alloc( count * sizeof( idDrawVert ) );
+	for ( int i = 0; i < count; i++ ) {
+		verts[i].xyz = v1[i];
+	}
+	const float *f0 = b.RandomFloats( count, 1.0f );
+	const float *f1 = b.RandomFloats( count, 1.0f );
+	const idVec3 cv( 1.0f, 2.0f, 3.0f );
+	const idPlane cp( 1.0f, 2.0f, 3.0f, 4.0f );
+	float *dst[2] = { b.Floats( count ), b.Floats( count ) };
+	float dot[2] = { 0.0f, 0.0f };
+
+	benchNoReset noReset;
+	auto compare = [&]( idBenchCompare &c ) { c.Floats( dst[0], dst[1], count ); };
+	const float eps = 1e-5f;
+	const float mag = 100.0f;
+
+	b.Run( "Dot( vec3, vec3[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cv, v0, count ); }, noReset, compare );
+	b.Run( "Dot( vec3, plane[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cv, planes, count ); }, noReset, compare );
+	b.Run( "Dot( vec3, drawVert[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cv, verts, count ); }, noReset, compare );
+	b.Run( "Dot( plane, vec3[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cp, v0, count ); }, noReset, compare );
+	b.Run( "Dot( plane, plane[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cp, planes, count ); }, noReset, compare );
+	b.Run( "Dot( plane, drawVert[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], cp, verts, count ); }, noReset, compare );
+	b.Run( "Dot( vec3[], vec3[] )", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->Dot( dst[s], v0, v1, count ); }, noReset, compare );
+
+	// summation order differs between processors, the error grows with the square root of the count
+	b.Run( "Dot( float[], float[] )", count, 0, 1e-5f, idMath::Sqrt( (float)count ),
+		[&]( idSIMDProcessor *p, int s ) { p->Dot( dot[s], f0, f1, count ); }, noReset,
+		[&]( idBenchCompare &c ) { c.Floats( &dot[0], &dot[1], 1 ); } );
+}
+
+/*
+================
+Bench_Compare
+================
+*/
+static void Bench_Compare( idSIMDBench &b, int count ) {
+	const float *src = b.RandomFloats( count, 10.0f );
+	byte *orig = (byte *)b.Alloc( count );
+	for ( int i = 0; i < count; i++ ) {
+		orig[i] = (byte)b.random.RandomInt( 256 );
+	}
+	byte *dst[2] = { (byte *)b.Alloc( count ), (byte *)b.Alloc( count ) };
+
+	benchNoReset noReset;
+	auto reset = [&]( int slot ) { memcpy( dst[slot], orig, count ); };
+	auto compare = [&]( idBenchCompare &c ) { c.Bytes( dst[0], dst[1], count ); };
+
+	b.Run( "CmpGT( src, c )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpGT( dst[s], src, 0.0f, count ); }, noReset, compare );
+	b.Run( "CmpGT( bit, src, c )", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpGT( dst[s], 3, src, 0.0f, count ); }, reset, compare );
+	b.Run( "CmpGE( src, c )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpGE( dst[s], src, 0.0f, count ); }, noReset, compare );
+	b.Run( "CmpGE( bit, src, c )", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpGE( dst[s], 3, src, 0.0f, count ); }, reset, compare );
+	b.Run( "CmpLT( src, c )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpLT( dst[s], src, 0.0f, count ); }, noReset, compare );
+	b.Run( "CmpLT( bit, src, c )", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpLT( dst[s], 3, src, 0.0f, count ); }, reset, compare );
+	b.Run( "CmpLE( src, c )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpLE( dst[s], src, 0.0f, count ); }, noReset, compare );
+	b.Run( "CmpLE( bit, src, c )", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CmpLE( dst[s], 3, src, 0.0f, count ); }, reset, compare );
+}
+
+/*
+================
+Bench_MinMaxClamp
+================
+*/
+static void Bench_MinMaxClamp( idSIMDBench &b, int count ) {
+	const float *src = b.RandomFloats( count * 3, 10.0f );
+	idDrawVert *verts = (idDrawVert *)b.Alloc( count * sizeof( idDrawVert ) );
+	int *indexes = (int *)b.Alloc( count * sizeof( int ) );
+	for ( int i = 0; i < count; i++ ) {
+		verts[i].xyz.Set( src[i*3+0], src[i*3+1], src[i*3+2] );
+		indexes[i] = b.random.RandomInt( count );
+	}
+	float *dst[2] = { b.Floats( count ), b.Floats( count ) };
+	idVec3 mins[2], maxs[2];
+
+	benchNoReset noReset;
+	auto compareFloats = [&]( idBenchCompare &c ) { c.Floats( dst[0], dst[1], count ); };
+	auto compareMinMax = [&]( idBenchCompare &c ) { c.Floats( mins[0].ToFloatPtr(), mins[1].ToFloatPtr(), 3 ); c.Floats( maxs[0].ToFloatPtr(), maxs[1].ToFloatPtr(), 3 ); };
+
+	b.Run( "MinMax( float[] )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { mins[s].Zero(); maxs[s].Zero(); p->MinMax( mins[s].x, maxs[s].x, src, count ); }, noReset, compareMinMax );
+	b.Run( "MinMax( vec2[] )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { mins[s].Zero(); maxs[s].Zero(); p->MinMax( mins[s].ToVec2(), maxs[s].ToVec2(), (const idVec2 *)src, count ); }, noReset, compareMinMax );
+	b.Run( "MinMax( vec3[] )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MinMax( mins[s], maxs[s], (const idVec3 *)src, count ); }, noReset, compareMinMax );
+	b.Run( "MinMax( drawVert[] )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MinMax( mins[s], maxs[s], verts, count ); }, noReset, compareMinMax );
+	b.Run( "MinMax( drawVert[], indexes )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MinMax( mins[s], maxs[s], verts, indexes, count ); }, noReset, compareMinMax );
+	b.Run( "Clamp( src, min, max )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Clamp( dst[s], src, -1.0f, 1.0f, count ); }, noReset, compareFloats );
+	b.Run( "ClampMin( src, min )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->ClampMin( dst[s], src, -1.0f, count ); }, noReset, compareFloats );
+	b.Run( "ClampMax( src, max )", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->ClampMax( dst[s], src, 1.0f, count ); }, noReset, compareFloats );
+}
+
+/*
+================
+Bench_Memory
+================
+*/
+static void Bench_Memory( idSIMDBench &b, int count ) {
+	const int bytes = count * sizeof( float );
+	const float *src = b.RandomFloats( count, 10.0f );
+	const float *src1 = b.RandomFloats( count, 10.0f );
+	float *dst[2] = { b.Floats( count ), b.Floats( count ) };
+
+	benchNoReset noReset;
+	auto reset = [&]( int slot ) { memcpy( dst[slot], src1, bytes ); };
+	auto compare = [&]( idBenchCompare &c ) { c.Floats( dst[0], dst[1], count ); };
+
+	b.Run( "Memcpy", bytes, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Memcpy( dst[s], src, bytes ); }, noReset, compare );
+	b.Run( "Memset", bytes, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Memset( dst[s], 0x3f, bytes ); }, noReset, compare );
+	b.Run( "Zero16", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Zero16( dst[s], count ); }, noReset, compare );
+	b.Run( "Negate16", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Negate16( dst[s], count ); }, reset, compare );
+	b.Run( "Copy16", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Copy16( dst[s], src, count ); }, noReset, compare );
+	b.Run( "Add16", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Add16( dst[s], src, src1, count ); }, noReset, compare );
+	b.Run( "Sub16", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Sub16( dst[s], src, src1, count ); }, noReset, compare );
+	b.Run( "Mul16", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->Mul16( dst[s], src, 0.123f, count ); }, noReset, compare );
+	b.Run( "AddAssign16", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->AddAssign16( dst[s], src, count ); }, reset, compare );
+	b.Run( "SubAssign16", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->SubAssign16( dst[s], src, count ); }, reset, compare );
+	b.Run( "MulAssign16", count, BENCH_INPLACE, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MulAssign16( dst[s], 0.123f, count ); }, reset, compare );
+}
+
+/*
+================
+Bench_MatX
+
+  The count is the number of matrix elements of a square matrix.
+================
+*/
+static void Bench_MatX( idSIMDBench &b, int count ) {
+	const int n = Max( 1, (int)idMath::Sqrt( (float)count ) );
+
+	idMatX m1, m2, dstMat[2];
+	m1.SetData( n, n, b.RandomFloats( n * n, 1.0f ) );
+	m2.SetData( n, n, b.RandomFloats( n * n, 1.0f ) );
+	dstMat[0].SetData( n, n, b.Floats( n * n ) );
+	dstMat[1].SetData( n, n, b.Floats( n * n ) );
+
+	idVecX vec, orig, dst[2];
+	vec.SetData( n, b.RandomFloats( n, 1.0f ) );
+	orig.SetData( n, b.RandomFloats( n, 1.0f ) );
+	dst[0].SetData( n, b.Floats( n ) );
+	dst[1].SetData( n, b.Floats( n ) );
+
+	benchNoReset noReset;
+	auto resetVec = [&]( int slot ) { memcpy( dst[slot].ToFloatPtr(), orig.ToFloatPtr(), n * sizeof( float ) ); };
+	auto compareVec = [&]( idBenchCompare &c ) { c.Floats( dst[0].ToFloatPtr(), dst[1].ToFloatPtr(), n ); };
+	auto compareMat = [&]( idBenchCompare &c ) { c.Floats( dstMat[0].ToFloatPtr(), dstMat[1].ToFloatPtr(), n * n ); };
+
+	// the products sum n terms in [-1, 1], the summation order is allowed to differ
+	const float eps = 1e-5f;
+	const float mag = (float)n;
+
+	b.Run( "MatX_MultiplyVecX", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_MultiplyVecX( dst[s], m1, vec ); }, noReset, compareVec );
+	b.Run( "MatX_MultiplyAddVecX", count, BENCH_INPLACE, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_MultiplyAddVecX( dst[s], m1, vec ); }, resetVec, compareVec );
+	b.Run( "MatX_MultiplySubVecX", count, BENCH_INPLACE, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_MultiplySubVecX( dst[s], m1, vec ); }, resetVec, compareVec );
+	b.Run( "MatX_TransposeMultiplyVecX", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_TransposeMultiplyVecX( dst[s], m1, vec ); }, noReset, compareVec );
+	b.Run( "MatX_TransposeMultiplyAddVecX", count, BENCH_INPLACE, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_TransposeMultiplyAddVecX( dst[s], m1, vec ); }, resetVec, compareVec );
+	b.Run( "MatX_TransposeMultiplySubVecX", count, BENCH_INPLACE, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_TransposeMultiplySubVecX( dst[s], m1, vec ); }, resetVec, compareVec );
+
+	// O(n^3)
+	if ( n <= 256 ) {
+		b.Run( "MatX_MultiplyMatX", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_MultiplyMatX( dstMat[s], m1, m2 ); }, noReset, compareMat );
+		b.Run( "MatX_TransposeMultiplyMatX", count, 0, eps, mag, [&]( idSIMDProcessor *p, int s ) { p->MatX_TransposeMultiplyMatX( dstMat[s], m1, m2 ); }, noReset, compareMat );
+	}
+}
+
+/*
+================
+Bench_MatXSolve
+================
+*/
+static void Bench_MatXSolve( idSIMDBench &b, int count ) {
+	const int n = Max( 1, (int)idMath::Sqrt( (float)count ) );
+	if ( n > 256 ) {
+		return;		// O(n^3)
+	}
+
+	// unit lower triangular with small off diagonal elements keeps the solves well conditioned
+	idMatX L;
+	L.SetData( n, n, b.Floats( n * n ) );
+	for ( int i = 0; i < n; i++ ) {
+		for ( int j = 0; j < i; j++ ) {
+			L[i][j] = b.random.CRandomFloat() / n;
+		}
+		L[i][i] = 1.0f;
+	}
+	const float *rhs = b.RandomFloats( n, 1.0f );
+	float *x[2] = { b.Floats( n ), b.Floats( n ) };
+
+	// symmetric positive definite
+	idMatX spd, mat[2];
+	spd.SetData( n, n, b.Floats( n * n ) );
+	for ( int i = 0; i < n; i++ ) {
+		for ( int j = 0; j <= i; j++ ) {
+			spd[i][j] = spd[j][i] = b.random.CRandomFloat();
+		}
+		spd[i][i] = (float)n;
+	}
+	mat[0].SetData( n, n, b.Floats( n * n ) );
+	mat[1].SetData( n, n, b.Floats( n * n ) );
+	idVecX invDiag[2];
+	invDiag[0].SetData( n, b.Floats( n ) );
+	invDiag[1].SetData( n, b.Floats( n ) );
+
+	benchNoReset noReset;
+	auto compareX = [&]( idBenchCompare &c ) { c.Floats( x[0], x[1], n ); };
+
+	b.Run( "MatX_LowerTriangularSolve", count, 0, 1e-4f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MatX_LowerTriangularSolve( L, x[s], rhs, n ); }, noReset, compareX );
+	b.Run( "MatX_LowerTriangularSolveTranspose", count, 0, 1e-4f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->MatX_LowerTriangularSolveTranspose( L, x[s], rhs, n ); }, noReset, compareX );
+	b.Run( "MatX_LDLTFactor", count, BENCH_INPLACE, 1e-4f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->MatX_LDLTFactor( mat[s], invDiag[s], n ); },
+		[&]( int slot ) { memcpy( mat[slot].ToFloatPtr(), spd.ToFloatPtr(), n * n * sizeof( float ) ); },
+		[&]( idBenchCompare &c ) { c.Floats( mat[0].ToFloatPtr(), mat[1].ToFloatPtr(), n * n ); c.Floats( invDiag[0].ToFloatPtr(), invDiag[1].ToFloatPtr(), n ); } );
+}
+
+/*
+================
+Bench_RandomJointMat
+================
+*/
+static void Bench_RandomJointMat( idSIMDBench &b, idJointMat &joint ) {
+	idAngles angles;
+	angles[0] = b.random.CRandomFloat() * 180.0f;
+	angles[1] = b.random.CRandomFloat() * 180.0f;
+	angles[2] = b.random.CRandomFloat() * 180.0f;
+	joint.SetRotation( angles.ToMat3() );
+	joint.SetTranslation( idVec3( b.random.CRandomFloat(), b.random.CRandomFloat(), b.random.CRandomFloat() ) * 2.0f );
+}
+
+/*
+================
+Bench_Joints
+================
+*/
+static void Bench_Joints( idSIMDBench &b, int count ) {
+	idJointQuat *baseQuats = (idJointQuat *)b.Alloc( count * sizeof( idJointQuat ) );
+	idJointQuat *blendQuats = (idJointQuat *)b.Alloc( count * sizeof( idJointQuat ) );
+	idJointMat *baseMats = (idJointMat *)b.Alloc( count * sizeof( idJointMat ) );
+	int *index = (int *)b.Alloc( count * sizeof( int ) );
+	int *parents = (int *)b.Alloc( count * sizeof( int ) );
+	for ( int i = 0; i < count; i++ ) {
+		Bench_RandomJointMat( b, baseMats[i] );
+		baseQuats[i] = baseMats[i].ToJointQuat();
+		idJointMat blend;
+		Bench_RandomJointMat( b, blend );
+		blendQuats[i] = blend.ToJointQuat();
+		index[i] = i;
+		// balanced hierarchy so the transforms do not accumulate over the whole count
+		parents[i] = ( i - 1 ) / 2;
+	}
+	idJointQuat *quats[2] = { (idJointQuat *)b.Alloc( count * sizeof( idJointQuat ) ), (idJointQuat *)b.Alloc( count * sizeof( idJointQuat ) ) };
+	idJointMat *mats[2] = { (idJointMat *)b.Alloc( count * sizeof( idJointMat ) ), (idJointMat *)b.Alloc( count * sizeof( idJointMat ) ) };
+
+	benchNoReset noReset;
+	auto resetQuats = [&]( int slot ) { memcpy( quats[slot], baseQuats, count * sizeof( idJointQuat ) ); };
+	auto resetMats = [&]( int slot ) { memcpy( mats[slot], baseMats, count * sizeof( idJointMat ) ); };
+	auto compareQuats = [&]( idBenchCompare &c ) { c.Floats( (float *)quats[0], (float *)quats[1], count * 7 ); };
+	auto compareMats = [&]( idBenchCompare &c ) { c.Floats( mats[0]->ToFloatPtr(), mats[1]->ToFloatPtr(), count * 12 ); };
+
+	b.Run( "BlendJoints", count, BENCH_INPLACE, 1e-4f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->BlendJoints( quats[s], blendQuats, 0.3f, index, count ); }, resetQuats, compareQuats );
+	b.Run( "ConvertJointQuatsToJointMats", count, 0, 1e-5f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->ConvertJointQuatsToJointMats( mats[s], baseQuats, count ); }, noReset, compareMats );
+	b.Run( "ConvertJointMatsToJointQuats", count, 0, 1e-5f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->ConvertJointMatsToJointQuats( quats[s], baseMats, count ); }, noReset, compareQuats );
+	b.Run( "TransformJoints", count, BENCH_INPLACE, 1e-4f, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->TransformJoints( mats[s], parents, 1, count - 1 ); }, resetMats, compareMats );
+	b.Run( "UntransformJoints", count, BENCH_INPLACE, 1e-4f, 10.0f, [&]( idSIMDProcessor *p, int s ) { p->UntransformJoints( mats[s], parents, 1, count - 1 ); }, resetMats, compareMats );
+}
+
+/*
+================
+Bench_RandomVerts
+
+  Vertices with positions, texture coordinates and unit normal and tangents.
+================
+*/
+static idDrawVert *Bench_RandomVerts( idSIMDBench &b, int count, float scale ) {
+	idDrawVert *verts = (idDrawVert *)b.Alloc( count * sizeof( idDrawVert ) );
+	for ( int i = 0; i < count; i++ ) {
+		idDrawVert &v = verts[i];
+		v.Clear();
+		v.xyz.Set( b.random.CRandomFloat(), b.random.CRandomFloat(), b.random.CRandomFloat() );
+		v.xyz *= scale;
+		v.st.Set( b.random.CRandomFloat(), b.random.CRandomFloat() );
+		v.normal.Set( b.random.CRandomFloat(), b.random.CRandomFloat(), b.random.CRandomFloat() + 2.0f );
+		v.normal.Normalize();
+		v.normal.NormalVectors( v.tangents[0], v.tangents[1] );
+	}
+	return verts;
+}
+
+/*
+================
+Bench_CopyVerts
+================
+*/
+static idDrawVert *Bench_CopyVerts( idSIMDBench &b, const idDrawVert *verts, int count ) {
+	idDrawVert *copy = (idDrawVert *)b.Alloc( count * sizeof( idDrawVert ) );
+	memcpy( copy, verts, count * sizeof( idDrawVert ) );
+	return copy;
+}
+
+/*
+================
+Bench_CompareVerts
+
+  Compares the float members, the color is never written by the kernels.
+================
+*/
+static void Bench_CompareVerts( idBenchCompare &c, const idDrawVert *ref, const idDrawVert *tst, int count ) {
+	for ( int i = 0; i < count; i++ ) {
+		c.Floats( ref[i].xyz.ToFloatPtr(), tst[i].xyz.ToFloatPtr(), 14 );
+	}
+}
+
+/*
+================
+Bench_CompareDirections
+
+  Derived tangent space vectors are not normalized and can be short for
+  degenerate triangles, compare their directions like testSIMD does.
+================
+*/
+static void Bench_CompareDirections( idBenchCompare &c, const idDrawVert *ref, const idDrawVert *tst, int count ) {
+	for ( int i = 0; i < count; i++ ) {
+		idVec3 r[3] = { ref[i].normal, ref[i].tangents[0], ref[i].tangents[1] };
+		idVec3 t[3] = { tst[i].normal, tst[i].tangents[0], tst[i].tangents[1] };
+		for ( int j = 0; j < 3; j++ ) {
+			r[j].Normalize();
+			t[j].Normalize();
+		}
+		c.Floats( r[0].ToFloatPtr(), t[0].ToFloatPtr(), 3 );
+		c.Floats( r[1].ToFloatPtr(), t[1].ToFloatPtr(), 3 );
+		c.Floats( r[2].ToFloatPtr(), t[2].ToFloatPtr(), 3 );
+	}
+}
+
+/*
+================
+Bench_TransformVerts
+================
+*/
+static void Bench_TransformVerts( idSIMDBench &b, int count ) {
+	const int numJoints = 64;
+	idJointMat *joints = (idJointMat *)b.Alloc( numJoints * sizeof( idJointMat ) );
+	for ( int i = 0; i < numJoints; i++ ) {
+		Bench_RandomJointMat( b, joints[i] );
+	}
+
+	// one to four weights per vertex
+	idList<idVec4> weightList;
+	idList<int> indexList;
+	weightList.Resize( count * 4 );
+	indexList.Resize( count * 8 );
+	for ( int i = 0; i < count; i++ ) {
+		const int numWeights = 1 + b.random.RandomInt( 4 );
+		for ( int j = 0; j < numWeights; j++ ) {
+			weightList.Append( idVec4( b.random.CRandomFloat() * 2.0f, b.random.CRandomFloat() * 2.0f, b.random.CRandomFloat() * 2.0f, 1.0f / numWeights ) );
+			indexList.Append( b.random.RandomInt( numJoints ) * sizeof( idJointMat ) );
+			indexList.Append( j == numWeights - 1 );
+		}
+	}
+	const int numWeights = weightList.Num();
+	idVec4 *weights = (idVec4 *)b.Alloc( numWeights * sizeof( idVec4 ) );
+	int *index = (int *)b.Alloc( numWeights * 2 * sizeof( int ) );
+	memcpy( weights, weightList.Ptr(), numWeights * sizeof( idVec4 ) );
+	memcpy( index, indexList.Ptr(), numWeights * 2 * sizeof( int ) );
+
+	idDrawVert *verts[2] = { Bench_RandomVerts( b, count, 1.0f ), NULL };
+	verts[1] = Bench_CopyVerts( b, verts[0], count );
+
+	b.Run( "TransformVerts", count, 0, 1e-5f, 10.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->TransformVerts( verts[s], count, joints, weights, index, numWeights ); }, benchNoReset(),
+		[&]( idBenchCompare &c ) { Bench_CompareVerts( c, verts[0], verts[1], count ); } );
+}
+
+/*
+================
+Bench_Cull
+================
+*/
+static void Bench_Cull( idSIMDBench &b, int count ) {
+	const idDrawVert *verts = Bench_RandomVerts( b, count, 100.0f );
+	idPlane planes[6];
+	for ( int i = 0; i < 6; i++ ) {
+		idVec3 normal( b.random.CRandomFloat(), b.random.CRandomFloat(), b.random.CRandomFloat() );
+		normal.Normalize();
+		planes[i].SetNormal( normal );
+		planes[i].SetDist( b.random.CRandomFloat() * 50.0f );
+	}
+	byte *bits[2] = { (byte *)b.Alloc( count ), (byte *)b.Alloc( count ) };
+	idVec2 *texCoords[2] = { (idVec2 *)b.Floats( count * 2 ), (idVec2 *)b.Floats( count * 2 ) };
+	byte totalOr[2] = { 0, 0 };
+
+	benchNoReset noReset;
+	auto compareBits = [&]( idBenchCompare &c ) { c.Bytes( bits[0], bits[1], count ); };
+
+	b.Run( "TracePointCull", count, 0, 0.0f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->TracePointCull( bits[s], totalOr[s], 5.0f, planes, verts, count ); }, noReset,
+		[&]( idBenchCompare &c ) { c.Bytes( bits[0], bits[1], count ); c.Bytes( &totalOr[0], &totalOr[1], 1 ); } );
+	b.Run( "DecalPointCull", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->DecalPointCull( bits[s], planes, verts, count ); }, noReset, compareBits );
+	b.Run( "OverlayPointCull", count, 0, 1e-5f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->OverlayPointCull( bits[s], texCoords[s], planes, verts, count ); }, noReset,
+		[&]( idBenchCompare &c ) { c.Bytes( bits[0], bits[1], count ); c.Floats( texCoords[0]->ToFloatPtr(), texCoords[1]->ToFloatPtr(), count * 2 ); } );
+
+	// SoA bounds, mins x y z then maxs x y z
+	float *bounds = b.Floats( count * 6 );
+	for ( int i = 0; i < count; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			const float center = verts[i].xyz[j];
+			const float extent = b.random.RandomFloat() * 10.0f;
+			bounds[j * count + i] = center - extent;
+			bounds[( j + 3 ) * count + i] = center + extent;
+		}
+	}
+	b.Run( "CullBounds", count, 0, 0.0f, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->CullBounds( bits[s], planes, 6, bounds, count, count ); }, noReset, compareBits );
+}
+
+/*
+================
+Bench_Tangents
+
+  The count is the number of vertices, every vertex starts a triangle
+  with the next two so all vertices are shared by three triangles.
+================
+*/
+static void Bench_Tangents( idSIMDBench &b, int count ) {
+	const idDrawVert *orig = Bench_RandomVerts( b, count, 10.0f );
+	const int numIndexes = count * 3;
+	int *indexes = (int *)b.Alloc( numIndexes * sizeof( int ) );
+	for ( int i = 0; i < count; i++ ) {
+		indexes[i*3+0] = ( i + 0 ) % count;
+		indexes[i*3+1] = ( i + 1 ) % count;
+		indexes[i*3+2] = ( i + 2 ) % count;
+	}
+	dominantTri_s *dominantTris = (dominantTri_s *)b.Alloc( count * sizeof( dominantTri_s ) );
+	for ( int i = 0; i < count; i++ ) {
+		dominantTris[i].v2 = ( i + 1 + b.random.RandomInt( 8 ) ) % count;
+		dominantTris[i].v3 = ( i + 9 + b.random.RandomInt( 8 ) ) % count;
+		dominantTris[i].normalizationScale[0] = b.random.CRandomFloat();
+		dominantTris[i].normalizationScale[1] = b.random.CRandomFloat();
+		dominantTris[i].normalizationScale[2] = b.random.CRandomFloat();
+	}
+	idDrawVert *verts[2] = { Bench_CopyVerts( b, orig, count ), Bench_CopyVerts( b, orig, count ) };
+	idPlane *planes[2] = { (idPlane *)b.Floats( count * 4 ), (idPlane *)b.Floats( count * 4 ) };
+
+	benchNoReset noReset;
+	auto reset = [&]( int slot ) { memcpy( verts[slot], orig, count * sizeof( idDrawVert ) ); };
+	auto comparePlanes = [&]( idBenchCompare &c ) { c.Floats( planes[0]->ToFloatPtr(), planes[1]->ToFloatPtr(), count * 4 ); };
+
+	b.Run( "DeriveTriPlanes", count, 0, BENCH_RSQRT_EPSILON, 1.0f, [&]( idSIMDProcessor *p, int s ) { p->DeriveTriPlanes( planes[s], orig, count, indexes, numIndexes ); }, noReset, comparePlanes );
+	b.Run( "DeriveTangents", count, 0, 1e-2f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->DeriveTangents( planes[s], verts[s], count, indexes, numIndexes ); }, reset,
+		[&]( idBenchCompare &c ) { Bench_CompareDirections( c, verts[0], verts[1], count ); } );
+	b.Run( "DeriveUnsmoothedTangents", count, 0, 1e-2f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->DeriveUnsmoothedTangents( verts[s], dominantTris, count ); }, reset,
+		[&]( idBenchCompare &c ) { Bench_CompareDirections( c, verts[0], verts[1], count ); } );
+	b.Run( "NormalizeTangents", count, BENCH_INPLACE, BENCH_RSQRT_EPSILON, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->NormalizeTangents( verts[s], count ); }, reset,
+		[&]( idBenchCompare &c ) { Bench_CompareVerts( c, verts[0], verts[1], count ); } );
+}
+
+/*
+================
+Bench_LightVectors
+================
+*/
+static void Bench_LightVectors( idSIMDBench &b, int count ) {
+	const idDrawVert *verts = Bench_RandomVerts( b, count, 100.0f );
+	const int numIndexes = count * 3;
+	int *indexes = (int *)b.Alloc( numIndexes * sizeof( int ) );
+	for ( int i = 0; i < numIndexes; i++ ) {
+		indexes[i] = b.random.RandomInt( count );
+	}
+	const idVec3 lightOrigin( b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f );
+	const idVec3 viewOrigin( b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f );
+	idVec3 *lightVectors[2] = { (idVec3 *)b.Floats( count * 3 ), (idVec3 *)b.Floats( count * 3 ) };
+	idVec4 *texCoords[2] = { (idVec4 *)b.Floats( count * 4 ), (idVec4 *)b.Floats( count * 4 ) };
+
+	benchNoReset noReset;
+
+	b.Run( "CreateTextureSpaceLightVectors", count, 0, BENCH_RSQRT_EPSILON, 100.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->CreateTextureSpaceLightVectors( lightVectors[s], lightOrigin, verts, count, indexes, numIndexes ); }, noReset,
+		[&]( idBenchCompare &c ) { c.Floats( lightVectors[0]->ToFloatPtr(), lightVectors[1]->ToFloatPtr(), count * 3 ); } );
+	b.Run( "CreateSpecularTextureCoords", count, 0, BENCH_RSQRT_EPSILON, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->CreateSpecularTextureCoords( texCoords[s], lightOrigin, viewOrigin, verts, count, indexes, numIndexes ); }, noReset,
+		[&]( idBenchCompare &c ) { c.Floats( texCoords[0]->ToFloatPtr(), texCoords[1]->ToFloatPtr(), count * 4 ); } );
+}
+
+/*
+================
+Bench_ShadowCache
+================
+*/
+static void Bench_ShadowCache( idSIMDBench &b, int count ) {
+	const idDrawVert *verts = Bench_RandomVerts( b, count, 100.0f );
+	int *origRemap = (int *)b.Alloc( count * sizeof( int ) );
+	for ( int i = 0; i < count; i++ ) {
+		origRemap[i] = ( b.random.CRandomFloat() > 0.0f ) ? -1 : 0;
+	}
+	const idVec3 lightOrigin( b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f, b.random.CRandomFloat() * 100.0f );
+	idVec4 *cache[2] = { (idVec4 *)b.Floats( count * 8 ), (idVec4 *)b.Floats( count * 8 ) };
+	int *remap[2] = { (int *)b.Alloc( count * sizeof( int ) ), (int *)b.Alloc( count * sizeof( int ) ) };
+	int numVerts[2] = { 0, 0 };
+
+	auto compareCache = [&]( idBenchCompare &c ) {
+		c.Ints( &numVerts[0], &numVerts[1], 1 );
+		c.Floats( cache[0]->ToFloatPtr(), cache[1]->ToFloatPtr(), Min( numVerts[0], numVerts[1] ) * 4 );
+	};
+
+	b.Run( "CreateShadowCache", count, BENCH_INPLACE, 1e-6f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { numVerts[s] = p->CreateShadowCache( cache[s], remap[s], lightOrigin, verts, count ); },
+		[&]( int slot ) { memcpy( remap[slot], origRemap, count * sizeof( int ) ); },
+		[&]( idBenchCompare &c ) { compareCache( c ); c.Ints( remap[0], remap[1], count ); } );
+	b.Run( "CreateVertexProgramShadowCache", count, 0, 1e-6f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { numVerts[s] = p->CreateVertexProgramShadowCache( cache[s], verts, count ); }, benchNoReset(),
+		compareCache );
+}
+
+/*
+================
+Bench_UpSample
+
+  The count is the number of input samples.
+================
+*/
+static void Bench_UpSample( idSIMDBench &b, int count ) {
+	short *pcm = (short *)b.Alloc( count * sizeof( short ) );
+	for ( int i = 0; i < count; i++ ) {
+		pcm[i] = (short)( b.random.RandomInt( 1 << 16 ) - ( 1 << 15 ) );
+	}
+	const float *ogg[2] = { b.RandomFloats( count, 1.0f ), b.RandomFloats( count, 1.0f ) };
+	float *dst[2] = { b.Floats( count * 4 ), b.Floats( count * 4 ) };
+
+	for ( int numChannels = 1; numChannels <= 2; numChannels++ ) {
+		for ( int kHz = 11025; kHz <= 44100; kHz *= 2 ) {
+			const int numOut = count * ( 44100 / kHz );
+			auto compare = [&]( idBenchCompare &c ) { c.Floats( dst[0], dst[1], numOut ); };
+
+			b.Run( va( "UpSamplePCMTo44kHz( %d, %d )", kHz, numChannels ), count, 0, 0.0f, 1.0f,
+				[&]( idSIMDProcessor *p, int s ) { p->UpSamplePCMTo44kHz( dst[s], pcm, count, kHz, numChannels ); }, benchNoReset(), compare );
+			b.Run( va( "UpSampleOGGTo44kHz( %d, %d )", kHz, numChannels ), count, 0, 1e-6f, 1.0f,
+				[&]( idSIMDProcessor *p, int s ) { p->UpSampleOGGTo44kHz( dst[s], ogg, count, kHz, numChannels ); }, benchNoReset(), compare );
+		}
+	}
+}
+
+/*
+================
+Bench_Mix
+
+  The mixers always work on MIXBUFFER_SAMPLES, larger counts mix several buffers.
+================
+*/
+static void Bench_Mix( idSIMDBench &b, int count ) {
+	const int numBuffers = Max( 1, count / MIXBUFFER_SAMPLES );
+	const int numSamples = numBuffers * MIXBUFFER_SAMPLES;
+	const float *samples = b.RandomFloats( numSamples * 2, 32767.0f );
+	const float *origMix = b.RandomFloats( numSamples * 6, 32767.0f );
+	float *mix[2] = { b.Floats( numSamples * 6 ), b.Floats( numSamples * 6 ) };
+	short *out[2] = { (short *)b.Alloc( numSamples * 6 * sizeof( short ) ), (short *)b.Alloc( numSamples * 6 * sizeof( short ) ) };
+	float lastV[6], currentV[6];
+	for ( int i = 0; i < 6; i++ ) {
+		lastV[i] = b.random.CRandomFloat();
+		currentV[i] = b.random.CRandomFloat();
+	}
+
+	auto reset = [&]( int slot ) { memcpy( mix[slot], origMix, numSamples * 6 * sizeof( float ) ); };
+
+	struct mixer_t {
+		const char *	name;
+		int				speakers;
+		int				channels;
+		void			(VPCALL idSIMDProcessor::*func)( float *, const float *, const int, const float *, const float * );
+	} mixers[] = {
+		{ "MixSoundTwoSpeakerMono",		2, 1, &idSIMDProcessor::MixSoundTwoSpeakerMono },
+		{ "MixSoundTwoSpeakerStereo",	2, 2, &idSIMDProcessor::MixSoundTwoSpeakerStereo },
+		{ "MixSoundSixSpeakerMono",		6, 1, &idSIMDProcessor::MixSoundSixSpeakerMono },
+		{ "MixSoundSixSpeakerStereo",	6, 2, &idSIMDProcessor::MixSoundSixSpeakerStereo },
+	};
+
+	// the volume ramps are stepped differently, so errors are relative to full scale
+	for ( int m = 0; m < (int)( sizeof( mixers ) / sizeof( mixers[0] ) ); m++ ) {
+		const mixer_t &mixer = mixers[m];
+		b.Run( mixer.name, numSamples, BENCH_INPLACE, 1e-4f, 32767.0f,
+			[&]( idSIMDProcessor *p, int s ) {
+				for ( int i = 0; i < numBuffers; i++ ) {
+					( p->*mixer.func )( mix[s] + i * MIXBUFFER_SAMPLES * mixer.speakers, samples + i * MIXBUFFER_SAMPLES * mixer.channels, MIXBUFFER_SAMPLES, lastV, currentV );
+				}
+			}, reset,
+			[&]( idBenchCompare &c ) { c.Floats( mix[0], mix[1], numSamples * mixer.speakers ); } );
+	}
+
+	// rounding to the nearest sample may differ by one
+	b.Run( "MixedSoundToSamples", numSamples * 2, 0, 1.0f, 1.0f,
+		[&]( idSIMDProcessor *p, int s ) { p->MixedSoundToSamples( out[s], origMix, numSamples * 2 ); }, benchNoReset(),
+		[&]( idBenchCompare &c ) { c.Shorts( out[0], out[1], numSamples * 2, 1 ); } );
+}
+
+static const benchKernel_t benchKernels[] = {
+	{ "Arithmetic",		Bench_Arithmetic,		0,			0 },
+	{ "Dot",			Bench_Dot,				0,			0 },
+	{ "Compare",		Bench_Compare,			0,			0 },
+	{ "MinMaxClamp",	Bench_MinMaxClamp,		0,			0 },
+	{ "Memory",			Bench_Memory,			0,			0 },
+	{ "MatX",			Bench_MatX,				0,			0 },
+	{ "MatXSolve",		Bench_MatXSolve,		0,			0 },
+	{ "Joints",			Bench_Joints,			0,			2 },
+	{ "TransformVerts",	Bench_TransformVerts,	0,			0 },
+	{ "Cull",			Bench_Cull,				0,			0 },
+	{ "Tangents",		Bench_Tangents,			0,			3 },
+	{ "LightVectors",	Bench_LightVectors,		0,			0 },
+	{ "ShadowCache",	Bench_ShadowCache,		0,			0 },
+	{ "UpSample",		Bench_UpSample,			0,			2 },
+	{ "Mix",			Bench_Mix,				0,			MIXBUFFER_SAMPLES },
+};
+
+/*
+===============================================================================
+
+	Output
+
+===============================================================================
+*/
+
+/*
+================
+Bench_JsonString
+================
+*/
+static idStr Bench_JsonString( const char *s ) {
+	idStr out = "\"";
+	for ( ; *s; s++ ) {
+		if ( *s == '"' || *s == '\\' ) {
+			out += '\\';
+		}
+		out += *s;
+	}
+	out += "\"";
+	return out;
+}
+
+/*
+================
+Bench_JsonNumber
+================
+*/
+static idStr Bench_JsonNumber( double d ) {
+	if ( d != d || d > 1e300 || d < -1e300 ) {
+		return "null";
+	}
+	return va( "%.6g", d );
+}
+
+/*
+================
+Bench_WriteJson
+================
+*/
+static bool Bench_WriteJson( const idSIMDBench &b, const char *fileName, int numFailed ) {
+	FILE *f = ( idStr::Cmp( fileName, "-" ) == 0 ) ? stdout : fopen( fileName, "w" );
+	if ( f == NULL ) {
+		common->Warning( "couldn't open %s for writing", fileName );
+		return false;
+	}
+
+	const int cpuid = sys->GetProcessorId();
+	fprintf( f, "{\n" );
+	fprintf( f, "\t\"version\": 1,\n" );
+	fprintf( f, "\t\"reference\": %s,\n", Bench_JsonString( b.generic->GetName() ).c_str() );
+	fprintf( f, "\t\"processor\": %s,\n", Bench_JsonString( b.simd->GetName() ).c_str() );
+	fprintf( f, "\t\"cpuid\": { \"mmx\": %s, \"sse\": %s, \"sse2\": %s, \"sse3\": %s, \"avx2\": %s },\n",
+				( cpuid & CPUID_MMX ) ? "true" : "false", ( cpuid & CPUID_SSE ) ? "true" : "false", ( cpuid & CPUID_SSE2 ) ? "true" : "false",
+				( cpuid & CPUID_SSE3 ) ? "true" : "false", ( cpuid & CPUID_AVX2 ) ? "true" : "false" );
+	fprintf( f, "\t\"iterations\": %d,\n", b.iterations );
+	fprintf( f, "\t\"toleranceScale\": %s,\n", Bench_JsonNumber( b.toleranceScale ).c_str() );
+	fprintf( f, "\t\"failed\": %d,\n", numFailed );
+	fprintf( f, "\t\"results\": [\n" );
+	for ( int i = 0; i < b.results.Num(); i++ ) {
+		const benchResult_t &r = b.results[i];
+		fprintf( f, "\t\t{ \"name\": %s, \"count\": %d, \"genericNs\": %s, \"simdNs\": %s, \"speedup\": %s, \"maxError\": %s, \"maxUlps\": %d, \"mismatches\": %d, \"firstMismatch\": %d, \"pass\": %s }%s\n",
+					Bench_JsonString( r.name ).c_str(), r.count, Bench_JsonNumber( r.genericNs ).c_str(), Bench_JsonNumber( r.simdNs ).c_str(),
+					Bench_JsonNumber( r.simdNs > 0.0 ? r.genericNs / r.simdNs : 0.0 ).c_str(), Bench_JsonNumber( r.maxError ).c_str(),
+					r.maxUlps, r.mismatches, r.firstMismatch, r.mismatches ? "false" : "true", ( i < b.results.Num() - 1 ) ? "," : "" );
+	}
+	fprintf( f, "\t]\n" );
+	fprintf( f, "}\n" );
+
+	if ( f != stdout ) {
+		fclose( f );
+	}
+	return true;
+}
+
+/*
+================
+Bench_CreateProcessor
+================
+*/
+static idSIMDProcessor *Bench_CreateProcessor( const char *name ) {
+	const int cpuid = sys->GetProcessorId();
+	idSIMDProcessor *processor = NULL;
+
+	if ( idStr::Icmp( name, "auto" ) == 0 ) {
+		idSIMD::InitProcessor( "simdbench", false );
+		return SIMDProcessor;
+	} else if ( idStr::Icmp( name, "generic" ) == 0 ) {
+		processor = new idSIMD_Generic;
+	} else if ( idStr::Icmp( name, "mmx" ) == 0 && ( cpuid & CPUID_MMX ) ) {
+		processor = new idSIMD_MMX;
+	} else if ( idStr::Icmp( name, "sse" ) == 0 && ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) ) {
+		processor = new idSIMD_SSE;
+	} else if ( idStr::Icmp( name, "sse2" ) == 0 && ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
+		processor = new idSIMD_SSE2;
+	} else if ( idStr::Icmp( name, "sse3" ) == 0 && ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) ) {
+		processor = new idSIMD_SSE3;
+#ifdef ID_SIMD_SSE2_INTRINSICS
+	} else if ( idStr::Icmp( name, "sse2intrin" ) == 0 && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
+		processor = new idSIMD_SSE2Intrin;
+	} else if ( idStr::Icmp( name, "avx2" ) == 0 && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_AVX2 ) ) {
+		processor = new idSIMD_AVX2;
+#endif
+	} else {
+		return NULL;
+	}
+	processor->cpuid = cpuid;
+	return processor;
+}
+
+/*
+================
+Bench_Usage
+================
+*/
+static int Bench_Usage( void ) {
+	common->Printf( "usage: simdbench [-processor auto|generic|mmx|sse|sse2|sse3|sse2intrin|avx2] [-min count] [-max count] [-step factor]\n"
+					"                 [-iterations n] [-tolerance scale] [-filter string] [-json file] [-list]\n" );
+	return 2;
+}
+
+/*
+================
+main
+================
+*/
+int main( int argc, char **argv ) {
+	const char *processorName = "auto";
+	const char *jsonFile = NULL;
+	int minCount = BENCH_DEFAULT_MIN;
+	int maxCount = BENCH_DEFAULT_MAX;
+	int step = 4;
+	bool list = false;
+
+	idLib::sys = sys;
+	idLib::common = common;
+	idLib::cvarSystem = NULL;
+	idLib::fileSystem = NULL;
+	idLib::Init();
+
+	idSIMDBench bench;
+	bench.random.SetSeed( RANDOM_SEED );
+
+	for ( int i = 1; i < argc; i++ ) {
+		const bool hasValue = i + 1 < argc;
+		if ( idStr::Icmp( argv[i], "-processor" ) == 0 && hasValue ) {
+			processorName = argv[++i];
+		} else if ( idStr::Icmp( argv[i], "-min" ) == 0 && hasValue ) {
+			minCount = Max( 1, atoi( argv[++i] ) );
+		} else if ( idStr::Icmp( argv[i], "-max" ) == 0 && hasValue ) {
+			maxCount = Max( 1, atoi( argv[++i] ) );
+		} else if ( idStr::Icmp( argv[i], "-step" ) == 0 && hasValue ) {
+			step = Max( 2, atoi( argv[++i] ) );
+		} else if ( idStr::Icmp( argv[i], "-iterations" ) == 0 && hasValue ) {
+			bench.iterations = Max( 1, atoi( argv[++i] ) );
+		} else if ( idStr::Icmp( argv[i], "-tolerance" ) == 0 && hasValue ) {
+			bench.toleranceScale = Max( 0.0f, (float)atof( argv[++i] ) );
+		} else if ( idStr::Icmp( argv[i], "-filter" ) == 0 && hasValue ) {
+			bench.filter = argv[++i];
+		} else if ( idStr::Icmp( argv[i], "-json" ) == 0 && hasValue ) {
+			jsonFile = argv[++i];
+		} else if ( idStr::Icmp( argv[i], "-list" ) == 0 ) {
+			list = true;
+		} else {
+			return Bench_Usage();
+		}
+	}
+
+	if ( jsonFile != NULL && idStr::Cmp( jsonFile, "-" ) == 0 ) {
+		benchOutput = stderr;
+	}
+
+	if ( list ) {
+		for ( int i = 0; i < (int)( sizeof( benchKernels ) / sizeof( benchKernels[0] ) ); i++ ) {
+			common->Printf( "%s\n", benchKernels[i].name );
+		}
+		return 0;
+	}
+
+	bench.generic = new idSIMD_Generic;
+	bench.generic->cpuid = CPUID_GENERIC;
+	bench.simd = Bench_CreateProcessor( processorName );
+	if ( bench.simd == NULL ) {
+		common->Printf( "processor %s is unknown or not supported by this CPU\n", processorName );
+		return Bench_Usage();
+	}
+
+	common->Printf( "comparing %s against %s\n", bench.simd->GetName(), bench.generic->GetName() );
+	common->Printf( "%-44s %8s %12s %12s %7s %10s\n", "kernel", "count", "generic ns", "simd ns", "speedup", "max error" );
+
+	for ( int i = 0; i < (int)( sizeof( benchKernels ) / sizeof( benchKernels[0] ) ); i++ ) {
+		const benchKernel_t &kernel = benchKernels[i];
+		int lastCount = 0;
+		for ( int count = minCount; count <= maxCount; count *= step ) {
+			int c = Max( count, kernel.minCount );
+			if ( kernel.maxCount ) {
+				c = Min( c, kernel.maxCount );
+			}
+			if ( c != lastCount ) {
+				kernel.func( bench, c );
+				bench.FreeAll();
+				lastCount = c;
+			}
+			if ( count > INT_MAX / step ) {
+				break;
+			}
+		}
+	}
+
+	int numFailed = 0;
+	for ( int i = 0; i < bench.results.Num(); i++ ) {
+		if ( bench.results[i].mismatches ) {
+			numFailed++;
+		}
+	}
+	common->Printf( "%d of %d kernel runs out of tolerance\n", numFailed, bench.results.Num() );
+
+	if ( jsonFile != NULL && !Bench_WriteJson( bench, jsonFile, numFailed ) ) {
+		return 2;
+	}
+
+	return numFailed ? 1 : 0;
+}